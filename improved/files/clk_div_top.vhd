@@ -44,6 +44,15 @@ entity clk_div_top is
            out_clk : out STD_LOGIC;
            clk_lost : out STD_LOGIC;
            SCALE : in UNSIGNED (31 downto 0);
+           -- pps reference select: '0' pps_clk pin, '1' ptp_pps from pps_gen
+           pps_sel : in STD_LOGIC;
+           ptp_pps : in STD_LOGIC;
+           -- selected pps reference, to the PS interrupt (IRQ_F2P[0])
+           pps_out : out STD_LOGIC;
+           -- sys_clk counts of the last completed pps window, in SCALE periods
+           WIN_COUNT : out UNSIGNED (31 downto 0);
+           -- signed correction added to the averaged divisor at each pps
+           DIV_TRIM : in SIGNED (31 downto 0);
            -- Debug ports
            rst_n_monitor : out STD_LOGIC;
            pps_clk_monitor : out STD_LOGIC;
@@ -80,10 +89,13 @@ architecture Behavioral of clk_div_top is
     
     -- Signals for edge_detector instance
     signal edge_pulse : STD_LOGIC;
+    signal pps_ref : STD_LOGIC;
     signal r_M : UNSIGNED (31 downto 0);
     
     signal rep_cnt : UNSIGNED (31 downto 0);
     
+    signal r_win_count : UNSIGNED (31 downto 0) := TO_UNSIGNED(0, 32);
+    
     signal clk_change : STD_LOGIC;
     
     signal counter : integer := 0;
@@ -115,11 +127,15 @@ begin
             clk => sys_clk,
             reset_n => rst_n,
             r_reset_n => r_rst_n,
-            edge_in => pps_clk,
+            edge_in => pps_ref,
             edge_pulse => edge_pulse
         );
         
 
+    pps_ref <= ptp_pps when pps_sel = '1' else pps_clk;
+    pps_out <= pps_ref;
+    WIN_COUNT <= r_win_count;
+
     divisor_by_2 <= '0' & divisor(31 downto 1); -- divide by 2
     out_clk <= r_out_clk AND r_out_ready;
     out_ready <= r_out_ready;
@@ -159,6 +175,7 @@ begin
             set_cnt <= 0;
             rep_cnt <= TO_UNSIGNED (0, 32);
             divisor <= std_logic_vector(TO_UNSIGNED(0,32));
+            r_win_count <= TO_UNSIGNED(0, 32);
             prep_ready <= '0';
             r_out_ready <= '0';
             div_cnt <= TO_UNSIGNED(0, 32);
@@ -292,14 +309,17 @@ begin
 --                end case;
                 
                 r_sys_array(set_cnt) <= sys_array(set_cnt);
+                r_win_count <= sys_array(set_cnt);
                 if (set_cnt = NUM_WIN-1) then
                     sys_array(0) <= TO_UNSIGNED(0, 32);
                 else
                     sys_array(set_cnt+1) <= TO_UNSIGNED(0, 32);
                 end if;
                 
-                -- update divisor based on registered counter
-                divisor <= ZERO_WIN & sys_cnt_vct(31 downto WIN_WIDTH);
+                -- update divisor based on registered counter, plus the trim
+                -- predicted by the PS for the coming window
+                divisor <= std_logic_vector(unsigned(ZERO_WIN & sys_cnt_vct(31 downto WIN_WIDTH))
+                           + unsigned(std_logic_vector(DIV_TRIM)));
                 -- store previous divisor
                 prev_divisor <= divisor;
               
@@ -49,11 +49,26 @@ component clk_div_top is
         out_ready : out STD_LOGIC;
         out_clk : out STD_LOGIC;
         clk_lost : out STD_LOGIC;
+        pps_sel : in STD_LOGIC;
+        ptp_pps : in STD_LOGIC;
+        pps_out : out STD_LOGIC;
+        WIN_COUNT : out UNSIGNED (31 downto 0);
+        DIV_TRIM : in SIGNED (31 downto 0);
         rst_n_monitor : out STD_LOGIC;
         pps_clk_monitor : out STD_LOGIC;
         edge_monitor : out STD_LOGIC);
 end component;
 
+component pps_gen is
+    Port (
+        rst_n : in STD_LOGIC;
+        sys_clk : in STD_LOGIC;
+        PERIOD : in UNSIGNED (31 downto 0);
+        STEP : in SIGNED (29 downto 0);
+        load_tgl : in STD_LOGIC;
+        pps_out : out STD_LOGIC);
+end component;
+
 signal reset_n : std_logic := '1';
 signal ready : std_logic;
 
@@ -72,6 +87,18 @@ signal SCALE : unsigned(31 downto 0);
 
 signal edge : std_logic;
 
+-- pps_gen, stands in for the PTP disciplined pps
+signal pps_sel : std_logic := '0';
+signal ptp_pps : std_logic;
+signal pps_out : std_logic;
+signal pps_period : unsigned(31 downto 0) := to_unsigned(0, 32);
+signal pps_step : signed(29 downto 0) := to_signed(0, 30);
+signal pps_load : std_logic := '0';
+
+-- divisor measurement and trim, driven by the PS temperature compensation
+signal win_count : unsigned(31 downto 0);
+signal div_trim : signed(31 downto 0) := to_signed(0, 32);
+
 constant pps_clock_period0 : time := 1 ms;  --1 Khz
 constant pps_clock_period1 : time := 10 ms; -- 10hz
 signal sys_clock_period : time := 1 ns;  --1 Mhz
@@ -94,10 +121,24 @@ CLK_DIV_TOP_UNIT : clk_div_top
         out_ready => ready,
         out_clk => out_clock,
         clk_lost => clock_lost,
+        pps_sel => pps_sel,
+        ptp_pps => ptp_pps,
+        pps_out => pps_out,
+        WIN_COUNT => win_count,
+        DIV_TRIM => div_trim,
         rst_n_monitor => rst_n_monitor,
         pps_clk_monitor => pps_clk_monitor,
         edge_monitor => edge);
         
+PPS_GEN_UNIT : pps_gen
+    port map(
+        rst_n => reset_n,
+        sys_clk => sys_clock,
+        PERIOD => pps_period,
+        STEP => pps_step,
+        load_tgl => pps_load,
+        pps_out => ptp_pps);
+
 sim_process : process
 begin
     wait for 2 us;
@@ -122,6 +163,23 @@ begin
 --    wait for 1 ns;
 --    reset_n <= '1';
     wait for 20 ms;
+    -- switch to pps_gen: 1 ms at 5 ns is 200000 cycles, started 500 ns
+    -- late and pulled back by a 100 cycle step
+    pps_period <= to_unsigned(200000, 32);
+    wait for 500 ns;
+    pps_load <= not pps_load;
+    wait for 100 us;
+    pps_step <= to_signed(-100, 30);
+    pps_load <= not pps_load;
+    wait for 1 ms;
+    pps_sel <= '1';
+    wait for 10 ms;
+    pps_sel <= '0';
+    -- trim the divisor by +2 for a few pps, as the PS would on a
+    -- temperature ramp
+    div_trim <= to_signed(2, 32);
+    wait for 5 ms;
+    div_trim <= to_signed(0, 32);
     clock_en <= '0';
     wait for 5 ms;
      reset_n <= '0';
@@ -38,9 +38,26 @@
 #include "xparameters.h"
 #include "xgpio.h"
 #include "stdio.h"
+#include "stdlib.h"
 #include "xstatus.h"
 #include "sleep.h"
 #include "xil_printf.h"
+#include "clk_div_pl.h"
+#include "pps_intr.h"
+#include "ptp_ref.h"
+#include "temp_comp.h"
+#include "boot_profile.h"
+#include "pr_engine.h"
+#include "cache_bench.h"
+#include "mem_bench.h"
+#include "timer_svc.h"
+#include "sched.h"
+#include "console.h"
+#include "amp.h"
+#include "pps_fiq.h"
+#include "irq_prof.h"
+#include "l2_lock.h"
+#include "ocm.h"
 
 /************************** Constant Definitions ****************************/
 
@@ -58,7 +75,41 @@
  * xparameters.h file. They are defined here such that a user can easily
  * change all the needed parameters in one place.
  */
-#define GPIO_OUTPUT_DEVICE_ID	XPAR_AXI_GPIO_0_DEVICE_ID
+#define GPIO_OUTPUT_DEVICE_ID	CLK_DIV_SCALE_GPIO_DEVICE_ID
+
+/*
+ * Scheduler tasks of the application, highest priority first, and their
+ * events
+ */
+#define TELEMETRY_PRIORITY	1U
+#define COMMAND_PRIORITY	2U
+
+#define COMMAND_EV_INPUT	0x1U	/* Characters on the console */
+#define COMMAND_EV_SWAP		0x2U	/* The engine swap ended */
+#define TELEMETRY_EV_PPS	0x1U
+
+/* Global timer ticks to us */
+#define LATENCY_US(Ticks)	((u32)(((u64)(Ticks) * 1000000U) / \
+				       COUNTS_PER_SECOND))
+
+/* Global timer ticks to ns */
+#define LATENCY_NS(Ticks)	((u32)(((u64)(Ticks) * 1000000000U) / \
+				       COUNTS_PER_SECOND))
+
+#define FIQ_SAMPLES		10000U	/* 1 s per path at 100 us */
+
+/************************** Function Prototypes *****************************/
+
+static void Command_Prompt(void);
+static void Command_Run(void *CallBackRef, u32 Events);
+static void Command_SwapDone(void *CallBackRef, u32 IntrStatus);
+static void Telemetry_Pps(void *CallBackRef, XTime Timestamp) L2_LOCKED_TEXT;
+static void Telemetry_Run(void *CallBackRef, u32 Events);
+static void Telemetry_Cpu1(void *CallBackRef, const MsgQueue_Msg *Msg);
+static void Telemetry_Print(u32 Pps);
+static void Latency_Print(void);
+static void Fiq_Print(void);
+static void Fiq_PrintHist(const char *Name, const PpsFiq_Hist *HistPtr);
 
 /************************** Variable Definitions **************************/
 
@@ -68,6 +119,10 @@
  */
 XGpio GpioOutput; /* The driver instance for GPIO Device configured as O/P */
 
+Sched_Task CommandTask;
+Sched_Task TelemetryTask;
+u32 TelemetryOn;
+
 /*****************************************************************************/
 /**
 * Main function to call the example. This function is not included if the
@@ -86,7 +141,19 @@ int main(void)
 {
 
 	int Status;
-	u32 input_value;
+	u32 variant;
+	PrEngine_Events engine_events = {
+		NULL, Command_SwapDone, Command_SwapDone, &CommandTask
+	};
+
+	/* Where the cold start went, as recorded by the FSBL */
+	BootProfile_Print();
+
+	/* One-shot timers and WFI sleeps instead of busy-waiting */
+	Status = TimerSvc_Init();
+	if (Status != XST_SUCCESS) {
+		printf("Failed to initialize timer service\r\n");
+	}
 
 	/*
 	 * Initialize the GPIO driver so that it's ready to use,
@@ -100,15 +167,414 @@ int main(void)
 	 /* Set the direction for all signals to be outputs */
 	 XGpio_SetDataDirection(&GpioOutput, PL_CHANNEL, 0x0);
 
-	 while (1) {
+	 /*
+	  * PTP disciplined pps. It only becomes the reference of clk_div_top
+	  * once selected with PtpRef_Select(), after the PTP message layer has
+	  * locked the TSU.
+	  */
+	 Status = PtpRef_Init(CLK_DIV_SYS_CLK_HZ);
+	 if ((Status != XST_SUCCESS) && (Status != XST_NO_FEATURE)) {
+		  printf("Failed to initialize PTP reference\r\n");
+	 }
+
+	 /* Temperature compensation of the divisor, if the PL has DIV_TRIM */
+	 Status = TempComp_Init();
+	 if ((Status != XST_SUCCESS) && (Status != XST_NO_FEATURE)) {
+		  printf("Failed to initialize temperature compensation\r\n");
+	 }
+
+	 Sched_TaskInit(&CommandTask, Command_Run, NULL, COMMAND_PRIORITY);
+	 Sched_TaskInit(&TelemetryTask, Telemetry_Run, NULL,
+			TELEMETRY_PRIORITY);
+
+	 /*
+	  * With APP_CPU1, the temperature model and the telemetry output move
+	  * to CPU1 and CPU0 keeps the interrupts and the register writes
+	  */
+	 (void)Amp_SetHandler(AMP_MSG_TELEMETRY, Telemetry_Cpu1, NULL);
+	 Status = Amp_Start();
+	 if ((Status != XST_SUCCESS) && (Status != XST_NO_FEATURE)) {
+		  printf("Failed to start CPU1\r\n");
+	 }
+
+	 (void)PpsIntr_AddHandler(Telemetry_Pps, NULL);
+	 Status = PpsIntr_Init();
+	 if ((Status != XST_SUCCESS) && (Status != XST_NO_FEATURE)) {
+		  printf("Failed to connect pps interrupt\r\n");
+	 }
+
+	 /* Divisor engine variants that can be swapped in without a reboot */
+	 Status = PrEngine_Init();
+	 if ((Status != XST_SUCCESS) && (Status != XST_NO_FEATURE)) {
+		  printf("Failed to initialize partial reconfiguration\r\n");
+	 }
+	 /* The devcfg interrupt reports the end of a swap to the command task */
+	 PrEngine_SetEvents(&engine_events);
+	 for (variant = 0; variant < PrEngine_GetCount(); variant++) {
+		  printf("Engine v%u: NUM_WIN %u, THRESHOLD %u\r\n", variant,
+			 PrEngine_GetVariant(variant)->NumWin,
+			 PrEngine_GetVariant(variant)->Threshold);
+	 }
+
+	 Command_Prompt();
+	 Status = Console_Init(&CommandTask, COMMAND_EV_INPUT);
+	 if (Status != XST_SUCCESS) {
+		  printf("Failed to connect console interrupt\r\n");
+	 }
+
+	 /*
+	  * Keep the interrupt path in the L2, out of reach of the bulk traffic
+	  * of the benchmarks, the telemetry and the engine swaps
+	  */
+	 Status = L2Lock_Init();
+	 if (Status != XST_SUCCESS) {
+		  printf("Failed to lock the interrupt path in L2\r\n");
+	 }
 
-		 sleep(1);
-		 printf("Enter an unsigned integer as scale: \r\n");
-		 scanf("%lu", &input_value);
-		 /* Set the GPIO outputs to low */
-		 XGpio_DiscreteWrite(&GpioOutput, PL_CHANNEL, input_value);
-		 printf("Wrote %u\r\n", input_value);
+	 /*
+	  * With IRQ_PROF, profile every interrupt handler from here on: entry
+	  * latency, run time and cache misses, and the latency of a probe
+	  */
+	 Status = IrqProf_Start();
+	 if ((Status != XST_SUCCESS) && (Status != XST_NO_FEATURE)) {
+		  printf("Failed to start the interrupt profile\r\n");
 	 }
 
+	 /* Everything from here on runs as scheduler tasks */
+	 Sched_Run();
+
 	 return XST_SUCCESS;
 }
+
+/*****************************************************************************/
+/**
+* Print the command prompt.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Command_Prompt(void)
+{
+	Amp_PrintLock();
+	if (PrEngine_GetCount() != 0) {
+		printf("Enter an unsigned integer as scale, "
+		       "c for the cache benchmark, "
+		       "m for the copy benchmark, "
+		       "t to toggle telemetry, "
+		       "l for the pps latency, "
+		       "f for the FIQ latency, "
+		       "p for the interrupt profile, "
+		       "k for the L2 lock benchmark, "
+		       "o for the OCM benchmark "
+		       "or v<n> for engine variant n: \r\n");
+	} else {
+		printf("Enter an unsigned integer as scale, "
+		       "c for the cache benchmark, "
+		       "m for the copy benchmark, "
+		       "t to toggle telemetry, "
+		       "l for the pps latency, "
+		       "f for the FIQ latency, "
+		       "p for the interrupt profile, "
+		       "k for the L2 lock benchmark "
+		       "or o for the OCM benchmark: \r\n");
+	}
+	Amp_PrintUnlock();
+}
+
+/*****************************************************************************/
+/**
+* Command task. Runs the commands typed on the console, and reports an
+* engine swap once the devcfg interrupt ends it. Input that arrives during
+* a swap stays in the UART until the swap is reported. Output is done under
+* the print lock of amp.c, except for the benchmarks, which must not wait
+* for CPU1.
+*
+* @param	CallBackRef is unused.
+* @param	Events are COMMAND_EV_* bits.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Command_Run(void *CallBackRef, u32 Events)
+{
+	static u32 swap_variant;
+	static u32 swapping;
+	char input_line[16];
+	u32 input_value;
+	u32 variant;
+	PrEngine_Status engine;
+
+	(void)CallBackRef;
+
+	if ((Events & COMMAND_EV_SWAP) != 0U) {
+		swapping = 0U;
+		PrEngine_GetStatus(&engine);
+		Amp_PrintLock();
+		if (engine.Variant == swap_variant) {
+			printf("Loaded engine v%u in %u us\r\n",
+			       swap_variant, engine.LastUs);
+		} else {
+			printf("Engine v%u failed, status 0x%08x\r\n",
+			       swap_variant, engine.LastIntrStatus);
+		}
+		Amp_PrintUnlock();
+		Command_Prompt();
+	}
+
+	while ((swapping == 0U) &&
+	       Console_GetToken(input_line, sizeof(input_line))) {
+
+		if (input_line[0] == 'c') {
+			CacheBench_Run();
+		} else if (input_line[0] == 'm') {
+			MemBench_Run();
+		} else if (input_line[0] == 't') {
+			TelemetryOn = !TelemetryOn;
+		} else if (input_line[0] == 'l') {
+			Latency_Print();
+		} else if (input_line[0] == 'f') {
+			Fiq_Print();
+		} else if (input_line[0] == 'p') {
+			IrqProf_Print(1U);
+		} else if (input_line[0] == 'k') {
+			L2Lock_Bench();
+		} else if (input_line[0] == 'o') {
+			Ocm_Bench();
+		} else if (input_line[0] == 'v') {
+			variant = strtoul(&input_line[1], NULL, 10);
+			if (PrEngine_Start(variant) != XST_SUCCESS) {
+				Amp_PrintLock();
+				printf("No engine variant %u\r\n", variant);
+				Amp_PrintUnlock();
+			} else {
+				/* Reported on COMMAND_EV_SWAP, not here */
+				swap_variant = variant;
+				swapping = 1U;
+				return;
+			}
+		} else {
+			input_value = strtoul(input_line, NULL, 10);
+			/* Set the GPIO outputs to low */
+			XGpio_DiscreteWrite(&GpioOutput, PL_CHANNEL,
+					    input_value);
+			TempComp_SetScale(input_value);
+			Amp_PrintLock();
+			printf("Wrote %u\r\n", input_value);
+			Amp_PrintUnlock();
+		}
+		Command_Prompt();
+	}
+}
+
+/*****************************************************************************/
+/**
+* PL done and error event of an engine swap. Hands the report over to the
+* command task.
+*
+* @param	CallBackRef is the command task.
+* @param	IntrStatus is unused.
+*
+* @return	None.
+*
+* @note		IRQ context.
+*
+******************************************************************************/
+static void Command_SwapDone(void *CallBackRef, u32 IntrStatus)
+{
+	(void)IntrStatus;
+
+	Sched_Post((Sched_Task *)CallBackRef, COMMAND_EV_SWAP);
+}
+
+/*****************************************************************************/
+/**
+* Per-second handler of the pps interrupt. Hands the second over to the
+* telemetry task, or to CPU1 when it runs.
+*
+* @param	CallBackRef is unused.
+* @param	Timestamp is unused.
+*
+* @return	None.
+*
+* @note		IRQ context.
+*
+******************************************************************************/
+static void Telemetry_Pps(void *CallBackRef, XTime Timestamp)
+{
+	MsgQueue_Msg Msg = { AMP_MSG_TELEMETRY, { 0U } };
+
+	(void)CallBackRef;
+	(void)Timestamp;
+
+	if (!TelemetryOn) {
+		return;
+	}
+
+	if (Amp_IsRunning()) {
+		Msg.Arg[0] = PpsIntr_GetCount();
+		(void)Amp_Send(&Msg);
+	} else {
+		Sched_Post(&TelemetryTask, TELEMETRY_EV_PPS);
+	}
+}
+
+/*****************************************************************************/
+/**
+* Telemetry task. Prints the state of the divisor once per pps while
+* enabled with the t command.
+*
+* @param	CallBackRef is unused.
+* @param	Events are TELEMETRY_EV_* bits.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Telemetry_Run(void *CallBackRef, u32 Events)
+{
+	(void)CallBackRef;
+	(void)Events;
+
+	Telemetry_Print(PpsIntr_GetCount());
+}
+
+/*****************************************************************************/
+/**
+* AMP_MSG_TELEMETRY handler: the telemetry task of CPU1.
+*
+* @param	CallBackRef is unused.
+* @param	Msg is the pps count.
+*
+* @return	None.
+*
+* @note		CPU1.
+*
+******************************************************************************/
+static void Telemetry_Cpu1(void *CallBackRef, const MsgQueue_Msg *Msg)
+{
+	(void)CallBackRef;
+
+	Telemetry_Print(Msg->Arg[0]);
+}
+
+/*****************************************************************************/
+/**
+* Print the telemetry line of a pps.
+*
+* @param	Pps is the pps count.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Telemetry_Print(u32 Pps)
+{
+	TempComp_Status temp;
+	PrEngine_Status engine;
+
+	TempComp_GetStatus(&temp);
+	PrEngine_GetStatus(&engine);
+	Amp_PrintLock();
+	printf("pps %u: %d mC, window %u, trim %d, engine %u\r\n",
+	       Pps, temp.TempMilliC, temp.WinCount, temp.Trim,
+	       engine.Variant);
+	Amp_PrintUnlock();
+}
+
+/*****************************************************************************/
+/**
+* Print and restart the timing of the pps handlers on CPU0: the count, the
+* min, mean and max run time, their spread as the jitter, where the model
+* runs and the messages to CPU1 dropped.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Latency_Print(void)
+{
+	PpsIntr_Stats stats;
+	u32 mean = 0U;
+
+	PpsIntr_GetStats(&stats, 1U);
+	if (stats.Count != 0U) {
+		mean = (u32)(stats.SumTicks / stats.Count);
+	}
+
+	Amp_PrintLock();
+	printf("pps handlers on CPU0 (%s): %u pps, min %u us, mean %u us, "
+	       "max %u us, jitter %u us, %u messages dropped\r\n",
+	       Amp_IsRunning() ? "model on CPU1" : "model on CPU0",
+	       stats.Count, LATENCY_US(stats.MinTicks), LATENCY_US(mean),
+	       LATENCY_US(stats.MaxTicks),
+	       LATENCY_US(stats.MaxTicks - stats.MinTicks), Amp_GetDropped());
+	Amp_PrintUnlock();
+}
+
+/*****************************************************************************/
+/**
+* Measure and print the interrupt-to-handler latency through the FIQ vector
+* and through the IRQ path.
+*
+* @return	None.
+*
+* @note		Blocks the command task for about 2 s.
+*
+******************************************************************************/
+static void Fiq_Print(void)
+{
+	static PpsFiq_Hist fiq_hist;
+	static PpsFiq_Hist irq_hist;
+
+	if (PpsFiq_Measure(FIQ_SAMPLES, &fiq_hist, &irq_hist) != XST_SUCCESS) {
+		Amp_PrintLock();
+		printf("FIQ latency measurement failed\r\n");
+		Amp_PrintUnlock();
+		return;
+	}
+
+	Fiq_PrintHist("FIQ", &fiq_hist);
+	Fiq_PrintHist("IRQ", &irq_hist);
+	Amp_PrintLock();
+	printf("%u interrupts handed back from FIQ to IRQ\r\n",
+	       PpsFiq_GetStolen());
+	Amp_PrintUnlock();
+}
+
+/*****************************************************************************/
+/**
+* Print one latency histogram, the empty buckets left out.
+*
+* @param	Name is the path measured.
+* @param	HistPtr is the histogram.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Fiq_PrintHist(const char *Name, const PpsFiq_Hist *HistPtr)
+{
+	u32 index;
+
+	Amp_PrintLock();
+	printf("%s latency: %u samples, min %u ns, max %u ns\r\n", Name,
+	       HistPtr->Count, LATENCY_NS(HistPtr->MinTicks),
+	       LATENCY_NS(HistPtr->MaxTicks));
+	for (index = 0U; index < PPS_FIQ_BUCKETS; index++) {
+		if (HistPtr->Bucket[index] != 0U) {
+			printf("  %4u ns%s %u\r\n",
+			       LATENCY_NS(index << PPS_FIQ_BUCKET_SHIFT),
+			       (index == (PPS_FIQ_BUCKETS - 1U)) ? "+" : " ",
+			       HistPtr->Bucket[index]);
+		}
+	}
+	Amp_PrintUnlock();
+}
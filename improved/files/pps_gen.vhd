@@ -0,0 +1,97 @@
+----------------------------------------------------------------------------------
+-- Company:
+-- Engineer:
+--
+-- Create Date: 10/19/2026 09:30:00 AM
+-- Design Name:
+-- Module Name: pps_gen - Behavioral
+-- Project Name:
+-- Target Devices:
+-- Tool Versions:
+-- Description: Software disciplined pps. Counts PERIOD sys_clk cycles per
+--              pulse. PERIOD and STEP are latched when load_tgl changes;
+--              STEP is added once to the second that is running, PERIOD is
+--              used for that second and all following ones. The PS writes
+--              PERIOD/STEP through AXI GPIO, so both must be stable before
+--              load_tgl is flipped. pps_out is high for the first half of
+--              each second and stays low while PERIOD is 0.
+--
+-- Dependencies:
+--
+-- Revision:
+-- Revision 0.01 - File Created
+-- Additional Comments:
+--
+----------------------------------------------------------------------------------
+
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+
+-- Uncomment the following library declaration if using
+-- arithmetic functions with Signed or Unsigned values
+use IEEE.NUMERIC_STD.ALL;
+
+-- Uncomment the following library declaration if instantiating
+-- any Xilinx leaf cells in this code.
+--library UNISIM;
+--use UNISIM.VComponents.all;
+
+entity pps_gen is
+    Port (
+           rst_n : in STD_LOGIC;
+           sys_clk : in STD_LOGIC;
+           PERIOD : in UNSIGNED (31 downto 0);
+           STEP : in SIGNED (29 downto 0);
+           load_tgl : in STD_LOGIC;
+           pps_out : out STD_LOGIC);
+end pps_gen;
+
+architecture Behavioral of pps_gen is
+    -- load_tgl crosses from the AXI clock domain
+    signal tgl_sync : STD_LOGIC_VECTOR (2 downto 0) := (others => '0');
+
+    signal r_period : UNSIGNED (31 downto 0) := TO_UNSIGNED(0, 32);
+    signal cur_len : UNSIGNED (31 downto 0) := TO_UNSIGNED(0, 32);
+    signal cnt : UNSIGNED (31 downto 0) := TO_UNSIGNED(0, 32);
+    signal r_pps : STD_LOGIC := '0';
+begin
+
+    pps_out <= r_pps;
+
+    process (sys_clk)
+    begin
+        if (sys_clk'event and sys_clk = '1') then
+          tgl_sync <= tgl_sync(1 downto 0) & load_tgl;
+          if (rst_n = '0') then
+            r_period <= TO_UNSIGNED(0, 32);
+            cur_len <= TO_UNSIGNED(0, 32);
+            cnt <= TO_UNSIGNED(0, 32);
+            r_pps <= '0';
+          else
+            if (r_period = 0) then
+              cnt <= TO_UNSIGNED(0, 32);
+              cur_len <= TO_UNSIGNED(0, 32);
+              r_pps <= '0';
+            elsif (cnt + 1 >= cur_len) then
+              -- start of a new second
+              cnt <= TO_UNSIGNED(0, 32);
+              cur_len <= r_period;
+              r_pps <= '1';
+            else
+              cnt <= cnt + 1;
+              if (cnt + 1 >= ('0' & cur_len(31 downto 1))) then
+                r_pps <= '0';
+              end if;
+            end if;
+
+            -- a load applies to the running second, overriding the above
+            if (tgl_sync(2) /= tgl_sync(1)) then
+              r_period <= PERIOD;
+              cur_len <= unsigned(signed(PERIOD) + resize(STEP, 32));
+            end if;
+          end if;
+        end if;
+    end process;
+
+end Behavioral;
@@ -0,0 +1,390 @@
+/*****************************************************************************/
+/**
+* @file ffs_cache_test.c
+*
+* Host test of the sector cache in the xilffs diskio layer of the FSBL BSP.
+* diskio.c is built here with its RAM disk interface on a host buffer, and
+* FatFs formats the RAM disk and lays out a directory tree and files. The
+* test then walks the tree the way a boot loader does, opening files by
+* path and reading them in small pieces and at random offsets, rewrites
+* part of a file, and checks that every byte read back is right. It prints
+* the cache counters and the media reads.
+*
+* Build and run from improved/:
+*   F=vitisProject/clk_div_scale_auto/clk_div_wrapper/zynq_fsbl
+*   B=$F/zynq_fsbl_bsp/ps7_cortexa9_0
+*   gcc -O2 -Wall -o ffs_cache_test tools/ffs_cache_test.c \
+*       $B/libsrc/xilffs_v5_0/src/ff.c -I$B/libsrc/xilffs_v5_0/src -I$B/include
+*   ./ffs_cache_test
+*
+* Add -DFILE_SYSTEM_CACHE_SECTORS=0 to count the media reads without the
+* cache, or other values of FILE_SYSTEM_CACHE_SECTORS and
+* FILE_SYSTEM_READ_AHEAD to size it.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xparameters.h"
+
+/*
+ * diskio.c on a host buffer: RAM interface instead of the SD controller
+ */
+#undef FILE_SYSTEM_INTERFACE_SD
+#define FILE_SYSTEM_INTERFACE_RAM
+#define RAMFS_SIZE		(16U << 20)
+#define RAMFS_START_ADDR	RamDisk
+
+static char RamDisk[RAMFS_SIZE];
+
+#include "diskio.c"
+
+/************************** Constant Definitions ****************************/
+
+#define TEST_DIRS		4U	/* Directories per level, three levels */
+#define TEST_FILES		8U	/* Files in each leaf directory */
+#define TEST_FILE_SIZE		0x3000U
+#define TEST_PIECE		100U	/* Small read size */
+#define TEST_SEEKS		64U
+
+/************************** Function Prototypes *****************************/
+
+static int Test_Build(void);
+static int Test_Walk(const char *Label);
+static int Test_Rewrite(void);
+static void Test_Path(char *Path, u32 Dir, u32 File);
+static u8 Test_Pattern(u32 File, u32 Offset);
+static void Test_Report(const char *Label);
+
+/************************** Variable Definitions ****************************/
+
+static FATFS Fs;
+static u8 Data[TEST_FILE_SIZE];
+static u8 Generation;	/* Bumped by Test_Rewrite */
+
+/*****************************************************************************/
+/**
+* Build the disk, walk it, rewrite part of it and walk it again.
+*
+* @return	0 if all data read back was right, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+int main(void)
+{
+	int Failed = 0;
+
+	printf("cache %u sectors, read-ahead %u\n",
+	       (unsigned)FILE_SYSTEM_CACHE_SECTORS,
+	       (unsigned)FILE_SYSTEM_READ_AHEAD);
+
+	if (Test_Build() != 0) {
+		return 1;
+	}
+
+	Failed |= Test_Walk("walk");
+	Failed |= Test_Rewrite();
+	Failed |= Test_Walk("rewalk");
+
+	printf("%s\n", Failed ? "FAIL" : "pass");
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Format the RAM disk and create the directory tree and files.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Test_Build(void)
+{
+	static BYTE Work[FF_MAX_SS * 4U];
+	const MKFS_PARM Opt = { FM_FAT, 1U, 0U, 0U, 1024U };
+	char Path[64];
+	FIL Fil;
+	UINT bw;
+	u32 Dir;
+	u32 File;
+	u32 Index;
+	u32 Len;
+
+	if ((f_mkfs("0:", &Opt, Work, sizeof(Work)) != FR_OK) ||
+	    (f_mount(&Fs, "0:", 1) != FR_OK)) {
+		printf("cannot format the RAM disk\n");
+		return 1;
+	}
+
+	for (Dir = 0U; Dir < (TEST_DIRS * TEST_DIRS * TEST_DIRS); Dir++) {
+		/* Each level of the path, parents first */
+		Test_Path(Path, Dir, TEST_FILES);
+		for (Len = 3U; Path[Len] != '\0'; Len++) {
+			if (Path[Len] == '/') {
+				Path[Len] = '\0';
+				(void)f_mkdir(Path);
+				Path[Len] = '/';
+			}
+		}
+
+		for (File = 0U; File < TEST_FILES; File++) {
+			Test_Path(Path, Dir, File);
+			for (Index = 0U; Index < TEST_FILE_SIZE; Index++) {
+				Data[Index] = Test_Pattern((Dir * TEST_FILES) + File,
+							   Index);
+			}
+			if ((f_open(&Fil, Path, FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) ||
+			    (f_write(&Fil, Data, TEST_FILE_SIZE, &bw) != FR_OK) ||
+			    (bw != TEST_FILE_SIZE) || (f_close(&Fil) != FR_OK)) {
+				printf("cannot write %s\n", Path);
+				return 1;
+			}
+		}
+	}
+
+	/* Start the walk from a cold cache and zero counters */
+	(void)f_mount(NULL, "0:", 0);
+	disk_cache_invalidate(0U);
+	if (f_mount(&Fs, "0:", 1) != FR_OK) {
+		return 1;
+	}
+	Test_Report(NULL);
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Open every file by path, read it in small pieces and at random offsets,
+* and compare with what was written.
+*
+* @param	Label names the pass in the output.
+*
+* @return	0 if all data matched, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Test_Walk(const char *Label)
+{
+	char Path[64];
+	u8 Piece[TEST_PIECE];
+	FIL Fil;
+	UINT br;
+	u32 Dir;
+	u32 File;
+	u32 Id;
+	u32 Offset;
+	u32 Index;
+	u32 Seek;
+	int Failed = 0;
+
+	srand(1U);
+	for (Dir = 0U; Dir < (TEST_DIRS * TEST_DIRS * TEST_DIRS); Dir++) {
+		for (File = 0U; File < TEST_FILES; File++) {
+			Id = (Dir * TEST_FILES) + File;
+			Test_Path(Path, Dir, File);
+			if (f_open(&Fil, Path, FA_READ) != FR_OK) {
+				printf("cannot open %s\n", Path);
+				return 1;
+			}
+
+			for (Offset = 0U; Offset < TEST_FILE_SIZE; Offset += br) {
+				if ((f_read(&Fil, Piece, sizeof(Piece), &br) != FR_OK) ||
+				    (br == 0U)) {
+					Failed = 1;
+					break;
+				}
+				for (Index = 0U; Index < br; Index++) {
+					Failed |= (Piece[Index] !=
+						   Test_Pattern(Id, Offset + Index));
+				}
+			}
+
+			for (Seek = 0U; Seek < (TEST_SEEKS / TEST_FILES); Seek++) {
+				Offset = (u32)rand() % (TEST_FILE_SIZE - TEST_PIECE);
+				if ((f_lseek(&Fil, Offset) != FR_OK) ||
+				    (f_read(&Fil, Piece, sizeof(Piece), &br) != FR_OK) ||
+				    (br != sizeof(Piece))) {
+					Failed = 1;
+					continue;
+				}
+				for (Index = 0U; Index < br; Index++) {
+					Failed |= (Piece[Index] !=
+						   Test_Pattern(Id, Offset + Index));
+				}
+			}
+
+			(void)f_close(&Fil);
+			if (Failed) {
+				printf("%s: wrong data in %s\n", Label, Path);
+				return 1;
+			}
+		}
+	}
+
+	Test_Report(Label);
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Rewrite the middle of every file, through sectors the cache holds, so the
+* next walk shows whether the writes dropped the stale copies.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Test_Rewrite(void)
+{
+	char Path[64];
+	FIL Fil;
+	UINT bw;
+	u32 Dir;
+	u32 File;
+	u32 Id;
+	u32 Index;
+
+	Generation++;
+	for (Dir = 0U; Dir < (TEST_DIRS * TEST_DIRS * TEST_DIRS); Dir++) {
+		for (File = 0U; File < TEST_FILES; File++) {
+			Id = (Dir * TEST_FILES) + File;
+			Test_Path(Path, Dir, File);
+			for (Index = 0U; Index < TEST_FILE_SIZE; Index++) {
+				Data[Index] = Test_Pattern(Id, Index);
+			}
+			if ((f_open(&Fil, Path, FA_WRITE) != FR_OK) ||
+			    (f_lseek(&Fil, TEST_FILE_SIZE / 4U) != FR_OK) ||
+			    (f_write(&Fil, &Data[TEST_FILE_SIZE / 4U],
+				     TEST_FILE_SIZE / 2U, &bw) != FR_OK) ||
+			    (f_close(&Fil) != FR_OK)) {
+				printf("cannot rewrite %s\n", Path);
+				return 1;
+			}
+		}
+	}
+	Test_Report(NULL);
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Path of a file, or with File of TEST_FILES of its directory plus a
+* trailing slash.
+*
+* @param	Path is filled with the path.
+* @param	Dir is the leaf directory number.
+* @param	File is the file number in the directory.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Test_Path(char *Path, u32 Dir, u32 File)
+{
+	(void)sprintf(Path, "0:/D%u/D%u/D%u/", (unsigned)(Dir / (TEST_DIRS * TEST_DIRS)),
+		      (unsigned)((Dir / TEST_DIRS) % TEST_DIRS),
+		      (unsigned)(Dir % TEST_DIRS));
+	if (File < TEST_FILES) {
+		(void)sprintf(Path + strlen(Path), "F%u.BIN", (unsigned)File);
+	}
+}
+
+/*****************************************************************************/
+/**
+* Contents of a file. The middle half changes with each rewrite.
+*
+* @param	File is the file number.
+* @param	Offset is the byte offset in the file.
+*
+* @return	Byte at that offset.
+*
+* @note		None.
+*
+******************************************************************************/
+static u8 Test_Pattern(u32 File, u32 Offset)
+{
+	u8 Value = (u8)((File * 31U) ^ Offset ^ (Offset >> 8));
+
+	if ((Offset >= (TEST_FILE_SIZE / 4U)) &&
+	    (Offset < ((TEST_FILE_SIZE * 3U) / 4U))) {
+		Value ^= (u8)(Generation * 0x55U);
+	}
+
+	return Value;
+}
+
+/*****************************************************************************/
+/**
+* Print the cache counters of a pass and clear them.
+*
+* @param	Label names the pass, NULL to only clear the counters.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Test_Report(const char *Label)
+{
+	DISK_CACHE_STATS Stats;
+
+	disk_cache_stats(&Stats, 1U);
+	if (Label == NULL) {
+		return;
+	}
+
+	printf("%-6s  media reads %6lu  sectors %6lu  hits %6lu  misses %6lu"
+	       "  read-ahead %6lu  bypassed %6lu\n", Label,
+	       (unsigned long)Stats.Reads, (unsigned long)Stats.Sectors,
+	       (unsigned long)Stats.Hits, (unsigned long)Stats.Misses,
+	       (unsigned long)Stats.ReadAhead, (unsigned long)Stats.Bypassed);
+}
+
+/*****************************************************************************/
+/*
+ * BSP functions diskio.c and ff.c use
+ */
+
+void Xil_DCacheFlushRange(INTPTR adr, u32 len)
+{
+	(void)adr;
+	(void)len;
+}
+
+int Xil_SMemCpy(void *Dest, const u32 DestSize, const void *Src,
+		const u32 SrcSize, const u32 CopyLen)
+{
+	(void)DestSize;
+	(void)SrcSize;
+	(void)memcpy(Dest, Src, CopyLen);
+
+	return 0;
+}
+
+int Xil_SMemSet(void *Dest, const u32 DestSize, const u8 Data, const u32 Len)
+{
+	(void)DestSize;
+	(void)memset(Dest, Data, Len);
+
+	return 0;
+}
@@ -0,0 +1,1214 @@
+/*****************************************************************************/
+/**
+* @file lz4_pack.c
+*
+* Host tool that LZ4 compresses partitions of a Zynq BOOT.BIN for the FSBL,
+* in the format of lz4.h in the FSBL. Every plain partition (not encrypted,
+* signed or checksummed, owned by the FSBL) other than the FSBL itself is
+* compressed, or with -p only the given ones, and kept compressed if that
+* makes it smaller. The partitions after a compressed one move down, their
+* headers are updated and the partition header checksums recomputed. Each
+* compressed partition is unpacked again with the FSBL lz4.c and compared
+* before the image is written.
+*
+* With -t, the round-trip test: blocks of known kinds of data, and of the
+* files given, are compressed and decompressed, corrupt blocks must fail
+* without writing past the buffer, and a BOOT.BIN built here (FSBL, a
+* bitstream, an application and a checksummed partition) is packed and
+* every partition of the result checked against the original.
+*
+* Build and run from improved/:
+*   F=vitisProject/clk_div_scale_auto/clk_div_wrapper/zynq_fsbl
+*   B=$F/zynq_fsbl_bsp/ps7_cortexa9_0
+*   gcc -O2 -Wall -o lz4_pack tools/lz4_pack.c $F/lz4.c -I$F -I$B/include
+*   ./lz4_pack [-b block_KB] [-p partition]... BOOT.BIN packed.bin
+*   ./lz4_pack -t [file]...
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "xstatus.h"
+#include "lz4.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PACK_DEFAULT_BLOCK_KB	128U
+
+/*
+ * Boot image layout, see image_mover.h
+ */
+#define PACK_BH_WIDTH_OFFSET	0x20U
+#define PACK_BH_WIDTH_WORD	0xAA995566U
+#define PACK_BH_ID_OFFSET	0x24U
+#define PACK_BH_ID_WORD		0x584C4E58U	/* "XNLX" */
+#define PACK_BH_FSBL_OFFSET	0x30U
+#define PACK_BH_FSBL_LENGTH	0x34U
+#define PACK_BH_IHT_OFFSET	0x98U
+#define PACK_BH_PHT_OFFSET	0x9CU
+#define PACK_BH_SIZE		0x8A0U
+
+#define PACK_PH_WORDS		16U
+#define PACK_PH_SIZE		(PACK_PH_WORDS * 4U)
+#define PACK_PH_IMAGE_LEN	0U
+#define PACK_PH_DATA_LEN	1U
+#define PACK_PH_PART_LEN	2U
+#define PACK_PH_LOAD		3U
+#define PACK_PH_EXEC		4U
+#define PACK_PH_START		5U
+#define PACK_PH_ATTR		6U
+#define PACK_PH_SECTIONS	7U
+#define PACK_PH_CHECKSUM_OFF	8U
+#define PACK_PH_AC_OFF		10U
+#define PACK_PH_CHECKSUM	15U
+#define PACK_MAX_PARTITIONS	14U	/* MAX_PARTITION_NUMBER */
+
+#define PACK_ATTR_OWNER_MASK	0x00030000U
+#define PACK_ATTR_RSA_MASK	0x00008000U
+#define PACK_ATTR_CHECKSUM_MASK	0x00007000U
+#define PACK_ATTR_PL		0x00000020U
+#define PACK_ATTR_PS		0x00000010U
+
+#define PACK_ALIGN		64U	/* Partition alignment of bootgen */
+#define PACK_MD5_SIZE		16U
+
+/*
+ * LZ4 block format: the last 5 bytes are literals and the last match
+ * starts at least 12 bytes before the end
+ */
+#define PACK_LAST_LITERALS	5U
+#define PACK_MATCH_LIMIT	12U
+#define PACK_MIN_MATCH		4U
+#define PACK_MAX_OFFSET		0xFFFFU
+#define PACK_HASH_BITS		16U
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u8 *Data;
+	u32 Length;
+} PackImage;
+
+/************************** Function Prototypes *****************************/
+
+static int Pack_Image(PackImage *Image, u32 BlockSize, const u32 *Select,
+		u32 SelectCount, int Quiet);
+static u32 Pack_Frame(const u8 *Source, u32 Length, u32 BlockSize,
+		u8 *Destination);
+static u32 Pack_Block(const u8 *Source, u32 Length, u8 *Destination,
+		u32 DestinationLength);
+static u8 *Pack_Sequence(u8 *Output, u8 *OutputEnd, const u8 *Literals,
+		u32 LiteralLength, u32 Offset, u32 MatchLength);
+static int Pack_Inflate(const u8 *Frame, u32 Length, u8 *Destination,
+		u32 *OutputLength);
+static u32 Pack_HeaderChecksum(const u8 *Header);
+static int Pack_Test(int Count, char *Names[]);
+static int Pack_TestBlock(const char *Label, const u8 *Data, u32 Length);
+static int Pack_TestCorrupt(const u8 *Data, u32 Length);
+static int Pack_TestImage(const u8 *Bitstream, u32 BitstreamLength);
+static void Pack_Fill(u8 *Data, u32 Length, u32 Kind);
+static int Pack_ReadFile(const char *Name, PackImage *Image);
+static u32 Pack_Get32(const u8 *Data, u32 Offset);
+static void Pack_Put32(u8 *Data, u32 Offset, u32 Value);
+
+/*****************************************************************************/
+/**
+* Pack a boot image, or run the round-trip test with -t.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+int main(int argc, char *argv[])
+{
+	PackImage Image;
+	u32 BlockSize = PACK_DEFAULT_BLOCK_KB << 10;
+	u32 Select[PACK_MAX_PARTITIONS];
+	u32 SelectCount = 0U;
+	int Test = 0;
+	int Opt;
+	FILE *Out;
+
+	while ((Opt = getopt(argc, argv, "b:p:t")) != -1) {
+		switch (Opt) {
+		case 'b':
+			BlockSize = (u32)strtoul(optarg, NULL, 0) << 10;
+			break;
+		case 'p':
+			if (SelectCount < PACK_MAX_PARTITIONS) {
+				Select[SelectCount++] =
+					(u32)strtoul(optarg, NULL, 0);
+			}
+			break;
+		case 't':
+			Test = 1;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-b block_KB] [-p partition]... "
+				"BOOT.BIN packed.bin\n       %s -t [file]...\n",
+				argv[0], argv[0]);
+			return 1;
+		}
+	}
+
+	if (Test) {
+		return Pack_Test(argc - optind, &argv[optind]);
+	}
+
+	if ((optind + 2) != argc) {
+		fprintf(stderr, "usage: %s [-b block_KB] [-p partition]... "
+			"BOOT.BIN packed.bin\n", argv[0]);
+		return 1;
+	}
+	if ((BlockSize == 0U) || (BlockSize > LZ4_BLOCK_SIZE_MAX)) {
+		fprintf(stderr, "lz4_pack: block size is 4 to %u KB\n",
+			(unsigned)(LZ4_BLOCK_SIZE_MAX >> 10));
+		return 1;
+	}
+
+	if (Pack_ReadFile(argv[optind], &Image) != 0) {
+		return 1;
+	}
+	if (Pack_Image(&Image, BlockSize, Select, SelectCount, 0) != 0) {
+		return 1;
+	}
+
+	Out = fopen(argv[optind + 1], "wb");
+	if ((Out == NULL) ||
+	    (fwrite(Image.Data, 1U, Image.Length, Out) != Image.Length) ||
+	    (fclose(Out) != 0)) {
+		perror(argv[optind + 1]);
+		return 1;
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Compress the partitions of a boot image in place.
+*
+* @param	Image is the boot image, replaced by the packed one.
+* @param	BlockSize is the uncompressed block size in bytes.
+* @param	Select lists the partitions to compress, all plain ones if
+*		SelectCount is 0.
+* @param	SelectCount is the number of entries in Select.
+* @param	Quiet suppresses the per partition lines.
+*
+* @return	0 on success, 1 if the image cannot be packed.
+*
+* @note		Partitions are never moved up, only down by multiples of
+*		PACK_ALIGN, so the alignment of everything after a
+*		compressed partition is kept.
+*
+******************************************************************************/
+static int Pack_Image(PackImage *Image, u32 BlockSize, const u32 *Select,
+		u32 SelectCount, int Quiet)
+{
+	u8 *Data = Image->Data;
+	u8 *Out;
+	u8 *Packed[PACK_MAX_PARTITIONS];
+	u32 PackedLength[PACK_MAX_PARTITIONS];
+	u32 Start[PACK_MAX_PARTITIONS];
+	u32 Length[PACK_MAX_PARTITIONS];
+	u32 Removed[PACK_MAX_PARTITIONS];
+	u32 HeaderTable;
+	u32 HeaderTableEnd;
+	u32 Count = 0U;
+	u32 Index;
+	u32 Other;
+	u32 Word;
+	u32 Attr;
+	u32 Offset;
+	u32 OutLength;
+	u32 Position;
+	u32 Shift;
+	u32 Before = 0U;
+	u32 After = 0U;
+	u8 *Header;
+	int Chosen;
+
+	if ((Image->Length < PACK_BH_SIZE) ||
+	    (Pack_Get32(Data, PACK_BH_WIDTH_OFFSET) != PACK_BH_WIDTH_WORD) ||
+	    (Pack_Get32(Data, PACK_BH_ID_OFFSET) != PACK_BH_ID_WORD)) {
+		fprintf(stderr, "lz4_pack: not a Zynq boot image\n");
+		return 1;
+	}
+
+	/*
+	 * Partition headers, up to the last (empty) one
+	 */
+	HeaderTable = Pack_Get32(Data, PACK_BH_PHT_OFFSET);
+	for (Count = 0U; ; Count++) {
+		if ((Count >= PACK_MAX_PARTITIONS) ||
+		    ((HeaderTable + ((Count + 1U) * PACK_PH_SIZE)) > Image->Length)) {
+			fprintf(stderr, "lz4_pack: bad partition header table\n");
+			return 1;
+		}
+		Header = &Data[HeaderTable + (Count * PACK_PH_SIZE)];
+		if (Pack_Get32(Header, PACK_PH_CHECKSUM * 4U) == 0xFFFFFFFFU) {
+			for (Word = 0U; Word < PACK_PH_CHECKSUM; Word++) {
+				if (Pack_Get32(Header, Word * 4U) != 0U) {
+					break;
+				}
+			}
+			if (Word == PACK_PH_CHECKSUM) {
+				break;
+			}
+		}
+		if (Pack_HeaderChecksum(Header) !=
+		    Pack_Get32(Header, PACK_PH_CHECKSUM * 4U)) {
+			fprintf(stderr, "lz4_pack: partition %u header checksum\n",
+				(unsigned)Count);
+			return 1;
+		}
+		/*
+		 * Headers of signed images are authenticated, they cannot
+		 * change
+		 */
+		if ((Pack_Get32(Header, PACK_PH_ATTR * 4U) &
+		     PACK_ATTR_RSA_MASK) != 0U) {
+			fprintf(stderr, "lz4_pack: signed boot image\n");
+			return 1;
+		}
+	}
+	HeaderTableEnd = HeaderTable + ((Count + 1U) * PACK_PH_SIZE);
+
+	/*
+	 * Compress the chosen partitions
+	 */
+	for (Index = 0U; Index < Count; Index++) {
+		Header = &Data[HeaderTable + (Index * PACK_PH_SIZE)];
+		Attr = Pack_Get32(Header, PACK_PH_ATTR * 4U);
+		Start[Index] = Pack_Get32(Header, PACK_PH_START * 4U) * 4U;
+		Length[Index] = Pack_Get32(Header, PACK_PH_IMAGE_LEN * 4U) * 4U;
+		Packed[Index] = NULL;
+		Removed[Index] = 0U;
+
+		if ((Start[Index] < HeaderTableEnd) ||
+		    (Start[Index] > Image->Length) ||
+		    (Length[Index] > (Image->Length - Start[Index]))) {
+			fprintf(stderr, "lz4_pack: partition %u outside the image\n",
+				(unsigned)Index);
+			return 1;
+		}
+
+		if (SelectCount != 0U) {
+			Chosen = 0;
+			for (Other = 0U; Other < SelectCount; Other++) {
+				Chosen |= (Select[Other] == Index);
+			}
+		} else {
+			Chosen = 1;
+		}
+		if (!Chosen) {
+			continue;
+		}
+
+		/* The Boot ROM finds the FSBL by its offset, it cannot move */
+		if ((Start[Index] <= Pack_Get32(Data, PACK_BH_FSBL_OFFSET)) ||
+		    ((Attr & PACK_ATTR_OWNER_MASK) != 0U) ||
+		    ((Attr & (PACK_ATTR_CHECKSUM_MASK | PACK_ATTR_RSA_MASK)) != 0U) ||
+		    ((Attr & (PACK_ATTR_PL | PACK_ATTR_PS)) == 0U) ||
+		    (Pack_Get32(Header, PACK_PH_DATA_LEN * 4U) * 4U != Length[Index]) ||
+		    (Pack_Get32(Header, PACK_PH_PART_LEN * 4U) * 4U != Length[Index]) ||
+		    (Length[Index] <= (LZ4_FRAME_HEADER_SIZE + 4U)) ||
+		    (Pack_Get32(Data, Start[Index]) == LZ4_FRAME_MAGIC)) {
+			if (SelectCount != 0U) {
+				fprintf(stderr, "lz4_pack: partition %u is not a "
+					"plain partition\n", (unsigned)Index);
+				return 1;
+			}
+			continue;
+		}
+
+		/* Worst case: every block stored, plus the block headers */
+		Packed[Index] = malloc(Length[Index] + LZ4_FRAME_HEADER_SIZE +
+			(((Length[Index] / BlockSize) + 2U) * 8U));
+		if (Packed[Index] == NULL) {
+			fprintf(stderr, "lz4_pack: no memory\n");
+			return 1;
+		}
+		PackedLength[Index] = Pack_Frame(&Data[Start[Index]],
+				Length[Index], BlockSize, Packed[Index]);
+
+		/*
+		 * Only worth it if the partition shrinks by at least one
+		 * PACK_ALIGN
+		 */
+		if ((PackedLength[Index] + PACK_ALIGN) > Length[Index]) {
+			free(Packed[Index]);
+			Packed[Index] = NULL;
+			continue;
+		}
+		Removed[Index] = (Length[Index] - PackedLength[Index]) &
+				 ~(PACK_ALIGN - 1U);
+
+		/*
+		 * Unpack with the FSBL code before using it
+		 */
+		Out = malloc(Length[Index]);
+		if ((Out == NULL) ||
+		    (Pack_Inflate(Packed[Index], PackedLength[Index], Out,
+				  &OutLength) != 0) ||
+		    (OutLength != Length[Index]) ||
+		    (memcmp(Out, &Data[Start[Index]], Length[Index]) != 0)) {
+			fprintf(stderr, "lz4_pack: partition %u does not unpack\n",
+				(unsigned)Index);
+			return 1;
+		}
+		free(Out);
+	}
+
+	/*
+	 * Everything past the end of a compressed partition moves down by
+	 * the space it saved: partitions, and checksums, which bootgen puts
+	 * after the partitions
+	 */
+	Out = malloc(Image->Length);
+	if (Out == NULL) {
+		fprintf(stderr, "lz4_pack: no memory\n");
+		return 1;
+	}
+	(void)memcpy(Out, Data, Image->Length);
+	OutLength = 0U;
+	Position = 0U;
+	for (Offset = 0U; Offset <= Image->Length; Offset++) {
+		for (Index = 0U; Index < Count; Index++) {
+			if ((Packed[Index] != NULL) && (Start[Index] == Offset)) {
+				break;
+			}
+		}
+		if (Index == Count) {
+			continue;
+		}
+
+		(void)memmove(&Out[OutLength], &Data[Position],
+			      Start[Index] - Position);
+		OutLength += Start[Index] - Position;
+		(void)memcpy(&Out[OutLength], Packed[Index], PackedLength[Index]);
+		(void)memset(&Out[OutLength + PackedLength[Index]], 0,
+			     Length[Index] - Removed[Index] - PackedLength[Index]);
+		OutLength += Length[Index] - Removed[Index];
+		Position = Start[Index] + Length[Index];
+	}
+	(void)memcpy(&Out[OutLength], &Data[Position], Image->Length - Position);
+	OutLength += Image->Length - Position;
+
+	/*
+	 * Update the headers: lengths of the compressed partitions, and
+	 * offsets that moved
+	 */
+	for (Index = 0U; Index < Count; Index++) {
+		Header = &Out[HeaderTable + (Index * PACK_PH_SIZE)];
+		if (Packed[Index] != NULL) {
+			Pack_Put32(Header, PACK_PH_IMAGE_LEN * 4U,
+				   PackedLength[Index] / 4U);
+			Pack_Put32(Header, PACK_PH_DATA_LEN * 4U,
+				   PackedLength[Index] / 4U);
+			Pack_Put32(Header, PACK_PH_PART_LEN * 4U,
+				   PackedLength[Index] / 4U);
+		}
+
+		for (Word = PACK_PH_START; Word <= PACK_PH_AC_OFF; Word++) {
+			if ((Word != PACK_PH_START) && (Word != PACK_PH_CHECKSUM_OFF) &&
+			    (Word != PACK_PH_AC_OFF)) {
+				continue;
+			}
+			Offset = Pack_Get32(Header, Word * 4U) * 4U;
+			if ((Offset == 0U) && (Word != PACK_PH_START)) {
+				continue;
+			}
+			Shift = 0U;
+			for (Other = 0U; Other < Count; Other++) {
+				if ((Packed[Other] != NULL) &&
+				    (Offset >= (Start[Other] + Length[Other]))) {
+					Shift += Removed[Other];
+				}
+			}
+			Pack_Put32(Header, Word * 4U, (Offset - Shift) / 4U);
+		}
+
+		Pack_Put32(Header, PACK_PH_CHECKSUM * 4U,
+			   Pack_HeaderChecksum(Header));
+
+		Before += Length[Index];
+		After += Pack_Get32(Header, PACK_PH_IMAGE_LEN * 4U) * 4U;
+		if (!Quiet) {
+			Attr = Pack_Get32(Header, PACK_PH_ATTR * 4U);
+			printf("partition %u  %s  %9lu -> %9lu bytes%s\n",
+			       (unsigned)Index,
+			       (Attr & PACK_ATTR_PL) ? "PL" : "PS",
+			       (unsigned long)Length[Index],
+			       (unsigned long)(Pack_Get32(Header,
+					PACK_PH_IMAGE_LEN * 4U) * 4U),
+			       (Packed[Index] != NULL) ? "  lz4" : "");
+		}
+		free(Packed[Index]);
+	}
+
+	if (!Quiet) {
+		printf("partition data %lu -> %lu bytes, image %lu -> %lu bytes\n",
+		       (unsigned long)Before, (unsigned long)After,
+		       (unsigned long)Image->Length, (unsigned long)OutLength);
+	}
+
+	free(Image->Data);
+	Image->Data = Out;
+	Image->Length = OutLength;
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Compress a partition into the frame format of lz4.h.
+*
+* @param	Source is the partition.
+* @param	Length is its length in bytes, a multiple of 4.
+* @param	BlockSize is the uncompressed block size.
+* @param	Destination receives the frame.
+*
+* @return	Frame length in bytes, a multiple of 4.
+*
+* @note		Blocks that do not shrink are stored.
+*
+******************************************************************************/
+static u32 Pack_Frame(const u8 *Source, u32 Length, u32 BlockSize,
+		u8 *Destination)
+{
+	u32 Offset;
+	u32 Output = LZ4_FRAME_HEADER_SIZE;
+	u32 BlockLength;
+	u32 Payload;
+
+	Pack_Put32(Destination, 0U, LZ4_FRAME_MAGIC);
+	Pack_Put32(Destination, 4U, Length);
+	Pack_Put32(Destination, 8U, BlockSize);
+	Pack_Put32(Destination, 12U, 0U);
+
+	for (Offset = 0U; Offset < Length; Offset += BlockLength) {
+		BlockLength = Length - Offset;
+		if (BlockLength > BlockSize) {
+			BlockLength = BlockSize;
+		}
+
+		Payload = Pack_Block(&Source[Offset], BlockLength,
+				     &Destination[Output + 4U], BlockLength - 1U);
+		if (Payload == 0U) {
+			Payload = BlockLength;
+			(void)memcpy(&Destination[Output + 4U], &Source[Offset],
+				     Payload);
+			Pack_Put32(Destination, Output, Payload | LZ4_BLOCK_RAW);
+		} else {
+			Pack_Put32(Destination, Output, Payload);
+		}
+		Output += 4U + Payload;
+		while ((Output & 3U) != 0U) {
+			Destination[Output++] = 0U;
+		}
+	}
+
+	Pack_Put32(Destination, Output, 0U);
+
+	return Output + 4U;
+}
+
+/*****************************************************************************/
+/**
+* Compress one block with a greedy LZ4 match search.
+*
+* @param	Source is the block.
+* @param	Length is its length in bytes.
+* @param	Destination receives the compressed block.
+* @param	DestinationLength is the largest useful compressed length.
+*
+* @return	Compressed length, or 0 if the block does not fit.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 Pack_Block(const u8 *Source, u32 Length, u8 *Destination,
+		u32 DestinationLength)
+{
+	static u32 Hash[1U << PACK_HASH_BITS];
+	u8 *Output = Destination;
+	u8 *OutputEnd = Destination + DestinationLength;
+	u32 Input = 0U;
+	u32 Anchor = 0U;
+	u32 Sequence;
+	u32 Slot;
+	u32 Match;
+	u32 MatchLength;
+
+	(void)memset(Hash, 0xFF, sizeof(Hash));
+
+	while ((Length > PACK_MATCH_LIMIT) &&
+	       (Input <= (Length - PACK_MATCH_LIMIT))) {
+		(void)memcpy(&Sequence, &Source[Input], 4U);
+		Slot = (Sequence * 2654435761U) >> (32U - PACK_HASH_BITS);
+		Match = Hash[Slot];
+		Hash[Slot] = Input;
+
+		if ((Match == 0xFFFFFFFFU) || ((Input - Match) > PACK_MAX_OFFSET) ||
+		    (memcmp(&Source[Match], &Source[Input], 4U) != 0)) {
+			Input++;
+			continue;
+		}
+
+		MatchLength = PACK_MIN_MATCH;
+		while (((Input + MatchLength) < (Length - PACK_LAST_LITERALS)) &&
+		       (Source[Match + MatchLength] == Source[Input + MatchLength])) {
+			MatchLength++;
+		}
+
+		Output = Pack_Sequence(Output, OutputEnd, &Source[Anchor],
+				       Input - Anchor, Input - Match, MatchLength);
+		if (Output == NULL) {
+			return 0U;
+		}
+
+		Input += MatchLength;
+		Anchor = Input;
+		if (Input <= (Length - 4U)) {
+			(void)memcpy(&Sequence, &Source[Input - 2U], 4U);
+			Hash[(Sequence * 2654435761U) >> (32U - PACK_HASH_BITS)] =
+				Input - 2U;
+		}
+	}
+
+	Output = Pack_Sequence(Output, OutputEnd, &Source[Anchor],
+			       Length - Anchor, 0U, 0U);
+	if (Output == NULL) {
+		return 0U;
+	}
+
+	return (u32)(Output - Destination);
+}
+
+/*****************************************************************************/
+/**
+* Write one LZ4 sequence.
+*
+* @param	Output is the write position.
+* @param	OutputEnd is the end of the output buffer.
+* @param	Literals are the literals of the sequence.
+* @param	LiteralLength is their number.
+* @param	Offset is the match offset, 0 for the last sequence.
+* @param	MatchLength is the match length.
+*
+* @return	New write position, or NULL if the buffer is full.
+*
+* @note		None.
+*
+******************************************************************************/
+static u8 *Pack_Sequence(u8 *Output, u8 *OutputEnd, const u8 *Literals,
+		u32 LiteralLength, u32 Offset, u32 MatchLength)
+{
+	u8 *Token = Output;
+	u32 Length;
+
+	/* Token, extension bytes, literals and match, at most */
+	if ((u32)(OutputEnd - Output) <
+	    (1U + (LiteralLength / 255U) + 1U + LiteralLength + 2U +
+	     (MatchLength / 255U) + 1U)) {
+		return NULL;
+	}
+
+	Output++;
+	Length = LiteralLength;
+	if (Length >= 15U) {
+		*Token = 0xF0U;
+		for (Length -= 15U; Length >= 255U; Length -= 255U) {
+			*Output++ = 0xFFU;
+		}
+		*Output++ = (u8)Length;
+	} else {
+		*Token = (u8)(Length << 4);
+	}
+	(void)memcpy(Output, Literals, LiteralLength);
+	Output += LiteralLength;
+
+	if (Offset == 0U) {
+		return Output;
+	}
+
+	*Output++ = (u8)Offset;
+	*Output++ = (u8)(Offset >> 8);
+	Length = MatchLength - PACK_MIN_MATCH;
+	if (Length >= 15U) {
+		*Token |= 0x0FU;
+		for (Length -= 15U; Length >= 255U; Length -= 255U) {
+			*Output++ = 0xFFU;
+		}
+		*Output++ = (u8)Length;
+	} else {
+		*Token |= (u8)Length;
+	}
+
+	return Output;
+}
+
+/*****************************************************************************/
+/**
+* Unpack a compressed partition the way PartitionInflate() in the FSBL
+* does: frame header and first block header, then each payload with the
+* next block header, and the same checks.
+*
+* @param	Frame is the compressed partition.
+* @param	Length is its length in bytes.
+* @param	Destination receives the partition.
+* @param	OutputLength is set to the unpacked length.
+*
+* @return	0 on success, 1 if the partition is corrupt.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Pack_Inflate(const u8 *Frame, u32 Length, u8 *Destination,
+		u32 *OutputLength)
+{
+	Lz4Frame Header;
+	u8 *Staging;
+	u32 Offset = LZ4_FRAME_HEADER_SIZE + 4U;
+	u32 Output = 0U;
+	u32 BlockHeader;
+	u32 PayloadLength;
+	u32 ReadLength;
+	u32 BlockLength;
+	u32 Produced;
+	u32 Status;
+
+	if (Length <= (LZ4_FRAME_HEADER_SIZE + 4U)) {
+		return 1;
+	}
+	(void)memcpy(&Header, Frame, sizeof(Header));
+	if (Lz4FrameCheck(&Header) != XST_SUCCESS) {
+		return 1;
+	}
+
+	Staging = malloc(LZ4_BLOCK_SIZE_MAX + 8U);
+	if (Staging == NULL) {
+		return 1;
+	}
+
+	BlockHeader = Pack_Get32(Frame, LZ4_FRAME_HEADER_SIZE);
+	while (BlockHeader != 0U) {
+		PayloadLength = BlockHeader & LZ4_BLOCK_LENGTH_MASK;
+		ReadLength = ((PayloadLength + 3U) & ~3U) + 4U;
+		BlockLength = Header.Length - Output;
+		if (BlockLength > Header.BlockSize) {
+			BlockLength = Header.BlockSize;
+		}
+		if ((PayloadLength == 0U) || (BlockLength == 0U) ||
+		    (PayloadLength > Header.BlockSize) ||
+		    (ReadLength > (Length - Offset))) {
+			break;
+		}
+
+		(void)memcpy(Staging, &Frame[Offset], ReadLength);
+
+		Status = XST_SUCCESS;
+		if ((BlockHeader & LZ4_BLOCK_RAW) != 0U) {
+			Produced = PayloadLength;
+			if (Produced == BlockLength) {
+				(void)memcpy(&Destination[Output], Staging, Produced);
+			}
+		} else {
+			Status = Lz4DecompressBlock(Staging, PayloadLength,
+						    &Destination[Output],
+						    BlockLength, &Produced);
+		}
+		if ((Status != XST_SUCCESS) || (Produced != BlockLength)) {
+			break;
+		}
+
+		Output += BlockLength;
+		Offset += ReadLength;
+		BlockHeader = Pack_Get32(Staging, ReadLength - 4U);
+	}
+	free(Staging);
+
+	*OutputLength = Output;
+
+	return ((BlockHeader != 0U) || (Output != Header.Length)) ? 1 : 0;
+}
+
+/*****************************************************************************/
+/**
+* Partition header checksum, as ValidatePartitionHeaderChecksum() checks it.
+*
+* @param	Header is the partition header.
+*
+* @return	Inverted sum of the first 15 words.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 Pack_HeaderChecksum(const u8 *Header)
+{
+	u32 Checksum = 0U;
+	u32 Word;
+
+	for (Word = 0U; Word < PACK_PH_CHECKSUM; Word++) {
+		Checksum += Pack_Get32(Header, Word * 4U);
+	}
+
+	return Checksum ^ 0xFFFFFFFFU;
+}
+
+/*****************************************************************************/
+/**
+* Round-trip test: blocks of each kind of test data and of the files given,
+* corrupt blocks, and a boot image.
+*
+* @param	Count is the number of files.
+* @param	Names are the files.
+*
+* @return	0 if all passed, 1 otherwise.
+*
+* @note		The first file, if any, is the bitstream of the test image.
+*
+******************************************************************************/
+static int Pack_Test(int Count, char *Names[])
+{
+	static const char *const Kinds[] = {
+		"zeros", "random", "sparse", "text", "short runs"
+	};
+	PackImage File;
+	u8 *Data;
+	u32 Kind;
+	u32 Length;
+	int Index;
+	int Failed = 0;
+
+	Data = malloc(LZ4_BLOCK_SIZE_MAX);
+	if (Data == NULL) {
+		return 1;
+	}
+
+	for (Kind = 0U; Kind < (sizeof(Kinds) / sizeof(Kinds[0])); Kind++) {
+		Pack_Fill(Data, LZ4_BLOCK_SIZE_MAX, Kind);
+		Failed |= Pack_TestBlock(Kinds[Kind], Data, LZ4_BLOCK_SIZE_MAX);
+		/* Odd and tiny lengths around the end rules */
+		for (Length = 0U; Length < 40U; Length++) {
+			Failed |= Pack_TestBlock(NULL, Data, Length);
+		}
+		Failed |= Pack_TestBlock(NULL, Data, 0x10001U);
+		Failed |= Pack_TestCorrupt(Data, LZ4_BLOCK_SIZE_MAX);
+	}
+
+	for (Index = 0; Index < Count; Index++) {
+		if (Pack_ReadFile(Names[Index], &File) != 0) {
+			return 1;
+		}
+		for (Length = 0U; Length < File.Length; Length += LZ4_BLOCK_SIZE_MAX) {
+			Failed |= Pack_TestBlock((Length == 0U) ? Names[Index] : NULL,
+				&File.Data[Length],
+				((File.Length - Length) > LZ4_BLOCK_SIZE_MAX) ?
+					LZ4_BLOCK_SIZE_MAX : (File.Length - Length));
+		}
+		if (Index == 0) {
+			Failed |= Pack_TestImage(File.Data, File.Length & ~3U);
+		}
+		free(File.Data);
+	}
+	if (Count == 0) {
+		Data = realloc(Data, 4U << 20);
+		if (Data == NULL) {
+			return 1;
+		}
+		Pack_Fill(Data, 4U << 20, 2U);
+		Failed |= Pack_TestImage(Data, 4U << 20);
+	}
+	free(Data);
+
+	printf("%s\n", Failed ? "FAIL" : "pass");
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Compress and decompress one block and compare.
+*
+* @param	Label names the data in the output, NULL for no output.
+* @param	Data is the block.
+* @param	Length is its length.
+*
+* @return	0 if the block came back, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Pack_TestBlock(const char *Label, const u8 *Data, u32 Length)
+{
+	static u8 Packed[LZ4_BLOCK_SIZE_MAX + 0x1000U];
+	static u8 Back[LZ4_BLOCK_SIZE_MAX + 0x1000U];
+	u32 PackedLength;
+	u32 Produced = 0U;
+	u32 Status;
+
+	/* Stored blocks are not LZ4 blocks, so give room to compress any */
+	PackedLength = Pack_Block(Data, Length, Packed, sizeof(Packed));
+	if ((PackedLength == 0U) && (Length != 0U)) {
+		printf("%s: no room\n", (Label != NULL) ? Label : "block");
+		return 1;
+	}
+
+	(void)memset(Back, 0xA5, sizeof(Back));
+	Status = Lz4DecompressBlock(Packed, PackedLength, Back, Length, &Produced);
+	if ((Status != XST_SUCCESS) || (Produced != Length) ||
+	    (memcmp(Back, Data, Length) != 0) || (Back[Length] != 0xA5U)) {
+		printf("%s: round trip of %lu bytes failed\n",
+		       (Label != NULL) ? Label : "block", (unsigned long)Length);
+		return 1;
+	}
+
+	if (Label != NULL) {
+		printf("%-12s %7lu -> %7lu bytes (%5.1f%%)\n", Label,
+		       (unsigned long)Length, (unsigned long)PackedLength,
+		       (100.0 * PackedLength) / Length);
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Decompress corrupt copies of a compressed block into a buffer with a
+* guard area, which must stay untouched.
+*
+* @param	Data is the block.
+* @param	Length is its length.
+*
+* @return	0 if no decompression wrote past the buffer, 1 otherwise.
+*
+* @note		Corrupt blocks may still decompress; that is what the frame
+*		lengths and, where needed, checksums are for.
+*
+******************************************************************************/
+static int Pack_TestCorrupt(const u8 *Data, u32 Length)
+{
+	static u8 Packed[LZ4_BLOCK_SIZE_MAX + 0x1000U];
+	static u8 Back[LZ4_BLOCK_SIZE_MAX + 0x1000U];
+	u32 PackedLength;
+	u32 Produced;
+	u32 Round;
+	u32 Flip;
+	u32 Cut;
+	u32 Index;
+
+	srand(Length);
+	for (Round = 0U; Round < 200U; Round++) {
+		PackedLength = Pack_Block(Data, Length, Packed, sizeof(Packed));
+		for (Flip = 0U; Flip < (1U + (Round % 4U)); Flip++) {
+			Packed[(u32)rand() % PackedLength] ^= (u8)(1U + (u32)rand());
+		}
+		Cut = (Round & 1U) ? ((u32)rand() % PackedLength) : PackedLength;
+
+		(void)memset(Back, 0xA5, sizeof(Back));
+		(void)Lz4DecompressBlock(Packed, Cut, Back, Length / 2U, &Produced);
+		for (Index = Length / 2U; Index < sizeof(Back); Index++) {
+			if (Back[Index] != 0xA5U) {
+				printf("corrupt block written past the buffer\n");
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Build a boot image, pack it, and check every partition of the result.
+*
+* @param	Bitstream is the bitstream partition.
+* @param	BitstreamLength is its length, a multiple of 4.
+*
+* @return	0 if all partitions came back, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Pack_TestImage(const u8 *Bitstream, u32 BitstreamLength)
+{
+	PackImage Image;
+	PackImage Original;
+	u32 Size[4] = { 0xC000U, 0U, 0x30000U, 0x8000U };
+	u32 Attr[4] = { PACK_ATTR_PS, PACK_ATTR_PL, PACK_ATTR_PS,
+			PACK_ATTR_PS | 0x1000U };
+	u32 Start[4];
+	u32 Index;
+	u32 Offset;
+	u32 Length;
+	u32 Produced;
+	u8 *Header;
+	u8 *Back;
+	int Failed = 0;
+
+	Size[1] = BitstreamLength;
+
+	/*
+	 * Boot header, image header, partition headers, then the partitions,
+	 * each 64-byte aligned; the last one checksummed, its MD5 right
+	 * after it
+	 */
+	Length = 0x1700U;
+	for (Index = 0U; Index < 4U; Index++) {
+		Start[Index] = Length;
+		Length = (Length + Size[Index] + PACK_ALIGN - 1U) & ~(PACK_ALIGN - 1U);
+	}
+	Length += PACK_MD5_SIZE;
+
+	Image.Length = Length;
+	Image.Data = calloc(1U, Length);
+	Original.Data = malloc(Length);
+	if ((Image.Data == NULL) || (Original.Data == NULL)) {
+		return 1;
+	}
+	Pack_Put32(Image.Data, PACK_BH_WIDTH_OFFSET, PACK_BH_WIDTH_WORD);
+	Pack_Put32(Image.Data, PACK_BH_ID_OFFSET, PACK_BH_ID_WORD);
+	Pack_Put32(Image.Data, PACK_BH_FSBL_OFFSET, Start[0]);
+	Pack_Put32(Image.Data, PACK_BH_FSBL_LENGTH, Size[0]);
+	Pack_Put32(Image.Data, PACK_BH_IHT_OFFSET, PACK_BH_SIZE);
+	Pack_Put32(Image.Data, PACK_BH_PHT_OFFSET, 0xC80U);
+
+	for (Index = 0U; Index < 4U; Index++) {
+		Header = &Image.Data[0xC80U + (Index * PACK_PH_SIZE)];
+		Pack_Put32(Header, PACK_PH_IMAGE_LEN * 4U, Size[Index] / 4U);
+		Pack_Put32(Header, PACK_PH_DATA_LEN * 4U, Size[Index] / 4U);
+		Pack_Put32(Header, PACK_PH_PART_LEN * 4U, Size[Index] / 4U);
+		Pack_Put32(Header, PACK_PH_LOAD * 4U, 0x100000U * Index);
+		Pack_Put32(Header, PACK_PH_EXEC * 4U, 0x100000U * Index);
+		Pack_Put32(Header, PACK_PH_START * 4U, Start[Index] / 4U);
+		Pack_Put32(Header, PACK_PH_ATTR * 4U, Attr[Index]);
+		Pack_Put32(Header, PACK_PH_SECTIONS * 4U, 1U);
+		if (Index == 3U) {
+			Pack_Put32(Header, PACK_PH_CHECKSUM_OFF * 4U,
+				   (Length - PACK_MD5_SIZE) / 4U);
+		}
+		Pack_Put32(Header, PACK_PH_CHECKSUM * 4U,
+			   Pack_HeaderChecksum(Header));
+
+		if (Index == 1U) {
+			(void)memcpy(&Image.Data[Start[Index]], Bitstream,
+				     Size[Index]);
+		} else {
+			Pack_Fill(&Image.Data[Start[Index]], Size[Index],
+				  (Index == 2U) ? 3U : 1U);
+		}
+	}
+	Pack_Put32(Image.Data, 0xC80U + (4U * PACK_PH_SIZE) +
+		   (PACK_PH_CHECKSUM * 4U), 0xFFFFFFFFU);
+	Pack_Fill(&Image.Data[Length - PACK_MD5_SIZE], PACK_MD5_SIZE, 1U);
+
+	Original.Length = Length;
+	(void)memcpy(Original.Data, Image.Data, Length);
+
+	if (Pack_Image(&Image, PACK_DEFAULT_BLOCK_KB << 10, NULL, 0U, 0) != 0) {
+		return 1;
+	}
+
+	Back = malloc(Original.Length);
+	if (Back == NULL) {
+		return 1;
+	}
+	for (Index = 0U; Index < 4U; Index++) {
+		Header = &Image.Data[0xC80U + (Index * PACK_PH_SIZE)];
+		Offset = Pack_Get32(Header, PACK_PH_START * 4U) * 4U;
+		Length = Pack_Get32(Header, PACK_PH_IMAGE_LEN * 4U) * 4U;
+
+		if (Pack_HeaderChecksum(Header) !=
+		    Pack_Get32(Header, PACK_PH_CHECKSUM * 4U)) {
+			printf("image: partition %u header checksum\n",
+			       (unsigned)Index);
+			Failed = 1;
+		}
+		if (Pack_Get32(Image.Data, Offset) == LZ4_FRAME_MAGIC) {
+			if ((Index == 0U) || (Index == 3U) ||
+			    (Pack_Inflate(&Image.Data[Offset], Length, Back,
+					  &Produced) != 0) ||
+			    (Produced != Size[Index])) {
+				printf("image: partition %u does not unpack\n",
+				       (unsigned)Index);
+				Failed = 1;
+				continue;
+			}
+		} else {
+			if (Length != Size[Index]) {
+				printf("image: partition %u length\n",
+				       (unsigned)Index);
+				Failed = 1;
+				continue;
+			}
+			(void)memcpy(Back, &Image.Data[Offset], Length);
+		}
+		if (memcmp(Back, &Original.Data[Start[Index]], Size[Index]) != 0) {
+			printf("image: partition %u data\n", (unsigned)Index);
+			Failed = 1;
+		}
+		if ((Index == 3U) &&
+		    (memcmp(&Image.Data[Pack_Get32(Header,
+				PACK_PH_CHECKSUM_OFF * 4U) * 4U],
+			    &Original.Data[Original.Length - PACK_MD5_SIZE],
+			    PACK_MD5_SIZE) != 0)) {
+			printf("image: checksum did not move with its partition\n");
+			Failed = 1;
+		}
+		if ((Offset % PACK_ALIGN) != 0U) {
+			printf("image: partition %u alignment\n", (unsigned)Index);
+			Failed = 1;
+		}
+	}
+
+	/* Corrupt frames must fail, not overrun */
+	Header = &Image.Data[0xC80U + PACK_PH_SIZE];
+	Offset = Pack_Get32(Header, PACK_PH_START * 4U) * 4U;
+	Length = Pack_Get32(Header, PACK_PH_IMAGE_LEN * 4U) * 4U;
+	if (Pack_Get32(Image.Data, Offset) == LZ4_FRAME_MAGIC) {
+		Pack_Put32(Image.Data, Offset + 4U, Size[1] + 4U);
+		if (Pack_Inflate(&Image.Data[Offset], Length, Back, &Produced) == 0) {
+			printf("image: wrong frame length accepted\n");
+			Failed = 1;
+		}
+		Pack_Put32(Image.Data, Offset + 4U, Size[1]);
+		if (Pack_Inflate(&Image.Data[Offset], Length - 8U, Back,
+				 &Produced) == 0) {
+			printf("image: truncated frame accepted\n");
+			Failed = 1;
+		}
+	}
+
+	free(Back);
+	free(Image.Data);
+	free(Original.Data);
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Fill a buffer with one kind of test data.
+*
+* @param	Data is the buffer.
+* @param	Length is its length.
+* @param	Kind is 0 zeros, 1 random, 2 a sparse bitstream-like pattern,
+*		3 text-like data, 4 short runs.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Pack_Fill(u8 *Data, u32 Length, u32 Kind)
+{
+	static const char *const Words[] = {
+		"Status ", "= ", "XST_SUCCESS", ";\n", "if ", "(Length ",
+		"> ", "0U) ", "{\n\t", "}\n", "return ", "Offset"
+	};
+	u32 Index;
+	u32 Run = 0U;
+	const char *Word;
+
+	srand(Kind + 1U);
+	for (Index = 0U; Index < Length; Index++) {
+		switch (Kind) {
+		case 0U:
+			Data[Index] = 0U;
+			break;
+		case 1U:
+			Data[Index] = (u8)rand();
+			break;
+		case 2U:
+			/* Configuration frames: mostly zero, some words set */
+			Data[Index] = (((Index / 404U) % 7U) == 0U) ?
+				(u8)rand() : 0U;
+			break;
+		case 3U:
+			Word = Words[(u32)rand() % (sizeof(Words) / sizeof(Words[0]))];
+			while ((*Word != '\0') && (Index < Length)) {
+				Data[Index++] = (u8)*Word++;
+			}
+			Index--;
+			break;
+		default:
+			if (Run == 0U) {
+				Run = 1U + ((u32)rand() % 9U);
+				Data[Index] = (u8)rand();
+			} else {
+				Data[Index] = Data[Index - 1U];
+			}
+			Run--;
+			break;
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+* Read a whole file.
+*
+* @param	Name is the file name.
+* @param	Image receives the contents.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Pack_ReadFile(const char *Name, PackImage *Image)
+{
+	FILE *File = fopen(Name, "rb");
+	long Size;
+
+	if ((File == NULL) || (fseek(File, 0, SEEK_END) != 0) ||
+	    ((Size = ftell(File)) <= 0) || (fseek(File, 0, SEEK_SET) != 0)) {
+		perror(Name);
+		return 1;
+	}
+
+	Image->Length = (u32)Size;
+	Image->Data = malloc(Image->Length + 4U);
+	if ((Image->Data == NULL) ||
+	    (fread(Image->Data, 1U, Image->Length, File) != Image->Length)) {
+		perror(Name);
+		return 1;
+	}
+	(void)fclose(File);
+
+	return 0;
+}
+
+/*****************************************************************************/
+/*
+ * Little-endian words, as the Zynq reads them
+ */
+
+static u32 Pack_Get32(const u8 *Data, u32 Offset)
+{
+	return (u32)Data[Offset] | ((u32)Data[Offset + 1U] << 8) |
+	       ((u32)Data[Offset + 2U] << 16) | ((u32)Data[Offset + 3U] << 24);
+}
+
+static void Pack_Put32(u8 *Data, u32 Offset, u32 Value)
+{
+	Data[Offset] = (u8)Value;
+	Data[Offset + 1U] = (u8)(Value >> 8);
+	Data[Offset + 2U] = (u8)(Value >> 16);
+	Data[Offset + 3U] = (u8)(Value >> 24);
+}
@@ -0,0 +1,180 @@
+/*****************************************************************************/
+/**
+* @file md5_bench.c
+*
+* Host check and benchmark of the FSBL partition checksum. Runs
+* MD5SelfTest() from the FSBL md5.c, checks the digest of a 1 MB pattern
+* against a reference digest with the buffer word aligned and not and fed
+* in the 128 KB chunks PartitionMoveChecksum() uses, and then times md5()
+* over a larger buffer on both paths.
+*
+* Build and run from improved/:
+*   gcc -O2 -Wall -o md5_bench tools/md5_bench.c \
+*       vitisProject/clk_div_scale_auto/clk_div_wrapper/zynq_fsbl/md5.c \
+*       -IvitisProject/clk_div_scale_auto/clk_div_wrapper/zynq_fsbl \
+*       -IvitisProject/clk_div_scale_auto/clk_div_wrapper/zynq_fsbl/zynq_fsbl_bsp/ps7_cortexa9_0/include
+*   ./md5_bench [megabytes]
+*
+* The same source cross-compiles for the Cortex-A9 with arm-none-eabi-gcc
+* -mcpu=cortex-a9 and runs under the debugger with semihosting, to compare
+* with the timings of the md5 stage in the boot profile.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "md5.h"
+#include "xstatus.h"
+
+/************************** Constant Definitions ****************************/
+
+#define BENCH_PATTERN_SIZE	0x100000	/* Reference pattern, 1 MB */
+#define BENCH_CHUNK_SIZE	0x20000		/* CHECKSUM_CHUNK_SIZE */
+#define BENCH_DEFAULT_MB	64U
+
+/************************** Variable Definitions ****************************/
+
+/* MD5 of BENCH_PATTERN_SIZE bytes of (i * 7 + 3) & 0xff */
+static const u8 PatternDigest[16] = {
+	0xd8, 0xa4, 0x69, 0xbb, 0x35, 0xfb, 0x5f, 0xad,
+	0x71, 0x56, 0x84, 0x2b, 0xa2, 0x24, 0x24, 0x34
+};
+
+/************************** Function Prototypes *****************************/
+
+static int Bench_CheckPattern(u8 *Buffer, u32 Chunk);
+static double Bench_Time(u8 *Buffer, u32 Length);
+
+/*****************************************************************************/
+/**
+* Run the checks and the benchmark.
+*
+* @return	0 if every digest matched, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+int main(int argc, char *argv[])
+{
+	u32 Megabytes = BENCH_DEFAULT_MB;
+	u32 Length;
+	u8 *Buffer;
+	u32 Index;
+	int Failed = 0;
+	double Seconds;
+
+	if (argc > 1) {
+		Megabytes = (u32)strtoul(argv[1], NULL, 0);
+	}
+	Length = Megabytes << 20;
+	if (Length < BENCH_PATTERN_SIZE) {
+		Length = BENCH_PATTERN_SIZE;
+	}
+
+	/* One spare byte for the unaligned runs */
+	Buffer = malloc(Length + 4U);
+	if (Buffer == NULL) {
+		fprintf(stderr, "md5_bench: no memory for %lu bytes\n",
+			(unsigned long)Length);
+		return 1;
+	}
+
+	if (MD5SelfTest() != XST_SUCCESS) {
+		printf("self test:        FAIL\n");
+		Failed = 1;
+	} else {
+		printf("self test:        pass\n");
+	}
+
+	Failed |= Bench_CheckPattern(Buffer, BENCH_PATTERN_SIZE);
+	Failed |= Bench_CheckPattern(Buffer + 1, BENCH_PATTERN_SIZE);
+	Failed |= Bench_CheckPattern(Buffer, BENCH_CHUNK_SIZE);
+	Failed |= Bench_CheckPattern(Buffer + 1, BENCH_CHUNK_SIZE);
+
+	for (Index = 0U; Index < Length + 4U; Index++) {
+		Buffer[Index] = (u8)Index;
+	}
+
+	Seconds = Bench_Time(Buffer, Length);
+	printf("aligned:          %8.1f MB/s\n", Megabytes / Seconds);
+	Seconds = Bench_Time(Buffer + 1, Length);
+	printf("unaligned:        %8.1f MB/s\n", Megabytes / Seconds);
+
+	free(Buffer);
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Hash the reference pattern in chunks and compare with its digest.
+*
+* @param	Buffer is where to build the pattern, at least
+*		BENCH_PATTERN_SIZE bytes.
+* @param	Chunk is the length passed to each MD5Update().
+*
+* @return	0 if the digest matched, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Bench_CheckPattern(u8 *Buffer, u32 Chunk)
+{
+	MD5Context Context;
+	u8 Digest[16];
+	u32 Offset;
+	u32 Index;
+	int Failed;
+
+	for (Index = 0U; Index < BENCH_PATTERN_SIZE; Index++) {
+		Buffer[Index] = (u8)((Index * 7U) + 3U);
+	}
+
+	MD5Init(&Context);
+	for (Offset = 0U; Offset < BENCH_PATTERN_SIZE; Offset += Chunk) {
+		MD5Update(&Context, Buffer + Offset, Chunk, FALSE);
+	}
+	MD5Final(&Context, Digest, FALSE);
+
+	Failed = (memcmp(Digest, PatternDigest, sizeof(Digest)) != 0);
+	printf("pattern %s %6lu: %s\n",
+	       (((unsigned long)(UINTPTR)Buffer & 0x3U) == 0U) ? "  aligned" : "unaligned",
+	       (unsigned long)Chunk, Failed ? "FAIL" : "pass");
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Time md5() over a buffer.
+*
+* @param	Buffer is the data to hash.
+* @param	Length is its length in bytes.
+*
+* @return	Processor time taken, in seconds.
+*
+* @note		None.
+*
+******************************************************************************/
+static double Bench_Time(u8 *Buffer, u32 Length)
+{
+	u8 Digest[16];
+	clock_t Start;
+
+	Start = clock();
+	md5(Buffer, Length, Digest, FALSE);
+
+	return (double)(clock() - Start) / CLOCKS_PER_SEC;
+}
@@ -0,0 +1,201 @@
+/*****************************************************************************/
+/**
+* @file mem_fuzz.c
+*
+* Host correctness fuzzer of Xil_MemCpy() and Xil_MemSet() from the BSP
+* xil_mem.c. Every source and destination offset within 8 bytes is tried
+* with every length up to MEM_FUZZ_SHORT, which covers each alignment
+* prologue and tail of the block loops, and then random offsets and lengths
+* up to MEM_FUZZ_LONG. Each result is compared with memcpy() and memset(),
+* and the guard bytes around the destination must be untouched.
+*
+* Build and run from improved/:
+*   gcc -O2 -Wall -o mem_fuzz tools/mem_fuzz.c \
+*       vitisProject/clk_div_scale_auto/clk_div_wrapper/ps7_cortexa9_0/standalone_domain/bsp/ps7_cortexa9_0/libsrc/standalone_v8_1/src/xil_mem.c \
+*       -IvitisProject/clk_div_scale_auto/clk_div_wrapper/ps7_cortexa9_0/standalone_domain/bsp/ps7_cortexa9_0/include
+*   ./mem_fuzz [iterations [seed]]
+*
+* On an x86 host this checks the C block loops; built with arm-linux-
+* gnueabihf-gcc -marm or -mthumb and run under qemu-arm it checks the
+* LDM/STM loops the Cortex-A9 runs.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xil_types.h"
+#include "xil_mem.h"
+
+/************************** Constant Definitions ****************************/
+
+#define MEM_FUZZ_ALIGN		8U	/* Offsets tried exhaustively */
+#define MEM_FUZZ_SHORT		300U	/* Lengths tried exhaustively */
+#define MEM_FUZZ_LONG		65536U	/* Longest random length */
+#define MEM_FUZZ_GUARD		64U	/* Guard bytes on each side */
+#define MEM_FUZZ_ITERATIONS	20000U
+#define MEM_FUZZ_SIZE		(MEM_FUZZ_LONG + MEM_FUZZ_ALIGN + \
+				 (2U * MEM_FUZZ_GUARD))
+
+/************************** Function Prototypes *****************************/
+
+static int Fuzz_Copy(u32 SrcOffset, u32 DstOffset, u32 Length);
+static int Fuzz_Set(u32 DstOffset, s32 Value, u32 Length);
+static u32 Fuzz_Random(void);
+
+/************************** Variable Definitions **************************/
+
+static u8 Src[MEM_FUZZ_SIZE] __attribute__ ((aligned (64)));
+static u8 Dst[MEM_FUZZ_SIZE] __attribute__ ((aligned (64)));
+static u8 Ref[MEM_FUZZ_SIZE] __attribute__ ((aligned (64)));
+static u32 Seed = 1U;
+
+/*****************************************************************************/
+/**
+* Run the exhaustive pass and the random pass.
+*
+* @return	0 if every copy and fill matched, 1 otherwise.
+*
+******************************************************************************/
+int main(int argc, char *argv[])
+{
+	u32 Iterations = MEM_FUZZ_ITERATIONS;
+	u32 SrcOffset;
+	u32 DstOffset;
+	u32 Length;
+	u32 Index;
+	u32 Cases = 0U;
+
+	if (argc > 1) {
+		Iterations = (u32)strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		Seed = (u32)strtoul(argv[2], NULL, 0);
+	}
+
+	for (SrcOffset = 0U; SrcOffset < MEM_FUZZ_ALIGN; SrcOffset++) {
+		for (DstOffset = 0U; DstOffset < MEM_FUZZ_ALIGN; DstOffset++) {
+			for (Length = 0U; Length <= MEM_FUZZ_SHORT; Length++) {
+				if (Fuzz_Copy(SrcOffset, DstOffset, Length) != 0) {
+					return 1;
+				}
+				Cases++;
+			}
+		}
+	}
+
+	for (DstOffset = 0U; DstOffset < MEM_FUZZ_ALIGN; DstOffset++) {
+		for (Length = 0U; Length <= MEM_FUZZ_SHORT; Length++) {
+			if (Fuzz_Set(DstOffset, (s32)(Length * 37U), Length) != 0) {
+				return 1;
+			}
+			Cases++;
+		}
+	}
+
+	for (Index = 0U; Index < Iterations; Index++) {
+		SrcOffset = Fuzz_Random() % MEM_FUZZ_ALIGN;
+		DstOffset = Fuzz_Random() % MEM_FUZZ_ALIGN;
+		Length = Fuzz_Random() % (MEM_FUZZ_LONG + 1U);
+		if ((Fuzz_Copy(SrcOffset, DstOffset, Length) != 0) ||
+		    (Fuzz_Set(DstOffset, (s32)Fuzz_Random(), Length) != 0)) {
+			return 1;
+		}
+		Cases += 2U;
+	}
+
+	printf("mem_fuzz: %u cases passed\n", Cases);
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Check one Xil_MemCpy() against memcpy().
+*
+* @param	SrcOffset is the source offset from a 64-byte boundary.
+* @param	DstOffset is the destination offset from a 64-byte boundary.
+* @param	Length is the length in bytes.
+*
+* @return	0 if the destination and its guard bytes match, 1 otherwise.
+*
+******************************************************************************/
+static int Fuzz_Copy(u32 SrcOffset, u32 DstOffset, u32 Length)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < MEM_FUZZ_SIZE; Index++) {
+		Src[Index] = (u8)Fuzz_Random();
+	}
+	memset(Dst, 0xA5, MEM_FUZZ_SIZE);
+	memset(Ref, 0xA5, MEM_FUZZ_SIZE);
+
+	Xil_MemCpy(&Dst[MEM_FUZZ_GUARD + DstOffset],
+		   &Src[MEM_FUZZ_GUARD + SrcOffset], Length);
+	memcpy(&Ref[MEM_FUZZ_GUARD + DstOffset],
+	       &Src[MEM_FUZZ_GUARD + SrcOffset], Length);
+
+	if (memcmp(Dst, Ref, MEM_FUZZ_SIZE) != 0) {
+		fprintf(stderr, "mem_fuzz: Xil_MemCpy failed, src offset %u, "
+			"dst offset %u, length %u\n", SrcOffset, DstOffset,
+			Length);
+		return 1;
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Check one Xil_MemSet() against memset().
+*
+* @param	DstOffset is the destination offset from a 64-byte boundary.
+* @param	Value is the fill value, of which the low byte is used.
+* @param	Length is the length in bytes.
+*
+* @return	0 if the destination and its guard bytes match, 1 otherwise.
+*
+******************************************************************************/
+static int Fuzz_Set(u32 DstOffset, s32 Value, u32 Length)
+{
+	memset(Dst, 0xA5, MEM_FUZZ_SIZE);
+	memset(Ref, 0xA5, MEM_FUZZ_SIZE);
+
+	Xil_MemSet(&Dst[MEM_FUZZ_GUARD + DstOffset], Value, Length);
+	memset(&Ref[MEM_FUZZ_GUARD + DstOffset], Value, Length);
+
+	if (memcmp(Dst, Ref, MEM_FUZZ_SIZE) != 0) {
+		fprintf(stderr, "mem_fuzz: Xil_MemSet failed, dst offset %u, "
+			"value 0x%02X, length %u\n", DstOffset,
+			(unsigned)(Value & 0xFF), Length);
+		return 1;
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* xorshift32, so a failing seed can be replayed.
+*
+* @return	The next pseudo-random number.
+*
+******************************************************************************/
+static u32 Fuzz_Random(void)
+{
+	Seed ^= Seed << 13;
+	Seed ^= Seed >> 17;
+	Seed ^= Seed << 5;
+
+	return Seed;
+}
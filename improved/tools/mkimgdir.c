@@ -0,0 +1,713 @@
+/*****************************************************************************/
+/**
+* @file mkimgdir.c
+*
+* Host tool that writes the multiboot image directory of the FSBL, in the
+* format of image_dir.h in the FSBL, into a flash image. The images are
+* given in the order the FSBL is to fall back through them, each as
+* offset[,version[,flags]] with flags g (golden) and b (bad). The boot
+* header of every image not marked bad must be in the flash image. Both
+* copies are written with the next sequence number, and the flash image is
+* padded with 0xFF up to the directory if it is shorter.
+*
+* With -l, the copies of the directory of a flash image are listed.
+*
+* With -t, the self test: the CRC against its check value, copies that are
+* erased, corrupt, misaligned or of another sequence, and the image the
+* FSBL selection takes on a fallback from each image of a flash image
+* built here, with images marked bad and with a corrupt boot header.
+*
+* Build and run from improved/:
+*   F=vitisProject/clk_div_scale_auto/clk_div_wrapper/zynq_fsbl
+*   B=$F/zynq_fsbl_bsp/ps7_cortexa9_0
+*   gcc -O2 -Wall -o mkimgdir tools/mkimgdir.c $F/image_dir.c -I$F -I$B/include
+*   ./mkimgdir [-o dir_offset] [-s sequence] flash.bin offset[,version[,flags]]...
+*   ./mkimgdir -l flash.bin
+*   ./mkimgdir -t
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "xstatus.h"
+#include "image_dir.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Boot header words checked by the FSBL, see HeaderChecksum() in main.c
+ */
+#define DIR_BH_WIDTH_OFFSET	0x20U
+#define DIR_BH_WIDTH_WORD	0xAA995566U
+#define DIR_BH_ID_OFFSET	0x24U
+#define DIR_BH_ID_WORD		0x584C4E58U	/* "XNLX" */
+#define DIR_BH_CHECKSUM_COUNT	10U
+#define DIR_BH_CHECKSUM_OFFSET	0x48U
+#define DIR_BH_SIZE		0x4CU
+
+#define DIR_TEST_FLASH_SIZE	0x01000000U
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u8 *Data;
+	u32 Length;
+} DirFlash;
+
+/************************** Function Prototypes *****************************/
+
+static int Dir_Usage(const char *Name);
+static int Dir_Parse(const char *Arg, ImageDirEntry *Entry);
+static int Dir_Write(DirFlash *Flash, u32 DirOffset, ImageDir *Dir);
+static void Dir_Read(const DirFlash *Flash, u32 DirOffset, ImageDir *Copy);
+static int Dir_List(const DirFlash *Flash, u32 DirOffset);
+static u32 Dir_HeaderCheck(const DirFlash *Flash, u32 Offset);
+static void Dir_HeaderMake(DirFlash *Flash, u32 Offset);
+static u32 Dir_Fallback(const DirFlash *Flash, u32 DirOffset,
+		u32 FailedOffset, u32 *Reads);
+static int Dir_Test(void);
+static int Dir_Expect(const char *Label, u32 Got, u32 Expected);
+static int Dir_ReadFile(const char *Name, DirFlash *Flash);
+static u32 Dir_Get32(const u8 *Data, u32 Offset);
+static void Dir_Put32(u8 *Data, u32 Offset, u32 Value);
+
+/*****************************************************************************/
+/**
+* Write the image directory of a flash image, list it with -l, or run the
+* self test with -t.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+int main(int argc, char *argv[])
+{
+	DirFlash Flash;
+	ImageDir Dir;
+	ImageDir Copy[2];
+	const ImageDir *Current;
+	u32 DirOffset = FSBL_IMAGE_DIR_OFFSET;
+	u32 Sequence = 0U;
+	int HaveSequence = 0;
+	int List = 0;
+	int Opt;
+	int Index;
+	FILE *Out;
+
+	while ((Opt = getopt(argc, argv, "o:s:lt")) != -1) {
+		switch (Opt) {
+		case 'o':
+			DirOffset = (u32)strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			Sequence = (u32)strtoul(optarg, NULL, 0);
+			HaveSequence = 1;
+			break;
+		case 'l':
+			List = 1;
+			break;
+		case 't':
+			return Dir_Test();
+		default:
+			return Dir_Usage(argv[0]);
+		}
+	}
+
+	if ((optind >= argc) || (List && ((optind + 1) != argc)) ||
+	    (!List && ((optind + 2) > argc)) ||
+	    ((argc - optind - 1) > (int)IMAGE_DIR_ENTRIES_MAX)) {
+		return Dir_Usage(argv[0]);
+	}
+	if ((DirOffset % IMAGE_DIR_COPY_OFFSET) != 0U) {
+		fprintf(stderr, "mkimgdir: directory offset must be a multiple "
+			"of 0x%x\n", (unsigned)IMAGE_DIR_COPY_OFFSET);
+		return 1;
+	}
+
+	if (Dir_ReadFile(argv[optind], &Flash) != 0) {
+		return 1;
+	}
+	if (List) {
+		return Dir_List(&Flash, DirOffset);
+	}
+
+	(void)memset(&Dir, 0, sizeof(Dir));
+	Dir.Magic = IMAGE_DIR_MAGIC;
+	for (Index = optind + 1; Index < argc; Index++) {
+		if (Dir_Parse(argv[Index], &Dir.Entry[Dir.Count]) != 0) {
+			fprintf(stderr, "mkimgdir: bad image %s\n", argv[Index]);
+			return 1;
+		}
+		if (((Dir.Entry[Dir.Count].Flags & IMAGE_DIR_FLAG_BAD) == 0U) &&
+		    (Dir_HeaderCheck(&Flash, Dir.Entry[Dir.Count].Offset) !=
+				XST_SUCCESS)) {
+			fprintf(stderr, "mkimgdir: no valid boot header at "
+				"0x%08x\n", (unsigned)Dir.Entry[Dir.Count].Offset);
+			return 1;
+		}
+		Dir.Count++;
+	}
+
+	/*
+	 * Next sequence after the directory in the flash image, if any
+	 */
+	if (!HaveSequence) {
+		Dir_Read(&Flash, DirOffset, &Copy[0]);
+		Dir_Read(&Flash, DirOffset + IMAGE_DIR_COPY_OFFSET, &Copy[1]);
+		Current = ImageDirPick(&Copy[0], &Copy[1]);
+		Sequence = (Current != NULL) ? (Current->Sequence + 1U) : 1U;
+	}
+	Dir.Sequence = Sequence;
+
+	if (Dir_Write(&Flash, DirOffset, &Dir) != 0) {
+		return 1;
+	}
+
+	Out = fopen(argv[optind], "wb");
+	if ((Out == NULL) ||
+	    (fwrite(Flash.Data, 1U, Flash.Length, Out) != Flash.Length) ||
+	    (fclose(Out) != 0)) {
+		perror(argv[optind]);
+		return 1;
+	}
+
+	return Dir_List(&Flash, DirOffset);
+}
+
+/*****************************************************************************/
+/**
+* Print the usage.
+*
+* @param	Name is the program name.
+*
+* @return	1.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Dir_Usage(const char *Name)
+{
+	fprintf(stderr, "usage: %s [-o dir_offset] [-s sequence] flash.bin "
+		"offset[,version[,flags]]...\n       %s -l flash.bin\n"
+		"       %s -t\n", Name, Name, Name);
+	return 1;
+}
+
+/*****************************************************************************/
+/**
+* Parse an image argument, offset[,version[,flags]].
+*
+* @param	Arg is the argument.
+* @param	Entry is set to the directory entry.
+*
+* @return	0 on success, 1 if the argument is not valid.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Dir_Parse(const char *Arg, ImageDirEntry *Entry)
+{
+	char *End;
+
+	(void)memset(Entry, 0, sizeof(*Entry));
+	Entry->Flags = IMAGE_DIR_FLAG_VALID;
+
+	Entry->Offset = (u32)strtoul(Arg, &End, 0);
+	if ((End == Arg) || ((Entry->Offset % IMAGE_DIR_ALIGN) != 0U)) {
+		return 1;
+	}
+	if (*End == ',') {
+		Arg = End + 1;
+		Entry->Version = (u32)strtoul(Arg, &End, 0);
+		if (End == Arg) {
+			return 1;
+		}
+	}
+	if (*End == ',') {
+		for (End++; *End != '\0'; End++) {
+			if (*End == 'g') {
+				Entry->Flags |= IMAGE_DIR_FLAG_GOLDEN;
+			} else if (*End == 'b') {
+				Entry->Flags |= IMAGE_DIR_FLAG_BAD;
+			} else {
+				return 1;
+			}
+		}
+	}
+
+	return (*End == '\0') ? 0 : 1;
+}
+
+/*****************************************************************************/
+/**
+* Write both copies of a directory, each in its own erased sector.
+*
+* @param	Flash is the flash image, grown if it ends before the copies.
+* @param	DirOffset is the offset of the first copy.
+* @param	Dir is the directory; its CRC is set here.
+*
+* @return	0 on success, 1 if out of memory.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Dir_Write(DirFlash *Flash, u32 DirOffset, ImageDir *Dir)
+{
+	u32 End = DirOffset + (2U * IMAGE_DIR_COPY_OFFSET);
+	u32 Copy;
+	u8 *Data;
+
+	if (Flash->Length < End) {
+		Data = realloc(Flash->Data, End);
+		if (Data == NULL) {
+			return 1;
+		}
+		(void)memset(&Data[Flash->Length], 0xFF, End - Flash->Length);
+		Flash->Data = Data;
+		Flash->Length = End;
+	}
+
+	Dir->Crc = ImageDirCrc(Dir);
+	for (Copy = 0U; Copy < 2U; Copy++) {
+		Data = &Flash->Data[DirOffset + (Copy * IMAGE_DIR_COPY_OFFSET)];
+		(void)memset(Data, 0xFF, IMAGE_DIR_COPY_OFFSET);
+		(void)memcpy(Data, Dir, sizeof(*Dir));
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Read one copy of the directory, erased if past the end of the image.
+*
+* @param	Flash is the flash image.
+* @param	Offset is the offset of the copy.
+* @param	Copy is set to the copy.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Dir_Read(const DirFlash *Flash, u32 Offset, ImageDir *Copy)
+{
+	(void)memset(Copy, 0xFF, sizeof(*Copy));
+	if ((Offset < Flash->Length) &&
+	    ((Flash->Length - Offset) >= sizeof(*Copy))) {
+		(void)memcpy(Copy, &Flash->Data[Offset], sizeof(*Copy));
+	}
+}
+
+/*****************************************************************************/
+/**
+* List both copies of the directory and which one the FSBL uses.
+*
+* @param	Flash is the flash image.
+* @param	DirOffset is the offset of the first copy.
+*
+* @return	0 if a copy is valid, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Dir_List(const DirFlash *Flash, u32 DirOffset)
+{
+	ImageDir Copy[2];
+	const ImageDir *Current;
+	const ImageDirEntry *Entry;
+	u32 Index;
+	u32 Entries;
+
+	for (Index = 0U; Index < 2U; Index++) {
+		Dir_Read(Flash, DirOffset + (Index * IMAGE_DIR_COPY_OFFSET),
+			&Copy[Index]);
+	}
+	Current = ImageDirPick(&Copy[0], &Copy[1]);
+
+	for (Index = 0U; Index < 2U; Index++) {
+		printf("copy %u at 0x%08x: ", (unsigned)Index,
+			(unsigned)(DirOffset + (Index * IMAGE_DIR_COPY_OFFSET)));
+		if (ImageDirCheck(&Copy[Index]) != XST_SUCCESS) {
+			printf("not valid\n");
+			continue;
+		}
+		printf("sequence %u, %u images%s\n",
+			(unsigned)Copy[Index].Sequence, (unsigned)Copy[Index].Count,
+			(Current == &Copy[Index]) ? ", in use" : "");
+	}
+	if (Current == NULL) {
+		return 1;
+	}
+
+	Entries = Current->Count;
+	for (Index = 0U; Index < Entries; Index++) {
+		Entry = &Current->Entry[Index];
+		printf("  %2u  0x%08x  version 0x%08x%s%s%s\n", (unsigned)Index,
+			(unsigned)Entry->Offset, (unsigned)Entry->Version,
+			((Entry->Flags & IMAGE_DIR_FLAG_GOLDEN) != 0U) ?
+				"  golden" : "",
+			((Entry->Flags & IMAGE_DIR_FLAG_BAD) != 0U) ? "  bad" : "",
+			(Dir_HeaderCheck(Flash, Entry->Offset) != XST_SUCCESS) ?
+				"  no boot header" : "");
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Check the boot header of an image as the FSBL does, the XLNX word and the
+* header checksum.
+*
+* @param	Flash is the flash image.
+* @param	Offset is the image offset.
+*
+* @return	XST_SUCCESS if the header is valid, XST_FAILURE otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 Dir_HeaderCheck(const DirFlash *Flash, u32 Offset)
+{
+	u32 Checksum = 0U;
+	u32 Word;
+
+	if ((Offset >= Flash->Length) ||
+	    ((Flash->Length - Offset) < DIR_BH_SIZE) ||
+	    (Dir_Get32(Flash->Data, Offset + DIR_BH_ID_OFFSET) !=
+			DIR_BH_ID_WORD)) {
+		return XST_FAILURE;
+	}
+
+	for (Word = 0U; Word < DIR_BH_CHECKSUM_COUNT; Word++) {
+		Checksum += Dir_Get32(Flash->Data,
+				Offset + DIR_BH_WIDTH_OFFSET + (Word * 4U));
+	}
+	if ((Checksum ^ 0xFFFFFFFFU) !=
+	    Dir_Get32(Flash->Data, Offset + DIR_BH_CHECKSUM_OFFSET)) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Write a boot header that passes Dir_HeaderCheck(), for the self test.
+*
+* @param	Flash is the flash image.
+* @param	Offset is the image offset.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Dir_HeaderMake(DirFlash *Flash, u32 Offset)
+{
+	u32 Checksum = 0U;
+	u32 Word;
+
+	Dir_Put32(Flash->Data, Offset + DIR_BH_WIDTH_OFFSET, DIR_BH_WIDTH_WORD);
+	Dir_Put32(Flash->Data, Offset + DIR_BH_ID_OFFSET, DIR_BH_ID_WORD);
+	for (Word = 2U; Word < DIR_BH_CHECKSUM_COUNT; Word++) {
+		Dir_Put32(Flash->Data, Offset + DIR_BH_WIDTH_OFFSET + (Word * 4U),
+			Offset + Word);
+	}
+	for (Word = 0U; Word < DIR_BH_CHECKSUM_COUNT; Word++) {
+		Checksum += Dir_Get32(Flash->Data,
+				Offset + DIR_BH_WIDTH_OFFSET + (Word * 4U));
+	}
+	Dir_Put32(Flash->Data, Offset + DIR_BH_CHECKSUM_OFFSET,
+		Checksum ^ 0xFFFFFFFFU);
+}
+
+/*****************************************************************************/
+/**
+* The fallback selection of the FSBL, ImageDirFallback() in main.c, on a
+* flash image.
+*
+* @param	Flash is the flash image.
+* @param	DirOffset is the offset of the first copy.
+* @param	FailedOffset is the offset of the image that failed.
+* @param	Reads is incremented by the flash reads made.
+*
+* @return	The offset of the image selected, IMAGE_DIR_NONE if none.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 Dir_Fallback(const DirFlash *Flash, u32 DirOffset,
+		u32 FailedOffset, u32 *Reads)
+{
+	ImageDir Copy[2];
+	const ImageDir *Dir;
+	u32 Index;
+
+	Dir_Read(Flash, DirOffset, &Copy[0]);
+	Dir_Read(Flash, DirOffset + IMAGE_DIR_COPY_OFFSET, &Copy[1]);
+	*Reads += 2U;
+
+	Dir = ImageDirPick(&Copy[0], &Copy[1]);
+	if (Dir == NULL) {
+		return IMAGE_DIR_NONE;
+	}
+
+	for (Index = ImageDirStart(Dir, FailedOffset);
+	     (Index = ImageDirNext(Dir, FailedOffset, Index)) != IMAGE_DIR_NONE;
+	     Index++) {
+		*Reads += 1U + DIR_BH_CHECKSUM_COUNT + 1U;
+		if (Dir_HeaderCheck(Flash, Dir->Entry[Index].Offset) ==
+				XST_SUCCESS) {
+			return Dir->Entry[Index].Offset;
+		}
+	}
+
+	return IMAGE_DIR_NONE;
+}
+
+/*****************************************************************************/
+/**
+* Self test of the directory checks and the fallback selection.
+*
+* @return	0 if all passed, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Dir_Test(void)
+{
+	static const u8 Check[] = "123456789";
+	static const u32 Images[] = { 0x000000U, 0x400000U, 0x800000U };
+	DirFlash Flash;
+	ImageDir Dir;
+	ImageDir Copy[2];
+	u32 DirOffset = FSBL_IMAGE_DIR_OFFSET;
+	u32 Index;
+	u32 Reads = 0U;
+	u32 ScanReads;
+	int Failed = 0;
+
+	/*
+	 * CRC-32 check value
+	 */
+	Failed |= Dir_Expect("crc", ImageDirCrc32(0U, Check, 9U), 0xCBF43926U);
+	Failed |= Dir_Expect("crc split",
+		ImageDirCrc32(ImageDirCrc32(0U, Check, 4U), &Check[4], 5U),
+		0xCBF43926U);
+
+	Flash.Length = DIR_TEST_FLASH_SIZE;
+	Flash.Data = malloc(Flash.Length);
+	if (Flash.Data == NULL) {
+		return 1;
+	}
+	(void)memset(Flash.Data, 0xFF, Flash.Length);
+
+	/*
+	 * Erased flash: no directory
+	 */
+	Failed |= Dir_Expect("erased", Dir_Fallback(&Flash, DirOffset, 0U,
+			&Reads), IMAGE_DIR_NONE);
+
+	(void)memset(&Dir, 0, sizeof(Dir));
+	Dir.Magic = IMAGE_DIR_MAGIC;
+	Dir.Sequence = 7U;
+	for (Index = 0U; Index < 3U; Index++) {
+		Dir_HeaderMake(&Flash, Images[Index]);
+		Dir.Entry[Index].Offset = Images[Index];
+		Dir.Entry[Index].Version = Index + 1U;
+		Dir.Entry[Index].Flags = IMAGE_DIR_FLAG_VALID;
+	}
+	Dir.Entry[2].Flags |= IMAGE_DIR_FLAG_GOLDEN;
+	Dir.Count = 3U;
+	if (Dir_Write(&Flash, DirOffset, &Dir) != 0) {
+		return 1;
+	}
+
+	/*
+	 * Fallback order, never back to an image that failed
+	 */
+	Failed |= Dir_Expect("after 0", Dir_Fallback(&Flash, DirOffset,
+			Images[0], &Reads), Images[1]);
+	Failed |= Dir_Expect("after 1", Dir_Fallback(&Flash, DirOffset,
+			Images[1], &Reads), Images[2]);
+	Failed |= Dir_Expect("after golden", Dir_Fallback(&Flash, DirOffset,
+			Images[2], &Reads), IMAGE_DIR_NONE);
+	Failed |= Dir_Expect("not listed", Dir_Fallback(&Flash, DirOffset,
+			0x200000U, &Reads), Images[0]);
+
+	/*
+	 * An image with a corrupt boot header is passed over
+	 */
+	Flash.Data[Images[1] + DIR_BH_CHECKSUM_OFFSET] ^= 0x01U;
+	Failed |= Dir_Expect("bad header", Dir_Fallback(&Flash, DirOffset,
+			Images[0], &Reads), Images[2]);
+	Flash.Data[Images[1] + DIR_BH_CHECKSUM_OFFSET] ^= 0x01U;
+
+	/*
+	 * An image marked bad is passed over
+	 */
+	Dir.Entry[1].Flags |= IMAGE_DIR_FLAG_BAD;
+	(void)Dir_Write(&Flash, DirOffset, &Dir);
+	Failed |= Dir_Expect("marked bad", Dir_Fallback(&Flash, DirOffset,
+			Images[0], &Reads), Images[2]);
+	Dir.Entry[1].Flags &= ~IMAGE_DIR_FLAG_BAD;
+	(void)Dir_Write(&Flash, DirOffset, &Dir);
+
+	/*
+	 * One corrupt copy: the other is used
+	 */
+	Flash.Data[DirOffset + 20U] ^= 0x80U;
+	Failed |= Dir_Expect("first corrupt", Dir_Fallback(&Flash, DirOffset,
+			Images[0], &Reads), Images[1]);
+	Flash.Data[DirOffset + IMAGE_DIR_COPY_OFFSET + 20U] ^= 0x80U;
+	Failed |= Dir_Expect("both corrupt", Dir_Fallback(&Flash, DirOffset,
+			Images[0], &Reads), IMAGE_DIR_NONE);
+	(void)Dir_Write(&Flash, DirOffset, &Dir);
+
+	/*
+	 * Copy checks
+	 */
+	Failed |= Dir_Expect("valid", ImageDirCheck(&Dir), XST_SUCCESS);
+	Copy[0] = Dir;
+	Copy[0].Entry[0].Offset = 0x1000U;
+	Copy[0].Crc = ImageDirCrc(&Copy[0]);
+	Failed |= Dir_Expect("misaligned", ImageDirCheck(&Copy[0]), XST_FAILURE);
+	Copy[0] = Dir;
+	Copy[0].Count = IMAGE_DIR_ENTRIES_MAX + 1U;
+	Copy[0].Crc = ImageDirCrc(&Copy[0]);
+	Failed |= Dir_Expect("count", ImageDirCheck(&Copy[0]), XST_FAILURE);
+
+	/*
+	 * Newer copy, also across the sequence wrap
+	 */
+	Copy[0] = Dir;
+	Copy[1] = Dir;
+	Copy[1].Sequence = Dir.Sequence + 1U;
+	Copy[1].Crc = ImageDirCrc(&Copy[1]);
+	Failed |= Dir_Expect("newer second",
+		(u32)(ImageDirPick(&Copy[0], &Copy[1]) == &Copy[1]), 1U);
+	Failed |= Dir_Expect("newer first",
+		(u32)(ImageDirPick(&Copy[1], &Copy[0]) == &Copy[1]), 1U);
+	Copy[0].Sequence = 0xFFFFFFFFU;
+	Copy[0].Crc = ImageDirCrc(&Copy[0]);
+	Copy[1].Sequence = 0U;
+	Copy[1].Crc = ImageDirCrc(&Copy[1]);
+	Failed |= Dir_Expect("wrap",
+		(u32)(ImageDirPick(&Copy[0], &Copy[1]) == &Copy[1]), 1U);
+
+	/*
+	 * Reads to fall back from the first image to the golden image, with
+	 * the image in between corrupt, against the 32 KB search
+	 */
+	Flash.Data[Images[1] + DIR_BH_ID_OFFSET] ^= 0x01U;
+	Reads = 0U;
+	(void)Dir_Fallback(&Flash, DirOffset, Images[0], &Reads);
+	ScanReads = 0U;
+	for (Index = Images[0] + IMAGE_DIR_ALIGN; Index < Images[2];
+	     Index += IMAGE_DIR_ALIGN) {
+		ScanReads += (Dir_HeaderCheck(&Flash, Index) == XST_SUCCESS) ?
+			(DIR_BH_CHECKSUM_COUNT + 2U) : 1U;
+	}
+	ScanReads += DIR_BH_CHECKSUM_COUNT + 2U;
+	printf("fallback to golden: %u reads, %u with the 32 KB search\n",
+		(unsigned)Reads, (unsigned)ScanReads);
+
+	free(Flash.Data);
+
+	printf("%s\n", Failed ? "FAIL" : "pass");
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Compare a test result.
+*
+* @param	Label names the check.
+* @param	Got is the result.
+* @param	Expected is the expected result.
+*
+* @return	0 if they match, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Dir_Expect(const char *Label, u32 Got, u32 Expected)
+{
+	if (Got != Expected) {
+		printf("%s: 0x%08x, expected 0x%08x\n", Label, (unsigned)Got,
+			(unsigned)Expected);
+		return 1;
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Read a file.
+*
+* @param	Name is the file name.
+* @param	Flash is set to the contents.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Dir_ReadFile(const char *Name, DirFlash *Flash)
+{
+	FILE *File = fopen(Name, "rb");
+	long Size;
+
+	if ((File == NULL) || (fseek(File, 0, SEEK_END) != 0) ||
+	    ((Size = ftell(File)) < 0) || (fseek(File, 0, SEEK_SET) != 0)) {
+		perror(Name);
+		return 1;
+	}
+
+	Flash->Length = (u32)Size;
+	Flash->Data = malloc(Flash->Length + 4U);
+	if ((Flash->Data == NULL) ||
+	    (fread(Flash->Data, 1U, Flash->Length, File) != Flash->Length)) {
+		perror(Name);
+		return 1;
+	}
+	(void)fclose(File);
+
+	return 0;
+}
+
+/*****************************************************************************/
+/*
+ * Little-endian words, as the Zynq reads them
+ */
+
+static u32 Dir_Get32(const u8 *Data, u32 Offset)
+{
+	return (u32)Data[Offset] | ((u32)Data[Offset + 1U] << 8) |
+	       ((u32)Data[Offset + 2U] << 16) | ((u32)Data[Offset + 3U] << 24);
+}
+
+static void Dir_Put32(u8 *Data, u32 Offset, u32 Value)
+{
+	Data[Offset] = (u8)Value;
+	Data[Offset + 1U] = (u8)(Value >> 8);
+	Data[Offset + 2U] = (u8)(Value >> 16);
+	Data[Offset + 3U] = (u8)(Value >> 24);
+}
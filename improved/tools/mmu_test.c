@@ -0,0 +1,509 @@
+/*****************************************************************************/
+/**
+* @file mmu_test.c
+*
+* Host test of Xil_SetPageAttributes() and its page table encoder in the
+* BSP xil_mmu.c. xil_mmu.c is built here against a host translation table
+* laid out like translation_table.S, with the CP15 operations stubbed out.
+* The test checks the page descriptors of the xil_mmu.h attributes against
+* encodings worked out from the ARMv7-A short-descriptor format. It then
+* maps page ranges and walks the whole 4 GB a page at a time after each
+* step, comparing the address and attributes of every page with a model:
+* a DMA ring in a 4 KB page, 64 KB pages, ranges across sections, a whole
+* section over a split one, running out of second level tables and bad
+* arguments.
+*
+* Build and run from improved/:
+*   B=vitisProject/clk_div_scale_auto/clk_div_wrapper/ps7_cortexa9_0/standalone_domain/bsp/ps7_cortexa9_0
+*   gcc -O2 -Wall -o mmu_test tools/mmu_test.c \
+*       -I$B/libsrc/standalone_v8_1/src -I$B/include
+*   ./mmu_test
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "xil_types.h"
+#include "xpseudo_asm.h"
+
+/*
+ * xil_mmu.c on a host table: no CP15 operations
+ */
+#undef mtcp
+#undef mfcp
+#undef dsb
+#undef isb
+#define mtcp(rn, v)	((void)(v))
+#define mfcp(rn)	0U
+#define dsb()
+#define isb()
+
+#include "xil_mmu.c"
+
+/************************** Constant Definitions ****************************/
+
+#define TEST_SECTIONS		4096U
+#define TEST_PAGES		(TEST_SECTIONS * ARM_AR_MEM_TTB_L2_ENTRIES)
+
+/* Section attribute bits a page keeps: type, B, C, XN, domain, AP, TEX,
+ * APX, S, nG and NS */
+#define TEST_ATTR_MASK		0xBFDFEU
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Attrib;	/* Section attribute from xil_mmu.h */
+	u32 Small;	/* Expected small page descriptor */
+	u32 Large;	/* Expected large page descriptor */
+} Test_Encoding;
+
+/************************** Function Prototypes *****************************/
+
+static int Test_Encoder(void);
+static int Test_Maps(void);
+static int Test_Map(const char *Label, u32 Addr, u32 Size, u32 attrib,
+		s32 Expected);
+static int Test_Walk(const char *Label);
+static u32 Test_TablesUsed(void);
+static void Test_ModelSet(u32 Addr, u32 Size, u32 attrib);
+
+void Xil_DCacheFlush(void);
+void Xil_DCacheInvalidate(void);
+void Xil_ICacheInvalidate(void);
+
+/************************** Variable Definitions ****************************/
+
+/* The table the BSP knows as MMUTable */
+u32 TestL1Table[TEST_SECTIONS] __asm__ ("MMUTable")
+		__attribute__ ((aligned (16384)));
+
+/* Expected normalized attribute of every 4 KB page, 0 for a fault */
+static u32 Model[TEST_PAGES];
+
+static const Test_Encoding Encoding[] = {
+	{ NORM_WB_CACHE,			0x576U,  0x5435U },
+	{ NORM_WB_CACHE & NON_SHAREABLE,	0x176U,  0x5035U },
+	{ NORM_WT_CACHE,			0x5BAU,  0x6439U },
+	{ NORM_NONCACHE,			0x472U,  0x1431U },
+	{ STRONG_ORDERED,			0x032U,  0x0031U },
+	{ DEVICE_MEMORY,			0x036U,  0x0035U },
+	{ DEVICE_MEMORY | EXECUTE_NEVER,	0x037U,  0x8035U },
+	{ NORM_NONCACHE | (0x1U << 15),		0x672U,  0x1631U },
+	{ NORM_NONCACHE | (0x1U << 17),		0xC72U,  0x1C31U },
+	{ RESERVED,				0x000U,  0x0000U },
+};
+
+/*****************************************************************************/
+/**
+* Run the encoder test and the mapping test.
+*
+* @return	0 if all checks passed, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+int main(void)
+{
+	int Failed = 0;
+
+	Failed |= Test_Encoder();
+	Failed |= Test_Maps();
+
+	printf("%s\n", Failed ? "FAIL" : "pass");
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Check the page descriptors of the section attributes.
+*
+* @return	0 if every encoding matched, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Test_Encoder(void)
+{
+	u32 Index;
+	u32 Small;
+	u32 Large;
+	int Failed = 0;
+
+	for (Index = 0U; Index < sizeof(Encoding) / sizeof(Encoding[0]);
+	     Index++) {
+		Small = Xil_MmuPageDesc(Encoding[Index].Attrib,
+					ARM_AR_MEM_SMALL_PAGE_SIZE);
+		Large = Xil_MmuPageDesc(Encoding[Index].Attrib,
+					ARM_AR_MEM_LARGE_PAGE_SIZE);
+		if ((Small != Encoding[Index].Small) ||
+		    (Large != Encoding[Index].Large)) {
+			printf("encoder: 0x%05X gives 0x%04X 0x%04X, "
+			       "expected 0x%04X 0x%04X\n",
+			       Encoding[Index].Attrib, Small, Large,
+			       Encoding[Index].Small, Encoding[Index].Large);
+			Failed = 1;
+		}
+	}
+
+	printf("encoder: %u attributes %s\n", Index, Failed ? "FAIL" : "ok");
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Map page ranges one after the other and walk the table after each.
+*
+* @return	0 if every mapping walked as the model, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Test_Maps(void)
+{
+	u32 Section;
+	u32 Index;
+	int Failed = 0;
+
+	/* DDR, PL, a hole and the devices and OCM, as translation_table.S */
+	for (Section = 0U; Section < TEST_SECTIONS; Section++) {
+		if (Section < 0x400U) {
+			TestL1Table[Section] = (Section << 20) | NORM_WB_CACHE;
+		} else if (Section < 0xC00U) {
+			TestL1Table[Section] = (Section << 20) | STRONG_ORDERED;
+		} else if (Section < 0xE00U) {
+			TestL1Table[Section] = RESERVED;
+		} else if (Section < 0xFFFU) {
+			TestL1Table[Section] = (Section << 20) | DEVICE_MEMORY;
+		} else {
+			TestL1Table[Section] = (Section << 20) | NORM_WB_CACHE;
+		}
+		Test_ModelSet(Section << 20, ARM_AR_MEM_TTB_SECT_SIZE,
+			      TestL1Table[Section]);
+	}
+	Failed |= Test_Walk("initial");
+
+	/* An uncached DMA ring in the middle of cached buffers */
+	Failed |= Test_Map("dma ring", 0x00104000U, 0x1000U, NORM_NONCACHE,
+			   XST_SUCCESS);
+	if ((TestL1Table[1] & ARM_AR_MEM_DESC_TYPE_MASK) !=
+	    ARM_AR_MEM_DESC_COARSE) {
+		printf("dma ring: section not split\n");
+		Failed = 1;
+	} else if ((MmuL2Table[0][4] != 0x00104472U) ||
+		   (MmuL2Table[0][3] != 0x00103576U)) {
+		printf("dma ring: entries 0x%08X 0x%08X\n",
+		       MmuL2Table[0][3], MmuL2Table[0][4]);
+		Failed = 1;
+	}
+
+	/* 64 KB aligned: large pages, repeated in 16 entries */
+	Failed |= Test_Map("large pages", 0x00120000U, 0x20000U,
+			   DEVICE_MEMORY | EXECUTE_NEVER, XST_SUCCESS);
+	for (Index = 0x20U; Index < 0x30U; Index++) {
+		if (MmuL2Table[0][Index] != (0x00120000U | 0x8035U)) {
+			printf("large pages: entry 0x%02X is 0x%08X\n", Index,
+			       MmuL2Table[0][Index]);
+			Failed = 1;
+			break;
+		}
+	}
+
+	/* Small pages up to a 64 KB boundary, then a large page */
+	Failed |= Test_Map("mixed pages", 0x00141000U, 0x1F000U,
+			   STRONG_ORDERED, XST_SUCCESS);
+	if ((MmuL2Table[0][0x4F] & ARM_AR_MEM_DESC_TYPE_MASK) !=
+	    ARM_AR_MEM_DESC_SMALL_PAGE) {
+		printf("mixed pages: 0x0014F000 not a small page\n");
+		Failed = 1;
+	}
+	if ((MmuL2Table[0][0x50] & ARM_AR_MEM_DESC_TYPE_MASK) !=
+	    ARM_AR_MEM_DESC_LARGE_PAGE) {
+		printf("mixed pages: 0x00150000 not a large page\n");
+		Failed = 1;
+	}
+
+	/* Across a section boundary: two more tables */
+	Failed |= Test_Map("across sections", 0x002FF000U, 0x2000U,
+			   NORM_WT_CACHE, XST_SUCCESS);
+	if (Test_TablesUsed() != 3U) {
+		printf("across sections: %u tables in use\n",
+		       Test_TablesUsed());
+		Failed = 1;
+	}
+
+	/* In a hole: the rest of the section stays a fault */
+	Failed |= Test_Map("in a hole", 0xC0010000U, 0x3000U, DEVICE_MEMORY,
+			   XST_SUCCESS);
+
+	/* A whole section over a split one gives its table back */
+	Failed |= Test_Map("whole section", 0x00100000U, 0x100000U,
+			   NORM_WB_CACHE, XST_SUCCESS);
+	if (((TestL1Table[1] & ARM_AR_MEM_DESC_TYPE_MASK) !=
+	     ARM_AR_MEM_DESC_SECTION) || (Test_TablesUsed() != 3U)) {
+		printf("whole section: L1 0x%08X, %u tables in use\n",
+		       TestL1Table[1], Test_TablesUsed());
+		Failed = 1;
+	}
+
+	/* As Xil_SetTlbAttributes: the table of 0x002 is free again */
+	TestL1Table[2] = 0x00200000U | NORM_NONCACHE;
+	Test_ModelSet(0x00200000U, ARM_AR_MEM_TTB_SECT_SIZE, 0x00200000U |
+		      NORM_NONCACHE);
+	Failed |= Test_Walk("set section");
+
+	/* The last page of the address space */
+	Failed |= Test_Map("last page", 0xFFFFF000U, 0x1000U, NORM_NONCACHE,
+			   XST_SUCCESS);
+
+	/* Split sections until the tables run out */
+	for (Index = 0U; Index < XIL_MMU_L2_TABLES - 3U; Index++) {
+		Failed |= Test_Map("fill tables", 0x10000000U + (Index << 20),
+				   0x1000U, NORM_NONCACHE, XST_SUCCESS);
+	}
+	if (Test_TablesUsed() != XIL_MMU_L2_TABLES) {
+		printf("fill tables: %u tables in use\n", Test_TablesUsed());
+		Failed = 1;
+	}
+	Failed |= Test_Map("no table left", 0x20000000U, 0x1000U,
+			   NORM_NONCACHE, XST_FAILURE);
+
+	/* Pages of a section with a table need no new one */
+	Failed |= Test_Map("same section", 0x10000000U, 0x80000U,
+			   DEVICE_MEMORY, XST_SUCCESS);
+
+	/* Bad arguments change nothing */
+	Failed |= Test_Map("unaligned address", 0x00100800U, 0x1000U,
+			   NORM_NONCACHE, XST_INVALID_PARAM);
+	Failed |= Test_Map("unaligned size", 0x00100000U, 0x800U,
+			   NORM_NONCACHE, XST_INVALID_PARAM);
+	Failed |= Test_Map("no size", 0x00100000U, 0U, NORM_NONCACHE,
+			   XST_INVALID_PARAM);
+	Failed |= Test_Map("wrap", 0xFFFFF000U, 0x2000U, NORM_NONCACHE,
+			   XST_INVALID_PARAM);
+	Failed |= Test_Map("supersection", 0x00100000U, 0x1000U,
+			   NORM_NONCACHE | ARM_AR_MEM_SECT_SUPERSECTION,
+			   XST_INVALID_PARAM);
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Map a range with Xil_SetPageAttributes(), update the model if it should
+* succeed and walk the table.
+*
+* @param	Label names the step.
+* @param	Addr is the address of the range.
+* @param	Size is the size of the range.
+* @param	attrib is the section attribute.
+* @param	Expected is the status Xil_SetPageAttributes() should return.
+*
+* @return	0 if the status and the walk are right, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Test_Map(const char *Label, u32 Addr, u32 Size, u32 attrib,
+		s32 Expected)
+{
+	s32 Status;
+
+	Status = Xil_SetPageAttributes((INTPTR)Addr, Size, attrib);
+	if (Status != Expected) {
+		printf("%s: status %d, expected %d\n", Label, (int)Status,
+		       (int)Expected);
+		return 1;
+	}
+	if (Status == XST_SUCCESS) {
+		Test_ModelSet(Addr, Size, attrib);
+	}
+
+	return Test_Walk(Label);
+}
+
+/*****************************************************************************/
+/**
+* Translate every 4 KB page as the MMU does and compare the address and the
+* attributes with the model.
+*
+* @param	Label names the step.
+*
+* @return	0 if every page matched, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Test_Walk(const char *Label)
+{
+	u32 Page;
+	u32 Section;
+	u32 L1Desc;
+	u32 Desc;
+	u32 Attrib;
+	u32 Phys;
+	u32 *L2Table;
+	u32 First;
+
+	for (Page = 0U; Page < TEST_PAGES; Page++) {
+		Section = Page / ARM_AR_MEM_TTB_L2_ENTRIES;
+		L1Desc = TestL1Table[Section];
+		Attrib = 0U;
+		Phys = Page << 12;
+
+		if ((L1Desc & ARM_AR_MEM_DESC_TYPE_MASK) ==
+		    ARM_AR_MEM_DESC_SECTION) {
+			Attrib = L1Desc & TEST_ATTR_MASK;
+			Phys = (L1Desc & 0xFFF00000U) | ((Page << 12) & 0xFF000U);
+		} else if ((L1Desc & ARM_AR_MEM_DESC_TYPE_MASK) ==
+			   ARM_AR_MEM_DESC_COARSE) {
+			L2Table = Xil_MmuFindL2Table(Section);
+			if ((L2Table == NULL) || ((u32)(UINTPTR)L2Table !=
+			    (L1Desc & ~(ARM_AR_MEM_TTB_L2_ALIGN - 1U)))) {
+				printf("%s: section 0x%03X points to no table\n",
+				       Label, Section);
+				return 1;
+			}
+			Desc = L2Table[Page % ARM_AR_MEM_TTB_L2_ENTRIES];
+
+			if ((Desc & ARM_AR_MEM_DESC_SMALL_PAGE) != 0U) {
+				Attrib = ARM_AR_MEM_DESC_SECTION |
+					 (Desc & 0xCU) |
+					 ((Desc & 0x1U) << 4) |
+					 (((Desc >> 4) & 0x3U) << 10) |
+					 (((Desc >> 6) & 0x7U) << 12) |
+					 (((Desc >> 9) & 0x7U) << 15);
+				Phys = Desc & 0xFFFFF000U;
+			} else if ((Desc & ARM_AR_MEM_DESC_TYPE_MASK) ==
+				   ARM_AR_MEM_DESC_LARGE_PAGE) {
+				/* All 16 entries of a large page are the same */
+				First = (Page % ARM_AR_MEM_TTB_L2_ENTRIES) &
+					~(ARM_AR_MEM_LARGE_PAGE_ENTRIES - 1U);
+				if (memcmp(&L2Table[First], &L2Table[First + 1U],
+					   (ARM_AR_MEM_LARGE_PAGE_ENTRIES - 1U) *
+					   sizeof(u32)) != 0) {
+					printf("%s: large page 0x%08X not "
+					       "repeated\n", Label, Page << 12);
+					return 1;
+				}
+				Attrib = ARM_AR_MEM_DESC_SECTION |
+					 (Desc & 0xCU) |
+					 (((Desc >> 15) & 0x1U) << 4) |
+					 (((Desc >> 4) & 0x3U) << 10) |
+					 (((Desc >> 12) & 0x7U) << 12) |
+					 (((Desc >> 9) & 0x7U) << 15);
+				Phys = (Desc & 0xFFFF0000U) |
+				       ((Page << 12) & 0xF000U);
+			}
+			if (Attrib != 0U) {
+				Attrib |= (L1Desc & ARM_AR_MEM_SECT_DOMAIN_MASK) |
+					  (((L1Desc >> ARM_AR_MEM_COARSE_NS_SHIFT) &
+					    0x1U) << ARM_AR_MEM_SECT_NS_SHIFT);
+			}
+		}
+
+		if ((Attrib != Model[Page]) ||
+		    ((Attrib != 0U) && (Phys != (Page << 12)))) {
+			printf("%s: page 0x%08X maps 0x%08X as 0x%05X, "
+			       "expected 0x%05X\n", Label, Page << 12, Phys,
+			       Attrib, Model[Page]);
+			return 1;
+		}
+	}
+
+	printf("%s: ok, %u tables in use\n", Label, Test_TablesUsed());
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Count the second level tables in use by a split section.
+*
+* @return	Tables in use.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 Test_TablesUsed(void)
+{
+	u32 Index;
+	u32 Used = 0U;
+
+	for (Index = 0U; Index < XIL_MMU_L2_TABLES; Index++) {
+		if ((MmuL2Section[Index] != 0U) &&
+		    ((TestL1Table[MmuL2Section[Index] - 1U] &
+		      ARM_AR_MEM_DESC_TYPE_MASK) == ARM_AR_MEM_DESC_COARSE)) {
+			Used++;
+		}
+	}
+
+	return Used;
+}
+
+/*****************************************************************************/
+/**
+* Cache maintenance of xil_mmu.c, nothing to do on a host.
+*
+******************************************************************************/
+void Xil_DCacheFlush(void)
+{
+}
+
+void Xil_DCacheInvalidate(void)
+{
+}
+
+void Xil_ICacheInvalidate(void)
+{
+}
+
+/*****************************************************************************/
+/**
+* Set the expected attribute of a range of pages. The domain and NS bits of
+* a section that is split stay those of the section.
+*
+* @param	Addr is the address of the range.
+* @param	Size is the size of the range.
+* @param	attrib is the section attribute.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Test_ModelSet(u32 Addr, u32 Size, u32 attrib)
+{
+	u32 Page = Addr >> 12;
+	u32 Count = Size >> 12;
+	u32 Keep = 0U;
+	u32 L1Desc;
+
+	if (Count < ARM_AR_MEM_TTB_L2_ENTRIES) {
+		L1Desc = TestL1Table[Addr >> 20];
+		if ((L1Desc & ARM_AR_MEM_DESC_TYPE_MASK) ==
+		    ARM_AR_MEM_DESC_COARSE) {
+			Keep = (L1Desc & ARM_AR_MEM_SECT_DOMAIN_MASK) |
+			       (((L1Desc >> ARM_AR_MEM_COARSE_NS_SHIFT) & 0x1U) <<
+				ARM_AR_MEM_SECT_NS_SHIFT);
+			attrib = (attrib & ~(ARM_AR_MEM_SECT_DOMAIN_MASK |
+				  (0x1U << ARM_AR_MEM_SECT_NS_SHIFT))) | Keep;
+		}
+	}
+
+	while (Count-- > 0U) {
+		Model[Page++] = ((attrib & ARM_AR_MEM_DESC_SECTION) != 0U) ?
+				(attrib & TEST_ATTR_MASK) : 0U;
+	}
+}
@@ -0,0 +1,236 @@
+/*****************************************************************************/
+/**
+* @file msg_queue_test.c
+*
+* Host test of the lock-free queue between CPU0 and CPU1, msg_queue.c. The
+* queue is built here with the ARM barriers replaced by full host barriers,
+* and driven from two threads, one producer and one consumer, like the two
+* cores drive it. The consumer checks that every message arrives once, in
+* order and whole; the producer retries when the queue is full and the
+* test checks the dropped count against those retries. A single threaded
+* part checks the empty, full and wrap-around cases.
+*
+* Build and run from improved/:
+*   S=vitisProject/clk_div_scale_auto/clk_div/src
+*   B=vitisProject/clk_div_scale_auto/clk_div_wrapper/ps7_cortexa9_0/standalone_domain/bsp/ps7_cortexa9_0
+*   gcc -O2 -Wall -pthread -o msg_queue_test tools/msg_queue_test.c \
+*       -iquote $S -I$B/include
+*   ./msg_queue_test
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include "xil_types.h"
+#include "xpseudo_asm.h"
+
+/*
+ * msg_queue.c on a host: the two threads stand for the two cores
+ */
+#undef dmb
+#define dmb()	__sync_synchronize()
+
+#include "msg_queue.c"
+
+/************************** Constant Definitions ****************************/
+
+#define TEST_MESSAGES		2000000U
+
+/************************** Function Prototypes *****************************/
+
+static int Test_Single(void);
+static int Test_Threads(void);
+static void *Test_Producer(void *Arg);
+static void *Test_Consumer(void *Arg);
+static void Test_Fill(MsgQueue_Msg *Msg, u32 Sequence);
+
+/************************** Variable Definitions *****************************/
+
+static MsgQueue TestQueue;
+static u32 TestRetries;
+static u32 TestErrors;
+
+/*****************************************************************************/
+
+int main(void)
+{
+	int Failed = 0;
+
+	Failed |= Test_Single();
+	Failed |= Test_Threads();
+
+	printf("%s\n", Failed ? "FAIL" : "pass");
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Empty, full and wrap-around, from one thread. The indexes start just
+* below 2^32 so they wrap during the test.
+*
+******************************************************************************/
+static int Test_Single(void)
+{
+	MsgQueue_Msg Msg;
+	u32 Round;
+	u32 Index;
+	int Failed = 0;
+
+	MsgQueue_Init(&TestQueue);
+	TestQueue.Head = 0xFFFFFFF0U;
+	TestQueue.Tail = 0xFFFFFFF0U;
+
+	if (MsgQueue_Pop(&TestQueue, &Msg) != 0) {
+		printf("single: popped from an empty queue\n");
+		Failed = 1;
+	}
+
+	for (Round = 0U; Round < 3U; Round++) {
+		for (Index = 0U; Index < MSG_QUEUE_DEPTH; Index++) {
+			Test_Fill(&Msg, (Round << 16) | Index);
+			if (MsgQueue_Push(&TestQueue, &Msg) != XST_SUCCESS) {
+				printf("single: push %u refused\n", Index);
+				Failed = 1;
+			}
+		}
+		if ((MsgQueue_Count(&TestQueue) != MSG_QUEUE_DEPTH) ||
+		    (MsgQueue_Push(&TestQueue, &Msg) != XST_FAILURE)) {
+			printf("single: full queue took a message\n");
+			Failed = 1;
+		}
+		for (Index = 0U; Index < MSG_QUEUE_DEPTH; Index++) {
+			if ((MsgQueue_Pop(&TestQueue, &Msg) == 0) ||
+			    (Msg.Type != ((Round << 16) | Index))) {
+				printf("single: pop %u wrong\n", Index);
+				Failed = 1;
+			}
+		}
+		if (MsgQueue_Pop(&TestQueue, &Msg) != 0) {
+			printf("single: popped past the end\n");
+			Failed = 1;
+		}
+	}
+
+	if (TestQueue.Dropped != 3U) {
+		printf("single: %u dropped\n", TestQueue.Dropped);
+		Failed = 1;
+	}
+
+	if (Failed == 0) {
+		printf("single: ok\n");
+	}
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* One producer and one consumer thread.
+*
+******************************************************************************/
+static int Test_Threads(void)
+{
+	pthread_t Producer;
+	pthread_t Consumer;
+
+	MsgQueue_Init(&TestQueue);
+	TestRetries = 0U;
+	TestErrors = 0U;
+
+	pthread_create(&Consumer, NULL, Test_Consumer, NULL);
+	pthread_create(&Producer, NULL, Test_Producer, NULL);
+	pthread_join(Producer, NULL);
+	pthread_join(Consumer, NULL);
+
+	if ((TestErrors != 0U) || (TestQueue.Dropped != TestRetries)) {
+		printf("threads: %u errors, %u dropped, %u retries\n",
+		       TestErrors, TestQueue.Dropped, TestRetries);
+		return 1;
+	}
+
+	printf("threads: ok, %u messages, %u times full\n", TEST_MESSAGES,
+	       TestRetries);
+
+	return 0;
+}
+
+static void *Test_Producer(void *Arg)
+{
+	MsgQueue_Msg Msg;
+	u32 Sequence;
+
+	(void)Arg;
+
+	for (Sequence = 0U; Sequence < TEST_MESSAGES; Sequence++) {
+		Test_Fill(&Msg, Sequence);
+		while (MsgQueue_Push(&TestQueue, &Msg) != XST_SUCCESS) {
+			TestRetries++;
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+static void *Test_Consumer(void *Arg)
+{
+	MsgQueue_Msg Msg;
+	MsgQueue_Msg Expected;
+	u32 Sequence = 0U;
+	u32 Index;
+
+	(void)Arg;
+
+	while (Sequence < TEST_MESSAGES) {
+		if (MsgQueue_Pop(&TestQueue, &Msg) == 0) {
+			/* WFE on CPU1 */
+			sched_yield();
+			continue;
+		}
+		Test_Fill(&Expected, Sequence);
+		for (Index = 0U; Index < MSG_QUEUE_ARGS; Index++) {
+			if (Msg.Arg[Index] != Expected.Arg[Index]) {
+				break;
+			}
+		}
+		if ((Msg.Type != Expected.Type) ||
+		    (Index != MSG_QUEUE_ARGS)) {
+			if (TestErrors < 10U) {
+				printf("threads: message %u is %u\n",
+				       Sequence, Msg.Type);
+			}
+			TestErrors++;
+		}
+		Sequence++;
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************/
+/**
+* Message number Sequence: every word derived from the sequence number, so
+* a torn message shows.
+*
+******************************************************************************/
+static void Test_Fill(MsgQueue_Msg *Msg, u32 Sequence)
+{
+	u32 Index;
+
+	Msg->Type = Sequence;
+	for (Index = 0U; Index < MSG_QUEUE_ARGS; Index++) {
+		Msg->Arg[Index] = (Sequence * 2654435761U) + Index;
+	}
+}
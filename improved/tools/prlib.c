@@ -0,0 +1,523 @@
+/*****************************************************************************/
+/**
+* @file prlib.c
+*
+* Host tool that packs the partial bitstreams of the divisor engine
+* variants into the library loaded by pr_engine.c, in the format of
+* pr_engine.h. Each variant is given as num_win,threshold,partial.bin, the
+* generics it was built with and its partial bitstream. A .bin from
+* write_bitstream -bin_file is in configuration word order and is swapped
+* to the word order of the PCAP; one from bootgen -process_bitstream bin is
+* already in it. Add the library to the boot image as a data partition
+* loaded to CLK_DIV_PR_LIB_ADDR.
+*
+* With -l, the variants of a library are listed and checked as
+* PrEngine_Init() checks them.
+*
+* With -t, the self test: bitstreams in both word orders are packed, the
+* library checked and every variant compared with its bitstream, and files
+* without a sync word or of odd length rejected.
+*
+* Build and run from improved/:
+*   gcc -O2 -Wall -o prlib tools/prlib.c \
+*       -IvitisProject/clk_div_scale_auto/clk_div/src \
+*       -IvitisProject/clk_div_scale_auto/clk_div_wrapper/ps7_cortexa9_0/standalone_domain/bsp/ps7_cortexa9_0/include
+*   ./prlib lib.bin num_win,threshold,partial.bin...
+*   ./prlib -l lib.bin
+*   ./prlib -t
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pr_engine.h"
+
+/************************** Constant Definitions ****************************/
+
+#define LIB_SYNC_WORD		0xAA995566U	/* PCAP word order */
+#define LIB_SYNC_WORD_SWAPPED	0x665599AAU	/* Configuration word order */
+#define LIB_SYNC_SEARCH		256U		/* Bytes searched for it */
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u8 *Data;
+	u32 Length;
+} LibBuffer;
+
+/************************** Function Prototypes *****************************/
+
+static int Lib_Pack(LibBuffer *Lib, int Count, char *Args[]);
+static int Lib_AddVariant(LibBuffer *Lib, u32 NumWin, u32 Threshold,
+		LibBuffer *Bitstream);
+static int Lib_WordOrder(LibBuffer *Bitstream);
+static int Lib_Check(const LibBuffer *Lib, int Quiet);
+static int Lib_Test(void);
+static void Lib_MakeBitstream(LibBuffer *Bitstream, u32 Words, u32 Seed,
+		int Swapped);
+static int Lib_ReadFile(const char *Name, LibBuffer *Buffer);
+static int Lib_WriteFile(const char *Name, const LibBuffer *Buffer);
+static u32 Lib_Get32(const u8 *Data, u32 Offset);
+static void Lib_Put32(u8 *Data, u32 Offset, u32 Value);
+
+/*****************************************************************************/
+/**
+* Pack a variant library, list one with -l, or run the self test with -t.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+int main(int argc, char *argv[])
+{
+	LibBuffer Lib;
+
+	if ((argc == 2) && (strcmp(argv[1], "-t") == 0)) {
+		return Lib_Test();
+	}
+	if ((argc == 3) && (strcmp(argv[1], "-l") == 0)) {
+		if (Lib_ReadFile(argv[2], &Lib) != 0) {
+			return 1;
+		}
+		return Lib_Check(&Lib, 0);
+	}
+	if ((argc < 3) || (argv[1][0] == '-') ||
+	    ((argc - 2) > (int)PR_ENGINE_MAX_VARIANTS)) {
+		fprintf(stderr, "usage: %s lib.bin num_win,threshold,partial.bin"
+			"...\n       %s -l lib.bin\n       %s -t\n",
+			argv[0], argv[0], argv[0]);
+		return 1;
+	}
+
+	if ((Lib_Pack(&Lib, argc - 2, &argv[2]) != 0) ||
+	    (Lib_Check(&Lib, 0) != 0) ||
+	    (Lib_WriteFile(argv[1], &Lib) != 0)) {
+		return 1;
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Pack the variants given on the command line.
+*
+* @param	Lib is set to the library.
+* @param	Count is the number of variants.
+* @param	Args are the variants, num_win,threshold,partial.bin.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Lib_Pack(LibBuffer *Lib, int Count, char *Args[])
+{
+	LibBuffer Bitstream;
+	u32 NumWin;
+	u32 Threshold = 0U;
+	char *Next;
+	int Index;
+
+	Lib->Length = sizeof(PrEngine_Lib);
+	Lib->Data = calloc(1U, Lib->Length);
+	if (Lib->Data == NULL) {
+		return 1;
+	}
+
+	for (Index = 0; Index < Count; Index++) {
+		NumWin = (u32)strtoul(Args[Index], &Next, 0);
+		if (*Next == ',') {
+			Threshold = (u32)strtoul(Next + 1, &Next, 0);
+		}
+		if ((*Next != ',') || (NumWin == 0U)) {
+			fprintf(stderr, "prlib: bad variant %s\n", Args[Index]);
+			return 1;
+		}
+		if ((Lib_ReadFile(Next + 1, &Bitstream) != 0) ||
+		    (Lib_WordOrder(&Bitstream) != 0)) {
+			fprintf(stderr, "prlib: %s is not a partial bitstream\n",
+				Next + 1);
+			return 1;
+		}
+		if (Lib_AddVariant(Lib, NumWin, Threshold, &Bitstream) != 0) {
+			return 1;
+		}
+		free(Bitstream.Data);
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Append a variant to a library.
+*
+* @param	Lib is the library, grown by the bitstream.
+* @param	NumWin is the NUM_WIN generic of the variant.
+* @param	Threshold is the THRESHOLD generic of the variant.
+* @param	Bitstream is the partial bitstream in PCAP word order.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Lib_AddVariant(LibBuffer *Lib, u32 NumWin, u32 Threshold,
+		LibBuffer *Bitstream)
+{
+	PrEngine_Lib Header;
+	PrEngine_Variant *VariantPtr;
+	u32 Offset;
+	u8 *Data;
+
+	(void)memcpy(&Header, Lib->Data, sizeof(Header));
+	if (Header.Count >= PR_ENGINE_MAX_VARIANTS) {
+		return 1;
+	}
+
+	Offset = (Lib->Length + PR_ENGINE_ALIGN - 1U) & ~(PR_ENGINE_ALIGN - 1U);
+	Data = realloc(Lib->Data, Offset + Bitstream->Length);
+	if (Data == NULL) {
+		return 1;
+	}
+	(void)memset(&Data[Lib->Length], 0, Offset - Lib->Length);
+	(void)memcpy(&Data[Offset], Bitstream->Data, Bitstream->Length);
+	Lib->Data = Data;
+	Lib->Length = Offset + Bitstream->Length;
+
+	VariantPtr = &Header.Variant[Header.Count];
+	VariantPtr->Offset = Offset;
+	VariantPtr->Length = Bitstream->Length;
+	VariantPtr->NumWin = NumWin;
+	VariantPtr->Threshold = Threshold;
+	Header.Magic = PR_ENGINE_LIB_MAGIC;
+	Header.Count++;
+	Header.Length = Lib->Length;
+	(void)memcpy(Lib->Data, &Header, sizeof(Header));
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Bring a partial bitstream into the word order of the PCAP.
+*
+* @param	Bitstream is the bitstream, swapped in place if needed.
+*
+* @return	0 on success, 1 if it has no sync word or an odd length.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Lib_WordOrder(LibBuffer *Bitstream)
+{
+	u32 Offset;
+	u32 Word;
+
+	if ((Bitstream->Length == 0U) || ((Bitstream->Length & 0x3U) != 0U)) {
+		return 1;
+	}
+
+	for (Offset = 0U; (Offset < LIB_SYNC_SEARCH) &&
+	     (Offset < Bitstream->Length); Offset += 4U) {
+		Word = Lib_Get32(Bitstream->Data, Offset);
+		if (Word == LIB_SYNC_WORD) {
+			return 0;
+		}
+		if (Word == LIB_SYNC_WORD_SWAPPED) {
+			break;
+		}
+	}
+	if ((Offset >= LIB_SYNC_SEARCH) || (Offset >= Bitstream->Length)) {
+		return 1;
+	}
+
+	for (Offset = 0U; Offset < Bitstream->Length; Offset += 4U) {
+		Word = Lib_Get32(Bitstream->Data, Offset);
+		Lib_Put32(Bitstream->Data, Offset,
+			  (Word >> 24) | ((Word >> 8) & 0xFF00U) |
+			  ((Word << 8) & 0xFF0000U) | (Word << 24));
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Check a library as PrEngine_Init() does and list its variants.
+*
+* @param	Lib is the library.
+* @param	Quiet suppresses the listing and the messages.
+*
+* @return	0 if the library is valid, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Lib_Check(const LibBuffer *Lib, int Quiet)
+{
+	PrEngine_Lib Header;
+	const PrEngine_Variant *VariantPtr;
+	u32 Index;
+
+	if (Lib->Length < sizeof(Header)) {
+		if (!Quiet) {
+			fprintf(stderr, "prlib: not a variant library\n");
+		}
+		return 1;
+	}
+	(void)memcpy(&Header, Lib->Data, sizeof(Header));
+	if ((Header.Magic != PR_ENGINE_LIB_MAGIC) || (Header.Count == 0U) ||
+	    (Header.Count > PR_ENGINE_MAX_VARIANTS) ||
+	    (Header.Length != Lib->Length)) {
+		if (!Quiet) {
+			fprintf(stderr, "prlib: not a variant library\n");
+		}
+		return 1;
+	}
+
+	for (Index = 0U; Index < Header.Count; Index++) {
+		VariantPtr = &Header.Variant[Index];
+		if ((VariantPtr->Offset < sizeof(Header)) ||
+		    ((VariantPtr->Offset % PR_ENGINE_ALIGN) != 0U) ||
+		    (VariantPtr->Length == 0U) ||
+		    ((VariantPtr->Length & 0x3U) != 0U) ||
+		    (VariantPtr->Offset > Header.Length) ||
+		    (VariantPtr->Length > (Header.Length - VariantPtr->Offset)) ||
+		    (VariantPtr->NumWin == 0U)) {
+			if (!Quiet) {
+				fprintf(stderr, "prlib: variant %u not "
+					"valid\n", (unsigned)Index);
+			}
+			return 1;
+		}
+		if (!Quiet) {
+			printf("v%u  NUM_WIN %u  THRESHOLD %u  offset 0x%06x  "
+			       "%u bytes\n", (unsigned)Index,
+			       (unsigned)VariantPtr->NumWin,
+			       (unsigned)VariantPtr->Threshold,
+			       (unsigned)VariantPtr->Offset,
+			       (unsigned)VariantPtr->Length);
+		}
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Self test of the packing.
+*
+* @return	0 if all passed, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Lib_Test(void)
+{
+	static const u32 Words[] = { 1000U, 333U, 4096U };
+	LibBuffer Lib;
+	LibBuffer Bitstream[3];
+	LibBuffer Expected;
+	PrEngine_Lib Header;
+	u32 Index;
+	int Failed = 0;
+
+	Lib.Length = sizeof(PrEngine_Lib);
+	Lib.Data = calloc(1U, Lib.Length);
+	if (Lib.Data == NULL) {
+		return 1;
+	}
+
+	for (Index = 0U; Index < 3U; Index++) {
+		Lib_MakeBitstream(&Bitstream[Index], Words[Index], Index,
+				  (int)(Index & 1U));
+		if ((Lib_WordOrder(&Bitstream[Index]) != 0) ||
+		    (Lib_AddVariant(&Lib, 8U << Index, 16U + Index,
+				    &Bitstream[Index]) != 0)) {
+			printf("variant %u not packed\n", (unsigned)Index);
+			Failed = 1;
+		}
+	}
+	Failed |= Lib_Check(&Lib, 1);
+
+	/* Every variant in PCAP word order, whatever order it came in */
+	(void)memcpy(&Header, Lib.Data, sizeof(Header));
+	for (Index = 0U; Index < Header.Count; Index++) {
+		Lib_MakeBitstream(&Expected, Words[Index], Index, 0);
+		if ((Header.Variant[Index].Length != Expected.Length) ||
+		    (memcmp(&Lib.Data[Header.Variant[Index].Offset],
+			    Expected.Data, Expected.Length) != 0) ||
+		    (Header.Variant[Index].NumWin != (8U << Index))) {
+			printf("variant %u differs\n", (unsigned)Index);
+			Failed = 1;
+		}
+		free(Expected.Data);
+		free(Bitstream[Index].Data);
+	}
+
+	/* No sync word, odd length */
+	Lib_MakeBitstream(&Expected, 100U, 7U, 0);
+	(void)memset(Expected.Data, 0xFF, LIB_SYNC_SEARCH);
+	if (Lib_WordOrder(&Expected) == 0) {
+		printf("bitstream without sync word packed\n");
+		Failed = 1;
+	}
+	Lib_MakeBitstream(&Expected, 100U, 7U, 0);
+	Expected.Length -= 2U;
+	if (Lib_WordOrder(&Expected) == 0) {
+		printf("bitstream of odd length packed\n");
+		Failed = 1;
+	}
+	free(Expected.Data);
+
+	/* A corrupt header is found */
+	Lib_Put32(Lib.Data, (u32)offsetof(PrEngine_Lib, Variant[1].Length),
+		  0x7FFFFFFFU);
+	if (Lib_Check(&Lib, 1) == 0) {
+		printf("corrupt library passed\n");
+		Failed = 1;
+	}
+	free(Lib.Data);
+
+	printf("%s\n", Failed ? "FAIL" : "pass");
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Make a partial bitstream for the self test: dummy words, the sync word
+* and data words.
+*
+* @param	Bitstream is set to the bitstream.
+* @param	Words is its length in words.
+* @param	Seed varies the data words.
+* @param	Swapped selects configuration word order instead of PCAP.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Lib_MakeBitstream(LibBuffer *Bitstream, u32 Words, u32 Seed,
+		int Swapped)
+{
+	u32 Index;
+	u32 Word;
+
+	Bitstream->Length = Words * 4U;
+	Bitstream->Data = malloc(Bitstream->Length);
+	if (Bitstream->Data == NULL) {
+		exit(1);
+	}
+
+	for (Index = 0U; Index < Words; Index++) {
+		if (Index < 8U) {
+			Word = 0xFFFFFFFFU;
+		} else if (Index == 8U) {
+			Word = LIB_SYNC_WORD;
+		} else {
+			Word = (Index * 2654435761U) ^ Seed;
+		}
+		if (Swapped) {
+			Word = (Word >> 24) | ((Word >> 8) & 0xFF00U) |
+			       ((Word << 8) & 0xFF0000U) | (Word << 24);
+		}
+		Lib_Put32(Bitstream->Data, Index * 4U, Word);
+	}
+}
+
+/*****************************************************************************/
+/**
+* Read a file.
+*
+* @param	Name is the file name.
+* @param	Buffer is set to the contents.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Lib_ReadFile(const char *Name, LibBuffer *Buffer)
+{
+	FILE *File = fopen(Name, "rb");
+	long Size;
+
+	if ((File == NULL) || (fseek(File, 0, SEEK_END) != 0) ||
+	    ((Size = ftell(File)) <= 0) || (fseek(File, 0, SEEK_SET) != 0)) {
+		perror(Name);
+		return 1;
+	}
+
+	Buffer->Length = (u32)Size;
+	Buffer->Data = malloc(Buffer->Length + 4U);
+	if ((Buffer->Data == NULL) ||
+	    (fread(Buffer->Data, 1U, Buffer->Length, File) != Buffer->Length)) {
+		perror(Name);
+		return 1;
+	}
+	(void)fclose(File);
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Write a file.
+*
+* @param	Name is the file name.
+* @param	Buffer is the contents.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Lib_WriteFile(const char *Name, const LibBuffer *Buffer)
+{
+	FILE *File = fopen(Name, "wb");
+
+	if ((File == NULL) ||
+	    (fwrite(Buffer->Data, 1U, Buffer->Length, File) != Buffer->Length) ||
+	    (fclose(File) != 0)) {
+		perror(Name);
+		return 1;
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/*
+ * Little-endian words, as the Zynq reads them
+ */
+
+static u32 Lib_Get32(const u8 *Data, u32 Offset)
+{
+	return (u32)Data[Offset] | ((u32)Data[Offset + 1U] << 8) |
+	       ((u32)Data[Offset + 2U] << 16) | ((u32)Data[Offset + 3U] << 24);
+}
+
+static void Lib_Put32(u8 *Data, u32 Offset, u32 Value)
+{
+	Data[Offset] = (u8)Value;
+	Data[Offset + 1U] = (u8)(Value >> 8);
+	Data[Offset + 2U] = (u8)(Value >> 16);
+	Data[Offset + 3U] = (u8)(Value >> 24);
+}
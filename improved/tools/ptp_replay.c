@@ -0,0 +1,387 @@
+/*****************************************************************************/
+/**
+* @file ptp_replay.c
+*
+* Host replay of the PTP reference servos. Reads a timestamp trace, runs it
+* through the same ptp_servo.c as the target, with the TSU and pps_gen
+* corrections of ptp_ref.c simulated, and prints the offset and frequency
+* correction of both loops per sample. Then checks that each loop locked
+* in time and that its residual offset is small.
+*
+* Trace records, one per line; other lines are ignored, so a whole console
+* capture can be fed in:
+*   sync,<t1>,<t2>	Sync origin time (master), receive time (slave)
+*   delay,<t3>,<t4>	Delay_req send time (slave), receive time (master)
+*   pps,<edge>		pps_gen edge (slave), pps_gen at its nominal period
+* Times are in ns, records in time order. Slave times are those of the free
+* running TSU, without the corrections of the servo, which the replay
+* applies itself. tools/ptp_trace.csv is a synthetic trace of ten minutes:
+* TSU 25 ppm fast and 1.23 ms ahead, 5 us path delay, sys_clk 12 ppm fast,
+* pps_gen 300 ms late and 40 ns of timestamp noise.
+*
+* Build and run from improved/:
+*   gcc -O2 -Wall -o ptp_replay tools/ptp_replay.c \
+*       vitisProject/clk_div_scale_auto/clk_div/src/ptp_servo.c \
+*       -IvitisProject/clk_div_scale_auto/clk_div/src \
+*       -IvitisProject/clk_div_scale_auto/clk_div_wrapper/ps7_cortexa9_0/standalone_domain/bsp/ps7_cortexa9_0/include \
+*       -lm
+*   ./ptp_replay < tools/ptp_trace.csv > replay.csv
+*
+* The pass criteria can be changed on the command line:
+*   ./ptp_replay lock_ns max_lock_s max_rms_ns
+* A loop is locked from the sample after which its offset stays within
+* lock_ns to the end of the trace.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "clk_div_pl.h"
+#include "ptp_ref.h"
+
+/************************** Constant Definitions ****************************/
+
+#define REPLAY_LOCK_NS		1000.0	/* Offset bound of a locked loop */
+#define REPLAY_MAX_LOCK_S	60.0	/* Latest lock that passes */
+#define REPLAY_MAX_RMS_NS	200.0	/* Largest residual that passes */
+#define REPLAY_MIN_LOCKED	10U	/* Locked samples needed for a verdict */
+#define REPLAY_LINE_MAX		256
+
+/**************************** Type Definitions ******************************/
+
+/* Lock of one loop, from its trailing run of samples within the bound */
+typedef struct {
+	const char *Name;
+	u32 Samples;
+	double FirstS;		/* Time of the first sample */
+	double LockS;		/* Time of the first sample of the run */
+	u32 Locked;		/* Samples in the run */
+	double SumSq;		/* Of the offsets in the run */
+	double MaxAbs;
+} Replay_Loop;
+
+/************************** Function Prototypes *****************************/
+
+static void Replay_Sync(s64 MasterTxNs, s64 RawRxNs);
+static void Replay_Delay(s64 RawTxNs, s64 MasterRxNs);
+static void Replay_Pps(s64 FreeEdgeNs);
+static void Replay_Check(Replay_Loop *LoopPtr, PtpServo_State State,
+			 s64 OffsetNs, double TimeS);
+static int Replay_Verdict(const Replay_Loop *LoopPtr, double MaxLockS,
+			  double MaxRmsNs);
+
+/************************** Variable Definitions **************************/
+
+static PtpServo TsuServo;
+static PtpServo PpsServo;
+static double LockNs = REPLAY_LOCK_NS;
+
+/* TSU loop, as in PtpRef_SyncReceived() */
+static s64 TsuCorrNs;		/* Added to the free running TSU */
+static s64 LastMasterTxNs;
+static s64 LastSlaveRxNs;
+static s64 PathDelayNs;
+static u32 PathDelayValid;
+
+/* pps_gen loop, as in PtpRef_PpsHandler() */
+static const u32 NominalPeriod = CLK_DIV_SYS_CLK_HZ;
+static u32 Period = CLK_DIV_SYS_CLK_HZ;
+static s32 Step;
+static double PeriodFrac;
+static double PpsEdgeNs;	/* Simulated edge, free running TSU time */
+static s64 LastFreeEdgeNs;
+static u32 PpsCount;
+
+static Replay_Loop TsuLoop = { "tsu", 0U, 0.0, 0.0, 0U, 0.0, 0.0 };
+static Replay_Loop PpsLoop = { "pps", 0U, 0.0, 0.0, 0U, 0.0, 0.0 };
+
+/*****************************************************************************/
+/**
+* Replay a trace from stdin.
+*
+* @return	0 if every loop with samples locked within max_lock_s and its
+*		residual is within max_rms_ns, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+int main(int argc, char *argv[])
+{
+	char Line[REPLAY_LINE_MAX];
+	long long A;
+	long long B;
+	double MaxLockS = REPLAY_MAX_LOCK_S;
+	double MaxRmsNs = REPLAY_MAX_RMS_NS;
+	int Fail;
+
+	if (argc > 3) {
+		LockNs = atof(argv[1]);
+		MaxLockS = atof(argv[2]);
+		MaxRmsNs = atof(argv[3]);
+	}
+
+	PtpServo_Init(&TsuServo, PTP_REF_TSU_KP, PTP_REF_TSU_KI,
+		      PTP_REF_TSU_MAX_PPB, PTP_REF_TSU_STEP_NS);
+	PtpServo_Init(&PpsServo, PTP_REF_PPS_KP, PTP_REF_PPS_KI,
+		      PTP_REF_PPS_MAX_PPB, PTP_REF_PPS_STEP_NS);
+
+	printf("loop,time_s,offset_ns,freq_ppb,state\n");
+
+	while (fgets(Line, sizeof(Line), stdin) != NULL) {
+		if (sscanf(Line, "sync,%lld,%lld", &A, &B) == 2) {
+			Replay_Sync((s64)A, (s64)B);
+		} else if (sscanf(Line, "delay,%lld,%lld", &A, &B) == 2) {
+			Replay_Delay((s64)A, (s64)B);
+		} else if (sscanf(Line, "pps,%lld", &A) == 1) {
+			Replay_Pps((s64)A);
+		}
+	}
+
+	Fail = Replay_Verdict(&TsuLoop, MaxLockS, MaxRmsNs);
+	if (PpsLoop.Samples != 0U) {
+		Fail |= Replay_Verdict(&PpsLoop, MaxLockS, MaxRmsNs);
+	}
+
+	return Fail;
+}
+
+/*****************************************************************************/
+/**
+* Sync record: run the TSU servo and correct the simulated TSU.
+*
+* @param	MasterTxNs is t1.
+* @param	RawRxNs is t2 on the free running TSU.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Replay_Sync(s64 MasterTxNs, s64 RawRxNs)
+{
+	PtpServo_State State;
+	s64 SlaveRxNs = RawRxNs + TsuCorrNs;
+	s64 OffsetNs;
+	double IntervalS;
+	double FreqPpb;
+
+	OffsetNs = PtpServo_Offset(MasterTxNs, SlaveRxNs,
+				   (PathDelayValid != 0U) ? PathDelayNs : 0);
+
+	if ((LastSlaveRxNs != 0) && (SlaveRxNs > LastSlaveRxNs)) {
+		IntervalS = (double)(SlaveRxNs - LastSlaveRxNs) /
+				(double)PTP_SERVO_NS_PER_SEC;
+	} else {
+		IntervalS = 1.0;
+	}
+	LastMasterTxNs = MasterTxNs;
+	LastSlaveRxNs = SlaveRxNs;
+
+	State = PtpServo_Sample(&TsuServo, OffsetNs, IntervalS, &FreqPpb);
+
+	if (State == PTP_SERVO_JUMP) {
+		TsuCorrNs += (s64)(FreqPpb * IntervalS) - OffsetNs;
+		LastSlaveRxNs = 0;
+	} else if (State == PTP_SERVO_LOCKED) {
+		/* Frequency applied as one interval's worth of phase */
+		TsuCorrNs += (s64)(FreqPpb * IntervalS);
+	}
+
+	Replay_Check(&TsuLoop, State, OffsetNs,
+		     (double)MasterTxNs / (double)PTP_SERVO_NS_PER_SEC);
+	printf("tsu,%.3f,%lld,%.1f,%d\n",
+	       (double)MasterTxNs / (double)PTP_SERVO_NS_PER_SEC,
+	       (long long)OffsetNs, FreqPpb, (int)State);
+}
+
+/*****************************************************************************/
+/**
+* Delay record: update the mean path delay.
+*
+* @param	RawTxNs is t3 on the free running TSU.
+* @param	MasterRxNs is t4.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Replay_Delay(s64 RawTxNs, s64 MasterRxNs)
+{
+	s64 DelayNs;
+
+	if (LastSlaveRxNs == 0) {
+		return;
+	}
+
+	DelayNs = PtpServo_PathDelay(LastMasterTxNs, LastSlaveRxNs,
+				     RawTxNs + TsuCorrNs, MasterRxNs);
+	if (DelayNs < 0) {
+		return;
+	}
+
+	if (PathDelayValid == 0U) {
+		PathDelayNs = DelayNs;
+		PathDelayValid = 1U;
+	} else {
+		PathDelayNs += (DelayNs - PathDelayNs) / 8;
+	}
+}
+
+/*****************************************************************************/
+/**
+* pps record: move the simulated pps_gen edge by the period and step last
+* written, measure its phase on the corrected TSU and run the pps servo.
+*
+* @param	FreeEdgeNs is the edge of pps_gen at its nominal period, on the
+*		free running TSU.
+*
+* @return	None.
+*
+* @note		The interval between free running edges is scaled by the
+*		period written, so the trace carries the wander of sys_clk.
+*
+******************************************************************************/
+static void Replay_Pps(s64 FreeEdgeNs)
+{
+	PtpServo_State State;
+	s64 EdgeNs;
+	s64 PhaseNs;
+	s64 OffsetNs;
+	double FreqPpb;
+	double PeriodF;
+
+	if (PpsCount == 0U) {
+		PpsEdgeNs = (double)FreeEdgeNs;
+	} else {
+		PpsEdgeNs += (double)(FreeEdgeNs - LastFreeEdgeNs) *
+				((double)Period + (double)Step) /
+				(double)NominalPeriod;
+	}
+	LastFreeEdgeNs = FreeEdgeNs;
+	PpsCount++;
+	/* pps_gen applies a step once */
+	Step = 0;
+
+	if (TsuServo.State != PTP_SERVO_LOCKED) {
+		return;
+	}
+
+	EdgeNs = (s64)PpsEdgeNs + TsuCorrNs - PTP_REF_PPS_LATENCY_NS;
+	PhaseNs = EdgeNs % PTP_SERVO_NS_PER_SEC;
+	if (PhaseNs > (PTP_SERVO_NS_PER_SEC / 2)) {
+		PhaseNs -= PTP_SERVO_NS_PER_SEC;
+	}
+	OffsetNs = -PhaseNs;
+
+	State = PtpServo_Sample(&PpsServo, OffsetNs, 1.0, &FreqPpb);
+
+	if (State == PTP_SERVO_JUMP) {
+		Step = (s32)((OffsetNs * (s64)NominalPeriod) /
+			     PTP_SERVO_NS_PER_SEC);
+		if (Step > CLK_DIV_PPS_GEN_STEP_MAX) {
+			Step = CLK_DIV_PPS_GEN_STEP_MAX;
+		} else if (Step < -CLK_DIV_PPS_GEN_STEP_MAX) {
+			Step = -CLK_DIV_PPS_GEN_STEP_MAX;
+		}
+	}
+
+	PeriodF = ((double)NominalPeriod * (1.0 - (FreqPpb * 1e-9))) +
+			PeriodFrac;
+	Period = (u32)PeriodF;
+	PeriodFrac = PeriodF - (double)Period;
+
+	Replay_Check(&PpsLoop, State, OffsetNs,
+		     (double)EdgeNs / (double)PTP_SERVO_NS_PER_SEC);
+	printf("pps,%.3f,%lld,%.1f,%d\n",
+	       (double)EdgeNs / (double)PTP_SERVO_NS_PER_SEC,
+	       (long long)OffsetNs, FreqPpb, (int)State);
+}
+
+/*****************************************************************************/
+/**
+* Track the trailing run of locked samples of a loop.
+*
+* @param	LoopPtr is the loop.
+* @param	State is the servo state after the sample.
+* @param	OffsetNs is the offset of the sample.
+* @param	TimeS is the time of the sample.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Replay_Check(Replay_Loop *LoopPtr, PtpServo_State State,
+			 s64 OffsetNs, double TimeS)
+{
+	double Abs = fabs((double)OffsetNs);
+
+	if (LoopPtr->Samples == 0U) {
+		LoopPtr->FirstS = TimeS;
+	}
+	LoopPtr->Samples++;
+
+	if ((State != PTP_SERVO_LOCKED) || (Abs > LockNs)) {
+		LoopPtr->Locked = 0U;
+		return;
+	}
+
+	if (LoopPtr->Locked == 0U) {
+		LoopPtr->LockS = TimeS;
+		LoopPtr->SumSq = 0.0;
+		LoopPtr->MaxAbs = 0.0;
+	}
+	LoopPtr->Locked++;
+	LoopPtr->SumSq += Abs * Abs;
+	if (Abs > LoopPtr->MaxAbs) {
+		LoopPtr->MaxAbs = Abs;
+	}
+}
+
+/*****************************************************************************/
+/**
+* Print the lock time and residual of a loop and judge them.
+*
+* @param	LoopPtr is the loop.
+* @param	MaxLockS is the latest lock, from its first sample, that passes.
+* @param	MaxRmsNs is the largest rms offset once locked that passes.
+*
+* @return	0 if the loop passes, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Replay_Verdict(const Replay_Loop *LoopPtr, double MaxLockS,
+			  double MaxRmsNs)
+{
+	double LockS;
+	double RmsNs;
+
+	if (LoopPtr->Locked < REPLAY_MIN_LOCKED) {
+		fprintf(stderr, "%s: %u samples, not locked at the end: FAIL\n",
+			LoopPtr->Name, LoopPtr->Samples);
+		return 1;
+	}
+
+	LockS = LoopPtr->LockS - LoopPtr->FirstS;
+	RmsNs = sqrt(LoopPtr->SumSq / (double)LoopPtr->Locked);
+
+	fprintf(stderr, "%s: %u samples, locked within %.0f ns after %.0f s, "
+		"residual %.1f ns rms, %.0f ns max: %s\n", LoopPtr->Name,
+		LoopPtr->Samples, LockNs, LockS, RmsNs, LoopPtr->MaxAbs,
+		((LockS <= MaxLockS) && (RmsNs <= MaxRmsNs)) ? "ok" : "FAIL");
+
+	return ((LockS <= MaxLockS) && (RmsNs <= MaxRmsNs)) ? 0 : 1;
+}
@@ -0,0 +1,449 @@
+/*****************************************************************************/
+/**
+* @file sched_test.c
+*
+* Host test of the application scheduler, sched.c. sched.c is built here
+* against a simulated global timer and a stand-in for the timer service
+* whose WFI wait fires the armed timers in deadline order, so the test runs
+* in simulated time. It checks that tasks run highest priority first and
+* in posting order within a priority, that events posted to a queued task
+* merge into one run, a task reposting itself, one-shot and periodic
+* timers, an interrupt posting a higher priority task while a lower one
+* runs, stopping a timer and Sched_RunUntil() returning at its deadline.
+*
+* Build and run from improved/:
+*   S=vitisProject/clk_div_scale_auto/clk_div/src
+*   B=vitisProject/clk_div_scale_auto/clk_div_wrapper/ps7_cortexa9_0/standalone_domain/bsp/ps7_cortexa9_0
+*   gcc -O2 -Wall -o sched_test tools/sched_test.c -I$S -I$B/include
+*   ./sched_test
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+
+/*
+ * sched.c on a host: the CPSR only records whether IRQs are masked
+ */
+#undef mfcpsr
+#undef mtcpsr
+#define mfcpsr()	TestCpsr
+#define mtcpsr(v)	(TestCpsr = (v))
+
+static u32 TestCpsr;
+
+#include "sched.c"
+
+/************************** Constant Definitions ****************************/
+
+#define TEST_MAX_TIMERS		8U
+#define TEST_LOG_SIZE		64U
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	Sched_Task *Self;
+	char Name;		/* Logged for each run */
+	u32 Events;		/* Events of the last run */
+	u32 Repost;		/* Runs left to repost itself */
+	Sched_Task *Irq;	/* Posted as from an interrupt during a run */
+	XTime LastRun;
+} Test_Task;
+
+/************************** Function Prototypes *****************************/
+
+static void Test_Handler(void *CallBackRef, u32 Events);
+static void Test_Reset(void);
+static int Test_Expect(const char *Label, const char *Log);
+static int Test_Order(void);
+static int Test_Coalesce(void);
+static int Test_Repost(void);
+static int Test_Irq(void);
+static int Test_Timers(void);
+
+/************************** Variable Definitions *****************************/
+
+static XTime TestNow;
+static TimerSvc_Timer *TestTimers[TEST_MAX_TIMERS];
+static char TestLog[TEST_LOG_SIZE];
+static u32 TestLogLength;
+
+/*****************************************************************************/
+/**
+* Simulated global timer.
+*
+******************************************************************************/
+void XTime_GetTime(XTime *Xtime_Global)
+{
+	*Xtime_Global = TestNow;
+}
+
+/*****************************************************************************/
+/**
+* Timer service stand-in: a flat list of armed timers.
+*
+******************************************************************************/
+void TimerSvc_InitTimer(TimerSvc_Timer *Timer, TimerSvc_Handler Handler,
+			void *CallBackRef)
+{
+	memset(Timer, 0, sizeof(*Timer));
+	Timer->Handler = Handler;
+	Timer->CallBackRef = CallBackRef;
+}
+
+void TimerSvc_Start(TimerSvc_Timer *Timer, XTime Deadline, XTime Period)
+{
+	u32 Index;
+	u32 Free = TEST_MAX_TIMERS;
+
+	Timer->Deadline = Deadline;
+	Timer->Period = Period;
+	Timer->Armed = 1U;
+	for (Index = 0U; Index < TEST_MAX_TIMERS; Index++) {
+		if (TestTimers[Index] == Timer) {
+			return;
+		}
+		if ((TestTimers[Index] == NULL) && (Free == TEST_MAX_TIMERS)) {
+			Free = Index;
+		}
+	}
+	TestTimers[Free] = Timer;
+}
+
+void TimerSvc_Stop(TimerSvc_Timer *Timer)
+{
+	u32 Index;
+
+	Timer->Armed = 0U;
+	for (Index = 0U; Index < TEST_MAX_TIMERS; Index++) {
+		if (TestTimers[Index] == Timer) {
+			TestTimers[Index] = NULL;
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+* WFI in simulated time: jump to each timer deadline in turn, running the
+* timer as its interrupt would, until the condition holds or the deadline.
+*
+******************************************************************************/
+int TimerSvc_WaitUntil(XTime Deadline, TimerSvc_Cond Cond,
+		       void *CallBackRef)
+{
+	TimerSvc_Timer *Timer;
+	u32 Index;
+	u32 Next;
+
+	while ((Cond == NULL) || (Cond(CallBackRef) == 0)) {
+		Next = TEST_MAX_TIMERS;
+		for (Index = 0U; Index < TEST_MAX_TIMERS; Index++) {
+			if ((TestTimers[Index] != NULL) &&
+			    ((Next == TEST_MAX_TIMERS) ||
+			     (TestTimers[Index]->Deadline <
+			      TestTimers[Next]->Deadline))) {
+				Next = Index;
+			}
+		}
+		if ((Next == TEST_MAX_TIMERS) ||
+		    (TestTimers[Next]->Deadline > Deadline)) {
+			TestNow = Deadline;
+			return XST_TIMEOUT;
+		}
+
+		Timer = TestTimers[Next];
+		if (Timer->Deadline > TestNow) {
+			TestNow = Timer->Deadline;
+		}
+		if (Timer->Period != 0U) {
+			Timer->Deadline += Timer->Period;
+		} else {
+			TimerSvc_Stop(Timer);
+		}
+		TestCpsr |= XIL_EXCEPTION_IRQ;
+		Timer->Handler(Timer->CallBackRef, TestNow);
+		TestCpsr &= ~XIL_EXCEPTION_IRQ;
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+
+int main(void)
+{
+	int Failed = 0;
+
+	Failed |= Test_Order();
+	Failed |= Test_Coalesce();
+	Failed |= Test_Repost();
+	Failed |= Test_Irq();
+	Failed |= Test_Timers();
+
+	printf("%s\n", Failed ? "FAIL" : "pass");
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Priorities and posting order.
+*
+******************************************************************************/
+static int Test_Order(void)
+{
+	Sched_Task Task[5];
+	Test_Task Ref[5];
+	u32 Index;
+
+	Test_Reset();
+	for (Index = 0U; Index < 5U; Index++) {
+		memset(&Ref[Index], 0, sizeof(Ref[Index]));
+		Ref[Index].Name = (char)('a' + Index);
+	}
+	Sched_TaskInit(&Task[0], Test_Handler, &Ref[0], 2U);
+	Sched_TaskInit(&Task[1], Test_Handler, &Ref[1], 0U);
+	Sched_TaskInit(&Task[2], Test_Handler, &Ref[2], 2U);
+	Sched_TaskInit(&Task[3], Test_Handler, &Ref[3], 3U);
+	/* Out of range priorities go to the lowest */
+	Sched_TaskInit(&Task[4], Test_Handler, &Ref[4], 99U);
+
+	Sched_Post(&Task[4], 1U);
+	Sched_Post(&Task[3], 1U);
+	Sched_Post(&Task[0], 1U);
+	Sched_Post(&Task[2], 1U);
+	Sched_Post(&Task[1], 1U);
+
+	while (Sched_RunOnce()) {
+		;
+	}
+
+	return Test_Expect("order", "baced");
+}
+
+/*****************************************************************************/
+/**
+* Events posted to a queued task merge into one run.
+*
+******************************************************************************/
+static int Test_Coalesce(void)
+{
+	Sched_Task Task;
+	Test_Task Ref;
+	int Failed;
+
+	Test_Reset();
+	memset(&Ref, 0, sizeof(Ref));
+	Ref.Name = 'a';
+	Sched_TaskInit(&Task, Test_Handler, &Ref, 1U);
+
+	Sched_Post(&Task, 0x1U);
+	Sched_Post(&Task, 0x4U);
+	Sched_Post(&Task, 0x1U);
+	while (Sched_RunOnce()) {
+		;
+	}
+
+	Failed = Test_Expect("coalesce", "a");
+	if ((Ref.Events != 0x5U) || (Task.Runs != 1U)) {
+		printf("coalesce: events 0x%X in %u runs\n", Ref.Events,
+		       Task.Runs);
+		Failed = 1;
+	}
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* A task reposting itself lets an equal priority task run in between.
+*
+******************************************************************************/
+static int Test_Repost(void)
+{
+	Sched_Task Task[2];
+	Test_Task Ref[2];
+
+	Test_Reset();
+	memset(Ref, 0, sizeof(Ref));
+	Ref[0].Name = 'a';
+	Ref[0].Repost = 2U;
+	Ref[1].Name = 'b';
+	Sched_TaskInit(&Task[0], Test_Handler, &Ref[0], 1U);
+	Sched_TaskInit(&Task[1], Test_Handler, &Ref[1], 1U);
+	Ref[0].Self = &Task[0];
+
+	Sched_Post(&Task[0], 1U);
+	Sched_Post(&Task[1], 1U);
+	while (Sched_RunOnce()) {
+		;
+	}
+
+	return Test_Expect("repost", "abaa");
+}
+
+/*****************************************************************************/
+/**
+* An interrupt posting a higher priority task while a lower one runs: the
+* higher one is next, ahead of tasks queued earlier.
+*
+******************************************************************************/
+static int Test_Irq(void)
+{
+	Sched_Task Task[3];
+	Test_Task Ref[3];
+
+	Test_Reset();
+	memset(Ref, 0, sizeof(Ref));
+	Ref[0].Name = 'l';
+	Ref[1].Name = 'm';
+	Ref[2].Name = 'h';
+	Sched_TaskInit(&Task[0], Test_Handler, &Ref[0], 3U);
+	Sched_TaskInit(&Task[1], Test_Handler, &Ref[1], 3U);
+	Sched_TaskInit(&Task[2], Test_Handler, &Ref[2], 0U);
+	Ref[0].Irq = &Task[2];
+
+	Sched_Post(&Task[0], 1U);
+	Sched_Post(&Task[1], 1U);
+	while (Sched_RunOnce()) {
+		;
+	}
+
+	return Test_Expect("irq", "lhm");
+}
+
+/*****************************************************************************/
+/**
+* One-shot and periodic timers in simulated time, stopping a timer and
+* Sched_RunUntil() returning at its deadline.
+*
+******************************************************************************/
+static int Test_Timers(void)
+{
+	Sched_Task Task[2];
+	Test_Task Ref[2];
+	Sched_Timer Timer[2];
+	XTime Start;
+	XTime Period = TIMER_SVC_US(250U);
+	int Failed = 0;
+
+	Test_Reset();
+	memset(Ref, 0, sizeof(Ref));
+	Ref[0].Name = 'p';
+	Ref[1].Name = 'o';
+	Sched_TaskInit(&Task[0], Test_Handler, &Ref[0], 1U);
+	Sched_TaskInit(&Task[1], Test_Handler, &Ref[1], 0U);
+	Sched_TimerInit(&Timer[0], &Task[0], 0x2U);
+	Sched_TimerInit(&Timer[1], &Task[1], 0x8U);
+
+	/* 40 periods of 250 us, and a one-shot half way */
+	Start = TestNow;
+	Sched_TimerStart(&Timer[0], 250U, 250U);
+	Sched_TimerStart(&Timer[1], 5000U, 0U);
+	Sched_RunUntil(Start + (40U * Period));
+
+	if (TestNow != (Start + (40U * Period))) {
+		printf("timers: returned at %llu ticks\n",
+		       (unsigned long long)(TestNow - Start));
+		Failed = 1;
+	}
+	/* The 40th period ends at the deadline itself and is left queued */
+	if ((Task[0].Runs != 39U) || (Task[0].Queued == 0U)) {
+		printf("timers: periodic ran %u times\n", Task[0].Runs);
+		Failed = 1;
+	}
+	if ((Task[1].Runs != 1U) || (Ref[1].Events != 0x8U) ||
+	    (Ref[1].LastRun != (Start + TIMER_SVC_US(5000U)))) {
+		printf("timers: one-shot ran %u times at %llu\n",
+		       Task[1].Runs,
+		       (unsigned long long)(Ref[1].LastRun - Start));
+		Failed = 1;
+	}
+
+	Sched_TimerStop(&Timer[0]);
+	(void)Sched_RunOnce();
+	Sched_RunUntil(TestNow + TIMER_SVC_US(10000U));
+	if (Task[0].Runs != 40U) {
+		printf("timers: stopped timer ran %u times\n", Task[0].Runs);
+		Failed = 1;
+	}
+	if (TestCpsr != 0U) {
+		printf("timers: IRQs left masked\n");
+		Failed = 1;
+	}
+
+	if (Failed == 0) {
+		printf("timers: ok\n");
+	}
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Handler of the test tasks: log the run and do what the task asks for.
+*
+******************************************************************************/
+static void Test_Handler(void *CallBackRef, u32 Events)
+{
+	Test_Task *Ref = (Test_Task *)CallBackRef;
+
+	if (TestLogLength < (TEST_LOG_SIZE - 1U)) {
+		TestLog[TestLogLength] = Ref->Name;
+		TestLogLength++;
+	}
+	Ref->Events = Events;
+	Ref->LastRun = TestNow;
+
+	if (Ref->Irq != NULL) {
+		Sched_Post(Ref->Irq, 1U);
+	}
+	if (Ref->Repost != 0U) {
+		Ref->Repost--;
+		Sched_Post(Ref->Self, 1U);
+	}
+}
+
+/*****************************************************************************/
+/**
+* Start a test from an empty scheduler and no armed timers.
+*
+******************************************************************************/
+static void Test_Reset(void)
+{
+	memset(ReadyQueue, 0, sizeof(ReadyQueue));
+	ReadyMask = 0U;
+	memset(TestTimers, 0, sizeof(TestTimers));
+	memset(TestLog, 0, sizeof(TestLog));
+	TestLogLength = 0U;
+}
+
+/*****************************************************************************/
+/**
+* Compare the run log with the expected one.
+*
+******************************************************************************/
+static int Test_Expect(const char *Label, const char *Log)
+{
+	if (strcmp(TestLog, Log) != 0) {
+		printf("%s: ran %s, expected %s\n", Label, TestLog, Log);
+		return 1;
+	}
+
+	printf("%s: ok\n", Label);
+
+	return 0;
+}
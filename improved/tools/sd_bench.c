@@ -0,0 +1,544 @@
+/*****************************************************************************/
+/**
+* @file sd_bench.c
+*
+* Host benchmark of the FSBL SD boot path on an image-file-backed SD card.
+* The FatFs of the FSBL BSP and the FSBL sd.c run on top of a disk_read()
+* that reads sectors from a FAT image file and counts the card commands and
+* sectors. The same FSBL-like read pattern (the header walk in small reads,
+* one partition in the 128 KB chunks of the checksum and bitstream paths,
+* one partition in a single MoveImage) is run through the old SDAccess,
+* f_lseek and f_read on every call, and through the new one, with the
+* cluster map and direct sector reads. Both are checked against the file
+* contents, and the card time is modelled from a per-command overhead and
+* the bus rate.
+*
+* Without an image argument, a FAT image is formatted with f_mkfs and a
+* BOOT.BIN is written to it in fragments, interleaved with a second file,
+* like on a card that has been written to for a while. That image is a
+* temporary file in $TMPDIR (or /tmp), removed again on exit. An existing image
+* must hold a BOOT.BIN at its root; the read pattern is then scaled to the
+* file size and only the data read back is compared between the two paths.
+*
+* Build and run from improved/ (x86-64 Linux; the FSBL passes buffers as
+* u32, so they are mapped below 2 GB):
+*   F=vitisProject/clk_div_scale_auto/clk_div_wrapper/zynq_fsbl
+*   B=$F/zynq_fsbl_bsp/ps7_cortexa9_0
+*   gcc -O2 -Wall -no-pie -o sd_bench tools/sd_bench.c $F/sd.c \
+*       $B/libsrc/xilffs_v5_0/src/ff.c -I$F -I$B/include
+*   ./sd_bench [-c cmd_us] [-r MB/s] [-s boot_MB] [-f fragment_KB] [image]
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 The generated image is a temporary file.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "ff.h"
+#include "diskio.h"
+#include "sd.h"
+#include "xil_cache.h"
+#include "xstatus.h"
+
+/************************** Constant Definitions ****************************/
+
+#define BENCH_IMAGE_TEMPLATE	"sd_bench.XXXXXX"
+#define BENCH_TMPDIR		"/tmp"	/* Without $TMPDIR */
+#define BENCH_IMAGE_SIZE	(256U << 20)	/* Formatted image */
+#define BENCH_CLUSTER_SIZE	0x8000U		/* Usual SD card cluster */
+#define BENCH_SECTOR_SIZE	512U
+
+#define BENCH_DEFAULT_BOOT_MB	8U
+#define BENCH_DEFAULT_FRAG_KB	256U
+
+/*
+ * Card model: polled CMD18 with ADMA2 setup and transfer-complete poll,
+ * and a 4-bit bus at 50 MHz (high speed)
+ */
+#define BENCH_DEFAULT_CMD_US	60.0
+#define BENCH_DEFAULT_RATE_MBS	22.0
+
+#define BENCH_HEADER_READS	48U	/* Boot and partition header reads */
+#define BENCH_HEADER_SIZE	0x1000U
+#define BENCH_CHUNK_SIZE	0x20000U	/* CHECKSUM_CHUNK_SIZE */
+#define BENCH_PARTITION_ALIGN	64U
+
+/**************************** Type Definitions *******************************/
+
+typedef u32 (*BenchAccess)(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes);
+
+typedef struct {
+	unsigned long Commands;
+	unsigned long Sectors;
+} BenchCount;
+
+/************************** Function Prototypes *****************************/
+
+static int Bench_MakeImage(u32 BootBytes, u32 FragBytes);
+static void Bench_RemoveImage(void);
+static u8 Bench_Pattern(u32 Offset);
+static u32 Bench_OldAccess(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes);
+static int Bench_Run(const char *Label, BenchAccess Access, u32 FileSize,
+		u8 *Buffer, u8 *Reference, int Verify);
+
+/************************** Variable Definitions ****************************/
+
+u32 FlashReadBaseAddress;
+
+static FILE *Image;
+static char TempName[PATH_MAX];	/* Generated image, until removed */
+static BenchCount Count;
+static FIL OldFil;
+static double CmdUs = BENCH_DEFAULT_CMD_US;
+static double RateMBs = BENCH_DEFAULT_RATE_MBS;
+
+/*****************************************************************************/
+/**
+* Format an image when none is given, run both paths and print the counts.
+*
+* @return	0 if both paths read back the right data, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+int main(int argc, char *argv[])
+{
+	const char *Name = NULL;
+	u32 BootBytes = BENCH_DEFAULT_BOOT_MB << 20;
+	u32 FragBytes = BENCH_DEFAULT_FRAG_KB << 10;
+	u32 FileSize;
+	u32 Index;
+	u8 *Buffer;
+	u8 *Reference;
+	int Verify;
+	int Failed = 0;
+	int Opt;
+
+	while ((Opt = getopt(argc, argv, "c:r:s:f:")) != -1) {
+		switch (Opt) {
+		case 'c':
+			CmdUs = atof(optarg);
+			break;
+		case 'r':
+			RateMBs = atof(optarg);
+			break;
+		case 's':
+			BootBytes = (u32)strtoul(optarg, NULL, 0) << 20;
+			break;
+		case 'f':
+			FragBytes = (u32)strtoul(optarg, NULL, 0) << 10;
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-c cmd_us] [-r MB/s] "
+				"[-s boot_MB] [-f fragment_KB] [image]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (optind < argc) {
+		Name = argv[optind];
+	}
+
+	Verify = (Name == NULL);
+	if (Name == NULL) {
+		atexit(Bench_RemoveImage);
+		if (Bench_MakeImage(BootBytes, FragBytes) != 0) {
+			return 1;
+		}
+		Name = TempName;
+	}
+
+	Image = fopen(Name, "r+b");
+	if (Image == NULL) {
+		perror(Name);
+		return 1;
+	}
+	/* The open file stays readable, and nothing is left on a crash */
+	if (Verify) {
+		(void)unlink(Name);
+	}
+
+	if (InitSD("BOOT.BIN") != XST_SUCCESS) {
+		fprintf(stderr, "sd_bench: InitSD failed on %s\n", Name);
+		return 1;
+	}
+	if (f_open(&OldFil, "0:/BOOT.BIN", FA_READ) != FR_OK) {
+		fprintf(stderr, "sd_bench: no BOOT.BIN in %s\n", Name);
+		return 1;
+	}
+	FileSize = (u32)f_size(&OldFil);
+	if (FileSize < (4U * BENCH_CHUNK_SIZE)) {
+		fprintf(stderr, "sd_bench: BOOT.BIN too small\n");
+		return 1;
+	}
+
+	/* Below 2 GB: sd.c takes the destination as a u32 */
+	Buffer = mmap(NULL, FileSize + 4U, PROT_READ | PROT_WRITE,
+		      MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	Reference = malloc(FileSize);
+	if ((Buffer == MAP_FAILED) || (Reference == NULL)) {
+		fprintf(stderr, "sd_bench: no memory\n");
+		return 1;
+	}
+
+	if (Verify) {
+		for (Index = 0U; Index < FileSize; Index++) {
+			Reference[Index] = Bench_Pattern(Index);
+		}
+	}
+
+	printf("%s: BOOT.BIN %lu bytes, cmd %.0f us, bus %.1f MB/s\n", Name,
+	       (unsigned long)FileSize, CmdUs, RateMBs);
+	printf("path  commands   sectors  card ms  host ms  data\n");
+
+	/* Old path first, its data is the reference for an existing image */
+	Failed |= Bench_Run("old", Bench_OldAccess, FileSize, Buffer,
+			    Reference, Verify);
+	if (!Verify) {
+		memcpy(Reference, Buffer, FileSize);
+	}
+	Failed |= Bench_Run("new", SDAccess, FileSize, Buffer, Reference, 1);
+
+	ReleaseSD();
+	f_close(&OldFil);
+	fclose(Image);
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* Read the file in the FSBL pattern through one access function.
+*
+* @param	Label names the path in the output.
+* @param	Access is the SDAccess to use.
+* @param	FileSize is the size of BOOT.BIN.
+* @param	Buffer is the destination, FileSize bytes, below 2 GB.
+* @param	Reference is the expected file contents.
+* @param	Verify compares Buffer with Reference when set.
+*
+* @return	0 if the data matched or was not compared, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Bench_Run(const char *Label, BenchAccess Access, u32 FileSize,
+		u8 *Buffer, u8 *Reference, int Verify)
+{
+	u32 Base = (u32)(UINTPTR)Buffer;
+	u32 Part1;
+	u32 Part2;
+	u32 Offset;
+	u32 Length;
+	u32 Index;
+	u32 Status = XST_SUCCESS;
+	clock_t Start;
+	double HostMs;
+	double CardMs;
+	int Failed = 0;
+
+	memset(Buffer, 0, FileSize);
+	memset(&Count, 0, sizeof(Count));
+	Start = clock();
+
+	/* Header walk: small reads spread over the header area */
+	for (Index = 0U; Index < BENCH_HEADER_READS; Index++) {
+		Offset = (Index * 0x54U) % (BENCH_HEADER_SIZE - 64U);
+		Status |= Access(Offset, Base + Offset, 64U);
+	}
+
+	/*
+	 * First partition in 128 KB chunks, the second in one read; both
+	 * start on the 64 byte partition alignment, not on a sector
+	 */
+	Part1 = BENCH_HEADER_SIZE + 0xA40U;
+	Part2 = Part1 + (((FileSize - Part1) / 2U) & ~(BENCH_PARTITION_ALIGN - 1U));
+	for (Offset = Part1; Offset < Part2; Offset += Length) {
+		Length = Part2 - Offset;
+		if (Length > BENCH_CHUNK_SIZE) {
+			Length = BENCH_CHUNK_SIZE;
+		}
+		Status |= Access(Offset, Base + Offset, Length);
+	}
+	Status |= Access(Part2, Base + Part2, FileSize - Part2);
+
+	HostMs = (double)(clock() - Start) * 1000.0 / CLOCKS_PER_SEC;
+	CardMs = ((double)Count.Commands * CmdUs / 1000.0) +
+		 ((double)Count.Sectors * BENCH_SECTOR_SIZE /
+		  (RateMBs * 1000.0 * 1000.0) * 1000.0);
+
+	if (Status != XST_SUCCESS) {
+		Failed = 1;
+	}
+	if (Verify) {
+		/* Header reads cover only part of the header area */
+		for (Index = 0U; Index < BENCH_HEADER_READS; Index++) {
+			Offset = (Index * 0x54U) % (BENCH_HEADER_SIZE - 64U);
+			Failed |= (memcmp(Buffer + Offset, Reference + Offset,
+					  64U) != 0);
+		}
+		Failed |= (memcmp(Buffer + Part1, Reference + Part1,
+				  FileSize - Part1) != 0);
+	}
+
+	printf("%-4s  %8lu  %8lu  %7.1f  %7.2f  %s\n", Label, Count.Commands,
+	       Count.Sectors, CardMs, HostMs,
+	       Verify ? (Failed ? "FAIL" : "pass") : "-");
+
+	return Failed;
+}
+
+/*****************************************************************************/
+/**
+* SDAccess as it was before the cluster map: a seek and a read per call.
+*
+* @param	SourceAddress is the offset in BOOT.BIN.
+* @param	DestinationAddress is the destination.
+* @param	LengthBytes is the number of bytes to read.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the seek failed.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 Bench_OldAccess(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes)
+{
+	UINT br;
+
+	if (f_lseek(&OldFil, SourceAddress) != FR_OK) {
+		return XST_FAILURE;
+	}
+	(void)f_read(&OldFil, (void *)(UINTPTR)DestinationAddress,
+		     LengthBytes, &br);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Format a FAT image in a new temporary file and write BOOT.BIN to it in
+* fragments. The file name is left in TempName.
+*
+* @param	BootBytes is the size of BOOT.BIN.
+* @param	FragBytes is the BOOT.BIN data written between two clusters
+*		of the filler file.
+*
+* @return	0 on success, 1 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Bench_MakeImage(u32 BootBytes, u32 FragBytes)
+{
+	static u8 Work[FF_MAX_SS * 8U];
+	static u8 Data[BENCH_CLUSTER_SIZE];
+	const MKFS_PARM Opt = { FM_ANY, 1U, 0U, 0U, BENCH_CLUSTER_SIZE };
+	FATFS Fs;
+	FIL Boot;
+	FIL Filler;
+	UINT bw;
+	u32 Offset;
+	u32 Length;
+	u32 Index;
+	const char *Dir = getenv("TMPDIR");
+	int Fd;
+
+	if ((Dir == NULL) || (Dir[0] == '\0')) {
+		Dir = BENCH_TMPDIR;
+	}
+	if (snprintf(TempName, sizeof(TempName), "%s/%s", Dir,
+		     BENCH_IMAGE_TEMPLATE) >= (int)sizeof(TempName)) {
+		fprintf(stderr, "sd_bench: TMPDIR too long\n");
+		TempName[0] = '\0';
+		return 1;
+	}
+	Fd = mkstemp(TempName);
+	if (Fd < 0) {
+		perror(TempName);
+		TempName[0] = '\0';
+		return 1;
+	}
+
+	Image = fdopen(Fd, "w+b");
+	if ((Image == NULL) || (ftruncate(fileno(Image), BENCH_IMAGE_SIZE) != 0)) {
+		perror(TempName);
+		return 1;
+	}
+
+	if ((f_mkfs("0:", &Opt, Work, sizeof(Work)) != FR_OK) ||
+	    (f_mount(&Fs, "0:", 1) != FR_OK) ||
+	    (f_open(&Boot, "0:/BOOT.BIN", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK) ||
+	    (f_open(&Filler, "0:/FILLER.BIN", FA_WRITE | FA_CREATE_ALWAYS) != FR_OK)) {
+		fprintf(stderr, "sd_bench: cannot format %s\n", TempName);
+		return 1;
+	}
+
+	for (Offset = 0U; Offset < BootBytes; Offset += Length) {
+		Length = BootBytes - Offset;
+		if (Length > sizeof(Data)) {
+			Length = sizeof(Data);
+		}
+		for (Index = 0U; Index < Length; Index++) {
+			Data[Index] = Bench_Pattern(Offset + Index);
+		}
+		if ((f_write(&Boot, Data, Length, &bw) != FR_OK) || (bw != Length)) {
+			fprintf(stderr, "sd_bench: image full\n");
+			return 1;
+		}
+		if ((FragBytes != 0U) && (((Offset + Length) % FragBytes) == 0U)) {
+			/* Force the next BOOT.BIN cluster elsewhere */
+			(void)f_sync(&Boot);
+			(void)f_write(&Filler, Data, BENCH_CLUSTER_SIZE, &bw);
+			(void)f_sync(&Filler);
+		}
+	}
+
+	f_close(&Boot);
+	f_close(&Filler);
+	f_mount(NULL, "0:", 0);
+	fclose(Image);
+	Image = NULL;
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+* Remove the generated image, if it is still there.
+*
+* @return	None.
+*
+* @note		Registered with atexit(), so failed runs clean up too.
+*
+******************************************************************************/
+static void Bench_RemoveImage(void)
+{
+	if (TempName[0] != '\0') {
+		(void)unlink(TempName);
+	}
+}
+
+/*****************************************************************************/
+/**
+* Contents of the generated BOOT.BIN.
+*
+* @param	Offset is the byte offset in the file.
+*
+* @return	Byte at that offset.
+*
+* @note		None.
+*
+******************************************************************************/
+static u8 Bench_Pattern(u32 Offset)
+{
+	return (u8)(Offset ^ (Offset >> 8) ^ (Offset >> 16) ^ 0x5AU);
+}
+
+/*****************************************************************************/
+/*
+ * Disk interface of FatFs on the image file, and the FSBL symbols sd.c uses
+ */
+
+DSTATUS disk_status(BYTE pdrv)
+{
+	(void)pdrv;
+	return (Image != NULL) ? 0U : STA_NOINIT;
+}
+
+DSTATUS disk_initialize(BYTE pdrv)
+{
+	return disk_status(pdrv);
+}
+
+DRESULT disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
+{
+	(void)pdrv;
+	Count.Commands++;
+	Count.Sectors += count;
+
+	if ((fseek(Image, (long)sector * BENCH_SECTOR_SIZE, SEEK_SET) != 0) ||
+	    (fread(buff, BENCH_SECTOR_SIZE, count, Image) != count)) {
+		return RES_ERROR;
+	}
+
+	return RES_OK;
+}
+
+DRESULT disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
+{
+	(void)pdrv;
+
+	if ((fseek(Image, (long)sector * BENCH_SECTOR_SIZE, SEEK_SET) != 0) ||
+	    (fwrite(buff, BENCH_SECTOR_SIZE, count, Image) != count)) {
+		return RES_ERROR;
+	}
+
+	return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+	(void)pdrv;
+
+	switch (cmd) {
+	case CTRL_SYNC:
+		return RES_OK;
+	case GET_SECTOR_COUNT:
+		fseek(Image, 0, SEEK_END);
+		*(LBA_t *)buff = (LBA_t)(ftell(Image) / BENCH_SECTOR_SIZE);
+		return RES_OK;
+	case GET_BLOCK_SIZE:
+		*(DWORD *)buff = 128U;
+		return RES_OK;
+	default:
+		return RES_PARERR;
+	}
+}
+
+void disk_cache_stats(DISK_CACHE_STATS *stats, BYTE reset)
+{
+	(void)reset;
+	memset(stats, 0, sizeof(*stats));
+}
+
+DWORD get_fattime(void)
+{
+	return ((DWORD)(2026U - 1980U) << 25) | (10U << 21) | (19U << 16);
+}
+
+void Xil_DCacheFlushRange(INTPTR adr, u32 len)
+{
+	(void)adr;
+	(void)len;
+}
+
+char *strcpy_rom(char *Dest, const char *Src)
+{
+	return strcpy(Dest, Src);
+}
+
+void xil_printf(const char8 *ctrl1, ...)
+{
+	va_list Args;
+
+	va_start(Args, ctrl1);
+	vprintf(ctrl1, Args);
+	va_end(Args);
+}
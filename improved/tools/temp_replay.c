@@ -0,0 +1,123 @@
+/*****************************************************************************/
+/**
+* @file temp_replay.c
+*
+* Host replay of the clk_div_top temperature compensation. Reads a UART log
+* of the application built with TEMP_COMP_LOG, runs the logged samples
+* through the same temp_model.c as the target and prints, per pps, the
+* trim computed on the host next to the logged one, the model prediction
+* and its residual. Lines that are not "tc," records are ignored, so a
+* whole console capture can be fed in.
+*
+* Build and run from improved/:
+*   gcc -O2 -Wall -o temp_replay tools/temp_replay.c \
+*       vitisProject/clk_div_scale_auto/clk_div/src/temp_model.c \
+*       -IvitisProject/clk_div_scale_auto/clk_div/src \
+*       -IvitisProject/clk_div_scale_auto/clk_div_wrapper/ps7_cortexa9_0/standalone_domain/bsp/ps7_cortexa9_0/include
+*   ./temp_replay [num_win] < console.log > replay.csv
+*
+* The model tuning can be changed on the command line to try other values
+* on the same log:
+*   ./temp_replay num_win ref_temp_c lambda init_cov max_trim_ppm
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "temp_model.h"
+#include "temp_comp.h"
+
+/************************** Constant Definitions ****************************/
+
+#define REPLAY_NUM_WIN		8U	/* NUM_WIN of clk_div_top */
+#define REPLAY_LINE_MAX		256
+
+/*****************************************************************************/
+/**
+* Replay a log from stdin.
+*
+* @return	0 if every logged trim was reproduced, 1 otherwise.
+*
+* @note		A mismatch is expected only when the log was taken with
+*		other tuning than given here, or lines were lost.
+*
+******************************************************************************/
+int main(int argc, char *argv[])
+{
+	TempTracker Tracker;
+	char Line[REPLAY_LINE_MAX];
+	unsigned long Pps;
+	long TempMilliC;
+	unsigned long WinCount;
+	unsigned long Scale;
+	long LoggedTrim;
+	u32 NumWin = REPLAY_NUM_WIN;
+	double RefTempC = TEMP_COMP_REF_TEMP_C;
+	double Lambda = TEMP_COMP_LAMBDA;
+	double InitCov = TEMP_COMP_INIT_COV;
+	double MaxTrimPpm = TEMP_COMP_MAX_TRIM_PPM;
+	double TempC;
+	u32 Mismatches = 0U;
+	u32 Records = 0U;
+	s32 Trim;
+
+	if (argc > 1) {
+		NumWin = (u32)strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 5) {
+		RefTempC = atof(argv[2]);
+		Lambda = atof(argv[3]);
+		InitCov = atof(argv[4]);
+		MaxTrimPpm = atof(argv[5]);
+	}
+
+	TempTracker_Init(&Tracker, NumWin, RefTempC, Lambda, InitCov,
+			 MaxTrimPpm);
+
+	printf("pps,temp_c,win_count,scale,freq_hz,predict_hz,trim,logged_trim\n");
+
+	while (fgets(Line, sizeof(Line), stdin) != NULL) {
+		if (sscanf(Line, "tc,%lu,%ld,%lu,%lu,%ld", &Pps, &TempMilliC,
+			   &WinCount, &Scale, &LoggedTrim) != 5) {
+			continue;
+		}
+		Records++;
+
+		/* Same conversion and same skip of unknown SCALE as the target */
+		TempC = (double)TempMilliC / 1000.0;
+		if (Scale == 0UL) {
+			Trim = 0;
+		} else {
+			Trim = TempTracker_Sample(&Tracker, TempC, (u32)WinCount,
+						  (u32)Scale);
+		}
+		if ((long)Trim != LoggedTrim) {
+			Mismatches++;
+		}
+
+		printf("%lu,%.3f,%lu,%lu,%.0f,%.1f,%ld,%ld\n", Pps, TempC,
+		       WinCount, Scale, (double)WinCount * (double)Scale,
+		       TempModel_Predict(&Tracker.Model, TempC), (long)Trim,
+		       LoggedTrim);
+	}
+
+	fprintf(stderr, "%u records, %u trims differ from the log, "
+		"%u windows rejected\n", Records, Mismatches,
+		Tracker.Rejected);
+	fprintf(stderr, "model: F0 %.1f Hz, %.4f Hz + %.4f Hz/10C + "
+		"%.4f Hz/(10C)^2 about %.1f C\n", Tracker.Model.F0,
+		Tracker.Model.Theta[0], Tracker.Model.Theta[1],
+		Tracker.Model.Theta[2], Tracker.Model.RefTempC);
+
+	return (Mismatches == 0U) ? 0 : 1;
+}
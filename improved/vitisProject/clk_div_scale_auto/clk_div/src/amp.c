@@ -0,0 +1,390 @@
+/*****************************************************************************/
+/**
+* @file amp.c
+*
+* Split of the application over the two Cortex-A9 cores. See amp.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 SGIs to CPU0 go through Intc_RaiseSgi()
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stddef.h>
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xil_mmu.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "xtime_l.h"
+#include "intc.h"
+#include "amp.h"
+
+#ifdef APP_CPU1
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Boot ROM wait loop of CPU1: CPU1 waits in WFE until AMP_CPU1_WAKE_ADDR
+ * holds an address, then jumps to it with the MMU and caches off
+ */
+#define AMP_CPU1_WAKE_ADDR	0xFFFFFFF0U
+
+#define AMP_SHARED_SIZE		0x1000U	/* One non-cacheable page */
+#define AMP_START_TIMEOUT_US	10000U
+
+#define sev()	__asm__ __volatile__ ("sev" : : : "memory")
+#define wfe()	__asm__ __volatile__ ("wfe" : : : "memory")
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	u32 Type;
+	Amp_Handler Handler;
+	void *CallBackRef;
+} Amp_Entry;
+
+typedef struct {
+	MsgQueue ToCpu1;		/* CPU0 produces, CPU1 consumes */
+	MsgQueue ToCpu0;		/* CPU1 produces, CPU0 consumes */
+} Amp_Shared;
+
+/************************** Function Prototypes *****************************/
+
+static void Amp_Dispatch(const MsgQueue_Msg *Msg);
+static void Amp_Cpu0IrqHandler(void *CallBackRef);
+
+/************************** Variable Definitions **************************/
+
+/* Placed in OCM by the linker script, and made non-cacheable */
+static Amp_Shared AmpShared __attribute__ ((section (".amp_shared"),
+					    aligned (AMP_SHARED_SIZE)));
+
+static Amp_Entry AmpHandlers[AMP_MAX_HANDLERS];
+static u32 AmpHandlerCount;
+static volatile u32 AmpRunning;
+static volatile u32 AmpPrintLockWord;
+
+/*****************************************************************************/
+/**
+* Register the handler of a message type, on whichever core receives it.
+*
+* @param	Type is the message type.
+* @param	Handler is called with each message of that type.
+* @param	CallBackRef is passed to the handler.
+*
+* @return
+*		- XST_SUCCESS if the handler was added
+*		- XST_FAILURE if AMP_MAX_HANDLERS are already registered
+*
+* @note		CPU0, before Amp_Start().
+*
+******************************************************************************/
+int Amp_SetHandler(u32 Type, Amp_Handler Handler, void *CallBackRef)
+{
+	if (AmpHandlerCount >= AMP_MAX_HANDLERS) {
+		return XST_FAILURE;
+	}
+
+	AmpHandlers[AmpHandlerCount].Type = Type;
+	AmpHandlers[AmpHandlerCount].Handler = Handler;
+	AmpHandlers[AmpHandlerCount].CallBackRef = CallBackRef;
+	AmpHandlerCount++;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Set up the shared queues and the doorbell and start CPU1.
+*
+* @return
+*		- XST_SUCCESS if CPU1 is running
+*		- XST_FAILURE if the shared page could not be mapped or CPU1
+*		  did not start, for example on a single core device
+*
+* @note		CPU0. CPU1 must be waiting in the Boot ROM loop, as the FSBL
+*		leaves it.
+*
+******************************************************************************/
+int Amp_Start(void)
+{
+	XTime Deadline;
+	XTime Now;
+	int Status;
+
+	Status = Xil_SetPageAttributes((INTPTR)&AmpShared, AMP_SHARED_SIZE,
+				       NORM_NONCACHE);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	MsgQueue_Init(&AmpShared.ToCpu1);
+	MsgQueue_Init(&AmpShared.ToCpu0);
+
+	Status = Intc_Connect(AMP_SGI_ID,
+			      (Xil_InterruptHandler)Amp_Cpu0IrqHandler, NULL,
+			      AMP_PRIORITY, INTC_TRIGGER_RISING);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/* The Boot ROM loop reads the address with the caches off */
+	Xil_Out32(AMP_CPU1_WAKE_ADDR, (u32)(UINTPTR)Amp_Cpu1Entry);
+	Xil_DCacheFlushRange(AMP_CPU1_WAKE_ADDR, 4U);
+	dsb();
+	sev();
+
+	XTime_GetTime(&Now);
+	Deadline = Now + (((XTime)AMP_START_TIMEOUT_US * COUNTS_PER_SECOND) /
+			  1000000U);
+	while (AmpRunning == 0U) {
+		XTime_GetTime(&Now);
+		if (Now >= Deadline) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Tell whether CPU1 is running and takes messages.
+*
+* @return	Nonzero if Amp_Start() succeeded.
+*
+* @note		None.
+*
+******************************************************************************/
+int Amp_IsRunning(void)
+{
+	return (AmpRunning != 0U) ? 1 : 0;
+}
+
+/*****************************************************************************/
+/**
+* Send a message to the core that handles its type: to CPU1 below
+* AMP_TYPE_CPU0, to CPU0 from it.
+*
+* @param	Msg is the message, copied.
+*
+* @return
+*		- XST_SUCCESS if the message was queued
+*		- XST_FAILURE if the queue is full or CPU1 is not running
+*
+* @note		CPU0 sends from tasks or interrupt handlers, CPU1 from its
+*		handlers. A core only sends to the other one.
+*
+******************************************************************************/
+int Amp_Send(const MsgQueue_Msg *Msg)
+{
+	int Status;
+	u32 Cpsr;
+
+	if (AmpRunning == 0U) {
+		return XST_FAILURE;
+	}
+
+	if (Msg->Type < AMP_TYPE_CPU0) {
+		/* Tasks and interrupt handlers on CPU0 make one producer */
+		Cpsr = mfcpsr();
+		mtcpsr(Cpsr | XIL_EXCEPTION_IRQ);
+		Status = MsgQueue_Push(&AmpShared.ToCpu1, Msg);
+		mtcpsr(Cpsr);
+
+		dsb();
+		sev();
+	} else {
+		Status = MsgQueue_Push(&AmpShared.ToCpu0, Msg);
+
+		dsb();
+		Intc_RaiseSgi(AMP_SGI_ID, INTC_CPU0);
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* Return the number of messages dropped because a queue was full.
+*
+* @return	Messages dropped in both directions.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 Amp_GetDropped(void)
+{
+	return AmpShared.ToCpu1.Dropped + AmpShared.ToCpu0.Dropped;
+}
+
+/*****************************************************************************/
+/**
+* Take the UART for a whole line of output, so the lines of the two cores
+* do not mix. Nothing to do while CPU1 is not running.
+*
+* @return	None.
+*
+* @note		Task context on CPU0, never an interrupt handler: CPU1 holds
+*		the lock for as long as a line takes on the UART. The lock is
+*		in DDR, kept coherent by the SCU.
+*
+******************************************************************************/
+void Amp_PrintLock(void)
+{
+	u32 Expected;
+
+	if (AmpRunning == 0U) {
+		return;
+	}
+
+	do {
+		Expected = 0U;
+	} while (!__atomic_compare_exchange_n(&AmpPrintLockWord, &Expected,
+					      1U, 0, __ATOMIC_ACQUIRE,
+					      __ATOMIC_RELAXED));
+}
+
+/*****************************************************************************/
+/**
+* Release the UART taken with Amp_PrintLock().
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void Amp_PrintUnlock(void)
+{
+	if (AmpRunning == 0U) {
+		return;
+	}
+
+	__atomic_store_n(&AmpPrintLockWord, 0U, __ATOMIC_RELEASE);
+}
+
+/*****************************************************************************/
+/**
+* Main loop of CPU1, called by amp_cpu1_entry.S with the MMU and caches on.
+* Runs the handlers of the messages from CPU0 and sleeps in WFE when there
+* are none.
+*
+* @return	Does not return.
+*
+* @note		CPU1.
+*
+******************************************************************************/
+void Amp_Cpu1Main(void)
+{
+	MsgQueue_Msg Msg;
+
+	AmpRunning = 1U;
+	dsb();
+
+	while (1) {
+		if (MsgQueue_Pop(&AmpShared.ToCpu1, &Msg)) {
+			Amp_Dispatch(&Msg);
+		} else {
+			/* A push after the check leaves the event set */
+			wfe();
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+* Doorbell of CPU1 on CPU0: run the handlers of the messages from CPU1.
+*
+* @param	CallBackRef is unused.
+*
+* @return	None.
+*
+* @note		IRQ context on CPU0.
+*
+******************************************************************************/
+static void Amp_Cpu0IrqHandler(void *CallBackRef)
+{
+	MsgQueue_Msg Msg;
+
+	(void)CallBackRef;
+
+	while (MsgQueue_Pop(&AmpShared.ToCpu0, &Msg)) {
+		Amp_Dispatch(&Msg);
+	}
+}
+
+/*****************************************************************************/
+/**
+* Call the handler registered for the type of a message. Messages of an
+* unknown type are dropped.
+*
+* @param	Msg is the message.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Amp_Dispatch(const MsgQueue_Msg *Msg)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < AmpHandlerCount; Index++) {
+		if (AmpHandlers[Index].Type == Msg->Type) {
+			AmpHandlers[Index].Handler(
+				AmpHandlers[Index].CallBackRef, Msg);
+			return;
+		}
+	}
+}
+
+#else /* CPU0 only */
+
+int Amp_SetHandler(u32 Type, Amp_Handler Handler, void *CallBackRef)
+{
+	(void)Type;
+	(void)Handler;
+	(void)CallBackRef;
+	return XST_NO_FEATURE;
+}
+
+int Amp_Start(void)
+{
+	return XST_NO_FEATURE;
+}
+
+int Amp_IsRunning(void)
+{
+	return 0;
+}
+
+int Amp_Send(const MsgQueue_Msg *Msg)
+{
+	(void)Msg;
+	return XST_FAILURE;
+}
+
+u32 Amp_GetDropped(void)
+{
+	return 0U;
+}
+
+void Amp_PrintLock(void)
+{
+}
+
+void Amp_PrintUnlock(void)
+{
+}
+
+#endif
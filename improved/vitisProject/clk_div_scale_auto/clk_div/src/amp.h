@@ -0,0 +1,77 @@
+/*****************************************************************************/
+/**
+* @file amp.h
+*
+* Split of the application over the two Cortex-A9 cores. Built with APP_CPU1
+* defined, the application starts CPU1 in this same ELF next to CPU0: CPU0
+* keeps the interrupts, the pps handling and every PL register write, and
+* hands the work that may take long, the temperature model, formatting and
+* UART output of telemetry, to CPU1 as messages.
+*
+* Messages go through two msg_queue.h queues in a non-cacheable OCM page,
+* one per direction. A message of a type below AMP_TYPE_CPU0 is sent to
+* CPU1, which waits for them in WFE; from AMP_TYPE_CPU0 on it is sent to
+* CPU0 and rings a software generated interrupt there. Each side calls the
+* handler registered for the type of a message it receives.
+*
+* CPU1 runs with the MMU on with the application translation table, the
+* caches on and the SMP bit set, so DDR stays coherent between the two
+* cores through the SCU. It takes no interrupts.
+*
+* Without APP_CPU1, Amp_Start() returns XST_NO_FEATURE and the callers do
+* the work on CPU0 as before.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef AMP_H			/* prevent circular inclusions */
+#define AMP_H			/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "msg_queue.h"
+
+/************************** Constant Definitions ****************************/
+
+#define AMP_MAX_HANDLERS	8U
+#define AMP_TYPE_CPU0		0x80U	/* First type handled by CPU0 */
+
+/* Message types, the Arg[] of each listed in the module that sends it */
+#define AMP_MSG_TEMP_SAMPLE	0x01U	/* temp_comp.c, a pps to fit */
+#define AMP_MSG_TEMP_NUMWIN	0x02U	/* temp_comp.c, restart the model */
+#define AMP_MSG_TELEMETRY	0x03U	/* helloworld.c, a telemetry line */
+#define AMP_MSG_TEMP_TRIM	0x81U	/* temp_comp.c, the trim to write */
+
+#define AMP_SGI_ID		15U	/* CPU1 to CPU0 doorbell */
+#define AMP_PRIORITY		0x18U	/* Below the timer service */
+
+/**************************** Type Definitions ******************************/
+
+/* Called on the receiving core, in IRQ context on CPU0 */
+typedef void (*Amp_Handler)(void *CallBackRef, const MsgQueue_Msg *Msg);
+
+/************************** Function Prototypes *****************************/
+
+int Amp_SetHandler(u32 Type, Amp_Handler Handler, void *CallBackRef);
+int Amp_Start(void);
+int Amp_IsRunning(void);
+int Amp_Send(const MsgQueue_Msg *Msg);
+u32 Amp_GetDropped(void);
+void Amp_PrintLock(void);
+void Amp_PrintUnlock(void);
+
+/*
+ * CPU1 side, entered from amp_cpu1_entry.S
+ */
+void Amp_Cpu1Entry(void);
+void Amp_Cpu1Main(void);
+
+#endif /* end of protection macro */
@@ -0,0 +1,165 @@
+/*****************************************************************************/
+/**
+* @file boot_profile.c
+*
+* Reader of the FSBL boot profile. See boot_profile.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "boot_profile.h"
+
+/************************** Function Prototypes *****************************/
+
+static const char *BootProfile_StageName(u32 Stage);
+static u32 BootProfile_TicksToUs(const BootProfile *ProfilePtr, u64 Ticks);
+
+/*****************************************************************************/
+/**
+* Return the boot profile left by the FSBL.
+*
+* @return	Pointer to the table, or NULL if the FSBL did not leave a
+*		complete table of this version.
+*
+* @note		None.
+*
+******************************************************************************/
+const BootProfile *BootProfile_Get(void)
+{
+	const BootProfile *ProfilePtr =
+		(const BootProfile *)BOOT_PROFILE_BASEADDR;
+
+	if ((ProfilePtr->Magic != BOOT_PROFILE_MAGIC) ||
+	    (ProfilePtr->Version != BOOT_PROFILE_VERSION) ||
+	    (ProfilePtr->Count > BOOT_PROFILE_MAX_ENTRIES) ||
+	    (ProfilePtr->TicksPerSecond == 0U)) {
+		return NULL;
+	}
+
+	return ProfilePtr;
+}
+
+/*****************************************************************************/
+/**
+* Print the boot profile, one line per stage with its start time, duration
+* and, for stages that move data, throughput. Stages that leave a result
+* code, such as the DDR test, print it last.
+*
+* @return
+*		- XST_SUCCESS if a profile was printed
+*		- XST_NO_DATA if the FSBL left none
+*
+* @note		Times are in microseconds from FSBL entry.
+*
+******************************************************************************/
+int BootProfile_Print(void)
+{
+	const BootProfile *ProfilePtr = BootProfile_Get();
+	const BootProfile_Entry *EntryPtr;
+	u32 StartUs;
+	u32 TimeUs;
+	u32 Index;
+
+	if (ProfilePtr == NULL) {
+		xil_printf("No boot profile from the FSBL\r\n");
+		return XST_NO_DATA;
+	}
+
+	xil_printf("Boot profile, boot mode %u, handoff to 0x%08x at %u us\r\n",
+		   ProfilePtr->BootMode, ProfilePtr->HandoffAddr,
+		   BootProfile_TicksToUs(ProfilePtr, ProfilePtr->HandoffTicks));
+	xil_printf("  stage         part    start us     time us       bytes"
+		   "    KB/s\r\n");
+
+	for (Index = 0U; Index < ProfilePtr->Count; Index++) {
+		EntryPtr = &ProfilePtr->Entry[Index];
+
+		StartUs = BootProfile_TicksToUs(ProfilePtr,
+						EntryPtr->StartTicks);
+		if (EntryPtr->EndTicks >= EntryPtr->StartTicks) {
+			TimeUs = BootProfile_TicksToUs(ProfilePtr,
+					EntryPtr->EndTicks -
+					EntryPtr->StartTicks);
+		} else {
+			TimeUs = 0U;
+		}
+
+		xil_printf("  %-12s  ", BootProfile_StageName(EntryPtr->Stage));
+		if (EntryPtr->Partition == BOOT_PROFILE_NO_PARTITION) {
+			xil_printf("   -");
+		} else {
+			xil_printf("%4u", EntryPtr->Partition);
+		}
+		xil_printf("  %10u  %10u", StartUs, TimeUs);
+
+		if ((EntryPtr->Bytes != 0U) && (TimeUs != 0U)) {
+			/* KB/s = bytes / us * 1e6 / 1024, in 64 bits */
+			xil_printf("  %10u  %6u", EntryPtr->Bytes,
+				   (u32)(((u64)EntryPtr->Bytes * 1000000U) /
+					 ((u64)TimeUs * 1024U)));
+		}
+		if (EntryPtr->Result != 0U) {
+			xil_printf("  result 0x%08x", EntryPtr->Result);
+		}
+		xil_printf("\r\n");
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Name of a boot stage.
+*
+* @param	Stage is a BOOT_PROFILE_* stage.
+*
+* @return	Printable name.
+*
+* @note		None.
+*
+******************************************************************************/
+static const char *BootProfile_StageName(u32 Stage)
+{
+	static const char *const Names[] = {
+		"?", "ps7_init", "ddr check", "pcap init", "flash init",
+		"header", "move", "pcap xfer", "pcap load", "md5", "auth",
+		"decrypt", "load image", "handoff", "stream", "md5 cpu1",
+		"sha cpu1", "cpu1 wait", "inflate"
+	};
+
+	if (Stage >= (sizeof(Names) / sizeof(Names[0]))) {
+		return Names[0];
+	}
+
+	return Names[Stage];
+}
+
+/*****************************************************************************/
+/**
+* Convert global timer ticks of the FSBL to microseconds.
+*
+* @param	ProfilePtr is the profile, for the timer frequency.
+* @param	Ticks is the tick count.
+*
+* @return	Microseconds, saturated to 32 bits.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 BootProfile_TicksToUs(const BootProfile *ProfilePtr, u64 Ticks)
+{
+	u64 Us = (Ticks * 1000000U) / ProfilePtr->TicksPerSecond;
+
+	return (Us > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (u32)Us;
+}
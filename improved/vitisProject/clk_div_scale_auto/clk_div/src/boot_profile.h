@@ -0,0 +1,84 @@
+/*****************************************************************************/
+/**
+* @file boot_profile.h
+*
+* Reader of the boot profile the FSBL leaves in the top of OCM: the global
+* timer at the start and end of every boot stage (ps7_init, DDR check, flash
+* init, partition moves, checksums, bitstream download, handoff).
+*
+* The layout must match zynq_fsbl/fsbl_profile.h; BootProfile_Get() rejects
+* a table whose magic number or version does not.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef BOOT_PROFILE_H		/* prevent circular inclusions */
+#define BOOT_PROFILE_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define BOOT_PROFILE_BASEADDR		0xFFFFFA00U
+#define BOOT_PROFILE_MAGIC		0x464F5250U	/* "PROF" */
+#define BOOT_PROFILE_VERSION		1U
+#define BOOT_PROFILE_MAX_ENTRIES	24U
+#define BOOT_PROFILE_NO_PARTITION	0xFFFFFFFFU
+
+/* Boot stages, FSBL_PROF_* */
+#define BOOT_PROFILE_PS7_INIT		1U
+#define BOOT_PROFILE_DDR_CHECK		2U
+#define BOOT_PROFILE_PCAP_INIT		3U
+#define BOOT_PROFILE_FLASH_INIT		4U
+#define BOOT_PROFILE_HEADER		5U
+#define BOOT_PROFILE_MOVE		6U
+#define BOOT_PROFILE_PCAP_XFER		7U
+#define BOOT_PROFILE_PCAP_LOAD		8U
+#define BOOT_PROFILE_MD5		9U
+#define BOOT_PROFILE_AUTH		10U
+#define BOOT_PROFILE_DECRYPT		11U
+#define BOOT_PROFILE_LOAD_IMAGE		12U
+#define BOOT_PROFILE_HANDOFF		13U
+#define BOOT_PROFILE_STREAM		14U
+#define BOOT_PROFILE_CPU1_MD5		15U
+#define BOOT_PROFILE_CPU1_SHA		16U
+#define BOOT_PROFILE_CPU1_WAIT		17U
+#define BOOT_PROFILE_INFLATE		18U
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	u32 Stage;
+	u32 Partition;
+	u32 Bytes;
+	u32 Result;
+	u64 StartTicks;
+	u64 EndTicks;
+} BootProfile_Entry;
+
+typedef struct {
+	u32 Magic;
+	u32 Version;
+	u32 Count;
+	u32 TicksPerSecond;
+	u32 BootMode;
+	u32 HandoffAddr;
+	u64 HandoffTicks;
+	BootProfile_Entry Entry[BOOT_PROFILE_MAX_ENTRIES];
+} BootProfile;
+
+/************************** Function Prototypes *****************************/
+
+const BootProfile *BootProfile_Get(void);
+int BootProfile_Print(void);
+
+#endif /* end of protection macro */
@@ -0,0 +1,125 @@
+/*****************************************************************************/
+/**
+* @file cache_bench.c
+*
+* Cache maintenance benchmark. See cache_bench.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xil_cache.h"
+#include "xil_printf.h"
+#include "xtime_l.h"
+#include "cache_bench.h"
+
+/************************** Constant Definitions ****************************/
+
+#define CACHE_BENCH_SIZES	10U
+
+/************************** Function Prototypes *****************************/
+
+static u32 CacheBench_Time(u32 Op, u32 Length);
+static u32 CacheBench_TicksToNs(XTime Ticks);
+
+/************************** Variable Definitions **************************/
+
+static const u32 CacheBenchLength[CACHE_BENCH_SIZES] = {
+	0x400U, 0x1000U, 0x4000U, 0x8000U, 0x10000U,
+	0x40000U, 0x80000U, 0x100000U, 0x200000U, 0x400000U
+};
+
+/*****************************************************************************/
+/**
+* Time the cache maintenance of every range length and print one line per
+* length: flush, invalidate and full flush, each the mean of
+* CACHE_BENCH_REPEAT runs on a buffer dirtied just before.
+*
+* @return	None.
+*
+* @note		Overwrites CACHE_BENCH_MAX_LEN bytes at CACHE_BENCH_ADDR.
+*
+******************************************************************************/
+void CacheBench_Run(void)
+{
+	u32 Index;
+
+	xil_printf("Cache maintenance of a dirty buffer, ns\r\n");
+	xil_printf("   length      flush range  invalidate range"
+		   "  flush all\r\n");
+
+	for (Index = 0U; Index < CACHE_BENCH_SIZES; Index++) {
+		xil_printf("%9u  %15u  %16u  %9u\r\n", CacheBenchLength[Index],
+			   CacheBench_Time(0U, CacheBenchLength[Index]),
+			   CacheBench_Time(1U, CacheBenchLength[Index]),
+			   CacheBench_Time(2U, CacheBenchLength[Index]));
+	}
+}
+
+/*****************************************************************************/
+/**
+* Time one cache operation on a dirty buffer.
+*
+* @param	Op is 0 for Xil_DCacheFlushRange(), 1 for
+*		Xil_DCacheInvalidateRange(), 2 for Xil_DCacheFlush().
+* @param	Length is the buffer length in bytes.
+*
+* @return	Mean time of CACHE_BENCH_REPEAT runs in ns.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 CacheBench_Time(u32 Op, u32 Length)
+{
+	XTime Start;
+	XTime End;
+	XTime Total = 0U;
+	u32 Run;
+
+	for (Run = 0U; Run < CACHE_BENCH_REPEAT; Run++) {
+		/* Dirty every line of the buffer that fits in the caches */
+		(void)memset((void *)CACHE_BENCH_ADDR, (int)Run, Length);
+
+		XTime_GetTime(&Start);
+		if (Op == 0U) {
+			Xil_DCacheFlushRange((INTPTR)CACHE_BENCH_ADDR, Length);
+		} else if (Op == 1U) {
+			Xil_DCacheInvalidateRange((INTPTR)CACHE_BENCH_ADDR,
+						  Length);
+		} else {
+			Xil_DCacheFlush();
+		}
+		XTime_GetTime(&End);
+
+		Total += End - Start;
+	}
+
+	return CacheBench_TicksToNs(Total / CACHE_BENCH_REPEAT);
+}
+
+/*****************************************************************************/
+/**
+* Convert global timer ticks to ns.
+*
+* @param	Ticks is the time in global timer ticks.
+*
+* @return	Time in ns, saturated at 0xFFFFFFFF.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 CacheBench_TicksToNs(XTime Ticks)
+{
+	u64 Ns = (Ticks * 1000U) / (COUNTS_PER_SECOND / 1000000U);
+
+	return (Ns > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (u32)Ns;
+}
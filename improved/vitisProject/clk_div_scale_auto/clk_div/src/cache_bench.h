@@ -0,0 +1,52 @@
+/*****************************************************************************/
+/**
+* @file cache_bench.h
+*
+* Cost of the data cache maintenance of the BSP against the range length:
+* Xil_DCacheFlushRange() and Xil_DCacheInvalidateRange() on a dirty buffer
+* in DDR, and Xil_DCacheFlush() for comparison. Use it to check the
+* thresholds at which xil_cache.c flushes whole caches instead of lines.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 The buffer is reserved by the linker script.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef CACHE_BENCH_H		/* prevent circular inclusions */
+#define CACHE_BENCH_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Scratch buffers shared by the benchmarks, which never run at the same
+ * time. The linker script reserves BENCH_SCRATCH_LEN bytes after the
+ * stacks, so nothing the program links can be overwritten.
+ */
+#define BENCH_SCRATCH_ADDR	((UINTPTR)__bench_scratch_start)
+#define BENCH_SCRATCH_LEN	((UINTPTR)__bench_scratch_end - \
+				 (UINTPTR)__bench_scratch_start)
+
+#define CACHE_BENCH_ADDR	BENCH_SCRATCH_ADDR
+#define CACHE_BENCH_MAX_LEN	0x400000U
+#define CACHE_BENCH_REPEAT	4U
+
+/************************** Variable Definitions ****************************/
+
+extern u8 __bench_scratch_start[];
+extern u8 __bench_scratch_end[];
+
+/************************** Function Prototypes *****************************/
+
+void CacheBench_Run(void);
+
+#endif /* end of protection macro */
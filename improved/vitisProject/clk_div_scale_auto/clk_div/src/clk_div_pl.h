@@ -0,0 +1,100 @@
+/*****************************************************************************/
+/**
+* @file clk_div_pl.h
+*
+* Register map of the clock divider logic in the PL as seen from the PS. All
+* PL registers are reached through AXI GPIO channels; a block is only
+* available when the matching AXI GPIO (or fabric interrupt) is present in
+* xparameters.h, so software for optional PL blocks compiles out on
+* hardware that does not have them.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release with SCALE and the PTP pps generator.
+* 1.01a xl   10/19/26 Added the window count and divisor trim.
+* 1.02a xl   10/19/26 Added the engine variant library.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef CLK_DIV_PL_H		/* prevent circular inclusions */
+#define CLK_DIV_PL_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Nominal frequency of the sys_clk pin. Software only uses it as a starting
+ * point; the PL measures the real frequency against the pps reference.
+ */
+#define CLK_DIV_SYS_CLK_HZ		10000000U
+
+/*
+ * axi_gpio_0, single channel: SCALE input of clk_div_top.
+ */
+#define CLK_DIV_SCALE_GPIO_DEVICE_ID	XPAR_AXI_GPIO_0_DEVICE_ID
+#define CLK_DIV_SCALE_CHANNEL		1
+
+/*
+ * NUM_WIN generic of clk_div_top: the divisor is the average of this many
+ * pps windows.
+ */
+#define CLK_DIV_NUM_WIN			8U
+
+/*
+ * pps_out of clk_div_top (the pps reference actually in use) on IRQ_F2P[0].
+ */
+#ifdef XPAR_FABRIC_CLK_DIV_TOP_0_PPS_OUT_INTR
+#define CLK_DIV_PPS_INTR_ID	XPAR_FABRIC_CLK_DIV_TOP_0_PPS_OUT_INTR
+#endif
+
+/*
+ * axi_gpio_1, dual channel: pps_gen, the PTP disciplined pps.
+ *  Channel 1: PERIOD, sys_clk cycles per pps.
+ *  Channel 2: bit 0 pps_sel of clk_div_top, bit 1 load toggle,
+ *             bits 31..2 signed STEP in sys_clk cycles.
+ * pps_gen latches PERIOD and STEP when it sees the load toggle change, so
+ * both must be written before the toggle.
+ */
+#ifdef XPAR_AXI_GPIO_1_DEVICE_ID
+#define CLK_DIV_PPS_GEN_GPIO_DEVICE_ID	XPAR_AXI_GPIO_1_DEVICE_ID
+#define CLK_DIV_PPS_GEN_PERIOD_CHANNEL	1
+#define CLK_DIV_PPS_GEN_CTRL_CHANNEL	2
+#endif
+
+#define CLK_DIV_PPS_GEN_SEL_MASK	0x00000001U /**< 1 = pps from pps_gen */
+#define CLK_DIV_PPS_GEN_LOAD_MASK	0x00000002U /**< Load toggle */
+#define CLK_DIV_PPS_GEN_STEP_SHIFT	2U	    /**< STEP field position */
+#define CLK_DIV_PPS_GEN_STEP_MAX	((1 << 29) - 1) /**< STEP range */
+
+/*
+ * axi_gpio_2, dual channel: divisor measurement and trim of clk_div_top.
+ *  Channel 1 (input): WIN_COUNT, SCALE periods of sys_clk counted in the
+ *             last completed pps window.
+ *  Channel 2 (output): DIV_TRIM, signed count added to the averaged
+ *             divisor at the next pps.
+ */
+#ifdef XPAR_AXI_GPIO_2_DEVICE_ID
+#define CLK_DIV_TRIM_GPIO_DEVICE_ID	XPAR_AXI_GPIO_2_DEVICE_ID
+#define CLK_DIV_WIN_COUNT_CHANNEL	1
+#define CLK_DIV_TRIM_CHANNEL		2
+#endif
+
+/*
+ * Partial bitstreams of the divisor engine variants (pr_engine.h), loaded
+ * to DDR by the FSBL. Only for a PL built with the clk_div_pr.xdc
+ * floorplan, so build with CLK_DIV_PR defined for such a PL; a library
+ * left in DDR by an earlier boot must not reach a PL without the
+ * reconfigurable partition.
+ */
+#ifdef CLK_DIV_PR
+#define CLK_DIV_PR_LIB_ADDR		0x20000000U
+#endif
+
+#endif /* end of protection macro */
@@ -0,0 +1,176 @@
+/*****************************************************************************/
+/**
+* @file console.c
+*
+* Interrupt driven input of the stdin UART. See console.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xuartps_hw.h"
+#include "intc.h"
+#include "console.h"
+
+/************************** Constant Definitions ****************************/
+
+#define CONSOLE_BASEADDR	STDIN_BASEADDRESS
+
+#if (STDIN_BASEADDRESS == XPS_UART1_BASEADDR)
+#define CONSOLE_INTR_ID		XPAR_XUARTPS_1_INTR
+#elif (STDIN_BASEADDRESS == XPS_UART0_BASEADDR)
+#define CONSOLE_INTR_ID		XPAR_XUARTPS_0_INTR
+#endif
+
+#define CONSOLE_LINE_SIZE	16U	/* Longest token kept, with the NUL */
+
+/************************** Variable Definitions **************************/
+
+static Sched_Task *ConsoleTask;
+static u32 ConsoleEvents;
+static char ConsoleLine[CONSOLE_LINE_SIZE];
+static u32 ConsoleLength;
+
+/*****************************************************************************/
+/**
+* IRQ handler of the UART. Masks the RX interrupt until the task has read
+* the FIFO, so a burst of characters posts a single event.
+*
+* @param	CallBackRef is unused.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Console_IrqHandler(void *CallBackRef)
+{
+	(void)CallBackRef;
+
+	XUartPs_WriteReg(CONSOLE_BASEADDR, XUARTPS_IDR_OFFSET,
+			 XUARTPS_IXR_RXOVR);
+	XUartPs_WriteReg(CONSOLE_BASEADDR, XUARTPS_ISR_OFFSET,
+			 XUARTPS_IXR_RXOVR);
+
+	Sched_Post(ConsoleTask, ConsoleEvents);
+}
+
+/*****************************************************************************/
+/**
+* Interrupt on every received character and post them to a task.
+*
+* @param	Task is the task that reads the input with Console_GetToken().
+* @param	Events are the event bits posted to it.
+*
+* @return
+*		- XST_SUCCESS if the interrupt is connected
+*		- XST_NO_FEATURE if stdin is not a PS UART
+*		- XST_FAILURE otherwise
+*
+* @note		The UART is left configured as the BSP set it up for stdio.
+*
+******************************************************************************/
+int Console_Init(Sched_Task *Task, u32 Events)
+{
+#ifdef CONSOLE_INTR_ID
+	int Status;
+
+	ConsoleTask = Task;
+	ConsoleEvents = Events;
+	ConsoleLength = 0U;
+
+	XUartPs_WriteReg(CONSOLE_BASEADDR, XUARTPS_IDR_OFFSET,
+			 XUARTPS_IXR_MASK);
+	XUartPs_WriteReg(CONSOLE_BASEADDR, XUARTPS_RXWM_OFFSET, 1U);
+	XUartPs_WriteReg(CONSOLE_BASEADDR, XUARTPS_ISR_OFFSET,
+			 XUARTPS_IXR_MASK);
+
+	Status = Intc_Connect(CONSOLE_INTR_ID,
+			      (Xil_InterruptHandler)Console_IrqHandler, NULL,
+			      CONSOLE_PRIORITY, INTC_TRIGGER_LEVEL);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	XUartPs_WriteReg(CONSOLE_BASEADDR, XUARTPS_IER_OFFSET,
+			 XUARTPS_IXR_RXOVR);
+
+	/* Characters typed before the interrupt was enabled */
+	if (XUartPs_IsReceiveData(CONSOLE_BASEADDR)) {
+		Sched_Post(ConsoleTask, ConsoleEvents);
+	}
+
+	return XST_SUCCESS;
+#else
+	(void)Task;
+	(void)Events;
+	return XST_NO_FEATURE;
+#endif
+}
+
+/*****************************************************************************/
+/**
+* Read the received characters up to the end of the next token, as
+* scanf("%s") would, without waiting for more. Characters past the size of
+* the token are dropped. The RX interrupt is unmasked again once the FIFO
+* is empty.
+*
+* @param	Token receives the NUL terminated token.
+* @param	Size is the size of Token, at least 2.
+*
+* @return	1 if a whole token was read, 0 if the FIFO ran empty first;
+*		the partial token is kept for the next call.
+*
+* @note		Task context only. Call until it returns 0 on each event.
+*
+******************************************************************************/
+int Console_GetToken(char *Token, u32 Size)
+{
+	u32 Index;
+	u8 Data;
+
+	while (XUartPs_IsReceiveData(CONSOLE_BASEADDR)) {
+		Data = (u8)XUartPs_ReadReg(CONSOLE_BASEADDR,
+					   XUARTPS_FIFO_OFFSET);
+		if ((Data != (u8)' ') && (Data != (u8)'\t') &&
+		    (Data != (u8)'\r') && (Data != (u8)'\n')) {
+			if (ConsoleLength < (CONSOLE_LINE_SIZE - 1U)) {
+				ConsoleLine[ConsoleLength] = (char)Data;
+				ConsoleLength++;
+			}
+			continue;
+		}
+		if (ConsoleLength == 0U) {
+			continue;
+		}
+
+		for (Index = 0U; (Index < ConsoleLength) &&
+				 (Index < (Size - 1U)); Index++) {
+			Token[Index] = ConsoleLine[Index];
+		}
+		Token[Index] = '\0';
+		ConsoleLength = 0U;
+		return 1;
+	}
+
+	/* Clear before unmasking so a character already in does not re-raise */
+	XUartPs_WriteReg(CONSOLE_BASEADDR, XUARTPS_ISR_OFFSET,
+			 XUARTPS_IXR_RXOVR);
+	XUartPs_WriteReg(CONSOLE_BASEADDR, XUARTPS_IER_OFFSET,
+			 XUARTPS_IXR_RXOVR);
+	if (XUartPs_IsReceiveData(CONSOLE_BASEADDR)) {
+		Sched_Post(ConsoleTask, ConsoleEvents);
+	}
+
+	return 0;
+}
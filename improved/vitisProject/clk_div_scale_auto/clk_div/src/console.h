@@ -0,0 +1,37 @@
+/*****************************************************************************/
+/**
+* @file console.h
+*
+* Interrupt driven input of the stdin UART. The RX interrupt posts an event
+* to a scheduler task (sched.h) instead of a scanf() blocking the CPU, and
+* the task takes the received characters as whitespace separated tokens.
+* Output still goes through xil_printf().
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef CONSOLE_H		/* prevent circular inclusions */
+#define CONSOLE_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "sched.h"
+
+/************************** Constant Definitions ****************************/
+
+#define CONSOLE_PRIORITY	0xA0U	/* Below the pps and the timers */
+
+/************************** Function Prototypes *****************************/
+
+int Console_Init(Sched_Task *Task, u32 Events);
+int Console_GetToken(char *Token, u32 Size);
+
+#endif /* end of protection macro */
@@ -0,0 +1,270 @@
+/*****************************************************************************/
+/**
+* @file intc.c
+*
+* Single GIC instance of the application. See intc.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 Added Intc_SetFiq() and the SGI helpers
+* 1.02a xl   10/19/26 Handlers go through irq_prof.c with IRQ_PROF
+* 1.03a xl   10/19/26 The GIC instance is locked in the L2, see l2_lock.h
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+#include "xscugic.h"
+#include "xil_exception.h"
+#include "xil_io.h"
+#include "xstatus.h"
+#include "intc.h"
+#include "irq_prof.h"
+#include "l2_lock.h"
+
+/************************** Constant Definitions ****************************/
+
+#define INTC_DEVICE_ID		XPAR_SCUGIC_0_DEVICE_ID
+
+/*
+ * With security extensions the secure ICDDCR enables group 0 (secure) and
+ * group 1 (non-secure) interrupts separately
+ */
+#define INTC_DIST_EN_GROUPS	0x3U
+
+#define INTC_ICDISR_REGS	((XSCUGIC_MAX_NUM_INTR_INPUTS + 31U) / 32U)
+
+/************************** Variable Definitions **************************/
+
+static XScuGic IntcInstance L2_LOCKED_DATA;
+static u32 IntcReady;
+
+/*
+ * Set once group 0 is signalled as FIQ. Read by CPU1 too, which raises SGIs
+ * at CPU0 through Intc_RaiseSgi().
+ */
+static volatile u32 IntcFiqMode;
+
+/*****************************************************************************/
+/**
+* Initialize the GIC and hook it into the IRQ exception. Safe to call more
+* than once; only the first call touches the hardware.
+*
+* @return
+*		- XST_SUCCESS if the GIC is ready
+*		- XST_FAILURE if it could not be initialized
+*
+* @note		IRQs are enabled in the CPSR on return.
+*
+******************************************************************************/
+int Intc_Init(void)
+{
+	XScuGic_Config *ConfigPtr;
+	int Status;
+
+	if (IntcReady != 0U) {
+		return XST_SUCCESS;
+	}
+
+	ConfigPtr = XScuGic_LookupConfig(INTC_DEVICE_ID);
+	if (ConfigPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XScuGic_CfgInitialize(&IntcInstance, ConfigPtr,
+				       ConfigPtr->CpuBaseAddress);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Xil_ExceptionInit();
+#ifdef IRQ_PROF
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+			(Xil_ExceptionHandler)IrqProf_Exception,
+			&IntcInstance);
+#else
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+			(Xil_ExceptionHandler)XScuGic_InterruptHandler,
+			&IntcInstance);
+#endif
+	Xil_ExceptionEnable();
+
+	IntcReady = 1U;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Return the GIC instance, for drivers that need it directly.
+*
+* @return	Pointer to the GIC instance. Intc_Init() must have succeeded.
+*
+* @note		None.
+*
+******************************************************************************/
+XScuGic *Intc_GetInstance(void)
+{
+	return &IntcInstance;
+}
+
+/*****************************************************************************/
+/**
+* Connect a handler to an interrupt, set its priority and trigger type and
+* enable it in the distributor.
+*
+* @param	IntId is the GIC interrupt ID.
+* @param	Handler is called in IRQ context with CallBackRef.
+* @param	CallBackRef is passed to the handler.
+* @param	Priority is the GIC priority, a multiple of 8, lower is higher.
+* @param	Trigger is INTC_TRIGGER_LEVEL or INTC_TRIGGER_RISING.
+*
+* @return
+*		- XST_SUCCESS if the interrupt is connected and enabled
+*		- XST_FAILURE otherwise
+*
+* @note		With IRQ_PROF the handler is called through the profiling
+*		trampoline of irq_prof.c.
+*
+******************************************************************************/
+int Intc_Connect(u32 IntId, Xil_InterruptHandler Handler, void *CallBackRef,
+		 u8 Priority, u8 Trigger)
+{
+	int Status;
+
+	Status = Intc_Init();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	XScuGic_SetPriorityTriggerType(&IntcInstance, IntId, Priority, Trigger);
+
+#ifdef IRQ_PROF
+	/* Out of slots, the handler is connected as it is */
+	(void)IrqProf_Wrap(IntId, &Handler, &CallBackRef);
+#endif
+
+	Status = XScuGic_Connect(&IntcInstance, IntId, Handler, CallBackRef);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	XScuGic_Enable(&IntcInstance, IntId);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Route an interrupt to FIQ or back to IRQ.
+*
+* The GIC signals group 0 (secure) interrupts as FIQ once ICCICR.FIQEn is
+* set. The first call moves every interrupt to group 1, which stays IRQ,
+* and enables both groups, then this one interrupt is moved to group 0.
+* The handler connected with Intc_Connect() keeps serving the interrupt
+* when the IRQ path acknowledges it first, so it should stay connected.
+*
+* @param	IntId is the GIC interrupt ID, connected with Intc_Connect().
+* @param	Fiq is 1 to signal the interrupt as FIQ, 0 for IRQ.
+*
+* @return
+*		- XST_SUCCESS if the interrupt is routed
+*		- XST_FAILURE if the GIC is not ready or IntId is out of range
+*
+* @note		The FIQ vector has to be installed with
+*		Xil_ExceptionSetFiqVector() before the interrupt is routed, and
+*		FIQs unmasked in the CPSR after. SGIs raised at a CPU in FIQ mode
+*		go through Intc_RaiseSgi(), since the GIC drops an SGI raised
+*		for the wrong group.
+*
+******************************************************************************/
+int Intc_SetFiq(u32 IntId, u32 Fiq)
+{
+	UINTPTR DistBase;
+	UINTPTR CpuBase;
+	u32 Offset;
+	u32 Reg;
+	u32 Index;
+
+	if ((IntcReady == 0U) || (IntId >= XSCUGIC_MAX_NUM_INTR_INPUTS)) {
+		return XST_FAILURE;
+	}
+
+	DistBase = IntcInstance.Config->DistBaseAddress;
+	CpuBase = IntcInstance.Config->CpuBaseAddress;
+
+	if (IntcFiqMode == 0U) {
+		for (Index = 0U; Index < INTC_ICDISR_REGS; Index++) {
+			Xil_Out32(DistBase + XSCUGIC_SECURITY_OFFSET +
+				  (Index * 4U), 0xFFFFFFFFU);
+		}
+		Xil_Out32(DistBase + XSCUGIC_DIST_EN_OFFSET,
+			  INTC_DIST_EN_GROUPS);
+		Xil_Out32(CpuBase + XSCUGIC_CONTROL_OFFSET,
+			  XSCUGIC_CNTR_FIQEN_MASK | XSCUGIC_CNTR_ACKCTL_MASK |
+			  XSCUGIC_CNTR_EN_NS_MASK | XSCUGIC_CNTR_EN_S_MASK);
+		IntcFiqMode = 1U;
+	}
+
+	Offset = XSCUGIC_SECURITY_TARGET_OFFSET_CALC(IntId);
+	Reg = Xil_In32(DistBase + Offset);
+	if (Fiq != 0U) {
+		Reg &= ~((u32)1U << (IntId % 32U));
+	} else {
+		Reg |= (u32)1U << (IntId % 32U);
+	}
+	Xil_Out32(DistBase + Offset, Reg);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Return the ICDSGIR value that raises an SGI. Fast paths precompute it and
+* write it themselves.
+*
+* @param	IntId is the SGI, 0 to 15.
+* @param	CpuMask is INTC_CPU0 and/or INTC_CPU1.
+*
+* @return	The ICDSGIR value.
+*
+* @note		Once Intc_SetFiq() has run, SGIs are group 1 and need the
+*		SATT bit to be forwarded.
+*
+******************************************************************************/
+u32 Intc_SgiValue(u32 IntId, u32 CpuMask)
+{
+	u32 Value;
+
+	Value = ((CpuMask << 16) & XSCUGIC_SFI_TRIG_CPU_MASK) |
+		(IntId & XSCUGIC_SFI_TRIG_INTID_MASK);
+	if (IntcFiqMode != 0U) {
+		Value |= XSCUGIC_SFI_TRIG_SATT_MASK;
+	}
+
+	return Value;
+}
+
+/*****************************************************************************/
+/**
+* Raise an SGI. Callable from any CPU and from interrupt context.
+*
+* @param	IntId is the SGI, 0 to 15.
+* @param	CpuMask is INTC_CPU0 and/or INTC_CPU1.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void Intc_RaiseSgi(u32 IntId, u32 CpuMask)
+{
+	Xil_Out32(XPAR_PS7_SCUGIC_0_DIST_BASEADDR + XSCUGIC_SFI_TRIG_OFFSET,
+		  Intc_SgiValue(IntId, CpuMask));
+}
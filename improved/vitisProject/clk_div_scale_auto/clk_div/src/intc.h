@@ -0,0 +1,48 @@
+/*****************************************************************************/
+/**
+* @file intc.h
+*
+* Single GIC instance of the application. Every module that takes an
+* interrupt connects it through Intc_Connect() so the GIC and the ARM
+* exception table are set up exactly once.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 Added Intc_SetFiq() and the SGI helpers
+* 1.02a xl   10/19/26 Handlers go through irq_prof.c with IRQ_PROF
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef INTC_H			/* prevent circular inclusions */
+#define INTC_H			/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xscugic.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Trigger types for Intc_Connect(), as encoded in the GIC ICDICFR */
+#define INTC_TRIGGER_LEVEL	0x1U	/* Active high level */
+#define INTC_TRIGGER_RISING	0x3U	/* Rising edge */
+
+/* Targets for Intc_RaiseSgi() */
+#define INTC_CPU0		0x1U
+#define INTC_CPU1		0x2U
+
+/************************** Function Prototypes *****************************/
+
+int Intc_Init(void);
+XScuGic *Intc_GetInstance(void);
+int Intc_Connect(u32 IntId, Xil_InterruptHandler Handler, void *CallBackRef,
+		 u8 Priority, u8 Trigger);
+int Intc_SetFiq(u32 IntId, u32 Fiq);
+u32 Intc_SgiValue(u32 IntId, u32 CpuMask);
+void Intc_RaiseSgi(u32 IntId, u32 CpuMask);
+
+#endif /* end of protection macro */
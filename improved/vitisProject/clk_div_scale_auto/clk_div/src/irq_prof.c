@@ -0,0 +1,654 @@
+/*****************************************************************************/
+/**
+* @file irq_prof.c
+*
+* Interrupt latency and jitter profiling. See irq_prof.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xil_io.h"
+#include "xil_printf.h"
+#include "xpseudo_asm.h"
+#include "xtime_l.h"
+#include "xscugic.h"
+#include "xscuwdt_hw.h"
+#include "xpm_counter.h"
+#include "xl2cc_counter.h"
+#include "xl2cc.h"
+#include "intc.h"
+#include "irq_prof.h"
+
+#ifdef IRQ_PROF
+
+/************************** Constant Definitions ****************************/
+
+#define IRQ_PROF_GT_LO		(GLOBAL_TMR_BASEADDR + \
+				 GTIMER_COUNTER_LOWER_OFFSET)
+
+/* PMU event counters of XPM_CNTRCFG1 */
+#define IRQ_PROF_PM_ICACHE	1U	/* XPM_EVENT_INSRFETCH_CACHEREFILL */
+#define IRQ_PROF_PM_DCACHE	3U	/* XPM_EVENT_DATA_CACHEREFILL */
+#define IRQ_PROF_PMCR_E		0x00000001U	/* Enable all counters */
+#define IRQ_PROF_PMCNTEN_CYCLES	0x80000000U	/* Cycle counter */
+
+/* L2 event counter control: reset both counters and keep counting */
+#define IRQ_PROF_L2_RESTART	0x7U
+
+/* Private watchdog of CPU0 in timer mode, the probe */
+#define IRQ_PROF_PROBE_BASE	XPAR_SCUWDT_0_BASEADDR
+#define IRQ_PROF_PROBE_INTR_ID	XPAR_SCUWDT_INTR
+#define IRQ_PROF_PROBE_TICKS \
+	((u32)(((u64)IRQ_PROF_PROBE_US * COUNTS_PER_SECOND) / 1000000U))
+
+#define IRQ_PROF_CPU_HZ		XPAR_CPU_CORTEXA9_CORE_CLOCK_FREQ_HZ
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	Xil_InterruptHandler Handler;	/* Handler passed to Intc_Connect() */
+	void *CallBackRef;
+	IrqProf_Stats Stats;
+} IrqProf_Slot;
+
+/************************** Function Prototypes *****************************/
+
+static void IrqProf_Handler(void *CallBackRef);
+static void IrqProf_ProbeHandler(void *CallBackRef);
+static void IrqProf_HistAdd(IrqProf_Hist *HistPtr, u32 Value);
+static void IrqProf_HistReset(IrqProf_Hist *HistPtr);
+static void IrqProf_PrintHist(const char *Name, const IrqProf_Hist *HistPtr,
+			      u32 Hz);
+static u32 IrqProf_ToNs(u64 Value, u32 Hz);
+
+/************************** Variable Definitions **************************/
+
+static IrqProf_Slot IrqProfSlots[IRQ_PROF_MAX_SLOTS];
+static u32 IrqProfSlotCount;
+static volatile u32 IrqProfOn;
+static u32 IrqProfEntryTicks;	/* Global timer at the last IRQ exception */
+static IrqProf_Hist IrqProfProbe;
+
+/*****************************************************************************/
+/**
+* IRQ exception handler in place of XScuGic_InterruptHandler(). Timestamps
+* the exception for the entry latency of the handler it dispatches.
+*
+* @param	IntcPtr is the GIC instance.
+*
+* @return	None.
+*
+* @note		Registered by Intc_Init().
+*
+******************************************************************************/
+void IrqProf_Exception(void *IntcPtr)
+{
+	IrqProfEntryTicks = Xil_In32(IRQ_PROF_GT_LO);
+	XScuGic_InterruptHandler((XScuGic *)IntcPtr);
+}
+
+/*****************************************************************************/
+/**
+* Put the profiling trampoline in front of a handler. Called by
+* Intc_Connect(); connecting the same interrupt again reuses its slot.
+*
+* @param	IntId is the GIC interrupt ID.
+* @param	HandlerPtr is the handler, replaced with the trampoline.
+* @param	CallBackRefPtr is its argument, replaced with the slot.
+*
+* @return
+*		- XST_SUCCESS if the handler is profiled
+*		- XST_FAILURE if IRQ_PROF_MAX_SLOTS are in use; the handler
+*		  and its argument are left as they are
+*
+* @note		None.
+*
+******************************************************************************/
+int IrqProf_Wrap(u32 IntId, Xil_InterruptHandler *HandlerPtr,
+		 void **CallBackRefPtr)
+{
+	IrqProf_Slot *SlotPtr = NULL;
+	u32 Index;
+
+	for (Index = 0U; Index < IrqProfSlotCount; Index++) {
+		if (IrqProfSlots[Index].Stats.IntId == IntId) {
+			SlotPtr = &IrqProfSlots[Index];
+			break;
+		}
+	}
+
+	if (SlotPtr == NULL) {
+		if (IrqProfSlotCount >= IRQ_PROF_MAX_SLOTS) {
+			return XST_FAILURE;
+		}
+		SlotPtr = &IrqProfSlots[IrqProfSlotCount];
+		SlotPtr->Stats.IntId = IntId;
+		IrqProfSlotCount++;
+	}
+
+	SlotPtr->Handler = *HandlerPtr;
+	SlotPtr->CallBackRef = *CallBackRefPtr;
+	*HandlerPtr = IrqProf_Handler;
+	*CallBackRefPtr = SlotPtr;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Set up the counters, clear the histograms and start the probe.
+*
+* @return
+*		- XST_SUCCESS if the profile runs
+*		- XST_FAILURE if the probe interrupt could not be connected
+*
+* @note		Takes the PMU and the L2 event counters for itself.
+*
+******************************************************************************/
+int IrqProf_Start(void)
+{
+	u32 Control;
+	u32 Index;
+	u32 Cpsr;
+	int Status;
+
+	Status = Intc_Connect(IRQ_PROF_PROBE_INTR_ID,
+			      (Xil_InterruptHandler)IrqProf_ProbeHandler, NULL,
+			      IRQ_PROF_PROBE_PRIORITY, INTC_TRIGGER_RISING);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/* L1 refills on event counters 1 and 3, and the cycle counter */
+	Xpm_SetEvents(XPM_CNTRCFG1);
+	mtcp(XREG_CP15_PERF_MONITOR_CTRL,
+	     mfcp(XREG_CP15_PERF_MONITOR_CTRL) | IRQ_PROF_PMCR_E);
+	mtcp(XREG_CP15_COUNT_ENABLE_SET, IRQ_PROF_PMCNTEN_CYCLES);
+
+	XL2cc_EventCtrInit(XL2CC_DRREQ, XL2CC_DRHIT);
+	XL2cc_EventCtrStart();
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_IRQ);
+	for (Index = 0U; Index < IrqProfSlotCount; Index++) {
+		(void)IrqProf_GetStats(Index, NULL, 1U);
+	}
+	IrqProf_HistReset(&IrqProfProbe);
+	IrqProfOn = 1U;
+	mtcpsr(Cpsr);
+
+	/* Timer mode needs the watchdog disable sequence if it was a watchdog */
+	Control = XScuWdt_ReadReg(IRQ_PROF_PROBE_BASE, XSCUWDT_CONTROL_OFFSET);
+	if ((Control & XSCUWDT_CONTROL_WD_MODE_MASK) != 0U) {
+		XScuWdt_WriteReg(IRQ_PROF_PROBE_BASE, XSCUWDT_DISABLE_OFFSET,
+				 XSCUWDT_DISABLE_VALUE1);
+		XScuWdt_WriteReg(IRQ_PROF_PROBE_BASE, XSCUWDT_DISABLE_OFFSET,
+				 XSCUWDT_DISABLE_VALUE2);
+	}
+	XScuWdt_WriteReg(IRQ_PROF_PROBE_BASE, XSCUWDT_CONTROL_OFFSET, 0U);
+	XScuWdt_WriteReg(IRQ_PROF_PROBE_BASE, XSCUWDT_LOAD_OFFSET,
+			 IRQ_PROF_PROBE_TICKS - 1U);
+	XScuWdt_WriteReg(IRQ_PROF_PROBE_BASE, XSCUWDT_ISR_OFFSET,
+			 XSCUWDT_ISR_EVENT_FLAG_MASK);
+	XScuWdt_WriteReg(IRQ_PROF_PROBE_BASE, XSCUWDT_CONTROL_OFFSET,
+			 XSCUWDT_CONTROL_IT_ENABLE_MASK |
+			 XSCUWDT_CONTROL_AUTO_RELOAD_MASK |
+			 XSCUWDT_CONTROL_WD_ENABLE_MASK);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Stop the probe and the profile. The histograms are kept.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void IrqProf_Stop(void)
+{
+	u32 Req;
+	u32 Hit;
+
+	IrqProfOn = 0U;
+	XScuWdt_WriteReg(IRQ_PROF_PROBE_BASE, XSCUWDT_CONTROL_OFFSET, 0U);
+	XScuWdt_WriteReg(IRQ_PROF_PROBE_BASE, XSCUWDT_ISR_OFFSET,
+			 XSCUWDT_ISR_EVENT_FLAG_MASK);
+	XL2cc_EventCtrStop(&Req, &Hit);
+}
+
+/*****************************************************************************/
+/**
+* Return the number of profiled interrupts.
+*
+* @return	Slots in use, the Index range of IrqProf_GetStats().
+*
+* @note		None.
+*
+******************************************************************************/
+u32 IrqProf_GetCount(void)
+{
+	return IrqProfSlotCount;
+}
+
+/*****************************************************************************/
+/**
+* Copy the histograms of one profiled interrupt.
+*
+* @param	Index is the slot, below IrqProf_GetCount().
+* @param	StatsPtr returns the histograms; NULL to only reset them.
+* @param	Reset is 1 to start over after the copy.
+*
+* @return
+*		- XST_SUCCESS if the slot exists
+*		- XST_FAILURE otherwise
+*
+* @note		None.
+*
+******************************************************************************/
+int IrqProf_GetStats(u32 Index, IrqProf_Stats *StatsPtr, u32 Reset)
+{
+	IrqProf_Stats *SlotStatsPtr;
+	u32 Cpsr;
+
+	if (Index >= IrqProfSlotCount) {
+		return XST_FAILURE;
+	}
+	SlotStatsPtr = &IrqProfSlots[Index].Stats;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_IRQ);
+
+	if (StatsPtr != NULL) {
+		*StatsPtr = *SlotStatsPtr;
+	}
+	if (Reset != 0U) {
+		IrqProf_HistReset(&SlotStatsPtr->Entry);
+		IrqProf_HistReset(&SlotStatsPtr->Cycles);
+		IrqProf_HistReset(&SlotStatsPtr->ICacheMiss);
+		IrqProf_HistReset(&SlotStatsPtr->DCacheMiss);
+		IrqProf_HistReset(&SlotStatsPtr->L2Miss);
+	}
+
+	mtcpsr(Cpsr);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Copy the probe histogram, the latency from the probe event to its handler
+* in global timer ticks.
+*
+* @param	HistPtr returns the histogram.
+* @param	Reset is 1 to start over after the copy.
+*
+* @return	None.
+*
+* @note		The latency includes the counter reads of the trampoline in
+*		front of the probe handler, a constant.
+*
+******************************************************************************/
+void IrqProf_GetProbe(IrqProf_Hist *HistPtr, u32 Reset)
+{
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_IRQ);
+
+	*HistPtr = IrqProfProbe;
+	if (Reset != 0U) {
+		IrqProf_HistReset(&IrqProfProbe);
+	}
+
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+* Print every profiled interrupt that was taken, with its run time
+* histogram, and the probe latency histogram.
+*
+* @param	Reset is 1 to start over after the print.
+*
+* @return	None.
+*
+* @note		Not for interrupt context.
+*
+******************************************************************************/
+void IrqProf_Print(u32 Reset)
+{
+	static IrqProf_Stats Stats;
+	static IrqProf_Hist Probe;
+	u32 Index;
+
+	xil_printf("Interrupt profile, mean/max\r\n");
+	for (Index = 0U; Index < IrqProfSlotCount; Index++) {
+		(void)IrqProf_GetStats(Index, &Stats, Reset);
+		if (Stats.Cycles.Count == 0U) {
+			continue;
+		}
+		xil_printf("irq %u: %u calls, entry %u/%u ns, run %u/%u ns, "
+			   "L1 I %u/%u, L1 D %u/%u, L2 %u/%u misses\r\n",
+			   Stats.IntId, Stats.Cycles.Count,
+			   IrqProf_ToNs(Stats.Entry.Sum / Stats.Entry.Count,
+					COUNTS_PER_SECOND),
+			   IrqProf_ToNs(Stats.Entry.Max, COUNTS_PER_SECOND),
+			   IrqProf_ToNs(Stats.Cycles.Sum / Stats.Cycles.Count,
+					IRQ_PROF_CPU_HZ),
+			   IrqProf_ToNs(Stats.Cycles.Max, IRQ_PROF_CPU_HZ),
+			   (u32)(Stats.ICacheMiss.Sum / Stats.ICacheMiss.Count),
+			   Stats.ICacheMiss.Max,
+			   (u32)(Stats.DCacheMiss.Sum / Stats.DCacheMiss.Count),
+			   Stats.DCacheMiss.Max,
+			   (u32)(Stats.L2Miss.Sum / Stats.L2Miss.Count),
+			   Stats.L2Miss.Max);
+		IrqProf_PrintHist("run", &Stats.Cycles, IRQ_PROF_CPU_HZ);
+	}
+
+	IrqProf_GetProbe(&Probe, Reset);
+	if (Probe.Count != 0U) {
+		xil_printf("probe: %u events, latency min %u ns, max %u ns\r\n",
+			   Probe.Count,
+			   IrqProf_ToNs(Probe.Min, COUNTS_PER_SECOND),
+			   IrqProf_ToNs(Probe.Max, COUNTS_PER_SECOND));
+		IrqProf_PrintHist("latency", &Probe, COUNTS_PER_SECOND);
+	}
+}
+
+/*****************************************************************************/
+/**
+* Profiling trampoline, connected to the GIC in place of every handler.
+*
+* @param	CallBackRef is the IrqProf_Slot of the interrupt.
+*
+* @return	None.
+*
+* @note		IRQ context.
+*
+******************************************************************************/
+static void IrqProf_Handler(void *CallBackRef)
+{
+	IrqProf_Slot *SlotPtr = (IrqProf_Slot *)CallBackRef;
+	u32 Entry;
+	u32 Cycles;
+	u32 ICache;
+	u32 DCache;
+	u32 Count;
+	u32 Req;
+	u32 Hit;
+
+	if (IrqProfOn == 0U) {
+		SlotPtr->Handler(SlotPtr->CallBackRef);
+		return;
+	}
+
+	Entry = Xil_In32(IRQ_PROF_GT_LO) - IrqProfEntryTicks;
+	(void)Xpm_GetEventCounter(IRQ_PROF_PM_ICACHE, &ICache);
+	(void)Xpm_GetEventCounter(IRQ_PROF_PM_DCACHE, &DCache);
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_EVNT_CNTRL_OFFSET,
+		  IRQ_PROF_L2_RESTART);
+	Cycles = Xpm_ReadCycleCounterVal();
+
+	SlotPtr->Handler(SlotPtr->CallBackRef);
+
+	Cycles = Xpm_ReadCycleCounterVal() - Cycles;
+	Req = Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_EVNT_CNT0_VAL_OFFSET);
+	Hit = Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_EVNT_CNT1_VAL_OFFSET);
+	(void)Xpm_GetEventCounter(IRQ_PROF_PM_ICACHE, &Count);
+	ICache = Count - ICache;
+	(void)Xpm_GetEventCounter(IRQ_PROF_PM_DCACHE, &Count);
+	DCache = Count - DCache;
+
+	IrqProf_HistAdd(&SlotPtr->Stats.Entry, Entry);
+	IrqProf_HistAdd(&SlotPtr->Stats.Cycles, Cycles);
+	IrqProf_HistAdd(&SlotPtr->Stats.ICacheMiss, ICache);
+	IrqProf_HistAdd(&SlotPtr->Stats.DCacheMiss, DCache);
+	IrqProf_HistAdd(&SlotPtr->Stats.L2Miss, (Req > Hit) ? (Req - Hit) : 0U);
+}
+
+/*****************************************************************************/
+/**
+* Handler of the probe. The watchdog counter was reloaded at the event and
+* has counted down since.
+*
+* @param	CallBackRef is unused.
+*
+* @return	None.
+*
+* @note		IRQ context.
+*
+******************************************************************************/
+static void IrqProf_ProbeHandler(void *CallBackRef)
+{
+	u32 Counter;
+
+	(void)CallBackRef;
+
+	Counter = XScuWdt_ReadReg(IRQ_PROF_PROBE_BASE, XSCUWDT_COUNTER_OFFSET);
+	XScuWdt_WriteReg(IRQ_PROF_PROBE_BASE, XSCUWDT_ISR_OFFSET,
+			 XSCUWDT_ISR_EVENT_FLAG_MASK);
+
+	if (IrqProfOn != 0U) {
+		IrqProf_HistAdd(&IrqProfProbe,
+				(IRQ_PROF_PROBE_TICKS - 1U) - Counter);
+	}
+}
+
+/*****************************************************************************/
+/**
+* Return the bucket of a value: the value itself below 4, then 4 buckets
+* per power of 2.
+*
+* @param	Value is the value to histogram.
+*
+* @return	Bucket, below IRQ_PROF_BUCKETS.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 IrqProf_Bucket(u32 Value)
+{
+	u32 Log2;
+	u32 Bucket;
+
+	if (Value < 4U) {
+		return Value;
+	}
+
+	Log2 = 31U - (u32)__builtin_clz(Value);
+	Bucket = ((Log2 - 1U) * 4U) + ((Value >> (Log2 - 2U)) & 0x3U);
+
+	return (Bucket < IRQ_PROF_BUCKETS) ? Bucket : (IRQ_PROF_BUCKETS - 1U);
+}
+
+/*****************************************************************************/
+/**
+* Return the lowest value that falls in a bucket.
+*
+* @param	Bucket is the bucket, below IRQ_PROF_BUCKETS.
+*
+* @return	Lowest value of the bucket.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 IrqProf_BucketLow(u32 Bucket)
+{
+	if (Bucket < 4U) {
+		return Bucket;
+	}
+
+	return (4U + (Bucket % 4U)) << ((Bucket / 4U) - 1U);
+}
+
+/*****************************************************************************/
+/**
+* Add a value to a histogram.
+*
+* @param	HistPtr is the histogram.
+* @param	Value is the value.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void IrqProf_HistAdd(IrqProf_Hist *HistPtr, u32 Value)
+{
+	if ((HistPtr->Count == 0U) || (Value < HistPtr->Min)) {
+		HistPtr->Min = Value;
+	}
+	if (Value > HistPtr->Max) {
+		HistPtr->Max = Value;
+	}
+	HistPtr->Sum += Value;
+	HistPtr->Count++;
+	HistPtr->Bucket[IrqProf_Bucket(Value)]++;
+}
+
+/*****************************************************************************/
+/**
+* Empty a histogram.
+*
+* @param	HistPtr is the histogram.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void IrqProf_HistReset(IrqProf_Hist *HistPtr)
+{
+	u32 Index;
+
+	HistPtr->Count = 0U;
+	HistPtr->Min = 0U;
+	HistPtr->Max = 0U;
+	HistPtr->Sum = 0U;
+	for (Index = 0U; Index < IRQ_PROF_BUCKETS; Index++) {
+		HistPtr->Bucket[Index] = 0U;
+	}
+}
+
+/*****************************************************************************/
+/**
+* Print the non-empty buckets of a histogram, lowest value in ns and count,
+* a few to a line.
+*
+* @param	Name labels the histogram.
+* @param	HistPtr is the histogram.
+* @param	Hz is the rate of the histogram unit.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void IrqProf_PrintHist(const char *Name, const IrqProf_Hist *HistPtr,
+			      u32 Hz)
+{
+	u32 Index;
+	u32 Column = 0U;
+
+	xil_printf("  %s ns:count", Name);
+	for (Index = 0U; Index < IRQ_PROF_BUCKETS; Index++) {
+		if (HistPtr->Bucket[Index] == 0U) {
+			continue;
+		}
+		if ((Column != 0U) && ((Column % 6U) == 0U)) {
+			xil_printf("\r\n   ");
+		}
+		xil_printf(" %u:%u", IrqProf_ToNs(IrqProf_BucketLow(Index), Hz),
+			   HistPtr->Bucket[Index]);
+		Column++;
+	}
+	xil_printf("\r\n");
+}
+
+/*****************************************************************************/
+/**
+* Convert a count of a clock to ns.
+*
+* @param	Value is the count.
+* @param	Hz is the clock rate.
+*
+* @return	ns.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 IrqProf_ToNs(u64 Value, u32 Hz)
+{
+	return (u32)((Value * 1000000000U) / Hz);
+}
+
+#else /* No profiling */
+
+void IrqProf_Exception(void *IntcPtr)
+{
+	XScuGic_InterruptHandler((XScuGic *)IntcPtr);
+}
+
+int IrqProf_Wrap(u32 IntId, Xil_InterruptHandler *HandlerPtr,
+		 void **CallBackRefPtr)
+{
+	(void)IntId;
+	(void)HandlerPtr;
+	(void)CallBackRefPtr;
+	return XST_NO_FEATURE;
+}
+
+int IrqProf_Start(void)
+{
+	return XST_NO_FEATURE;
+}
+
+void IrqProf_Stop(void)
+{
+}
+
+u32 IrqProf_GetCount(void)
+{
+	return 0U;
+}
+
+int IrqProf_GetStats(u32 Index, IrqProf_Stats *StatsPtr, u32 Reset)
+{
+	(void)Index;
+	(void)StatsPtr;
+	(void)Reset;
+	return XST_FAILURE;
+}
+
+void IrqProf_GetProbe(IrqProf_Hist *HistPtr, u32 Reset)
+{
+	(void)Reset;
+	HistPtr->Count = 0U;
+}
+
+u32 IrqProf_BucketLow(u32 Bucket)
+{
+	return Bucket;
+}
+
+void IrqProf_Print(u32 Reset)
+{
+	(void)Reset;
+	xil_printf("Built without IRQ_PROF\r\n");
+}
+
+#endif
@@ -0,0 +1,92 @@
+/*****************************************************************************/
+/**
+* @file irq_prof.h
+*
+* Interrupt latency and jitter profiling. Built with IRQ_PROF defined,
+* every handler connected with Intc_Connect() is called through a profiling
+* trampoline, and the IRQ exception is timestamped before the GIC is
+* acknowledged. While the profile runs, each call of a handler adds to
+* histograms of:
+*  - the entry latency, from the IRQ exception to the handler, in global
+*    timer ticks. It covers the GIC acknowledge and the dispatch.
+*  - the run time of the handler in CPU cycles, from the PMU cycle counter.
+*  - the L1 instruction and data cache refills in the handler, from the PMU
+*    event counters set up with Xpm_SetEvents().
+*  - the L2 read misses in the handler, from the L2 cache controller event
+*    counters of xl2cc_counter.c. The L2 counts every master, CPU1 and the
+*    DMA included, so they are an upper bound.
+*
+* A probe interrupt, the private watchdog of CPU0 in timer mode, fires every
+* IRQ_PROF_PROBE_US. Its counter reloads at the event, so the probe
+* handler knows how long ago the event was: that is the latency from the
+* hardware event to a handler, with everything in front of it, the other
+* handlers and the IRQ-masked sections. At 100 us the probe makes a
+* million events in under two minutes.
+*
+* Without IRQ_PROF, IrqProf_Start() returns XST_NO_FEATURE and handlers are
+* connected as they are.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef IRQ_PROF_H		/* prevent circular inclusions */
+#define IRQ_PROF_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_exception.h"
+
+/************************** Constant Definitions ****************************/
+
+#define IRQ_PROF_MAX_SLOTS	16U	/* Interrupts profiled */
+#define IRQ_PROF_PROBE_US	100U
+#define IRQ_PROF_PROBE_PRIORITY	0xF0U	/* Lowest, waits behind everything */
+
+/*
+ * Histogram buckets: exact below 4, then 4 per power of 2 up to 2^17,
+ * everything above in the last bucket. IrqProf_BucketLow() gives the
+ * lowest value of a bucket.
+ */
+#define IRQ_PROF_BUCKETS	64U
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	u32 Count;
+	u32 Min;
+	u32 Max;
+	u64 Sum;
+	u32 Bucket[IRQ_PROF_BUCKETS];
+} IrqProf_Hist;
+
+typedef struct {
+	u32 IntId;
+	IrqProf_Hist Entry;	/* Global timer ticks, exception to handler */
+	IrqProf_Hist Cycles;	/* CPU cycles in the handler */
+	IrqProf_Hist ICacheMiss;	/* L1 I-cache refills */
+	IrqProf_Hist DCacheMiss;	/* L1 D-cache refills */
+	IrqProf_Hist L2Miss;	/* L2 data read misses, every master */
+} IrqProf_Stats;
+
+/************************** Function Prototypes *****************************/
+
+void IrqProf_Exception(void *IntcPtr);
+int IrqProf_Wrap(u32 IntId, Xil_InterruptHandler *HandlerPtr,
+		 void **CallBackRefPtr);
+int IrqProf_Start(void);
+void IrqProf_Stop(void);
+u32 IrqProf_GetCount(void);
+int IrqProf_GetStats(u32 Index, IrqProf_Stats *StatsPtr, u32 Reset);
+void IrqProf_GetProbe(IrqProf_Hist *HistPtr, u32 Reset);
+u32 IrqProf_BucketLow(u32 Bucket);
+void IrqProf_Print(u32 Reset);
+
+#endif /* end of protection macro */
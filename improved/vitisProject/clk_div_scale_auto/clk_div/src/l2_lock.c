@@ -0,0 +1,253 @@
+/*****************************************************************************/
+/**
+* @file l2_lock.c
+*
+* L2 cache lockdown of the interrupt path. See l2_lock.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xil_io.h"
+#include "xil_cache_l.h"
+#include "xil_printf.h"
+#include "xtime_l.h"
+#include "intc.h"
+#include "l2_lock.h"
+
+/************************** Constant Definitions ****************************/
+
+#define L2_LOCK_ALL_WAYS	0xFFU
+
+/************************** Function Prototypes *****************************/
+
+static void L2Lock_BenchHandler(void *CallBackRef) L2_LOCKED_TEXT;
+static void L2Lock_BenchRun(const char *Name);
+static u32 L2Lock_TicksToNs(XTime Ticks);
+
+/************************** Variable Definitions **************************/
+
+/* From lscript.ld */
+extern u8 __l2_locked_start[];
+extern u8 __l2_locked_end[];
+extern u8 _irq_stack_end[];
+extern u8 __irq_stack[];
+
+static u32 L2LockLocked;
+static u32 L2LockBenchConnected;
+static volatile XTime L2LockBenchEntry L2_LOCKED_DATA;
+static volatile u32 L2LockBenchTaken L2_LOCKED_DATA;
+
+/*****************************************************************************/
+/**
+* Load the .l2_locked section into L2_LOCK_WAYS and lock them, and lock the
+* lines of the IRQ stack. Does nothing if already locked.
+*
+* @return
+*		- XST_SUCCESS if the interrupt path is locked
+*		- XST_FAILURE if the section is larger than L2_LOCK_LEN
+*
+* @note		Runs with interrupts masked for as long as it takes to load
+*		the section.
+*
+******************************************************************************/
+int L2Lock_Init(void)
+{
+	u32 Len = (u32)(__l2_locked_end - __l2_locked_start);
+
+	if (L2LockLocked != 0U) {
+		return XST_SUCCESS;
+	}
+	if (Len > L2_LOCK_LEN) {
+		return XST_FAILURE;
+	}
+
+	Xil_L2CacheLockRange(L2_LOCK_WAYS, (u32)(UINTPTR)__l2_locked_start,
+			     Len);
+	Xil_L2CacheLockLines((u32)(UINTPTR)_irq_stack_end,
+			     (u32)(__irq_stack - _irq_stack_end));
+	L2LockLocked = 1U;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Unlock what L2Lock_Init() locked. The lines stay cached until evicted.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void L2Lock_Release(void)
+{
+	Xil_L2CacheUnlockWays(L2_LOCK_WAYS);
+	/* The IRQ stack lines may be in any way */
+	Xil_L2CacheUnlockLines(L2_LOCK_ALL_WAYS);
+	L2LockLocked = 0U;
+}
+
+/*****************************************************************************/
+/**
+* Return whether the interrupt path is locked in the L2.
+*
+* @return	1 if locked, 0 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 L2Lock_IsLocked(void)
+{
+	return L2LockLocked;
+}
+
+/*****************************************************************************/
+/**
+* Measure the IRQ entry latency after the L2 has been evicted, with the
+* interrupt path unlocked and then locked, and print both. The lock is left
+* as it was found.
+*
+* @return	None.
+*
+* @note		Overwrites L2_LOCK_EVICT_LEN bytes at L2_LOCK_EVICT_ADDR.
+*		Takes about a second per pass.
+*
+******************************************************************************/
+void L2Lock_Bench(void)
+{
+	u32 WasLocked = L2LockLocked;
+
+	if (L2LockBenchConnected == 0U) {
+		if (Intc_Connect(L2_LOCK_BENCH_SGI_ID,
+				 (Xil_InterruptHandler)L2Lock_BenchHandler,
+				 NULL, L2_LOCK_BENCH_PRIORITY,
+				 INTC_TRIGGER_RISING) != XST_SUCCESS) {
+			xil_printf("Failed to connect the benchmark SGI\r\n");
+			return;
+		}
+		L2LockBenchConnected = 1U;
+	}
+
+	xil_printf("IRQ entry latency after evicting the L2, %u B locked, ns\r\n",
+		   (u32)(__l2_locked_end - __l2_locked_start));
+	xil_printf("              min     mean      max\r\n");
+
+	L2Lock_Release();
+	L2Lock_BenchRun("unlocked");
+
+	if (L2Lock_Init() != XST_SUCCESS) {
+		xil_printf("locked    .l2_locked is larger than %u B\r\n",
+			   L2_LOCK_LEN);
+	} else {
+		L2Lock_BenchRun("locked");
+	}
+
+	if (WasLocked == 0U) {
+		L2Lock_Release();
+	}
+}
+
+/*****************************************************************************/
+/**
+* Handler of the benchmark SGI. Timestamps its entry.
+*
+* @param	CallBackRef is unused.
+*
+* @return	None.
+*
+* @note		IRQ context.
+*
+******************************************************************************/
+static void L2Lock_BenchHandler(void *CallBackRef)
+{
+	XTime Now;
+
+	(void)CallBackRef;
+
+	XTime_GetTime(&Now);
+	L2LockBenchEntry = Now;
+	L2LockBenchTaken = 1U;
+}
+
+/*****************************************************************************/
+/**
+* Take L2_LOCK_BENCH_SAMPLES samples of the IRQ entry latency and print one
+* line. Each sample dirties L2_LOCK_EVICT_LEN bytes and invalidates the
+* instruction cache, then times an SGI from its raise to its handler.
+*
+* @param	Name is the name of the line.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void L2Lock_BenchRun(const char *Name)
+{
+	XTime Start;
+	XTime Sum = 0U;
+	u32 Ticks;
+	u32 Min = 0xFFFFFFFFU;
+	u32 Max = 0U;
+	u32 SgiValue;
+	u32 Sample;
+
+	SgiValue = Intc_SgiValue(L2_LOCK_BENCH_SGI_ID, INTC_CPU0);
+
+	for (Sample = 0U; Sample < L2_LOCK_BENCH_SAMPLES; Sample++) {
+		(void)memset((void *)L2_LOCK_EVICT_ADDR, (int)Sample,
+			     L2_LOCK_EVICT_LEN);
+		Xil_L1ICacheInvalidate();
+
+		L2LockBenchTaken = 0U;
+		XTime_GetTime(&Start);
+		Xil_Out32(XPAR_PS7_SCUGIC_0_DIST_BASEADDR +
+			  XSCUGIC_SFI_TRIG_OFFSET, SgiValue);
+		while (L2LockBenchTaken == 0U) {
+			/* Taken within a few us */
+		}
+
+		Ticks = (u32)(L2LockBenchEntry - Start);
+		if (Ticks < Min) {
+			Min = Ticks;
+		}
+		if (Ticks > Max) {
+			Max = Ticks;
+		}
+		Sum += Ticks;
+	}
+
+	xil_printf("%-9s %8u %8u %8u\r\n", Name, L2Lock_TicksToNs(Min),
+		   L2Lock_TicksToNs(Sum / L2_LOCK_BENCH_SAMPLES),
+		   L2Lock_TicksToNs(Max));
+}
+
+/*****************************************************************************/
+/**
+* Convert global timer ticks to ns.
+*
+* @param	Ticks is the time in global timer ticks.
+*
+* @return	Time in ns, saturated at 0xFFFFFFFF.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 L2Lock_TicksToNs(XTime Ticks)
+{
+	u64 Ns = (Ticks * 1000U) / (COUNTS_PER_SECOND / 1000000U);
+
+	return (Ns > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (u32)Ns;
+}
@@ -0,0 +1,71 @@
+/*****************************************************************************/
+/**
+* @file l2_lock.h
+*
+* Lockdown of the interrupt path in the L2 cache. The linker script gathers
+* the exception vectors, the IRQ dispatch of the BSP and its exception
+* table, and everything marked L2_LOCKED_TEXT or L2_LOCKED_DATA, into the
+* .l2_locked section. L2Lock_Init() loads that section into L2_LOCK_WAYS and
+* locks them, and locks the IRQ stack line by line. Bulk copies, telemetry
+* and DMA then no longer evict the pps path, and the pps ISR no longer
+* waits for DDR after them. The other ways are left to everything else.
+*
+* The section must fit in the locked ways, 64 KB per way. Locked lines are
+* read and written as usual; writes to locked data stay in the L2 until
+* flushed by address. The GIC handler table is in OCM instead, see ocm.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 The GIC handler table moved to OCM.
+* 1.02a xl   10/19/26 The eviction buffer is reserved by the linker script.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef L2_LOCK_H		/* prevent circular inclusions */
+#define L2_LOCK_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "cache_bench.h"
+
+/************************** Constant Definitions ****************************/
+
+#define L2_LOCK_WAYS		0x80U		/* Way 7 */
+#define L2_LOCK_LEN		0x10000U	/* 64 KB per way */
+
+/*
+ * Benchmark: IRQ entry latency of an SGI at the pps priority, each sample
+ * taken after L2_LOCK_EVICT_LEN bytes of writes have evicted the L1 and
+ * the unlocked L2 ways
+ */
+#define L2_LOCK_BENCH_SGI_ID	13U
+#define L2_LOCK_BENCH_PRIORITY	0x08U		/* Same as the pps */
+#define L2_LOCK_BENCH_SAMPLES	1000U
+#define L2_LOCK_EVICT_ADDR	BENCH_SCRATCH_ADDR
+#define L2_LOCK_EVICT_LEN	0x100000U	/* Twice the L2 */
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/*
+ * Place a function or a variable in the .l2_locked section. Give functions
+ * the attribute on their prototype, and variables after their name:
+ *	static void Pps_Handler(void *CallBackRef) L2_LOCKED_TEXT;
+ *	static u32 PpsCount L2_LOCKED_DATA;
+ */
+#define L2_LOCKED_TEXT	__attribute__((section(".l2_locked.text")))
+#define L2_LOCKED_DATA	__attribute__((section(".l2_locked.data")))
+
+/************************** Function Prototypes *****************************/
+
+int L2Lock_Init(void);
+void L2Lock_Release(void);
+u32 L2Lock_IsLocked(void);
+void L2Lock_Bench(void);
+
+#endif /* end of protection macro */
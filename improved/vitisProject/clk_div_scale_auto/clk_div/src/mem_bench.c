@@ -0,0 +1,114 @@
+/*****************************************************************************/
+/**
+* @file mem_bench.c
+*
+* Memory copy and fill benchmark. See mem_bench.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xil_types.h"
+#include "xil_mem.h"
+#include "xil_printf.h"
+#include "xtime_l.h"
+#include "mem_bench.h"
+
+/************************** Constant Definitions ****************************/
+
+#define MEM_BENCH_SIZES		8U
+#define MEM_BENCH_SRC		MEM_BENCH_ADDR
+#define MEM_BENCH_DST		(MEM_BENCH_ADDR + MEM_BENCH_MAX_LEN)
+
+/************************** Function Prototypes *****************************/
+
+static u32 MemBench_Time(u32 Op, u32 Length);
+
+/************************** Variable Definitions **************************/
+
+static const u32 MemBenchLength[MEM_BENCH_SIZES] = {
+	0x40U, 0x100U, 0x400U, 0x1000U, 0x4000U, 0x40000U, 0x100000U,
+	0x400000U
+};
+
+/*****************************************************************************/
+/**
+* Time the copies and fills of every length and print one line per length
+* in MB/s.
+*
+* @return	None.
+*
+* @note		Overwrites 2 * MEM_BENCH_MAX_LEN bytes at MEM_BENCH_ADDR.
+*
+******************************************************************************/
+void MemBench_Run(void)
+{
+	u32 Index;
+
+	xil_printf("Copy and fill throughput, MB/s\r\n");
+	xil_printf("   length   memcpy  Xil_MemCpy   memset  Xil_MemSet\r\n");
+
+	for (Index = 0U; Index < MEM_BENCH_SIZES; Index++) {
+		xil_printf("%9u  %7u  %10u  %7u  %10u\r\n",
+			   MemBenchLength[Index],
+			   MemBench_Time(0U, MemBenchLength[Index]),
+			   MemBench_Time(1U, MemBenchLength[Index]),
+			   MemBench_Time(2U, MemBenchLength[Index]),
+			   MemBench_Time(3U, MemBenchLength[Index]));
+	}
+}
+
+/*****************************************************************************/
+/**
+* Repeat one copy or fill until MEM_BENCH_BYTES bytes have been moved.
+*
+* @param	Op is 0 for memcpy(), 1 for Xil_MemCpy(), 2 for memset(),
+*		3 for Xil_MemSet().
+* @param	Length is the length of each copy or fill in bytes.
+*
+* @return	Throughput in MB/s.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 MemBench_Time(u32 Op, u32 Length)
+{
+	void *Dst = (void *)MEM_BENCH_DST;
+	const void *Src = (const void *)MEM_BENCH_SRC;
+	u32 Runs = MEM_BENCH_BYTES / Length;
+	u32 Run;
+	XTime Start;
+	XTime End;
+	u64 Us;
+
+	XTime_GetTime(&Start);
+	for (Run = 0U; Run < Runs; Run++) {
+		if (Op == 0U) {
+			(void)memcpy(Dst, Src, Length);
+		} else if (Op == 1U) {
+			Xil_MemCpy(Dst, Src, Length);
+		} else if (Op == 2U) {
+			(void)memset(Dst, (int)Run, Length);
+		} else {
+			Xil_MemSet(Dst, (s32)Run, Length);
+		}
+	}
+	XTime_GetTime(&End);
+
+	Us = (End - Start) / (COUNTS_PER_SECOND / 1000000U);
+	if (Us == 0U) {
+		Us = 1U;
+	}
+
+	/* Bytes per us are MB/s */
+	return (u32)(((u64)Runs * Length) / Us);
+}
@@ -0,0 +1,39 @@
+/*****************************************************************************/
+/**
+* @file mem_bench.h
+*
+* Throughput of the BSP Xil_MemCpy() and Xil_MemSet() against the newlib
+* memcpy() and memset() over a range of lengths, on buffers in DDR with the
+* caches on. Small lengths run from the caches, large ones from DDR.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 The buffers are reserved by the linker script.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef MEM_BENCH_H		/* prevent circular inclusions */
+#define MEM_BENCH_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "cache_bench.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Source and destination buffers, in the benchmark scratch */
+#define MEM_BENCH_ADDR		BENCH_SCRATCH_ADDR
+#define MEM_BENCH_MAX_LEN	0x400000U
+#define MEM_BENCH_BYTES		0x1000000U	/* Bytes moved per result */
+
+/************************** Function Prototypes *****************************/
+
+void MemBench_Run(void);
+
+#endif /* end of protection macro */
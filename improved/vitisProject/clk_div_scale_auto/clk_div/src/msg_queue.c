@@ -0,0 +1,138 @@
+/*****************************************************************************/
+/**
+* @file msg_queue.c
+*
+* Lock-free single producer, single consumer message queue. See
+* msg_queue.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "msg_queue.h"
+
+/*****************************************************************************/
+/**
+* Empty a queue. Only one core may do this, before the other uses it.
+*
+* @param	Queue is the queue.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void MsgQueue_Init(MsgQueue *Queue)
+{
+	Queue->Head = 0U;
+	Queue->Tail = 0U;
+	Queue->Dropped = 0U;
+	dmb();
+}
+
+/*****************************************************************************/
+/**
+* Add a message at the head of a queue.
+*
+* @param	Queue is the queue.
+* @param	Msg is the message, copied into the queue.
+*
+* @return
+*		- XST_SUCCESS if the message was added
+*		- XST_FAILURE if the queue is full; the message is dropped
+*
+* @note		Producer side only. The consumer may see the message as soon
+*		as this returns; waking it up is left to the caller.
+*
+******************************************************************************/
+int MsgQueue_Push(MsgQueue *Queue, const MsgQueue_Msg *Msg)
+{
+	u32 Head = Queue->Head;
+	MsgQueue_Msg *Slot;
+	u32 Index;
+
+	if ((Head - Queue->Tail) >= MSG_QUEUE_DEPTH) {
+		Queue->Dropped++;
+		return XST_FAILURE;
+	}
+
+	/* The slot is free only once the Tail read above is done */
+	dmb();
+
+	Slot = &Queue->Msg[Head & (MSG_QUEUE_DEPTH - 1U)];
+	Slot->Type = Msg->Type;
+	for (Index = 0U; Index < MSG_QUEUE_ARGS; Index++) {
+		Slot->Arg[Index] = Msg->Arg[Index];
+	}
+
+	/* The message must be complete before the consumer sees the Head */
+	dmb();
+	Queue->Head = Head + 1U;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Remove the message at the tail of a queue.
+*
+* @param	Queue is the queue.
+* @param	Msg returns the message.
+*
+* @return	1 if a message was removed, 0 if the queue is empty.
+*
+* @note		Consumer side only.
+*
+******************************************************************************/
+int MsgQueue_Pop(MsgQueue *Queue, MsgQueue_Msg *Msg)
+{
+	u32 Tail = Queue->Tail;
+	const MsgQueue_Msg *Slot;
+	u32 Index;
+
+	if (Queue->Head == Tail) {
+		return 0;
+	}
+
+	/* Read the message only after the Head that published it */
+	dmb();
+
+	Slot = &Queue->Msg[Tail & (MSG_QUEUE_DEPTH - 1U)];
+	Msg->Type = Slot->Type;
+	for (Index = 0U; Index < MSG_QUEUE_ARGS; Index++) {
+		Msg->Arg[Index] = Slot->Arg[Index];
+	}
+
+	/* The copy must be done before the producer may reuse the slot */
+	dmb();
+	Queue->Tail = Tail + 1U;
+
+	return 1;
+}
+
+/*****************************************************************************/
+/**
+* Return the number of messages in a queue.
+*
+* @param	Queue is the queue.
+*
+* @return	The number of messages, a snapshot that either side may change
+*		right after.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 MsgQueue_Count(const MsgQueue *Queue)
+{
+	return Queue->Head - Queue->Tail;
+}
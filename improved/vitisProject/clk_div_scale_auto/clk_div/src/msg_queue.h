@@ -0,0 +1,64 @@
+/*****************************************************************************/
+/**
+* @file msg_queue.h
+*
+* Lock-free single producer, single consumer queue of fixed size messages,
+* for passing work between the two Cortex-A9 cores. The producer only
+* writes Head and the consumer only writes Tail, so neither side needs a
+* lock or an exclusive access; a barrier orders the message against the
+* index that publishes it.
+*
+* The queue may be placed in memory that is not cached, such as a
+* non-cacheable OCM page shared by both cores, or in memory kept coherent
+* by the SCU.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef MSG_QUEUE_H		/* prevent circular inclusions */
+#define MSG_QUEUE_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define MSG_QUEUE_DEPTH		32U	/* Messages, a power of 2 */
+#define MSG_QUEUE_ARGS		7U
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	u32 Type;
+	u32 Arg[MSG_QUEUE_ARGS];
+} MsgQueue_Msg;
+
+/*
+ * Head and Tail count messages from 0 and wrap at 2^32. Each sits in its
+ * own cache line so the two cores never write the same line.
+ */
+typedef struct {
+	volatile u32 Head;		/* Written by the producer */
+	u32 Dropped;			/* Pushes refused, queue full */
+	u32 Reserved0[6];
+	volatile u32 Tail;		/* Written by the consumer */
+	u32 Reserved1[7];
+	MsgQueue_Msg Msg[MSG_QUEUE_DEPTH];
+} MsgQueue;
+
+/************************** Function Prototypes *****************************/
+
+void MsgQueue_Init(MsgQueue *Queue);
+int MsgQueue_Push(MsgQueue *Queue, const MsgQueue_Msg *Msg);
+int MsgQueue_Pop(MsgQueue *Queue, MsgQueue_Msg *Msg);
+u32 MsgQueue_Count(const MsgQueue *Queue);
+
+#endif /* end of protection macro */
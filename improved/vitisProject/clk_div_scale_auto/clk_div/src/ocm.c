@@ -0,0 +1,215 @@
+/*****************************************************************************/
+/**
+* @file ocm.c
+*
+* OCM latency benchmark. See ocm.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xil_cache_l.h"
+#include "xil_printf.h"
+#include "xtime_l.h"
+#include "ocm.h"
+
+/************************** Constant Definitions ****************************/
+
+#define OCM_LINE_WORDS		8U	/* 32-byte cache line */
+
+/************************** Function Prototypes *****************************/
+
+static u32 Ocm_WalkOcm(const u32 *Start) OCM_TEXT;
+static u32 Ocm_WalkDdr(const u32 *Start);
+static void Ocm_Chain(u32 *Chain);
+static void Ocm_BenchRun(const char *Name, u32 (*Walk)(const u32 *Start),
+			 const u32 *Chain);
+static u32 Ocm_TicksToNs(XTime Ticks);
+
+/************************** Variable Definitions **************************/
+
+static u32 OcmChainOcm[OCM_BENCH_LINES * OCM_LINE_WORDS] OCM_BSS;
+static u32 OcmChainDdr[OCM_BENCH_LINES * OCM_LINE_WORDS]
+	__attribute__((aligned(32)));
+
+/*****************************************************************************/
+/**
+* Follow a chain of OCM_BENCH_LINES pointers, one per cache line.
+*
+* @param	Start is the first line of the chain.
+*
+* @return	Address of the last line, so the walk is not optimized out.
+*
+* @note		Ocm_WalkOcm() and Ocm_WalkDdr() are this walk, from OCM and
+*		from DDR.
+*
+******************************************************************************/
+static inline __attribute__((always_inline)) u32 Ocm_Walk(const u32 *Start)
+{
+	const u32 *Line = Start;
+	u32 Step;
+
+	for (Step = 0U; Step < OCM_BENCH_LINES; Step++) {
+		Line = (const u32 *)(UINTPTR)*Line;
+	}
+
+	return (u32)(UINTPTR)Line;
+}
+
+/*****************************************************************************/
+/**
+* Ocm_Walk() from OCM.
+*
+* @param	Start is the first line of the chain.
+*
+* @return	Address of the last line.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 Ocm_WalkOcm(const u32 *Start)
+{
+	return Ocm_Walk(Start);
+}
+
+/*****************************************************************************/
+/**
+* Ocm_Walk() from DDR.
+*
+* @param	Start is the first line of the chain.
+*
+* @return	Address of the last line.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 Ocm_WalkDdr(const u32 *Start)
+{
+	return Ocm_Walk(Start);
+}
+
+/*****************************************************************************/
+/**
+* Measure the same walk of dependent loads with its code and data in DDR,
+* then in OCM, each time after the caches have been evicted, and print both.
+* This is the time the control loop waits for memory when bulk traffic has
+* evicted it.
+*
+* @return	None.
+*
+* @note		Overwrites OCM_BENCH_EVICT_LEN bytes at OCM_BENCH_EVICT_ADDR.
+*		Takes about a second per line.
+*
+******************************************************************************/
+void Ocm_Bench(void)
+{
+	Ocm_Chain(OcmChainDdr);
+	Ocm_Chain(OcmChainOcm);
+
+	xil_printf("Walk of %u cache lines after evicting the caches, ns\r\n",
+		   OCM_BENCH_LINES);
+	xil_printf("         min     mean      max  mean/line\r\n");
+
+	Ocm_BenchRun("DDR", Ocm_WalkDdr, OcmChainDdr);
+	Ocm_BenchRun("OCM", Ocm_WalkOcm, OcmChainOcm);
+}
+
+/*****************************************************************************/
+/**
+* Link the cache lines of a buffer into one cycle, OCM_BENCH_STRIDE lines
+* per step.
+*
+* @param	Chain is the buffer, OCM_BENCH_LINES lines.
+*
+* @return	None.
+*
+* @note		OCM_BENCH_STRIDE must be odd to visit every line.
+*
+******************************************************************************/
+static void Ocm_Chain(u32 *Chain)
+{
+	u32 Line;
+	u32 Next;
+
+	for (Line = 0U; Line < OCM_BENCH_LINES; Line++) {
+		Next = (Line + OCM_BENCH_STRIDE) % OCM_BENCH_LINES;
+		Chain[Line * OCM_LINE_WORDS] =
+			(u32)(UINTPTR)&Chain[Next * OCM_LINE_WORDS];
+	}
+}
+
+/*****************************************************************************/
+/**
+* Time OCM_BENCH_SAMPLES walks and print one line. Each sample dirties
+* OCM_BENCH_EVICT_LEN bytes and invalidates the instruction cache first.
+*
+* @param	Name is the name of the line.
+* @param	Walk is the walk to time.
+* @param	Chain is the chain it walks.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void Ocm_BenchRun(const char *Name, u32 (*Walk)(const u32 *Start),
+			 const u32 *Chain)
+{
+	XTime Start;
+	XTime End;
+	XTime Sum = 0U;
+	u32 Ticks;
+	u32 Min = 0xFFFFFFFFU;
+	u32 Max = 0U;
+	u32 Sample;
+
+	for (Sample = 0U; Sample < OCM_BENCH_SAMPLES; Sample++) {
+		(void)memset((void *)OCM_BENCH_EVICT_ADDR, (int)Sample,
+			     OCM_BENCH_EVICT_LEN);
+		Xil_L1ICacheInvalidate();
+
+		XTime_GetTime(&Start);
+		(void)Walk(Chain);
+		XTime_GetTime(&End);
+
+		Ticks = (u32)(End - Start);
+		if (Ticks < Min) {
+			Min = Ticks;
+		}
+		if (Ticks > Max) {
+			Max = Ticks;
+		}
+		Sum += Ticks;
+	}
+
+	xil_printf("%-4s %8u %8u %8u %10u\r\n", Name, Ocm_TicksToNs(Min),
+		   Ocm_TicksToNs(Sum / OCM_BENCH_SAMPLES), Ocm_TicksToNs(Max),
+		   Ocm_TicksToNs(Sum / OCM_BENCH_SAMPLES) / OCM_BENCH_LINES);
+}
+
+/*****************************************************************************/
+/**
+* Convert global timer ticks to ns.
+*
+* @param	Ticks is the time in global timer ticks.
+*
+* @return	Time in ns, saturated at 0xFFFFFFFF.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 Ocm_TicksToNs(XTime Ticks)
+{
+	u64 Ns = (Ticks * 1000U) / (COUNTS_PER_SECOND / 1000000U);
+
+	return (Ns > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (u32)Ns;
+}
@@ -0,0 +1,71 @@
+/*****************************************************************************/
+/**
+* @file ocm.h
+*
+* Hot code and data in the on-chip memory. Functions and variables marked
+* OCM_TEXT, OCM_DATA or OCM_BSS run from ps7_ram_0, the 192 KB of OCM
+* mapped at 0, instead of DDR: no DDR latency, refresh or contention with
+* bulk traffic on the critical path. The OCM is not behind the L2, so it
+* does not compete for the L2 either.
+*
+* The FSBL runs from this OCM, so the linker script loads OCM_TEXT and
+* OCM_DATA in DDR after the program and xil-crt0.S copies them to the OCM
+* before main(); it clears OCM_BSS there. The linker script also puts the
+* GIC handler table of the BSP, XScuGic_ConfigTable, in OCM.
+*
+* The first line of the OCM, at NULL, is left empty so that no function
+* placed here links at address 0. OCM_BSS is for zero-initialized data
+* only, an initializer is dropped.
+* The OCM is cached in L1 like DDR, so DMA buffers and descriptors placed in
+* OCM_BSS still need the usual cache maintenance.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 Nothing is placed at address 0.
+* 1.02a xl   10/19/26 The eviction buffer is reserved by the linker script.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef OCM_H			/* prevent circular inclusions */
+#define OCM_H			/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "cache_bench.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Benchmark: a walk of dependent loads over OCM_BENCH_LINES cache lines,
+ * OCM_BENCH_STRIDE lines apart so the prefetcher cannot follow, after
+ * OCM_BENCH_EVICT_LEN bytes of writes have evicted the L1 and the L2
+ */
+#define OCM_BENCH_LINES		256U		/* 8 KB */
+#define OCM_BENCH_STRIDE	97U
+#define OCM_BENCH_SAMPLES	1000U
+#define OCM_BENCH_EVICT_ADDR	BENCH_SCRATCH_ADDR
+#define OCM_BENCH_EVICT_LEN	0x100000U	/* Twice the L2 */
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/*
+ * Place a function or a variable in OCM. Give functions the attribute on
+ * their prototype, and variables after their name:
+ *	static void Loop_Step(void) OCM_TEXT;
+ *	static Loop_State State OCM_BSS;
+ */
+#define OCM_TEXT	__attribute__((section(".ocm.text")))
+#define OCM_DATA	__attribute__((section(".ocm.data")))
+#define OCM_BSS		__attribute__((section(".ocm.bss")))
+
+/************************** Function Prototypes *****************************/
+
+void Ocm_Bench(void);
+
+#endif /* end of protection macro */
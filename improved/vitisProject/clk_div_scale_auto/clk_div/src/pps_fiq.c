@@ -0,0 +1,388 @@
+/*****************************************************************************/
+/**
+* @file pps_fiq.c
+*
+* FIQ fast path of the pps interrupt. See pps_fiq.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 PpsFiqState is locked in the L2, see l2_lock.h.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stddef.h>
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xil_io.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "intc.h"
+#include "l2_lock.h"
+#include "pps_fiq.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PPS_FIQ_NO_ID		1023U	/* Matches no interrupt */
+
+/* Global timer comparator, PPI 27 of each CPU */
+#define PPS_FIQ_GT_INTR_ID	27U
+#define PPS_FIQ_GT_PRIORITY	0x08U	/* Same as the pps */
+#define PPS_FIQ_GT_CONTROL	(GLOBAL_TMR_BASEADDR + 0x08U)
+#define PPS_FIQ_GT_ISR		(GLOBAL_TMR_BASEADDR + 0x0CU)
+#define PPS_FIQ_GT_COMP_LO	(GLOBAL_TMR_BASEADDR + 0x10U)
+#define PPS_FIQ_GT_COMP_HI	(GLOBAL_TMR_BASEADDR + 0x14U)
+#define PPS_FIQ_GT_AUTOINC	(GLOBAL_TMR_BASEADDR + 0x18U)
+#define PPS_FIQ_GT_MEASURE	0x0000000EU	/* Comparator, IRQ, auto-increment */
+
+#define PPS_FIQ_MEASURE_TICKS \
+	((u32)(((u64)PPS_FIQ_MEASURE_US * COUNTS_PER_SECOND) / 1000000U))
+
+/**************************** Type Definitions ******************************/
+
+/* Shared with pps_fiq_vector.S, which uses fixed offsets */
+typedef struct {
+	u32 PpsId;		/* Interrupt ID of the pps */
+	u32 SgiValue;		/* ICDSGIR value of the dispatch SGI */
+	u32 Period;		/* Comparator period while measuring */
+	u32 Count;		/* pps taken as FIQ, stored after TsLo/TsHi */
+	u32 TsLo;		/* Global timer at the last pps */
+	u32 TsHi;
+	u32 Stolen;		/* Group 1 interrupts pended again */
+	PpsFiq_Hist Hist;	/* Comparator latency through the FIQ */
+} PpsFiq_State;
+
+/* pps_fiq_vector.S addresses PpsFiqState by these offsets */
+typedef char PpsFiq_OffsetCheck[((offsetof(PpsFiq_State, Stolen) == 24U) &&
+				 (offsetof(PpsFiq_State, Hist.Bucket) == 40U)) ?
+				1 : -1];
+
+/************************** Function Prototypes *****************************/
+
+extern void PpsFiq_Vector(void);
+static void PpsFiq_IrqMeasure(void *CallBackRef);
+static int PpsFiq_Run(u32 Fiq, u32 Samples, PpsFiq_Hist *HistPtr);
+
+/************************** Variable Definitions **************************/
+
+volatile PpsFiq_State PpsFiqState L2_LOCKED_DATA;
+static volatile PpsFiq_Hist PpsIrqHist;
+static u32 PpsFiqReady;
+
+/*****************************************************************************/
+/**
+* Install PpsFiq_Vector in the FIQ vector and unmask FIQs. Safe to call more
+* than once; only the first call does the work. No interrupt is routed to
+* FIQ yet.
+*
+* @return
+*		- XST_SUCCESS if the FIQ vector is installed
+*		- XST_FAILURE if the GIC could not be initialized
+*
+* @note		None.
+*
+******************************************************************************/
+int PpsFiq_Init(void)
+{
+	int Status;
+
+	if (PpsFiqReady != 0U) {
+		return XST_SUCCESS;
+	}
+
+	Status = Intc_Init();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Xil_ExceptionDisableMask(XIL_EXCEPTION_FIQ);
+	PpsFiqState.PpsId = PPS_FIQ_NO_ID;
+	Xil_ExceptionSetFiqVector(PpsFiq_Vector);
+	Xil_ExceptionEnableMask(XIL_EXCEPTION_FIQ);
+
+	PpsFiqReady = 1U;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Take the pps as FIQ. Each pps the FIQ vector timestamps the edge and
+* raises SgiId on CPU0, whose handler reads the timestamp back with
+* PpsFiq_GetTimestamp().
+*
+* @param	IntId is the pps interrupt, already connected with
+*		Intc_Connect() to a handler that still serves it when the IRQ
+*		path acknowledges it first.
+* @param	SgiId is the dispatch SGI, connected with Intc_Connect().
+*
+* @return
+*		- XST_SUCCESS if the pps is taken as FIQ
+*		- XST_FAILURE otherwise
+*
+* @note		None.
+*
+******************************************************************************/
+int PpsFiq_Route(u32 IntId, u32 SgiId)
+{
+	u32 Cpsr;
+	int Status;
+
+	Status = PpsFiq_Init();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_ALL);
+
+	PpsFiqState.PpsId = IntId;
+	Status = Intc_SetFiq(IntId, 1U);
+	PpsFiqState.SgiValue = Intc_SgiValue(SgiId, INTC_CPU0);
+
+	mtcpsr(Cpsr);
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* Return the global timer value the FIQ vector took at the last pps.
+*
+* @param	TimestampPtr returns the timestamp.
+*
+* @return
+*		- XST_SUCCESS if a pps has been taken as FIQ
+*		- XST_FAILURE otherwise
+*
+* @note		Safe against a pps FIQ in the middle of the read.
+*
+******************************************************************************/
+int PpsFiq_GetTimestamp(XTime *TimestampPtr)
+{
+	u32 Count;
+	u32 Lo;
+	u32 Hi;
+
+	do {
+		Count = PpsFiqState.Count;
+		Lo = PpsFiqState.TsLo;
+		Hi = PpsFiqState.TsHi;
+	} while (Count != PpsFiqState.Count);
+
+	if (Count == 0U) {
+		return XST_FAILURE;
+	}
+
+	*TimestampPtr = ((XTime)Hi << 32) | Lo;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Return the number of group 1 interrupts the FIQ vector acknowledged and
+* handed back to the IRQ path.
+*
+* @return	Interrupts handed back.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 PpsFiq_GetStolen(void)
+{
+	return PpsFiqState.Stolen;
+}
+
+/*****************************************************************************/
+/**
+* Measure the interrupt-to-handler latency of the FIQ vector and of the IRQ
+* path. The global timer comparator interrupts every PPS_FIQ_MEASURE_US
+* with auto-increment, so the time of each event is the comparator value
+* less one period, and the latency is the timestamp taken by the handler
+* less that. Samples events are taken as FIQ, then Samples as IRQ.
+*
+* @param	Samples is the number of events of each pass.
+* @param	FiqHistPtr returns the latency through PpsFiq_Vector.
+* @param	IrqHistPtr returns the latency through the IRQ exception and
+*		XScuGic_InterruptHandler() to a connected handler.
+*
+* @return
+*		- XST_SUCCESS if both passes took Samples events
+*		- XST_FAILURE otherwise
+*
+* @note		Busy waits Samples * PPS_FIQ_MEASURE_US twice. A latency
+*		over one period is not measured right. Not for interrupt
+*		context.
+*
+******************************************************************************/
+int PpsFiq_Measure(u32 Samples, PpsFiq_Hist *FiqHistPtr,
+		   PpsFiq_Hist *IrqHistPtr)
+{
+	int Status;
+
+	if ((Samples == 0U) || (FiqHistPtr == NULL) || (IrqHistPtr == NULL)) {
+		return XST_FAILURE;
+	}
+
+	Status = PpsFiq_Init();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = Intc_Connect(PPS_FIQ_GT_INTR_ID,
+			      (Xil_InterruptHandler)PpsFiq_IrqMeasure, NULL,
+			      PPS_FIQ_GT_PRIORITY, INTC_TRIGGER_RISING);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = PpsFiq_Run(1U, Samples, FiqHistPtr);
+	if (Status == XST_SUCCESS) {
+		Status = PpsFiq_Run(0U, Samples, IrqHistPtr);
+	}
+
+	XScuGic_Disable(Intc_GetInstance(), PPS_FIQ_GT_INTR_ID);
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* Add a latency to a histogram.
+*
+* @param	HistPtr is the histogram.
+* @param	Ticks is the latency in global timer ticks.
+*
+* @return	None.
+*
+* @note		Same update as the measure path of PpsFiq_Vector.
+*
+******************************************************************************/
+static void PpsFiq_HistAdd(volatile PpsFiq_Hist *HistPtr, u32 Ticks)
+{
+	u32 Bucket;
+
+	if ((HistPtr->Count == 0U) || (Ticks < HistPtr->MinTicks)) {
+		HistPtr->MinTicks = Ticks;
+	}
+	if (Ticks > HistPtr->MaxTicks) {
+		HistPtr->MaxTicks = Ticks;
+	}
+	HistPtr->Count++;
+
+	Bucket = Ticks >> PPS_FIQ_BUCKET_SHIFT;
+	if (Bucket >= PPS_FIQ_BUCKETS) {
+		Bucket = PPS_FIQ_BUCKETS - 1U;
+	}
+	HistPtr->Bucket[Bucket]++;
+}
+
+/*****************************************************************************/
+/**
+* IRQ handler of the global timer comparator for the IRQ pass of
+* PpsFiq_Measure().
+*
+* @param	CallBackRef is unused.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void PpsFiq_IrqMeasure(void *CallBackRef)
+{
+	XTime Now;
+	u32 Event;
+
+	(void)CallBackRef;
+
+	XTime_GetTime(&Now);
+	Event = Xil_In32(PPS_FIQ_GT_COMP_LO) - PpsFiqState.Period;
+	Xil_Out32(PPS_FIQ_GT_ISR, 1U);
+
+	PpsFiq_HistAdd(&PpsIrqHist, (u32)Now - Event);
+}
+
+/*****************************************************************************/
+/**
+* One pass of PpsFiq_Measure().
+*
+* @param	Fiq is 1 to take the comparator as FIQ, 0 as IRQ.
+* @param	Samples is the number of events to take.
+* @param	HistPtr returns the histogram.
+*
+* @return
+*		- XST_SUCCESS if Samples events were taken
+*		- XST_FAILURE if they did not come in time
+*
+* @note		The global timer keeps counting; only its comparator is
+*		used.
+*
+******************************************************************************/
+static int PpsFiq_Run(u32 Fiq, u32 Samples, PpsFiq_Hist *HistPtr)
+{
+	volatile PpsFiq_Hist *LivePtr;
+	XTime Now;
+	XTime Comp;
+	XTime Deadline;
+	u32 Control;
+	u32 Cpsr;
+	u32 Index;
+	int Status;
+
+	LivePtr = (Fiq != 0U) ? &PpsFiqState.Hist : &PpsIrqHist;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_ALL);
+	LivePtr->Count = 0U;
+	LivePtr->MinTicks = 0U;
+	LivePtr->MaxTicks = 0U;
+	for (Index = 0U; Index < PPS_FIQ_BUCKETS; Index++) {
+		LivePtr->Bucket[Index] = 0U;
+	}
+	PpsFiqState.Period = PPS_FIQ_MEASURE_TICKS;
+	mtcpsr(Cpsr);
+
+	Status = Intc_SetFiq(PPS_FIQ_GT_INTR_ID, Fiq);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Control = Xil_In32(PPS_FIQ_GT_CONTROL) & ~PPS_FIQ_GT_MEASURE;
+	Xil_Out32(PPS_FIQ_GT_CONTROL, Control);
+	XTime_GetTime(&Now);
+	Comp = Now + PPS_FIQ_MEASURE_TICKS;
+	Xil_Out32(PPS_FIQ_GT_COMP_LO, (u32)Comp);
+	Xil_Out32(PPS_FIQ_GT_COMP_HI, (u32)(Comp >> 32));
+	Xil_Out32(PPS_FIQ_GT_AUTOINC, PPS_FIQ_MEASURE_TICKS);
+	Xil_Out32(PPS_FIQ_GT_ISR, 1U);
+	Xil_Out32(PPS_FIQ_GT_CONTROL, Control | PPS_FIQ_GT_MEASURE);
+
+	Deadline = Now + ((XTime)PPS_FIQ_MEASURE_TICKS * Samples * 2U) +
+		   COUNTS_PER_SECOND / 100U;
+	while ((LivePtr->Count < Samples) && (Now < Deadline)) {
+		XTime_GetTime(&Now);
+	}
+
+	Xil_Out32(PPS_FIQ_GT_CONTROL, Control);
+	Xil_Out32(PPS_FIQ_GT_ISR, 1U);
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_ALL);
+	HistPtr->Count = LivePtr->Count;
+	HistPtr->MinTicks = LivePtr->MinTicks;
+	HistPtr->MaxTicks = LivePtr->MaxTicks;
+	for (Index = 0U; Index < PPS_FIQ_BUCKETS; Index++) {
+		HistPtr->Bucket[Index] = LivePtr->Bucket[Index];
+	}
+	mtcpsr(Cpsr);
+
+	return (HistPtr->Count >= Samples) ? XST_SUCCESS : XST_FAILURE;
+}
@@ -0,0 +1,66 @@
+/*****************************************************************************/
+/**
+* @file pps_fiq.h
+*
+* FIQ fast path of the pps interrupt. The pps is moved to GIC group 0,
+* which the GIC signals as FIQ, and PpsFiq_Vector in pps_fiq_vector.S is
+* installed straight in the FIQ vector. It runs in the banked r8-r12 of FIQ
+* mode with no state saved: it reads the global timer, acknowledges the
+* interrupt, stores the timestamp and raises a software generated interrupt
+* on CPU0. The per-second handlers then run from that SGI in IRQ context
+* with the FIQ timestamp, so the time of the edge no longer depends on the
+* IRQs, handlers or IRQ-masked sections in front of it.
+*
+* PpsFiq_Measure() histograms the interrupt-to-handler latency with the
+* global timer comparator, whose event time is known to the tick: once
+* through the FIQ vector and once through the regular IRQ path.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PPS_FIQ_H		/* prevent circular inclusions */
+#define PPS_FIQ_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xtime_l.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Latency histogram, PPS_FIQ_BUCKETS of 2^PPS_FIQ_BUCKET_SHIFT ticks */
+#define PPS_FIQ_BUCKETS		64U
+#define PPS_FIQ_BUCKET_SHIFT	3U	/* 8 ticks, 24 ns at 333 MHz */
+
+#define PPS_FIQ_MEASURE_US	100U	/* Comparator period of a measurement */
+
+/**************************** Type Definitions ******************************/
+
+/*
+ * Latency from the event to the first instruction that timestamps it, in
+ * global timer ticks. The last bucket also counts everything above it.
+ */
+typedef struct {
+	u32 Count;
+	u32 MinTicks;
+	u32 MaxTicks;
+	u32 Bucket[PPS_FIQ_BUCKETS];
+} PpsFiq_Hist;
+
+/************************** Function Prototypes *****************************/
+
+int PpsFiq_Init(void);
+int PpsFiq_Route(u32 IntId, u32 SgiId);
+int PpsFiq_GetTimestamp(XTime *TimestampPtr);
+u32 PpsFiq_GetStolen(void);
+int PpsFiq_Measure(u32 Samples, PpsFiq_Hist *FiqHistPtr,
+		   PpsFiq_Hist *IrqHistPtr);
+
+#endif /* end of protection macro */
@@ -0,0 +1,323 @@
+/*****************************************************************************/
+/**
+* @file pps_intr.c
+*
+* Dispatch of the pps interrupt. See pps_intr.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 Added PpsIntr_Mask().
+* 1.02a xl   10/19/26 Added PpsIntr_Wait().
+* 1.03a xl   10/19/26 Added PpsIntr_GetStats().
+* 1.04a xl   10/19/26 Added the FIQ path, PPS_INTR_FIQ.
+* 1.05a xl   10/19/26 The dispatch is locked in the L2, see l2_lock.h.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "clk_div_pl.h"
+#include "intc.h"
+#include "timer_svc.h"
+#include "pps_fiq.h"
+#include "l2_lock.h"
+#include "pps_intr.h"
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	PpsIntr_Handler Handler;
+	void *CallBackRef;
+} PpsIntr_Entry;
+
+/************************** Function Prototypes *****************************/
+
+static void PpsIntr_IrqHandler(void *CallBackRef) L2_LOCKED_TEXT;
+#if defined (PPS_INTR_FIQ) && defined (CLK_DIV_PPS_INTR_ID)
+static void PpsIntr_SgiHandler(void *CallBackRef) L2_LOCKED_TEXT;
+#endif
+static void PpsIntr_Dispatch(XTime Timestamp) L2_LOCKED_TEXT;
+static int PpsIntr_Arrived(void *CallBackRef);
+
+/************************** Variable Definitions **************************/
+
+static PpsIntr_Entry PpsHandlers[PPS_INTR_MAX_HANDLERS] L2_LOCKED_DATA;
+static u32 PpsHandlerCount L2_LOCKED_DATA;
+static volatile u32 PpsCount L2_LOCKED_DATA;
+static u32 PpsConnected;
+static PpsIntr_Stats PpsStats L2_LOCKED_DATA;
+
+/*****************************************************************************/
+/**
+* IRQ handler of pps_out. Timestamps first so the registered handlers see
+* the same, least delayed, time of the edge.
+*
+* @param	CallBackRef is unused.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void PpsIntr_IrqHandler(void *CallBackRef)
+{
+	XTime Timestamp;
+
+	(void)CallBackRef;
+
+	XTime_GetTime(&Timestamp);
+	PpsIntr_Dispatch(Timestamp);
+}
+
+#if defined (PPS_INTR_FIQ) && defined (CLK_DIV_PPS_INTR_ID)
+/*****************************************************************************/
+/**
+* Handler of the SGI the FIQ vector raises on a pps.
+*
+* @param	CallBackRef is unused.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void PpsIntr_SgiHandler(void *CallBackRef)
+{
+	XTime Timestamp;
+
+	(void)CallBackRef;
+
+	if (PpsFiq_GetTimestamp(&Timestamp) == XST_SUCCESS) {
+		PpsIntr_Dispatch(Timestamp);
+	}
+}
+#endif
+
+/*****************************************************************************/
+/**
+* Call the per-second handlers with the time of the edge and time them.
+*
+* @param	Timestamp is the global timer value taken at the interrupt.
+*
+* @return	None.
+*
+* @note		IRQ context.
+*
+******************************************************************************/
+static void PpsIntr_Dispatch(XTime Timestamp)
+{
+	XTime End;
+	u32 Ticks;
+	u32 Index;
+
+	PpsCount++;
+
+	for (Index = 0U; Index < PpsHandlerCount; Index++) {
+		PpsHandlers[Index].Handler(PpsHandlers[Index].CallBackRef,
+					   Timestamp);
+	}
+
+	XTime_GetTime(&End);
+	Ticks = (u32)(End - Timestamp);
+	if ((PpsStats.Count == 0U) || (Ticks < PpsStats.MinTicks)) {
+		PpsStats.MinTicks = Ticks;
+	}
+	if (Ticks > PpsStats.MaxTicks) {
+		PpsStats.MaxTicks = Ticks;
+	}
+	PpsStats.SumTicks += Ticks;
+	PpsStats.Count++;
+}
+
+/*****************************************************************************/
+/**
+* Connect the pps interrupt, and with PPS_INTR_FIQ move it to the FIQ.
+*
+* @return
+*		- XST_SUCCESS if the interrupt is connected
+*		- XST_NO_FEATURE if pps_out is not wired to the PS
+*		- XST_FAILURE otherwise
+*
+* @note		None.
+*
+******************************************************************************/
+int PpsIntr_Init(void)
+{
+#ifdef CLK_DIV_PPS_INTR_ID
+	int Status;
+
+	Status = Intc_Connect(CLK_DIV_PPS_INTR_ID,
+			      (Xil_InterruptHandler)PpsIntr_IrqHandler, NULL,
+			      PPS_INTR_PRIORITY, INTC_TRIGGER_RISING);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	PpsConnected = 1U;
+
+#ifdef PPS_INTR_FIQ
+	Status = Intc_Connect(PPS_INTR_SGI_ID,
+			      (Xil_InterruptHandler)PpsIntr_SgiHandler, NULL,
+			      PPS_INTR_PRIORITY, INTC_TRIGGER_RISING);
+	if (Status == XST_SUCCESS) {
+		Status = PpsFiq_Route(CLK_DIV_PPS_INTR_ID, PPS_INTR_SGI_ID);
+	}
+#endif
+
+	return Status;
+#else
+	return XST_NO_FEATURE;
+#endif
+}
+
+/*****************************************************************************/
+/**
+* Register a handler to be called on every pps. Handlers are called in the
+* order they were added.
+*
+* @param	Handler is the per-second handler.
+* @param	CallBackRef is passed to the handler.
+*
+* @return
+*		- XST_SUCCESS if the handler was added
+*		- XST_FAILURE if PPS_INTR_MAX_HANDLERS are already registered
+*
+* @note		Call before PpsIntr_Init() or with the pps interrupt masked.
+*
+******************************************************************************/
+int PpsIntr_AddHandler(PpsIntr_Handler Handler, void *CallBackRef)
+{
+	if (PpsHandlerCount >= PPS_INTR_MAX_HANDLERS) {
+		return XST_FAILURE;
+	}
+
+	PpsHandlers[PpsHandlerCount].Handler = Handler;
+	PpsHandlers[PpsHandlerCount].CallBackRef = CallBackRef;
+	PpsHandlerCount++;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Return the number of pps interrupts taken since boot.
+*
+* @return	pps count.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 PpsIntr_GetCount(void)
+{
+	return PpsCount;
+}
+
+/*****************************************************************************/
+/**
+* Mask or unmask the pps interrupt, for while pps_out cannot be trusted.
+* Edges latched by the GIC while the interrupt was masked are dropped, not
+* taken when it is unmasked.
+*
+* @param	Mask is 1 to mask the interrupt, 0 to unmask it.
+*
+* @return	None.
+*
+* @note		Does nothing before PpsIntr_Init() has connected the
+*		interrupt.
+*
+******************************************************************************/
+void PpsIntr_Mask(u32 Mask)
+{
+#ifdef CLK_DIV_PPS_INTR_ID
+	XScuGic *IntcPtr;
+
+	if (PpsConnected == 0U) {
+		return;
+	}
+
+	IntcPtr = Intc_GetInstance();
+	if (Mask != 0U) {
+		XScuGic_Disable(IntcPtr, CLK_DIV_PPS_INTR_ID);
+	} else {
+		XScuGic_DistWriteReg(IntcPtr, XSCUGIC_PENDING_CLR_OFFSET +
+				     ((CLK_DIV_PPS_INTR_ID / 32U) * 4U),
+				     1U << (CLK_DIV_PPS_INTR_ID % 32U));
+		XScuGic_Enable(IntcPtr, CLK_DIV_PPS_INTR_ID);
+	}
+#else
+	(void)Mask;
+#endif
+}
+
+/*****************************************************************************/
+/**
+* Sleep until the next pps, or until a deadline if it does not come.
+*
+* @param	Deadline is the global timer value to give up at.
+*
+* @return
+*		- XST_SUCCESS on the pps; the handlers have run
+*		- XST_TIMEOUT if the deadline passed first
+*
+* @note		Not for interrupt context.
+*
+******************************************************************************/
+int PpsIntr_Wait(XTime Deadline)
+{
+	u32 Count = PpsCount;
+
+	return TimerSvc_WaitUntil(Deadline, PpsIntr_Arrived, &Count);
+}
+
+/*****************************************************************************/
+/**
+* Return how long the per-second handlers took.
+*
+* @param	StatsPtr returns the statistics.
+* @param	Reset is 1 to start over after the copy.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void PpsIntr_GetStats(PpsIntr_Stats *StatsPtr, u32 Reset)
+{
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_IRQ);
+
+	*StatsPtr = PpsStats;
+	if (Reset != 0U) {
+		PpsStats.Count = 0U;
+		PpsStats.MinTicks = 0U;
+		PpsStats.MaxTicks = 0U;
+		PpsStats.SumTicks = 0U;
+	}
+
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+* Wait condition of PpsIntr_Wait().
+*
+* @param	CallBackRef is the pps count at the start of the wait.
+*
+* @return	Nonzero once a pps has been taken since.
+*
+* @note		None.
+*
+******************************************************************************/
+static int PpsIntr_Arrived(void *CallBackRef)
+{
+	return (PpsCount != *(u32 *)CallBackRef) ? 1 : 0;
+}
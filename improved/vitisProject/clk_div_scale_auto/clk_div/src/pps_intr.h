@@ -0,0 +1,72 @@
+/*****************************************************************************/
+/**
+* @file pps_intr.h
+*
+* Dispatch of the pps interrupt. clk_div_top drives the pps reference it is
+* locked to on pps_out, which is wired to IRQ_F2P[0]. Each pps the handler
+* takes a global timer timestamp as early as possible and passes it to every
+* registered per-second handler.
+*
+* Built with PPS_INTR_FIQ, the pps is taken as FIQ by pps_fiq.c, which
+* timestamps it and raises PPS_INTR_SGI_ID; the handlers then run from that
+* SGI with the FIQ timestamp. The IRQ handler of pps_out stays connected for
+* the pps the IRQ path acknowledges first.
+*
+* The handler also times itself, from that timestamp to the return of the
+* last per-second handler. PpsIntr_GetStats() returns the spread, the part
+* of the pps jitter of CPU0 that comes from the work done each second.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 Added PpsIntr_Mask().
+* 1.02a xl   10/19/26 Added PpsIntr_Wait().
+* 1.03a xl   10/19/26 Added PpsIntr_GetStats().
+* 1.04a xl   10/19/26 Added the FIQ path, PPS_INTR_FIQ.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PPS_INTR_H		/* prevent circular inclusions */
+#define PPS_INTR_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xtime_l.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PPS_INTR_MAX_HANDLERS	4	/* Per-second handlers */
+#define PPS_INTR_PRIORITY	0x08U	/* Highest priority used by the app */
+#define PPS_INTR_SGI_ID		14U	/* Dispatch of the FIQ path */
+
+/**************************** Type Definitions ******************************/
+
+/*
+ * Called in IRQ context once per pps. Timestamp is the global timer value
+ * taken on entry to the interrupt handler, the FIQ one with PPS_INTR_FIQ.
+ */
+typedef void (*PpsIntr_Handler)(void *CallBackRef, XTime Timestamp);
+
+/* Time spent in the per-second handlers, in global timer ticks */
+typedef struct {
+	u32 Count;		/* pps timed */
+	u32 MinTicks;
+	u32 MaxTicks;
+	u64 SumTicks;
+} PpsIntr_Stats;
+
+/************************** Function Prototypes *****************************/
+
+int PpsIntr_Init(void);
+int PpsIntr_AddHandler(PpsIntr_Handler Handler, void *CallBackRef);
+u32 PpsIntr_GetCount(void);
+void PpsIntr_Mask(u32 Mask);
+int PpsIntr_Wait(XTime Deadline);
+void PpsIntr_GetStats(PpsIntr_Stats *StatsPtr, u32 Reset);
+
+#endif /* end of protection macro */
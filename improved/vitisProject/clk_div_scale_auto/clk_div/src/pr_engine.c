@@ -0,0 +1,412 @@
+/*****************************************************************************/
+/**
+* @file pr_engine.c
+*
+* Partial reconfiguration of the divisor engine. See pr_engine.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 Added the swap event callbacks.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stddef.h>
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xil_cache.h"
+#include "xtime_l.h"
+#include "clk_div_pl.h"
+#include "intc.h"
+#include "pps_intr.h"
+#include "temp_comp.h"
+#include "pr_engine.h"
+
+#ifdef CLK_DIV_PR_LIB_ADDR
+
+#include "xdevcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PR_ENGINE_DCFG_DEVICE_ID	XPAR_XDCFG_0_DEVICE_ID
+#define PR_ENGINE_DCFG_INTR_ID		XPAR_XDCFG_0_INTR
+
+/* Address LSBs 01 mark the last DMA command of a transfer */
+#define PR_ENGINE_LAST_TRANSFER		0x1U
+
+#define PR_ENGINE_INTR_MASK		(XDCFG_IXR_DMA_DONE_MASK | \
+					 XDCFG_IXR_D_P_DONE_MASK | \
+					 XDCFG_IXR_ERROR_FLAGS_MASK)
+
+/************************** Function Prototypes *****************************/
+
+static int PrEngine_CheckLib(const PrEngine_Lib *LibPtr);
+static void PrEngine_DcfgHandler(void *CallBackRef, u32 IntrStatus);
+
+/************************** Variable Definitions **************************/
+
+static XDcfg DcfgInstance;
+static const PrEngine_Lib *Lib;
+static volatile u32 PendingVariant;
+static XTime SwapStart;
+static volatile PrEngine_Status EngineStatus = {
+	PR_ENGINE_VARIANT_BOOT, 0U, 0U, 0U, 0U, 0U
+};
+static PrEngine_Events EngineEvents;
+
+/*****************************************************************************/
+/**
+* Find the variant library and set up the PCAP for partial reconfiguration
+* with the devcfg interrupt.
+*
+* @return
+*		- XST_SUCCESS if the engine can be swapped
+*		- XST_NO_FEATURE if there is no valid library in DDR
+*		- XST_FAILURE otherwise
+*
+* @note		None.
+*
+******************************************************************************/
+int PrEngine_Init(void)
+{
+	XDcfg_Config *ConfigPtr;
+	int Status;
+
+	if (PrEngine_CheckLib((const PrEngine_Lib *)CLK_DIV_PR_LIB_ADDR) !=
+	    XST_SUCCESS) {
+		return XST_NO_FEATURE;
+	}
+
+	ConfigPtr = XDcfg_LookupConfig(PR_ENGINE_DCFG_DEVICE_ID);
+	if (ConfigPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XDcfg_CfgInitialize(&DcfgInstance, ConfigPtr,
+				     ConfigPtr->BaseAddr);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/* The PCAP, not the ICAP, reconfigures the PL after the boot */
+	XDcfg_EnablePCAP(&DcfgInstance);
+	XDcfg_SelectPcapInterface(&DcfgInstance);
+
+	XDcfg_SetHandler(&DcfgInstance, (void *)PrEngine_DcfgHandler, NULL);
+	XDcfg_IntrClear(&DcfgInstance, XDCFG_IXR_ALL_MASK);
+	XDcfg_IntrEnable(&DcfgInstance, PR_ENGINE_INTR_MASK);
+
+	Status = Intc_Connect(PR_ENGINE_DCFG_INTR_ID,
+			      (Xil_InterruptHandler)XDcfg_InterruptHandler,
+			      &DcfgInstance, PR_ENGINE_PRIORITY,
+			      INTC_TRIGGER_LEVEL);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Lib = (const PrEngine_Lib *)CLK_DIV_PR_LIB_ADDR;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Return the number of engine variants.
+*
+* @return	Variants in the library, 0 if PrEngine_Init() found none.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 PrEngine_GetCount(void)
+{
+	return (Lib != NULL) ? Lib->Count : 0U;
+}
+
+/*****************************************************************************/
+/**
+* Return an engine variant.
+*
+* @param	Index is the variant, below PrEngine_GetCount().
+*
+* @return	The variant, NULL if there is no such variant.
+*
+* @note		None.
+*
+******************************************************************************/
+const PrEngine_Variant *PrEngine_GetVariant(u32 Index)
+{
+	if (Index >= PrEngine_GetCount()) {
+		return NULL;
+	}
+
+	return &Lib->Variant[Index];
+}
+
+/*****************************************************************************/
+/**
+* Start loading an engine variant into the reconfigurable partition. The
+* partial bitstream goes to the PCAP by DMA; the devcfg interrupt ends the
+* swap and calls the callbacks of PrEngine_SetEvents().
+*
+* @param	Index is the variant.
+*
+* @return
+*		- XST_SUCCESS if the DMA was started
+*		- XST_NO_FEATURE if there is no library
+*		- XST_INVALID_PARAM if there is no such variant
+*		- XST_DEVICE_BUSY if a swap is in progress
+*		- XST_FAILURE if the DMA did not start
+*
+* @note		None.
+*
+******************************************************************************/
+int PrEngine_Start(u32 Index)
+{
+	const PrEngine_Variant *VariantPtr;
+	UINTPTR Address;
+	u32 Status;
+
+	if (Lib == NULL) {
+		return XST_NO_FEATURE;
+	}
+	VariantPtr = PrEngine_GetVariant(Index);
+	if (VariantPtr == NULL) {
+		return XST_INVALID_PARAM;
+	}
+	if (EngineStatus.Busy != 0U) {
+		return XST_DEVICE_BUSY;
+	}
+
+	Address = (UINTPTR)Lib + VariantPtr->Offset;
+	Xil_DCacheFlushRange((INTPTR)Address, VariantPtr->Length);
+
+	/*
+	 * The outputs of clk_div_top are undefined while it is reloaded;
+	 * nothing may act on its pps until the new engine is in
+	 */
+	PpsIntr_Mask(1U);
+
+	PendingVariant = Index;
+	EngineStatus.Busy = 1U;
+	XDcfg_IntrClear(&DcfgInstance, XDCFG_IXR_ALL_MASK);
+	XTime_GetTime(&SwapStart);
+
+	Status = XDcfg_Transfer(&DcfgInstance,
+			(void *)(Address | PR_ENGINE_LAST_TRANSFER),
+			VariantPtr->Length >> 2,
+			(void *)(XDCFG_DMA_INVALID_ADDRESS |
+				 PR_ENGINE_LAST_TRANSFER),
+			0U, XDCFG_NON_SECURE_PCAP_WRITE);
+	if (Status != XST_SUCCESS) {
+		EngineStatus.Busy = 0U;
+		EngineStatus.Errors++;
+		PpsIntr_Mask(0U);
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Tell whether a swap is in progress.
+*
+* @return	1 while the partial bitstream is being loaded, 0 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+int PrEngine_IsBusy(void)
+{
+	return (EngineStatus.Busy != 0U) ? 1 : 0;
+}
+
+/*****************************************************************************/
+/**
+* Return the state of the engine and the last swap.
+*
+* @param	StatusPtr returns the status.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void PrEngine_GetStatus(PrEngine_Status *StatusPtr)
+{
+	*StatusPtr = EngineStatus;
+}
+
+/*****************************************************************************/
+/**
+* Set the callbacks of the swap events.
+*
+* @param	EventsPtr is the callbacks, copied; NULL removes them all.
+*
+* @return	None.
+*
+* @note		The callbacks run in the devcfg interrupt; set them while no
+*		swap is in progress.
+*
+******************************************************************************/
+void PrEngine_SetEvents(const PrEngine_Events *EventsPtr)
+{
+	if (EventsPtr != NULL) {
+		EngineEvents = *EventsPtr;
+	} else {
+		EngineEvents.DmaDone = NULL;
+		EngineEvents.PlDone = NULL;
+		EngineEvents.Error = NULL;
+		EngineEvents.CallBackRef = NULL;
+	}
+}
+
+/*****************************************************************************/
+/**
+* Check a variant library.
+*
+* @param	LibPtr is the library.
+*
+* @return	XST_SUCCESS if every variant lies within the library,
+*		XST_FAILURE otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int PrEngine_CheckLib(const PrEngine_Lib *LibPtr)
+{
+	const PrEngine_Variant *VariantPtr;
+	u32 Index;
+
+	if ((LibPtr->Magic != PR_ENGINE_LIB_MAGIC) || (LibPtr->Count == 0U) ||
+	    (LibPtr->Count > PR_ENGINE_MAX_VARIANTS)) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0U; Index < LibPtr->Count; Index++) {
+		VariantPtr = &LibPtr->Variant[Index];
+		if ((VariantPtr->Offset < sizeof(*LibPtr)) ||
+		    ((VariantPtr->Offset % PR_ENGINE_ALIGN) != 0U) ||
+		    (VariantPtr->Length == 0U) ||
+		    ((VariantPtr->Length & 0x3U) != 0U) ||
+		    (VariantPtr->Offset > LibPtr->Length) ||
+		    (VariantPtr->Length > (LibPtr->Length - VariantPtr->Offset)) ||
+		    (VariantPtr->NumWin == 0U)) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* devcfg interrupt: the partial bitstream is in the PCAP, the new engine
+* runs, or the transfer failed. Calls the callbacks of the events.
+*
+* @param	CallBackRef is unused.
+* @param	IntrStatus is the devcfg interrupt status, already cleared.
+*
+* @return	None.
+*
+* @note		After a failed transfer the state of clk_div_top is not
+*		known; it stays PR_ENGINE_VARIANT_NONE until a variant loads.
+*
+******************************************************************************/
+static void PrEngine_DcfgHandler(void *CallBackRef, u32 IntrStatus)
+{
+	XTime Now;
+
+	(void)CallBackRef;
+
+	if (EngineStatus.Busy == 0U) {
+		return;
+	}
+
+	/* The PCAP may still be writing the PL; the swap is not over yet */
+	if (((IntrStatus & XDCFG_IXR_DMA_DONE_MASK) != 0U) &&
+	    (EngineEvents.DmaDone != NULL)) {
+		EngineEvents.DmaDone(EngineEvents.CallBackRef, IntrStatus);
+	}
+
+	if ((IntrStatus & XDCFG_IXR_ERROR_FLAGS_MASK) != 0U) {
+		EngineStatus.Variant = PR_ENGINE_VARIANT_NONE;
+		EngineStatus.Errors++;
+	} else if ((IntrStatus & XDCFG_IXR_D_P_DONE_MASK) != 0U) {
+		EngineStatus.Variant = PendingVariant;
+		EngineStatus.Swaps++;
+		TempComp_SetNumWin(Lib->Variant[PendingVariant].NumWin);
+	} else {
+		return;
+	}
+
+	XTime_GetTime(&Now);
+	EngineStatus.LastUs = (u32)((Now - SwapStart) /
+				    (COUNTS_PER_SECOND / 1000000U));
+	EngineStatus.LastIntrStatus = IntrStatus;
+	EngineStatus.Busy = 0U;
+
+	PpsIntr_Mask(0U);
+
+	if ((IntrStatus & XDCFG_IXR_ERROR_FLAGS_MASK) != 0U) {
+		if (EngineEvents.Error != NULL) {
+			EngineEvents.Error(EngineEvents.CallBackRef,
+					   IntrStatus);
+		}
+	} else if (EngineEvents.PlDone != NULL) {
+		EngineEvents.PlDone(EngineEvents.CallBackRef, IntrStatus);
+	}
+}
+
+#else /* no partial reconfiguration */
+
+int PrEngine_Init(void)
+{
+	return XST_NO_FEATURE;
+}
+
+u32 PrEngine_GetCount(void)
+{
+	return 0U;
+}
+
+const PrEngine_Variant *PrEngine_GetVariant(u32 Index)
+{
+	(void)Index;
+	return NULL;
+}
+
+int PrEngine_Start(u32 Index)
+{
+	(void)Index;
+	return XST_NO_FEATURE;
+}
+
+int PrEngine_IsBusy(void)
+{
+	return 0;
+}
+
+void PrEngine_GetStatus(PrEngine_Status *StatusPtr)
+{
+	StatusPtr->Variant = PR_ENGINE_VARIANT_BOOT;
+	StatusPtr->Busy = 0U;
+	StatusPtr->Swaps = 0U;
+	StatusPtr->Errors = 0U;
+	StatusPtr->LastUs = 0U;
+	StatusPtr->LastIntrStatus = 0U;
+}
+
+void PrEngine_SetEvents(const PrEngine_Events *EventsPtr)
+{
+	(void)EventsPtr;
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*****************************************************************************/
+/**
+* @file pr_engine.h
+*
+* Partial reconfiguration of the divisor engine. clk_div_top is the
+* reconfigurable partition of the PL (files/clk_div_pr.xdc), and each
+* engine variant is clk_div_top built with other NUM_WIN and THRESHOLD
+* generics. tools/prlib.c packs the partial bitstreams of the variants into
+* one library, which the FSBL loads to CLK_DIV_PR_LIB_ADDR as a data
+* partition of the boot image.
+*
+* PrEngine_Start() sends a variant to the PCAP by DMA and returns at once;
+* the devcfg interrupt ends the swap. The PS, pps_gen and the AXI GPIOs keep
+* running. The pps interrupt is masked while clk_div_top is reloaded, and
+* the temperature compensation restarts with the NUM_WIN of the new engine.
+*
+* Callbacks for DMA done, PL done and errors, set with PrEngine_SetEvents(),
+* tell the application about the swap without polling, like PcapSetEvents()
+* of the FSBL does during the boot.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 Added the swap event callbacks.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PR_ENGINE_H		/* prevent circular inclusions */
+#define PR_ENGINE_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PR_ENGINE_LIB_MAGIC	0x52504443U	/* "CDPR" */
+#define PR_ENGINE_MAX_VARIANTS	8U
+#define PR_ENGINE_ALIGN		64U	/* Offset alignment of a variant */
+#define PR_ENGINE_PRIORITY	0xA0U	/* Below the pps interrupt */
+
+/* Variant of PrEngine_Status before the first swap, or after a failed one */
+#define PR_ENGINE_VARIANT_BOOT	0xFFFFFFFEU	/* From the full bitstream */
+#define PR_ENGINE_VARIANT_NONE	0xFFFFFFFFU	/* Engine not configured */
+
+/**************************** Type Definitions ******************************/
+
+/*
+ * Library layout: a PrEngine_Lib header, then the partial bitstreams, each
+ * in the word order of the PCAP at a multiple of PR_ENGINE_ALIGN.
+ */
+typedef struct {
+	u32 Offset;		/* From the start of the library, in bytes */
+	u32 Length;		/* Partial bitstream length in bytes */
+	u32 NumWin;		/* NUM_WIN generic of the variant */
+	u32 Threshold;		/* THRESHOLD generic of the variant */
+} PrEngine_Variant;
+
+typedef struct {
+	u32 Magic;		/* PR_ENGINE_LIB_MAGIC */
+	u32 Count;		/* Variants in the library */
+	u32 Length;		/* Library length in bytes */
+	u32 Reserved;
+	PrEngine_Variant Variant[PR_ENGINE_MAX_VARIANTS];
+} PrEngine_Lib;
+
+/*
+ * Swap events, called from the devcfg interrupt with the interrupt status
+ * bits that raised them, after PrEngine_Status is updated. Any of them may
+ * be NULL.
+ */
+typedef void (*PrEngine_EventHandler)(void *CallBackRef, u32 IntrStatus);
+
+typedef struct {
+	PrEngine_EventHandler DmaDone;	/* The bitstream is in the PCAP */
+	PrEngine_EventHandler PlDone;	/* The new engine runs */
+	PrEngine_EventHandler Error;	/* The swap failed */
+	void *CallBackRef;
+} PrEngine_Events;
+
+typedef struct {
+	u32 Variant;		/* Engine in the PL, or PR_ENGINE_VARIANT_* */
+	u32 Busy;		/* A swap is in progress */
+	u32 Swaps;		/* Swaps done */
+	u32 Errors;		/* Swaps failed */
+	u32 LastUs;		/* Time of the last swap */
+	u32 LastIntrStatus;	/* devcfg interrupt status that ended it */
+} PrEngine_Status;
+
+/************************** Function Prototypes *****************************/
+
+int PrEngine_Init(void);
+u32 PrEngine_GetCount(void);
+const PrEngine_Variant *PrEngine_GetVariant(u32 Index);
+int PrEngine_Start(u32 Index);
+int PrEngine_IsBusy(void);
+void PrEngine_GetStatus(PrEngine_Status *StatusPtr);
+void PrEngine_SetEvents(const PrEngine_Events *EventsPtr);
+
+#endif /* end of protection macro */
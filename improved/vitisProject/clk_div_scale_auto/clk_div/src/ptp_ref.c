@@ -0,0 +1,441 @@
+/*****************************************************************************/
+/**
+* @file ptp_ref.c
+*
+* PTP disciplined pps reference for clk_div_top. See ptp_ref.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 The pps phase detector and the servos run from OCM.
+* 1.02a xl   10/19/26 A TSU step also applies the frequency correction.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+#include "xemacps.h"
+#include "xgpio.h"
+#include "xtime_l.h"
+#include "xstatus.h"
+#include "clk_div_pl.h"
+#include "pps_intr.h"
+#include "ptp_servo.h"
+#include "ocm.h"
+#include "ptp_ref.h"
+
+#if defined(CLK_DIV_PPS_GEN_GPIO_DEVICE_ID) && defined(CLK_DIV_PPS_INTR_ID)
+
+/************************** Constant Definitions ****************************/
+
+#define PTP_REF_EMAC_DEVICE_ID		XPAR_XEMACPS_0_DEVICE_ID
+
+/*
+ * The TSU runs from CPU_1x unless a clock is brought in through EMIO;
+ * CPU_1x is a sixth of the CPU clock in the default 6:2:1 ratio.
+ */
+#if XPAR_XEMACPS_0_ENET_TSU_CLK_FREQ_HZ != 0
+#define PTP_REF_TSU_CLK_HZ	XPAR_XEMACPS_0_ENET_TSU_CLK_FREQ_HZ
+#else
+#define PTP_REF_TSU_CLK_HZ	(XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 6U)
+#endif
+
+/************************** Function Prototypes *****************************/
+
+static void PtpRef_PpsHandler(void *CallBackRef, XTime Timestamp) OCM_TEXT;
+static void PtpRef_WritePpsGen(u32 Period, s32 Step) OCM_TEXT;
+
+/************************** Variable Definitions **************************/
+
+static XEmacPs EmacInstance;
+static XGpio PpsGenGpio;
+
+static PtpServo TsuServo OCM_BSS;
+static PtpServo PpsServo OCM_BSS;
+
+static u32 NominalPeriod;	/* sys_clk cycles per second, nominal */
+static double PeriodFrac OCM_BSS;	/* Cycle fraction for the next pps */
+static u32 CtrlReg;		/* Shadow of the pps_gen control channel */
+
+static s64 LastMasterTxNs;	/* t1 of the last Sync */
+static s64 LastSlaveRxNs;	/* t2 of the last Sync */
+static u32 PathDelayValid;
+
+static volatile PtpRef_Status RefStatus;
+
+/*****************************************************************************/
+/**
+* Initialize the TSU and pps_gen and register the pps phase detector. The
+* pps interrupt itself is enabled by the caller with PpsIntr_Init().
+*
+* @param	SysClkHz is the nominal sys_clk frequency. It only seeds the
+*		pps_gen period; the servo finds the actual frequency.
+*
+* @return
+*		- XST_SUCCESS if the reference is ready
+*		- XST_NO_FEATURE if the PL has no pps_gen
+*		- XST_FAILURE otherwise
+*
+* @note		None.
+*
+******************************************************************************/
+int PtpRef_Init(u32 SysClkHz)
+{
+	XEmacPs_Config *EmacConfigPtr;
+	int Status;
+
+	EmacConfigPtr = XEmacPs_LookupConfig(PTP_REF_EMAC_DEVICE_ID);
+	if (EmacConfigPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XEmacPs_CfgInitialize(&EmacInstance, EmacConfigPtr,
+				       EmacConfigPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	XEmacPs_PtpSetIncrement(&EmacInstance, PTP_REF_TSU_CLK_HZ);
+
+	Status = XGpio_Initialize(&PpsGenGpio, CLK_DIV_PPS_GEN_GPIO_DEVICE_ID);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XGpio_SetDataDirection(&PpsGenGpio, CLK_DIV_PPS_GEN_PERIOD_CHANNEL, 0x0);
+	XGpio_SetDataDirection(&PpsGenGpio, CLK_DIV_PPS_GEN_CTRL_CHANNEL, 0x0);
+
+	PtpServo_Init(&TsuServo, PTP_REF_TSU_KP, PTP_REF_TSU_KI,
+		      PTP_REF_TSU_MAX_PPB, PTP_REF_TSU_STEP_NS);
+	PtpServo_Init(&PpsServo, PTP_REF_PPS_KP, PTP_REF_PPS_KI,
+		      PTP_REF_PPS_MAX_PPB, PTP_REF_PPS_STEP_NS);
+
+	NominalPeriod = SysClkHz;
+	PeriodFrac = 0.0;
+	CtrlReg = 0U;
+	PathDelayValid = 0U;
+	LastSlaveRxNs = 0;
+
+	/* Free run at the nominal rate until the TSU is locked */
+	PtpRef_WritePpsGen(NominalPeriod, 0);
+
+	return PpsIntr_AddHandler(PtpRef_PpsHandler, NULL);
+}
+
+/*****************************************************************************/
+/**
+* Select pps_gen or the pps_clk pin as the reference of clk_div_top.
+*
+* @param	Enable is 1 to use pps_gen, 0 for the pps_clk pin.
+*
+* @return	XST_SUCCESS.
+*
+* @note		clk_div_top keeps averaging across the switch; pulse rst_n
+*		afterwards for a clean restart of the divisor windows.
+*
+******************************************************************************/
+int PtpRef_Select(u32 Enable)
+{
+	if (Enable != 0U) {
+		CtrlReg |= CLK_DIV_PPS_GEN_SEL_MASK;
+	} else {
+		CtrlReg &= ~CLK_DIV_PPS_GEN_SEL_MASK;
+	}
+
+	XGpio_DiscreteWrite(&PpsGenGpio, CLK_DIV_PPS_GEN_CTRL_CHANNEL, CtrlReg);
+	RefStatus.Selected = Enable;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Run the TSU servo on a Sync message. Called by the PTP message layer when
+* the Follow_Up (or the one-step Sync) carrying the origin timestamp has
+* arrived; the receive timestamp of the Sync is read from the MAC.
+*
+* @param	OriginTs is t1, the precise origin timestamp of the Sync,
+*		corrected by the correctionField.
+*
+* @return
+*		- XST_SUCCESS if the sample was used
+*		- XST_FAILURE if the TSU could not be adjusted
+*
+* @note		None.
+*
+******************************************************************************/
+int PtpRef_SyncReceived(const XEmacPs_PtpTime *OriginTs)
+{
+	XEmacPs_PtpTime RxTs;
+	XEmacPs_PtpTime Now;
+	PtpServo_State State;
+	s64 MasterTxNs;
+	s64 SlaveRxNs;
+	s64 OffsetNs;
+	s64 AdjustNs;
+	double IntervalS;
+	double FreqPpb;
+	int Status = XST_SUCCESS;
+
+	XEmacPs_PtpGetEventTime(&EmacInstance, XEMACPS_PTP_EVENT_RX, &RxTs);
+
+	MasterTxNs = PtpServo_ToNs(OriginTs->Seconds, OriginTs->NanoSeconds);
+	SlaveRxNs = PtpServo_ToNs(RxTs.Seconds, RxTs.NanoSeconds);
+	OffsetNs = PtpServo_Offset(MasterTxNs, SlaveRxNs,
+				   (PathDelayValid != 0U) ?
+				   RefStatus.PathDelayNs : 0);
+
+	if ((LastSlaveRxNs != 0) && (SlaveRxNs > LastSlaveRxNs)) {
+		IntervalS = (double)(SlaveRxNs - LastSlaveRxNs) /
+				(double)PTP_SERVO_NS_PER_SEC;
+	} else {
+		IntervalS = 1.0;
+	}
+	LastMasterTxNs = MasterTxNs;
+	LastSlaveRxNs = SlaveRxNs;
+
+	State = PtpServo_Sample(&TsuServo, OffsetNs, IntervalS, &FreqPpb);
+
+	switch (State) {
+	case PTP_SERVO_JUMP:
+		/*
+		 * The step carries the frequency correction of the next
+		 * interval too, or the drift of a fast crystal alone would
+		 * exceed the step threshold again by the next Sync.
+		 */
+		AdjustNs = (s64)(FreqPpb * IntervalS) - OffsetNs;
+		if ((AdjustNs < (s64)XEMACPS_1588_ADJ_NS_MASK) &&
+		    (AdjustNs > -(s64)XEMACPS_1588_ADJ_NS_MASK)) {
+			Status = (int)XEmacPs_PtpAdjustTime(&EmacInstance,
+							    (s32)AdjustNs);
+		} else {
+			XEmacPs_PtpGetTime(&EmacInstance, &Now);
+			AdjustNs += PtpServo_ToNs(Now.Seconds, Now.NanoSeconds);
+			Now.Seconds = (u32)(AdjustNs / PTP_SERVO_NS_PER_SEC);
+			Now.NanoSeconds = (u32)(AdjustNs % PTP_SERVO_NS_PER_SEC);
+			XEmacPs_PtpSetTime(&EmacInstance, &Now);
+		}
+		/* Stepped clocks invalidate the t1/t2 pair */
+		LastSlaveRxNs = 0;
+		break;
+
+	case PTP_SERVO_LOCKED:
+		/*
+		 * The TSU increment cannot be trimmed finely enough on this
+		 * GEM, so the frequency correction is applied as a phase
+		 * correction of one interval's worth per sample.
+		 */
+		AdjustNs = (s64)(FreqPpb * IntervalS);
+		Status = (int)XEmacPs_PtpAdjustTime(&EmacInstance, (s32)AdjustNs);
+		break;
+
+	default:
+		break;
+	}
+
+	RefStatus.TsuState = State;
+	RefStatus.TsuOffsetNs = OffsetNs;
+	RefStatus.TsuFreqPpb = FreqPpb;
+
+	return (Status == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
+}
+
+/*****************************************************************************/
+/**
+* Update the mean path delay on a Delay_resp message. The transmit
+* timestamp of the Delay_req is read from the MAC.
+*
+* @param	ReceiveTs is t4, the receive timestamp in the Delay_resp.
+*
+* @return
+*		- XST_SUCCESS if the delay was updated
+*		- XST_FAILURE if no Sync was seen yet or the delay is negative
+*
+* @note		The delay is averaged over 8 exchanges.
+*
+******************************************************************************/
+int PtpRef_DelayRespReceived(const XEmacPs_PtpTime *ReceiveTs)
+{
+	XEmacPs_PtpTime TxTs;
+	s64 DelayNs;
+
+	if (LastSlaveRxNs == 0) {
+		return XST_FAILURE;
+	}
+
+	XEmacPs_PtpGetEventTime(&EmacInstance, XEMACPS_PTP_EVENT_TX, &TxTs);
+
+	DelayNs = PtpServo_PathDelay(LastMasterTxNs, LastSlaveRxNs,
+			PtpServo_ToNs(TxTs.Seconds, TxTs.NanoSeconds),
+			PtpServo_ToNs(ReceiveTs->Seconds,
+				      ReceiveTs->NanoSeconds));
+	if (DelayNs < 0) {
+		return XST_FAILURE;
+	}
+
+	if (PathDelayValid == 0U) {
+		RefStatus.PathDelayNs = DelayNs;
+		PathDelayValid = 1U;
+	} else {
+		RefStatus.PathDelayNs += (DelayNs - RefStatus.PathDelayNs) / 8;
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Copy out the state of both loops.
+*
+* @param	StatusPtr returns the status.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void PtpRef_GetStatus(PtpRef_Status *StatusPtr)
+{
+	*StatusPtr = RefStatus;
+}
+
+/*****************************************************************************/
+/**
+* pps phase detector, in IRQ context. The TSU is read now and moved back by
+* the global timer time elapsed since the edge was timestamped, which gives
+* the TSU time of the pps edge. Its distance from the nearest TSU second is
+* the phase error of pps_gen.
+*
+* @param	CallBackRef is unused.
+* @param	Timestamp is the global timer time of the pps edge.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void PtpRef_PpsHandler(void *CallBackRef, XTime Timestamp)
+{
+	XEmacPs_PtpTime Now;
+	XTime Elapsed;
+	PtpServo_State State;
+	s64 EdgeNs;
+	s64 PhaseNs;
+	s64 OffsetNs;
+	double FreqPpb;
+	double PeriodF;
+	u32 Period;
+	s32 Step = 0;
+
+	(void)CallBackRef;
+
+	XEmacPs_PtpGetTime(&EmacInstance, &Now);
+	XTime_GetTime(&Elapsed);
+	Elapsed -= Timestamp;
+
+	/* Only discipline pps_gen once the TSU follows the master */
+	if (TsuServo.State != PTP_SERVO_LOCKED) {
+		return;
+	}
+
+	EdgeNs = PtpServo_ToNs(Now.Seconds, Now.NanoSeconds) -
+			(s64)((Elapsed * (u64)PTP_SERVO_NS_PER_SEC) /
+			      COUNTS_PER_SECOND) - PTP_REF_PPS_LATENCY_NS;
+	PhaseNs = EdgeNs % PTP_SERVO_NS_PER_SEC;
+	if (PhaseNs > (PTP_SERVO_NS_PER_SEC / 2)) {
+		PhaseNs -= PTP_SERVO_NS_PER_SEC;
+	}
+
+	/* A late pps is a pps_gen second that runs behind the TSU */
+	OffsetNs = -PhaseNs;
+
+	State = PtpServo_Sample(&PpsServo, OffsetNs, 1.0, &FreqPpb);
+
+	if (State == PTP_SERVO_JUMP) {
+		Step = (s32)((OffsetNs * (s64)NominalPeriod) /
+			     PTP_SERVO_NS_PER_SEC);
+		if (Step > CLK_DIV_PPS_GEN_STEP_MAX) {
+			Step = CLK_DIV_PPS_GEN_STEP_MAX;
+		} else if (Step < -CLK_DIV_PPS_GEN_STEP_MAX) {
+			Step = -CLK_DIV_PPS_GEN_STEP_MAX;
+		}
+	}
+
+	/* A faster pps_gen is a shorter period; dither the fraction */
+	PeriodF = ((double)NominalPeriod * (1.0 - (FreqPpb * 1e-9))) +
+			PeriodFrac;
+	Period = (u32)PeriodF;
+	PeriodFrac = PeriodF - (double)Period;
+
+	PtpRef_WritePpsGen(Period, Step);
+
+	RefStatus.PpsState = State;
+	RefStatus.PpsOffsetNs = OffsetNs;
+	RefStatus.PpsFreqPpb = FreqPpb;
+}
+
+/*****************************************************************************/
+/**
+* Load a new period, and a one-off phase step, into pps_gen. Both take
+* effect on the second that is running when the load toggle arrives.
+*
+* @param	Period is the number of sys_clk cycles per second.
+* @param	Step is added once to the running second, in sys_clk cycles.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void PtpRef_WritePpsGen(u32 Period, s32 Step)
+{
+	XGpio_DiscreteWrite(&PpsGenGpio, CLK_DIV_PPS_GEN_PERIOD_CHANNEL, Period);
+
+	CtrlReg = (CtrlReg & (CLK_DIV_PPS_GEN_SEL_MASK |
+			      CLK_DIV_PPS_GEN_LOAD_MASK)) |
+		  ((u32)Step << CLK_DIV_PPS_GEN_STEP_SHIFT);
+	XGpio_DiscreteWrite(&PpsGenGpio, CLK_DIV_PPS_GEN_CTRL_CHANNEL, CtrlReg);
+
+	/* Toggle last so pps_gen samples settled PERIOD and STEP */
+	CtrlReg ^= CLK_DIV_PPS_GEN_LOAD_MASK;
+	XGpio_DiscreteWrite(&PpsGenGpio, CLK_DIV_PPS_GEN_CTRL_CHANNEL, CtrlReg);
+
+	RefStatus.PpsPeriod = Period;
+}
+
+#else /* no pps_gen in the PL */
+
+int PtpRef_Init(u32 SysClkHz)
+{
+	(void)SysClkHz;
+	return XST_NO_FEATURE;
+}
+
+int PtpRef_Select(u32 Enable)
+{
+	(void)Enable;
+	return XST_NO_FEATURE;
+}
+
+int PtpRef_SyncReceived(const XEmacPs_PtpTime *OriginTs)
+{
+	(void)OriginTs;
+	return XST_NO_FEATURE;
+}
+
+int PtpRef_DelayRespReceived(const XEmacPs_PtpTime *ReceiveTs)
+{
+	(void)ReceiveTs;
+	return XST_NO_FEATURE;
+}
+
+void PtpRef_GetStatus(PtpRef_Status *StatusPtr)
+{
+	(void)StatusPtr;
+}
+
+#endif
@@ -0,0 +1,81 @@
+/*****************************************************************************/
+/**
+* @file ptp_ref.h
+*
+* PTP disciplined pps reference for clk_div_top, for sites that have PTP but
+* no GNSS pps on the pps_clk pin.
+*
+* Two servos (ptp_servo.c) are cascaded:
+*  - The GEM 1588 timer (TSU) is disciplined to the PTP master from the
+*    Sync/Follow_Up and Delay_req/Delay_resp timestamps. The MAC captures
+*    the local timestamps (t2, t3); the PTP message layer passes in the
+*    master timestamps (t1, t4).
+*  - pps_gen in the PL counts sys_clk cycles and is disciplined to the TSU
+*    second: on each pps interrupt the phase of the pps against the TSU is
+*    measured and the pps_gen period (and, to acquire, its phase) is
+*    corrected. Selecting pps_gen as the reference of clk_div_top then makes
+*    the divisor track sys_clk against PTP time.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PTP_REF_H		/* prevent circular inclusions */
+#define PTP_REF_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xemacps.h"
+#include "ptp_servo.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Delay from the pps_out edge to the timestamp taken in PpsIntr, subtracted
+ * from the measured pps phase. Calibrate on the target with a scope on
+ * pps_out and a GEM timer compare, or leave at 0 to accept the fixed offset.
+ */
+#define PTP_REF_PPS_LATENCY_NS		0
+
+/* Servo tuning of the TSU loop, one Sync per second */
+#define PTP_REF_TSU_KP			0.7
+#define PTP_REF_TSU_KI			0.3
+#define PTP_REF_TSU_MAX_PPB		500000.0
+#define PTP_REF_TSU_STEP_NS		20000
+
+/* Servo tuning of the pps_gen loop, one sample per pps */
+#define PTP_REF_PPS_KP			0.5
+#define PTP_REF_PPS_KI			0.1
+#define PTP_REF_PPS_MAX_PPB		1000000.0
+#define PTP_REF_PPS_STEP_NS		20000
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	PtpServo_State TsuState;	/* TSU to PTP master loop */
+	s64 TsuOffsetNs;
+	double TsuFreqPpb;
+	s64 PathDelayNs;
+	PtpServo_State PpsState;	/* pps_gen to TSU loop */
+	s64 PpsOffsetNs;
+	double PpsFreqPpb;
+	u32 PpsPeriod;			/* Last pps_gen PERIOD written */
+	u32 Selected;			/* pps_gen drives clk_div_top */
+} PtpRef_Status;
+
+/************************** Function Prototypes *****************************/
+
+int PtpRef_Init(u32 SysClkHz);
+int PtpRef_Select(u32 Enable);
+int PtpRef_SyncReceived(const XEmacPs_PtpTime *OriginTs);
+int PtpRef_DelayRespReceived(const XEmacPs_PtpTime *ReceiveTs);
+void PtpRef_GetStatus(PtpRef_Status *StatusPtr);
+
+#endif /* end of protection macro */
@@ -0,0 +1,239 @@
+/*****************************************************************************/
+/**
+* @file ptp_servo.c
+*
+* Proportional-integral clock servo for PTP. See ptp_servo.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "ptp_servo.h"
+
+/***************** Macros (Inline Functions) Definitions *******************/
+
+#define PTP_SERVO_ABS(x)	(((x) < 0) ? -(x) : (x))
+
+/************************** Function Prototypes ****************************/
+
+static double PtpServo_Clamp(double Value, double Limit);
+
+/*****************************************************************************/
+/**
+* Initialize a servo.
+*
+* @param	ServoPtr is the servo to initialize.
+* @param	Kp is the proportional gain. 0.7 suits hardware timestamps at
+*		one sample per second.
+* @param	Ki is the integral gain. 0.3 suits hardware timestamps at one
+*		sample per second.
+* @param	MaxFreqPpb limits the returned correction.
+* @param	StepThresholdNs is the offset above which the servo asks for a
+*		step instead of slewing. 0 disables steps once locked.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void PtpServo_Init(PtpServo *ServoPtr, double Kp, double Ki,
+		   double MaxFreqPpb, s64 StepThresholdNs)
+{
+	ServoPtr->Kp = Kp;
+	ServoPtr->Ki = Ki;
+	ServoPtr->MaxFreqPpb = MaxFreqPpb;
+	ServoPtr->StepThresholdNs = StepThresholdNs;
+	ServoPtr->DriftPpb = 0.0;
+	PtpServo_Reset(ServoPtr);
+}
+
+/*****************************************************************************/
+/**
+* Restart the servo from the unlocked state. The frequency estimate is kept
+* so a servo that lost its reference restarts close to the right frequency.
+*
+* @param	ServoPtr is the servo.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void PtpServo_Reset(PtpServo *ServoPtr)
+{
+	ServoPtr->LastOffsetNs = 0;
+	ServoPtr->LastFreqPpb = ServoPtr->DriftPpb;
+	ServoPtr->SampleCount = 0U;
+	ServoPtr->State = PTP_SERVO_UNLOCKED;
+}
+
+/*****************************************************************************/
+/**
+* Feed one offset sample to the servo.
+*
+* @param	ServoPtr is the servo.
+* @param	OffsetNs is slave minus master time, in ns.
+* @param	IntervalS is the time since the previous sample, in seconds.
+* @param	FreqPpbPtr returns the frequency correction to apply, in ppb.
+*
+* @return
+*		- PTP_SERVO_UNLOCKED if more samples are needed; keep the
+*		  current frequency
+*		- PTP_SERVO_JUMP if the clock must be stepped by -OffsetNs and
+*		  set to the returned frequency
+*		- PTP_SERVO_LOCKED if the returned frequency must be applied
+*
+* @note		None.
+*
+******************************************************************************/
+PtpServo_State PtpServo_Sample(PtpServo *ServoPtr, s64 OffsetNs,
+			       double IntervalS, double *FreqPpbPtr)
+{
+	double KiTerm;
+	double FreqPpb;
+
+	switch (ServoPtr->SampleCount) {
+	case 0U:
+		ServoPtr->LastOffsetNs = OffsetNs;
+		ServoPtr->SampleCount = 1U;
+		ServoPtr->State = PTP_SERVO_UNLOCKED;
+		break;
+
+	case 1U:
+		/*
+		 * The change of offset over the interval is the frequency
+		 * error left over by the current correction.
+		 */
+		if (IntervalS > 0.0) {
+			ServoPtr->DriftPpb -= (double)(OffsetNs -
+					ServoPtr->LastOffsetNs) / IntervalS;
+			ServoPtr->DriftPpb = PtpServo_Clamp(ServoPtr->DriftPpb,
+						ServoPtr->MaxFreqPpb);
+		}
+		ServoPtr->LastFreqPpb = ServoPtr->DriftPpb;
+		ServoPtr->SampleCount = 2U;
+
+		if (PTP_SERVO_ABS(OffsetNs) > ServoPtr->StepThresholdNs) {
+			ServoPtr->State = PTP_SERVO_JUMP;
+		} else {
+			ServoPtr->State = PTP_SERVO_LOCKED;
+		}
+		break;
+
+	default:
+		if ((ServoPtr->StepThresholdNs != 0) &&
+		    (PTP_SERVO_ABS(OffsetNs) > ServoPtr->StepThresholdNs)) {
+			ServoPtr->LastFreqPpb = ServoPtr->DriftPpb;
+			ServoPtr->State = PTP_SERVO_JUMP;
+			break;
+		}
+
+		KiTerm = ServoPtr->Ki * (double)OffsetNs * IntervalS;
+		FreqPpb = ServoPtr->DriftPpb - KiTerm -
+				(ServoPtr->Kp * (double)OffsetNs);
+
+		/* Stop integrating while the output is saturated */
+		if ((FreqPpb > ServoPtr->MaxFreqPpb) ||
+		    (FreqPpb < -ServoPtr->MaxFreqPpb)) {
+			FreqPpb = PtpServo_Clamp(FreqPpb, ServoPtr->MaxFreqPpb);
+		} else {
+			ServoPtr->DriftPpb -= KiTerm;
+		}
+
+		ServoPtr->LastOffsetNs = OffsetNs;
+		ServoPtr->LastFreqPpb = FreqPpb;
+		ServoPtr->State = PTP_SERVO_LOCKED;
+		break;
+	}
+
+	*FreqPpbPtr = ServoPtr->LastFreqPpb;
+
+	return ServoPtr->State;
+}
+
+/*****************************************************************************/
+/**
+* Convert a seconds/nanoseconds timestamp to nanoseconds.
+*
+* @param	Seconds is the seconds field.
+* @param	NanoSeconds is the nanoseconds field.
+*
+* @return	The timestamp in ns.
+*
+* @note		None.
+*
+******************************************************************************/
+s64 PtpServo_ToNs(u32 Seconds, u32 NanoSeconds)
+{
+	return ((s64)Seconds * PTP_SERVO_NS_PER_SEC) + (s64)NanoSeconds;
+}
+
+/*****************************************************************************/
+/**
+* Offset of the slave from one Sync message.
+*
+* @param	MasterTxNs is t1, the origin timestamp from the master.
+* @param	SlaveRxNs is t2, the receive timestamp of the slave.
+* @param	PathDelayNs is the mean path delay.
+*
+* @return	Slave minus master time, in ns.
+*
+* @note		None.
+*
+******************************************************************************/
+s64 PtpServo_Offset(s64 MasterTxNs, s64 SlaveRxNs, s64 PathDelayNs)
+{
+	return SlaveRxNs - MasterTxNs - PathDelayNs;
+}
+
+/*****************************************************************************/
+/**
+* Mean path delay from a Sync and Delay_req exchange.
+*
+* @param	MasterTxNs is t1, the Sync origin timestamp.
+* @param	SlaveRxNs is t2, the Sync receive timestamp.
+* @param	SlaveTxNs is t3, the Delay_req transmit timestamp.
+* @param	MasterRxNs is t4, the Delay_req receive timestamp from the
+*		Delay_resp message.
+*
+* @return	Mean path delay in ns.
+*
+* @note		None.
+*
+******************************************************************************/
+s64 PtpServo_PathDelay(s64 MasterTxNs, s64 SlaveRxNs, s64 SlaveTxNs,
+		       s64 MasterRxNs)
+{
+	return ((SlaveRxNs - MasterTxNs) + (MasterRxNs - SlaveTxNs)) / 2;
+}
+
+/*****************************************************************************/
+/**
+* Limit a value to +/- Limit.
+*
+* @param	Value is the value to limit.
+* @param	Limit is the positive limit.
+*
+* @return	The limited value.
+*
+* @note		None.
+*
+******************************************************************************/
+static double PtpServo_Clamp(double Value, double Limit)
+{
+	if (Value > Limit) {
+		return Limit;
+	}
+	if (Value < -Limit) {
+		return -Limit;
+	}
+	return Value;
+}
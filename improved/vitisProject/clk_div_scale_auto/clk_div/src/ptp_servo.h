@@ -0,0 +1,72 @@
+/*****************************************************************************/
+/**
+* @file ptp_servo.h
+*
+* Proportional-integral clock servo for PTP. The servo takes one offset
+* sample per measurement interval and returns the frequency correction to
+* apply to the disciplined clock. It starts by estimating the frequency error
+* from the first two samples and asking for a phase step, then tracks with
+* the PI loop, and asks for a new step if the offset ever exceeds the step
+* threshold.
+*
+* The servo does no I/O and depends only on xil_types.h, so the same source
+* can be built on a host and driven with recorded offset traces.
+*
+* Sign conventions: an offset is slave time minus master time, and a
+* positive frequency correction makes the slave clock run faster.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PTP_SERVO_H		/* prevent circular inclusions */
+#define PTP_SERVO_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PTP_SERVO_NS_PER_SEC	1000000000LL
+
+/**************************** Type Definitions ******************************/
+
+typedef enum {
+	PTP_SERVO_UNLOCKED = 0,	/* Collecting the first samples */
+	PTP_SERVO_JUMP,		/* Caller must step the clock by -Offset */
+	PTP_SERVO_LOCKED	/* Caller must apply the frequency correction */
+} PtpServo_State;
+
+typedef struct {
+	double Kp;		/* Proportional gain */
+	double Ki;		/* Integral gain, per second */
+	double MaxFreqPpb;	/* Correction limit */
+	s64 StepThresholdNs;	/* Offsets above this are stepped */
+	double DriftPpb;	/* Integral term, the frequency error */
+	s64 LastOffsetNs;	/* Offset of the previous sample */
+	double LastFreqPpb;	/* Correction returned for the previous sample */
+	u32 SampleCount;	/* Samples since the last reset or step */
+	PtpServo_State State;
+} PtpServo;
+
+/************************** Function Prototypes *****************************/
+
+void PtpServo_Init(PtpServo *ServoPtr, double Kp, double Ki,
+		   double MaxFreqPpb, s64 StepThresholdNs);
+void PtpServo_Reset(PtpServo *ServoPtr);
+PtpServo_State PtpServo_Sample(PtpServo *ServoPtr, s64 OffsetNs,
+			       double IntervalS, double *FreqPpbPtr);
+
+s64 PtpServo_ToNs(u32 Seconds, u32 NanoSeconds);
+s64 PtpServo_Offset(s64 MasterTxNs, s64 SlaveRxNs, s64 PathDelayNs);
+s64 PtpServo_PathDelay(s64 MasterTxNs, s64 SlaveRxNs, s64 SlaveTxNs,
+		       s64 MasterRxNs);
+
+#endif /* end of protection macro */
@@ -0,0 +1,293 @@
+/*****************************************************************************/
+/**
+* @file sched.c
+*
+* Cooperative run-to-completion scheduler. See sched.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stddef.h>
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "timer_svc.h"
+#include "sched.h"
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	Sched_Task *Head;
+	Sched_Task *Tail;
+} Sched_Queue;
+
+/************************** Function Prototypes *****************************/
+
+static void Sched_TimerHandler(void *CallBackRef, XTime Deadline);
+static int Sched_IsReady(void *CallBackRef);
+
+/************************** Variable Definitions **************************/
+
+static Sched_Queue ReadyQueue[SCHED_PRIORITIES];
+static volatile u32 ReadyMask;		/* Bit n: queue n is not empty */
+
+/*****************************************************************************/
+/**
+* Initialize a task, with no events pending.
+*
+* @param	Task is the task, owned by the caller.
+* @param	Handler runs the task.
+* @param	CallBackRef is passed to the handler.
+* @param	Priority is 0 (highest) to SCHED_PRIORITIES - 1.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void Sched_TaskInit(Sched_Task *Task, Sched_Handler Handler,
+		    void *CallBackRef, u32 Priority)
+{
+	Task->Next = NULL;
+	Task->Handler = Handler;
+	Task->CallBackRef = CallBackRef;
+	Task->Priority = (Priority < SCHED_PRIORITIES) ? Priority :
+			 (SCHED_PRIORITIES - 1U);
+	Task->Events = 0U;
+	Task->Queued = 0U;
+	Task->Runs = 0U;
+}
+
+/*****************************************************************************/
+/**
+* Post events to a task and queue it if it is not queued yet. Events posted
+* to a task that is already queued are merged into its next run.
+*
+* @param	Task is the task.
+* @param	Events are the event bits, nonzero.
+*
+* @return	None.
+*
+* @note		May be called from a task or any interrupt handler.
+*
+******************************************************************************/
+void Sched_Post(Sched_Task *Task, u32 Events)
+{
+	Sched_Queue *Queue;
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_IRQ);
+
+	Task->Events |= Events;
+	if (Task->Queued == 0U) {
+		Task->Queued = 1U;
+		Task->Next = NULL;
+		Queue = &ReadyQueue[Task->Priority];
+		if (Queue->Tail != NULL) {
+			Queue->Tail->Next = Task;
+		} else {
+			Queue->Head = Task;
+		}
+		Queue->Tail = Task;
+		ReadyMask |= 1U << Task->Priority;
+	}
+
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+* Initialize a timer that posts events to a task.
+*
+* @param	Timer is the timer, owned by the caller.
+* @param	Task is the task to post to.
+* @param	Events are the event bits to post.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void Sched_TimerInit(Sched_Timer *Timer, Sched_Task *Task, u32 Events)
+{
+	TimerSvc_InitTimer(&Timer->Timer, Sched_TimerHandler, Timer);
+	Timer->Task = Task;
+	Timer->Events = Events;
+}
+
+/*****************************************************************************/
+/**
+* Start a timer, or restart it if it is running.
+*
+* @param	Timer is the timer.
+* @param	DelayUs is the time to the first post.
+* @param	PeriodUs is the time between posts after that, 0 to post once.
+*
+* @return	None.
+*
+* @note		May be called from a task or any interrupt handler.
+*
+******************************************************************************/
+void Sched_TimerStart(Sched_Timer *Timer, u32 DelayUs, u32 PeriodUs)
+{
+	XTime Now;
+
+	XTime_GetTime(&Now);
+	TimerSvc_Start(&Timer->Timer, Now + TIMER_SVC_US(DelayUs),
+		       TIMER_SVC_US(PeriodUs));
+}
+
+/*****************************************************************************/
+/**
+* Stop a timer. Events it posted already stay pending.
+*
+* @param	Timer is the timer.
+*
+* @return	None.
+*
+* @note		May be called from a task or any interrupt handler.
+*
+******************************************************************************/
+void Sched_TimerStop(Sched_Timer *Timer)
+{
+	TimerSvc_Stop(&Timer->Timer);
+}
+
+/*****************************************************************************/
+/**
+* Run the first task of the highest priority ready queue, once.
+*
+* @return	1 if a task ran, 0 if none was ready.
+*
+* @note		Task context only.
+*
+******************************************************************************/
+int Sched_RunOnce(void)
+{
+	Sched_Queue *Queue;
+	Sched_Task *Task;
+	u32 Priority;
+	u32 Events;
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_IRQ);
+
+	if (ReadyMask == 0U) {
+		mtcpsr(Cpsr);
+		return 0;
+	}
+
+	for (Priority = 0U; (ReadyMask & (1U << Priority)) == 0U; Priority++) {
+		;
+	}
+	Queue = &ReadyQueue[Priority];
+	Task = Queue->Head;
+	Queue->Head = Task->Next;
+	if (Queue->Head == NULL) {
+		Queue->Tail = NULL;
+		ReadyMask &= ~(1U << Priority);
+	}
+	Task->Next = NULL;
+	Task->Queued = 0U;
+	Events = Task->Events;
+	Task->Events = 0U;
+
+	mtcpsr(Cpsr);
+
+	Task->Runs++;
+	Task->Handler(Task->CallBackRef, Events);
+
+	return 1;
+}
+
+/*****************************************************************************/
+/**
+* Run tasks until a deadline, sleeping in WFI whenever none is ready.
+*
+* @param	Deadline is the global timer value to return at; tasks ready
+*		then are left queued.
+*
+* @return	None.
+*
+* @note		Task context only.
+*
+******************************************************************************/
+void Sched_RunUntil(XTime Deadline)
+{
+	XTime Now;
+
+	while (1) {
+		XTime_GetTime(&Now);
+		if (Now >= Deadline) {
+			return;
+		}
+		if (Sched_RunOnce() == 0) {
+			(void)TimerSvc_WaitUntil(Deadline, Sched_IsReady, NULL);
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+* Run tasks for ever.
+*
+* @return	Does not return.
+*
+* @note		Called from main() once the tasks and interrupts are set up.
+*
+******************************************************************************/
+void Sched_Run(void)
+{
+	while (1) {
+		Sched_RunUntil(~(XTime)0U);
+	}
+}
+
+/*****************************************************************************/
+/**
+* Timer service handler of a Sched_Timer: post its events.
+*
+* @param	CallBackRef is the Sched_Timer.
+* @param	Deadline is unused.
+*
+* @return	None.
+*
+* @note		IRQ context.
+*
+******************************************************************************/
+static void Sched_TimerHandler(void *CallBackRef, XTime Deadline)
+{
+	Sched_Timer *Timer = (Sched_Timer *)CallBackRef;
+
+	(void)Deadline;
+
+	Sched_Post(Timer->Task, Timer->Events);
+}
+
+/*****************************************************************************/
+/**
+* Wake condition of the idle sleep.
+*
+* @param	CallBackRef is unused.
+*
+* @return	Nonzero if a task is ready.
+*
+* @note		None.
+*
+******************************************************************************/
+static int Sched_IsReady(void *CallBackRef)
+{
+	(void)CallBackRef;
+
+	return (ReadyMask != 0U) ? 1 : 0;
+}
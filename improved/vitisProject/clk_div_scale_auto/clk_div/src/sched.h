@@ -0,0 +1,73 @@
+/*****************************************************************************/
+/**
+* @file sched.h
+*
+* Cooperative run-to-completion scheduler of the application. A task is a
+* handler with a set of pending event bits. Sched_Post() ORs bits into a
+* task and queues it, from a task or from an interrupt handler; the
+* scheduler calls the handler once with all the bits posted since it last
+* ran. Ready tasks run highest priority first, in posting order within a
+* priority, and each runs to completion: a task that must wait posts itself
+* an event or starts a timer and returns.
+*
+* Sched_Timer posts events after a delay or periodically, on the timer
+* service (timer_svc.c). When no task is ready the CPU sleeps in WFI.
+*
+* tools/sched_test.c builds this file on a host against a simulated clock.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef SCHED_H			/* prevent circular inclusions */
+#define SCHED_H			/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "timer_svc.h"
+
+/************************** Constant Definitions ****************************/
+
+#define SCHED_PRIORITIES	4U	/* 0 is the highest */
+
+/**************************** Type Definitions ******************************/
+
+/* Called in task context with the events posted since the last call */
+typedef void (*Sched_Handler)(void *CallBackRef, u32 Events);
+
+typedef struct Sched_Task {
+	struct Sched_Task *Next;	/* In its ready queue */
+	Sched_Handler Handler;
+	void *CallBackRef;
+	u32 Priority;
+	volatile u32 Events;		/* Pending */
+	volatile u32 Queued;
+	u32 Runs;			/* Handler calls */
+} Sched_Task;
+
+typedef struct {
+	TimerSvc_Timer Timer;
+	Sched_Task *Task;
+	u32 Events;
+} Sched_Timer;
+
+/************************** Function Prototypes *****************************/
+
+void Sched_TaskInit(Sched_Task *Task, Sched_Handler Handler,
+		    void *CallBackRef, u32 Priority);
+void Sched_Post(Sched_Task *Task, u32 Events);
+void Sched_TimerInit(Sched_Timer *Timer, Sched_Task *Task, u32 Events);
+void Sched_TimerStart(Sched_Timer *Timer, u32 DelayUs, u32 PeriodUs);
+void Sched_TimerStop(Sched_Timer *Timer);
+int Sched_RunOnce(void);
+void Sched_RunUntil(XTime Deadline);
+void Sched_Run(void);
+
+#endif /* end of protection macro */
@@ -0,0 +1,420 @@
+/*****************************************************************************/
+/**
+* @file temp_comp.c
+*
+* Temperature compensation of the clk_div_top divisor. See temp_comp.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 Added TempComp_SetNumWin() for engine swaps.
+* 1.02a xl   10/19/26 Run the model on CPU1 when amp.c has started it.
+* 1.03a xl   10/19/26 The pps path and the tracker run from OCM.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+#include "xadcps.h"
+#include "xgpio.h"
+#include "xtime_l.h"
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "clk_div_pl.h"
+#include "pps_intr.h"
+#include "temp_model.h"
+#include "amp.h"
+#include "ocm.h"
+#include "temp_comp.h"
+
+#if defined(CLK_DIV_TRIM_GPIO_DEVICE_ID) && defined(CLK_DIV_PPS_INTR_ID)
+
+/************************** Constant Definitions ****************************/
+
+#define TEMP_COMP_XADC_DEVICE_ID	XPAR_XADCPS_0_DEVICE_ID
+
+/************************** Function Prototypes *****************************/
+
+static void TempComp_PpsHandler(void *CallBackRef,
+				XTime Timestamp) OCM_TEXT;
+static s32 TempComp_Fit(u32 Pps, s32 TempMilliC, u32 WinCount,
+			u32 Scale) OCM_TEXT;
+static void TempComp_Apply(s32 TempMilliC, u32 WinCount, s32 Trim,
+			   u32 Samples, u32 Rejected) OCM_TEXT;
+static void TempComp_Cpu1Sample(void *CallBackRef, const MsgQueue_Msg *Msg);
+static void TempComp_Cpu1NumWin(void *CallBackRef, const MsgQueue_Msg *Msg);
+static void TempComp_TrimHandler(void *CallBackRef, const MsgQueue_Msg *Msg);
+
+/************************** Variable Definitions **************************/
+
+static XAdcPs XAdcInstance;
+static XGpio TrimGpio;
+
+static TempTracker Tracker OCM_BSS;
+static volatile u32 CurrentScale;
+
+/* Trims CPU1 fitted for an older model are dropped */
+static volatile u32 ModelGeneration;
+
+static volatile TempComp_Status CompStatus;
+
+/*****************************************************************************/
+/**
+* Initialize the XADC and the trim registers and register the pps handler.
+* The pps interrupt itself is enabled by the caller with PpsIntr_Init().
+* Call before Amp_Start(), so the model can move to CPU1.
+*
+* @return
+*		- XST_SUCCESS if compensation is running
+*		- XST_NO_FEATURE if the PL has no divisor trim
+*		- XST_FAILURE otherwise
+*
+* @note		The XADC is left sampling the temperature continuously with
+*		16 sample averaging, so a read from the pps handler never
+*		waits for a conversion.
+*
+******************************************************************************/
+int TempComp_Init(void)
+{
+	XAdcPs_Config *ConfigPtr;
+	int Status;
+
+	ConfigPtr = XAdcPs_LookupConfig(TEMP_COMP_XADC_DEVICE_ID);
+	if (ConfigPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XAdcPs_CfgInitialize(&XAdcInstance, ConfigPtr,
+				      ConfigPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = XAdcPs_SelfTest(&XAdcInstance);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/* The sequencer must be in safe mode while it is configured */
+	XAdcPs_SetSequencerMode(&XAdcInstance, XADCPS_SEQ_MODE_SAFE);
+	XAdcPs_SetAvg(&XAdcInstance, XADCPS_AVG_16_SAMPLES);
+
+	Status = XAdcPs_SetSeqAvgEnables(&XAdcInstance, XADCPS_SEQ_CH_TEMP);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = XAdcPs_SetSeqChEnables(&XAdcInstance, XADCPS_SEQ_CH_TEMP |
+					XADCPS_SEQ_CH_CALIB);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	XAdcPs_SetSequencerMode(&XAdcInstance, XADCPS_SEQ_MODE_CONTINPASS);
+
+	Status = XGpio_Initialize(&TrimGpio, CLK_DIV_TRIM_GPIO_DEVICE_ID);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XGpio_SetDataDirection(&TrimGpio, CLK_DIV_WIN_COUNT_CHANNEL,
+			       0xFFFFFFFF);
+	XGpio_SetDataDirection(&TrimGpio, CLK_DIV_TRIM_CHANNEL, 0x0);
+	XGpio_DiscreteWrite(&TrimGpio, CLK_DIV_TRIM_CHANNEL, 0U);
+
+	TempTracker_Init(&Tracker, CLK_DIV_NUM_WIN, TEMP_COMP_REF_TEMP_C,
+			 TEMP_COMP_LAMBDA, TEMP_COMP_INIT_COV,
+			 TEMP_COMP_MAX_TRIM_PPM);
+
+	(void)Amp_SetHandler(AMP_MSG_TEMP_SAMPLE, TempComp_Cpu1Sample, NULL);
+	(void)Amp_SetHandler(AMP_MSG_TEMP_NUMWIN, TempComp_Cpu1NumWin, NULL);
+	(void)Amp_SetHandler(AMP_MSG_TEMP_TRIM, TempComp_TrimHandler, NULL);
+
+	return PpsIntr_AddHandler(TempComp_PpsHandler, NULL);
+}
+
+/*****************************************************************************/
+/**
+* Tell the compensation the SCALE written to clk_div_top. Must be called
+* whenever SCALE is written; the windows of the old SCALE are dropped at the
+* next pps.
+*
+* @param	Scale is the value written to SCALE.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void TempComp_SetScale(u32 Scale)
+{
+	CurrentScale = Scale;
+}
+
+/*****************************************************************************/
+/**
+* Restart the model for a divisor engine with another NUM_WIN, after a
+* partial reconfiguration of clk_div_top. The fit of the old engine does
+* not apply to the new one.
+*
+* @param	NumWin is the NUM_WIN generic of the engine now in the PL.
+*
+* @return	None.
+*
+* @note		Call with the pps interrupt masked.
+*
+******************************************************************************/
+void TempComp_SetNumWin(u32 NumWin)
+{
+	MsgQueue_Msg Msg = { AMP_MSG_TEMP_NUMWIN, { 0U } };
+
+	if (Amp_IsRunning()) {
+		/* Behind the samples of the old engine still queued */
+		ModelGeneration++;
+		Msg.Arg[0] = NumWin;
+		(void)Amp_Send(&Msg);
+	} else {
+		TempTracker_Init(&Tracker, NumWin, TEMP_COMP_REF_TEMP_C,
+				 TEMP_COMP_LAMBDA, TEMP_COMP_INIT_COV,
+				 TEMP_COMP_MAX_TRIM_PPM);
+	}
+	XGpio_DiscreteWrite(&TrimGpio, CLK_DIV_TRIM_CHANNEL, 0U);
+}
+
+/*****************************************************************************/
+/**
+* Return the state of the compensation.
+*
+* @param	StatusPtr returns the status.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void TempComp_GetStatus(TempComp_Status *StatusPtr)
+{
+	*StatusPtr = CompStatus;
+}
+
+/*****************************************************************************/
+/**
+* pps handler: fit the window that just ended and write the trim used by
+* clk_div_top at the next pps, or send the window to the model on CPU1.
+*
+* @param	CallBackRef is unused.
+* @param	Timestamp is unused.
+*
+* @return	None.
+*
+* @note		clk_div_top latches WIN_COUNT a few sys_clk cycles after the
+*		pps edge, well before the interrupt reaches this handler.
+*
+******************************************************************************/
+static void TempComp_PpsHandler(void *CallBackRef, XTime Timestamp)
+{
+	MsgQueue_Msg Msg = { AMP_MSG_TEMP_SAMPLE, { 0U } };
+	u32 Scale = CurrentScale;
+	u32 WinCount;
+	s32 TempMilliC;
+	s32 Trim;
+
+	(void)CallBackRef;
+	(void)Timestamp;
+
+	/*
+	 * The temperature goes through the model in whole mC, the resolution
+	 * of the log, so a host replay of the log is exact.
+	 */
+	TempMilliC = (s32)(XAdcPs_RawToTemperature(XAdcPs_GetAdcData(
+			&XAdcInstance, XADCPS_CH_TEMP)) * 1000.0f);
+	WinCount = XGpio_DiscreteRead(&TrimGpio, CLK_DIV_WIN_COUNT_CHANNEL);
+
+	if (Amp_IsRunning()) {
+		/* A full queue loses the window; the trim stays as it is */
+		Msg.Arg[0] = PpsIntr_GetCount();
+		Msg.Arg[1] = (u32)TempMilliC;
+		Msg.Arg[2] = WinCount;
+		Msg.Arg[3] = Scale;
+		Msg.Arg[4] = ModelGeneration;
+		(void)Amp_Send(&Msg);
+		return;
+	}
+
+	Trim = TempComp_Fit(PpsIntr_GetCount(), TempMilliC, WinCount, Scale);
+	TempComp_Apply(TempMilliC, WinCount, Trim, Tracker.Model.Samples,
+		       Tracker.Rejected);
+}
+
+/*****************************************************************************/
+/**
+* Run a window through the model.
+*
+* @param	Pps is the pps count of the window, for the log.
+* @param	TempMilliC is the temperature at the end of the window.
+* @param	WinCount is the window count.
+* @param	Scale is the SCALE the window was counted with.
+*
+* @return	The trim to write to DIV_TRIM.
+*
+* @note		On the core that owns the model: CPU1 once it runs, CPU0
+*		before that.
+*
+******************************************************************************/
+static s32 TempComp_Fit(u32 Pps, s32 TempMilliC, u32 WinCount, u32 Scale)
+{
+	s32 Trim;
+
+	if (Scale == 0U) {
+		/* SCALE not known yet; clk_div_top does not run either */
+		Trim = 0;
+	} else {
+		Trim = TempTracker_Sample(&Tracker, (double)TempMilliC / 1000.0,
+					  WinCount, Scale);
+	}
+
+#ifdef TEMP_COMP_LOG
+	/* About 3 ms at 115200 baud, once a second */
+	Amp_PrintLock();
+	xil_printf("tc,%u,%d,%u,%u,%d\r\n", Pps, TempMilliC, WinCount, Scale,
+		   Trim);
+	Amp_PrintUnlock();
+#else
+	(void)Pps;
+#endif
+
+	return Trim;
+}
+
+/*****************************************************************************/
+/**
+* Write a trim to DIV_TRIM and update the status.
+*
+* @param	TempMilliC is the temperature of the window fitted.
+* @param	WinCount is the window count of the window fitted.
+* @param	Trim is the trim.
+* @param	Samples is the number of windows in the model.
+* @param	Rejected is the number of windows rejected.
+*
+* @return	None.
+*
+* @note		CPU0, in IRQ context.
+*
+******************************************************************************/
+static void TempComp_Apply(s32 TempMilliC, u32 WinCount, s32 Trim,
+			   u32 Samples, u32 Rejected)
+{
+	XGpio_DiscreteWrite(&TrimGpio, CLK_DIV_TRIM_CHANNEL, (u32)Trim);
+
+	CompStatus.TempMilliC = TempMilliC;
+	CompStatus.WinCount = WinCount;
+	CompStatus.Trim = Trim;
+	CompStatus.Samples = Samples;
+	CompStatus.Rejected = Rejected;
+}
+
+/*****************************************************************************/
+/**
+* AMP_MSG_TEMP_SAMPLE handler: fit a window sent by the pps handler and send
+* the trim back.
+*
+* @param	CallBackRef is unused.
+* @param	Msg is pps, mC, WIN_COUNT, SCALE and model generation.
+*
+* @return	None.
+*
+* @note		CPU1.
+*
+******************************************************************************/
+static void TempComp_Cpu1Sample(void *CallBackRef, const MsgQueue_Msg *Msg)
+{
+	MsgQueue_Msg Reply = { AMP_MSG_TEMP_TRIM, { 0U } };
+	s32 Trim;
+
+	(void)CallBackRef;
+
+	Trim = TempComp_Fit(Msg->Arg[0], (s32)Msg->Arg[1], Msg->Arg[2],
+			    Msg->Arg[3]);
+
+	Reply.Arg[0] = (u32)Trim;
+	Reply.Arg[1] = Msg->Arg[1];
+	Reply.Arg[2] = Msg->Arg[2];
+	Reply.Arg[3] = Tracker.Model.Samples;
+	Reply.Arg[4] = Tracker.Rejected;
+	Reply.Arg[5] = Msg->Arg[4];
+	(void)Amp_Send(&Reply);
+}
+
+/*****************************************************************************/
+/**
+* AMP_MSG_TEMP_NUMWIN handler: restart the model for another engine.
+*
+* @param	CallBackRef is unused.
+* @param	Msg is the NUM_WIN of the new engine.
+*
+* @return	None.
+*
+* @note		CPU1.
+*
+******************************************************************************/
+static void TempComp_Cpu1NumWin(void *CallBackRef, const MsgQueue_Msg *Msg)
+{
+	(void)CallBackRef;
+
+	TempTracker_Init(&Tracker, Msg->Arg[0], TEMP_COMP_REF_TEMP_C,
+			 TEMP_COMP_LAMBDA, TEMP_COMP_INIT_COV,
+			 TEMP_COMP_MAX_TRIM_PPM);
+}
+
+/*****************************************************************************/
+/**
+* AMP_MSG_TEMP_TRIM handler: write the trim CPU1 fitted, unless the engine
+* was swapped since.
+*
+* @param	CallBackRef is unused.
+* @param	Msg is trim, mC, WIN_COUNT, samples, rejected and generation.
+*
+* @return	None.
+*
+* @note		CPU0, in IRQ context.
+*
+******************************************************************************/
+static void TempComp_TrimHandler(void *CallBackRef, const MsgQueue_Msg *Msg)
+{
+	(void)CallBackRef;
+
+	if (Msg->Arg[5] != ModelGeneration) {
+		return;
+	}
+
+	TempComp_Apply((s32)Msg->Arg[1], Msg->Arg[2], (s32)Msg->Arg[0],
+		       Msg->Arg[3], Msg->Arg[4]);
+}
+
+#else /* no divisor trim in the PL */
+
+int TempComp_Init(void)
+{
+	return XST_NO_FEATURE;
+}
+
+void TempComp_SetScale(u32 Scale)
+{
+	(void)Scale;
+}
+
+void TempComp_SetNumWin(u32 NumWin)
+{
+	(void)NumWin;
+}
+
+void TempComp_GetStatus(TempComp_Status *StatusPtr)
+{
+	(void)StatusPtr;
+}
+
+#endif
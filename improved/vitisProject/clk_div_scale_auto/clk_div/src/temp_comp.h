@@ -0,0 +1,64 @@
+/*****************************************************************************/
+/**
+* @file temp_comp.h
+*
+* Temperature compensation of the clk_div_top divisor. On every pps the
+* on-die temperature is read from the XADC and the window count of the
+* second that just ended from the PL; both feed the temperature model
+* (temp_model.c), and the predicted divisor correction is written to the
+* DIV_TRIM input of clk_div_top for the next pps.
+*
+* When CPU1 runs (amp.h), the pps handler on CPU0 only reads the XADC and
+* WIN_COUNT and sends them to CPU1. The model runs there and sends the trim
+* back, and CPU0 writes it to DIV_TRIM, a few ms after the pps instead of
+* in the pps handler.
+*
+* Build with TEMP_COMP_LOG defined to print one line per pps,
+*   tc,<pps>,<temperature mC>,<WIN_COUNT>,<SCALE>,<trim>
+* which tools/temp_replay.c replays through the same model on a host.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* 1.01a xl   10/19/26 Added TempComp_SetNumWin() for engine swaps.
+* 1.02a xl   10/19/26 Run the model on CPU1 when amp.c has started it.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef TEMP_COMP_H		/* prevent circular inclusions */
+#define TEMP_COMP_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Model tuning */
+#define TEMP_COMP_REF_TEMP_C	45.0	/* Centre of the temperature axis */
+#define TEMP_COMP_LAMBDA	0.999	/* About 17 minutes of memory */
+#define TEMP_COMP_INIT_COV	1.0e6
+#define TEMP_COMP_MAX_TRIM_PPM	100.0	/* Trim limit relative to the divisor */
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	s32 TempMilliC;		/* Temperature at the last pps */
+	u32 WinCount;		/* Window count of the last pps */
+	s32 Trim;		/* Last DIV_TRIM written */
+	u32 Samples;		/* Windows fitted by the model */
+	u32 Rejected;		/* Windows rejected as outliers */
+} TempComp_Status;
+
+/************************** Function Prototypes *****************************/
+
+int TempComp_Init(void);
+void TempComp_SetScale(u32 Scale);
+void TempComp_SetNumWin(u32 NumWin);
+void TempComp_GetStatus(TempComp_Status *StatusPtr);
+
+#endif /* end of protection macro */
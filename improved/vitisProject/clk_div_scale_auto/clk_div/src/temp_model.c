@@ -0,0 +1,366 @@
+/*****************************************************************************/
+/**
+* @file temp_model.c
+*
+* Online temperature to frequency model of sys_clk. See temp_model.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "temp_model.h"
+
+/************************** Constant Definitions ****************************/
+
+#define TEMP_MODEL_X_SCALE	10.0	/* Degrees per unit of x */
+#define TEMP_MODEL_SLOPE_SHIFT	3U	/* Slope smoothing, 1/8 per sample */
+
+/*
+ * A trim written at a pps is applied by clk_div_top at the next pps, to the
+ * second after that; the middle of that second is 1.5 s ahead.
+ */
+#define TEMP_MODEL_LEAD_S	1.5
+
+/***************** Macros (Inline Functions) Definitions *******************/
+
+#define TEMP_MODEL_ABS(x)	(((x) < 0) ? -(x) : (x))
+
+/************************** Function Prototypes ****************************/
+
+static void TempModel_Regressor(const TempModel *ModelPtr, double TempC,
+				double *Phi);
+
+/*****************************************************************************/
+/**
+* Initialize a model.
+*
+* @param	ModelPtr is the model to initialize.
+* @param	RefTempC is the centre of the temperature axis, the expected
+*		operating temperature.
+* @param	Lambda is the forgetting factor; 0.999 forgets with a time
+*		constant of about 1000 samples.
+* @param	InitCov is the initial covariance. Larger values let the first
+*		samples move the fit more.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void TempModel_Init(TempModel *ModelPtr, double RefTempC, double Lambda,
+		    double InitCov)
+{
+	u32 Row;
+	u32 Col;
+
+	for (Row = 0U; Row < TEMP_MODEL_TERMS; Row++) {
+		ModelPtr->Theta[Row] = 0.0;
+		for (Col = 0U; Col < TEMP_MODEL_TERMS; Col++) {
+			ModelPtr->P[Row][Col] = (Row == Col) ? InitCov : 0.0;
+		}
+	}
+
+	ModelPtr->Lambda = Lambda;
+	ModelPtr->InitCov = InitCov;
+	ModelPtr->RefTempC = RefTempC;
+	ModelPtr->F0 = 0.0;
+	ModelPtr->Samples = 0U;
+}
+
+/*****************************************************************************/
+/**
+* Add one sample to the fit.
+*
+* @param	ModelPtr is the model.
+* @param	TempC is the temperature of the window.
+* @param	Value is the frequency measured over the window.
+*
+* @return	None.
+*
+* @note		Forgetting is suspended while the covariance is above its
+*		initial value, which stops it from growing without bound when
+*		the temperature does not move.
+*
+******************************************************************************/
+void TempModel_Update(TempModel *ModelPtr, double TempC, double Value)
+{
+	double Phi[TEMP_MODEL_TERMS];
+	double PPhi[TEMP_MODEL_TERMS];
+	double Gain[TEMP_MODEL_TERMS];
+	double Denom;
+	double Error;
+	double Trace = 0.0;
+	double Lambda;
+	u32 Row;
+	u32 Col;
+
+	if (ModelPtr->Samples == 0U) {
+		ModelPtr->F0 = Value;
+	}
+
+	TempModel_Regressor(ModelPtr, TempC, Phi);
+
+	Lambda = ModelPtr->Lambda;
+	for (Row = 0U; Row < TEMP_MODEL_TERMS; Row++) {
+		Trace += ModelPtr->P[Row][Row];
+	}
+	if (Trace > ((double)TEMP_MODEL_TERMS * ModelPtr->InitCov)) {
+		Lambda = 1.0;
+	}
+
+	Denom = Lambda;
+	Error = (Value - ModelPtr->F0);
+	for (Row = 0U; Row < TEMP_MODEL_TERMS; Row++) {
+		PPhi[Row] = 0.0;
+		for (Col = 0U; Col < TEMP_MODEL_TERMS; Col++) {
+			PPhi[Row] += ModelPtr->P[Row][Col] * Phi[Col];
+		}
+		Denom += Phi[Row] * PPhi[Row];
+		Error -= Phi[Row] * ModelPtr->Theta[Row];
+	}
+
+	for (Row = 0U; Row < TEMP_MODEL_TERMS; Row++) {
+		Gain[Row] = PPhi[Row] / Denom;
+		ModelPtr->Theta[Row] += Gain[Row] * Error;
+	}
+
+	/* P = (P - K * (P * phi)') / lambda, kept symmetric */
+	for (Row = 0U; Row < TEMP_MODEL_TERMS; Row++) {
+		for (Col = Row; Col < TEMP_MODEL_TERMS; Col++) {
+			ModelPtr->P[Row][Col] = (ModelPtr->P[Row][Col] -
+					(Gain[Row] * PPhi[Col])) / Lambda;
+			ModelPtr->P[Col][Row] = ModelPtr->P[Row][Col];
+		}
+	}
+
+	ModelPtr->Samples++;
+}
+
+/*****************************************************************************/
+/**
+* Predict the frequency at a temperature.
+*
+* @param	ModelPtr is the model.
+* @param	TempC is the temperature.
+*
+* @return	Predicted frequency, in the units of the samples.
+*
+* @note		None.
+*
+******************************************************************************/
+double TempModel_Predict(const TempModel *ModelPtr, double TempC)
+{
+	double Phi[TEMP_MODEL_TERMS];
+	double Value = ModelPtr->F0;
+	u32 Row;
+
+	TempModel_Regressor(ModelPtr, TempC, Phi);
+	for (Row = 0U; Row < TEMP_MODEL_TERMS; Row++) {
+		Value += Phi[Row] * ModelPtr->Theta[Row];
+	}
+
+	return Value;
+}
+
+/*****************************************************************************/
+/**
+* Return whether the model has seen enough samples to be used.
+*
+* @param	ModelPtr is the model.
+*
+* @return	1 if predictions can be used, 0 otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 TempModel_IsValid(const TempModel *ModelPtr)
+{
+	return (ModelPtr->Samples >= TEMP_MODEL_MIN_SAMPLES) ? 1U : 0U;
+}
+
+/*****************************************************************************/
+/**
+* Frequency error of a moving average over past windows. clk_div_top
+* divides by the average of its last windows, which lags the oscillator
+* when the temperature moves; the error is the predicted frequency now minus
+* the average of the predictions for the temperatures of those windows.
+* Using the model on both sides cancels any constant bias of the fit.
+*
+* @param	ModelPtr is the model.
+* @param	TempNowC is the temperature the correction is for.
+* @param	WindowTempC are the temperatures of the averaged windows.
+* @param	WindowCount is the number of averaged windows.
+*
+* @return	Frequency to add to the averaged measurement.
+*
+* @note		None.
+*
+******************************************************************************/
+double TempModel_LagCorrection(const TempModel *ModelPtr, double TempNowC,
+			       const double *WindowTempC, u32 WindowCount)
+{
+	double Average = 0.0;
+	u32 Index;
+
+	if (WindowCount == 0U) {
+		return 0.0;
+	}
+
+	for (Index = 0U; Index < WindowCount; Index++) {
+		Average += TempModel_Predict(ModelPtr, WindowTempC[Index]);
+	}
+	Average /= (double)WindowCount;
+
+	return TempModel_Predict(ModelPtr, TempNowC) - Average;
+}
+
+/*****************************************************************************/
+/**
+* Initialize a tracker.
+*
+* @param	TrackerPtr is the tracker to initialize.
+* @param	NumWin is the NUM_WIN generic of clk_div_top, at most
+*		TEMP_MODEL_MAX_WIN.
+* @param	RefTempC, Lambda and InitCov are passed to TempModel_Init().
+* @param	MaxTrimPpm limits the trim relative to the divisor.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void TempTracker_Init(TempTracker *TrackerPtr, u32 NumWin, double RefTempC,
+		      double Lambda, double InitCov, double MaxTrimPpm)
+{
+	TempModel_Init(&TrackerPtr->Model, RefTempC, Lambda, InitCov);
+
+	TrackerPtr->NumWin = (NumWin > TEMP_MODEL_MAX_WIN) ?
+			TEMP_MODEL_MAX_WIN : NumWin;
+	TrackerPtr->WinIndex = 0U;
+	TrackerPtr->WinFill = 0U;
+	TrackerPtr->Scale = 0U;
+	TrackerPtr->LastTempC = RefTempC;
+	TrackerPtr->SlopeCPerS = 0.0;
+	TrackerPtr->MaxTrimPpm = MaxTrimPpm;
+	TrackerPtr->Rejected = 0U;
+}
+
+/*****************************************************************************/
+/**
+* Process the window that ended at a pps and return the divisor trim for
+* the next pps.
+*
+* @param	TrackerPtr is the tracker.
+* @param	TempC is the temperature at the pps.
+* @param	WinCount is WIN_COUNT, SCALE periods of sys_clk in the window.
+* @param	Scale is the SCALE input of clk_div_top during the window.
+*
+* @return	Signed trim to add to the averaged divisor, 0 until the model
+*		is valid and clk_div_top averages only windows seen here.
+*
+* @note		clk_div_top clears its windows when SCALE changes, so a
+*		change of Scale drops the window history (the model is in Hz
+*		and is kept) and the partial window is not fitted. The first
+*		sample is handled the same way since the tracker may start in
+*		the middle of a window.
+*
+******************************************************************************/
+s32 TempTracker_Sample(TempTracker *TrackerPtr, double TempC, u32 WinCount,
+		       u32 Scale)
+{
+	double TempMidC;
+	double FreqHz;
+	double ErrorHz;
+	double LimitHz;
+	double CorrHz;
+	double Trim;
+	double MaxTrim;
+
+	if ((Scale != TrackerPtr->Scale) || (WinCount == 0U)) {
+		TrackerPtr->Scale = Scale;
+		TrackerPtr->WinIndex = 0U;
+		TrackerPtr->WinFill = 0U;
+		TrackerPtr->LastTempC = TempC;
+		return 0;
+	}
+
+	/* The window spans the last second; use its mean temperature */
+	TempMidC = (TempC + TrackerPtr->LastTempC) / 2.0;
+	TrackerPtr->SlopeCPerS += ((TempC - TrackerPtr->LastTempC) -
+			TrackerPtr->SlopeCPerS) /
+			(double)(1U << TEMP_MODEL_SLOPE_SHIFT);
+	TrackerPtr->LastTempC = TempC;
+
+	FreqHz = (double)WinCount * (double)Scale;
+	ErrorHz = FreqHz - TempModel_Predict(&TrackerPtr->Model, TempMidC);
+	LimitHz = (FreqHz * TEMP_MODEL_OUTLIER_PPM) / 1000000.0;
+	if (LimitHz < (2.0 * (double)Scale)) {
+		/* Never reject on the quantization of WIN_COUNT */
+		LimitHz = 2.0 * (double)Scale;
+	}
+	if ((TempModel_IsValid(&TrackerPtr->Model) != 0U) &&
+	    (TEMP_MODEL_ABS(ErrorHz) > LimitHz)) {
+		TrackerPtr->Rejected++;
+	} else {
+		TempModel_Update(&TrackerPtr->Model, TempMidC, FreqHz);
+	}
+
+	TrackerPtr->WindowTempC[TrackerPtr->WinIndex] = TempMidC;
+	TrackerPtr->WinIndex++;
+	if (TrackerPtr->WinIndex >= TrackerPtr->NumWin) {
+		TrackerPtr->WinIndex = 0U;
+	}
+	if (TrackerPtr->WinFill < TrackerPtr->NumWin) {
+		TrackerPtr->WinFill++;
+	}
+
+	if ((TrackerPtr->WinFill < TrackerPtr->NumWin) ||
+	    (TempModel_IsValid(&TrackerPtr->Model) == 0U)) {
+		return 0;
+	}
+
+	CorrHz = TempModel_LagCorrection(&TrackerPtr->Model,
+			TempC + (TEMP_MODEL_LEAD_S * TrackerPtr->SlopeCPerS),
+			TrackerPtr->WindowTempC, TrackerPtr->NumWin);
+
+	Trim = CorrHz / (double)Scale;
+	MaxTrim = ((double)WinCount * TrackerPtr->MaxTrimPpm) / 1000000.0;
+	if (Trim > MaxTrim) {
+		Trim = MaxTrim;
+	} else if (Trim < -MaxTrim) {
+		Trim = -MaxTrim;
+	}
+
+	return (Trim < 0.0) ? (s32)(Trim - 0.5) : (s32)(Trim + 0.5);
+}
+
+/*****************************************************************************/
+/**
+* Build the regressor vector for a temperature.
+*
+* @param	ModelPtr is the model.
+* @param	TempC is the temperature.
+* @param	Phi returns the regressor, TEMP_MODEL_TERMS entries.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void TempModel_Regressor(const TempModel *ModelPtr, double TempC,
+				double *Phi)
+{
+	double X = (TempC - ModelPtr->RefTempC) / TEMP_MODEL_X_SCALE;
+
+	Phi[0] = 1.0;
+	Phi[1] = X;
+	Phi[2] = X * X;
+}
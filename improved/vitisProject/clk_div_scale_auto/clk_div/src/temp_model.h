@@ -0,0 +1,84 @@
+/*****************************************************************************/
+/**
+* @file temp_model.h
+*
+* Online temperature to frequency model of sys_clk. The frequency measured
+* over each pps window is fitted against temperature with a quadratic,
+* f(T) = F0 + a*x + b*x^2 with x = (T - RefTempC) / 10, by recursive least
+* squares with exponential forgetting, so the fit follows ageing of the
+* oscillator.
+*
+* TempTracker runs the model once per pps: it feeds the measured window to
+* the fit and turns the model into a divisor trim for clk_div_top, which
+* otherwise divides by a moving average of past windows and so lags the
+* oscillator whenever the temperature moves.
+*
+* Both do no I/O and depend only on xil_types.h, so a host build can replay
+* logged (temperature, window count, SCALE) samples through exactly the same
+* code as the target; see tools/temp_replay.c.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef TEMP_MODEL_H		/* prevent circular inclusions */
+#define TEMP_MODEL_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define TEMP_MODEL_TERMS	3U	/* Constant, linear and square terms */
+#define TEMP_MODEL_MIN_SAMPLES	16U	/* Samples before predictions are used */
+#define TEMP_MODEL_MAX_WIN	16U	/* Largest NUM_WIN of clk_div_top */
+#define TEMP_MODEL_OUTLIER_PPM	200.0	/* Windows further off are not fitted */
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	double Theta[TEMP_MODEL_TERMS];	/* Fitted deviation from F0 */
+	double P[TEMP_MODEL_TERMS][TEMP_MODEL_TERMS]; /* Covariance */
+	double Lambda;		/* Forgetting factor, just below 1 */
+	double InitCov;		/* Initial covariance, bounds wind-up */
+	double RefTempC;	/* Centre of the temperature axis */
+	double F0;		/* First sample, the fit is relative to it */
+	u32 Samples;		/* Samples taken */
+} TempModel;
+
+typedef struct {
+	TempModel Model;
+	double WindowTempC[TEMP_MODEL_MAX_WIN]; /* Windows in the divisor */
+	u32 NumWin;		/* Windows averaged by clk_div_top */
+	u32 WinIndex;		/* Next entry of WindowTempC */
+	u32 WinFill;		/* Valid entries of WindowTempC */
+	u32 Scale;		/* SCALE of the last sample */
+	double LastTempC;	/* Temperature at the last sample */
+	double SlopeCPerS;	/* Smoothed temperature slope */
+	double MaxTrimPpm;	/* Trim limit, relative to the divisor */
+	u32 Rejected;		/* Windows not fitted as outliers */
+} TempTracker;
+
+/************************** Function Prototypes *****************************/
+
+void TempModel_Init(TempModel *ModelPtr, double RefTempC, double Lambda,
+		    double InitCov);
+void TempModel_Update(TempModel *ModelPtr, double TempC, double Value);
+double TempModel_Predict(const TempModel *ModelPtr, double TempC);
+u32 TempModel_IsValid(const TempModel *ModelPtr);
+double TempModel_LagCorrection(const TempModel *ModelPtr, double TempNowC,
+			       const double *WindowTempC, u32 WindowCount);
+
+void TempTracker_Init(TempTracker *TrackerPtr, u32 NumWin, double RefTempC,
+		      double Lambda, double InitCov, double MaxTrimPpm);
+s32 TempTracker_Sample(TempTracker *TrackerPtr, double TempC, u32 WinCount,
+		       u32 Scale);
+
+#endif /* end of protection macro */
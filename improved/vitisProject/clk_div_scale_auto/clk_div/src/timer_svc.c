@@ -0,0 +1,455 @@
+/*****************************************************************************/
+/**
+* @file timer_svc.c
+*
+* Tickless timer service. See timer_svc.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <stddef.h>
+#include "xparameters.h"
+#include "xscutimer.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "xstatus.h"
+#include "intc.h"
+#include "timer_svc.h"
+
+/************************** Constant Definitions ****************************/
+
+#define TIMER_SVC_DEVICE_ID	XPAR_XSCUTIMER_0_DEVICE_ID
+#define TIMER_SVC_INTR_ID	XPAR_SCUTIMER_INTR
+
+/* The private timer counts the same PERIPHCLK as the global timer */
+#define TIMER_SVC_MAX_LOAD	0xFFFFFFFFU
+
+#define TIMER_SVC_SLOT_MASK	(TIMER_SVC_WHEEL_SLOTS - 1U)
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define wfi()	__asm__ __volatile__ ("wfi" : : : "memory")
+
+/************************** Function Prototypes *****************************/
+
+static void TimerSvc_IrqHandler(void *CallBackRef);
+static void TimerSvc_Link(TimerSvc_Timer *Timer);
+static void TimerSvc_Unlink(TimerSvc_Timer *Timer);
+static void TimerSvc_Expire(XTime Now);
+static void TimerSvc_Program(void);
+
+/************************** Variable Definitions **************************/
+
+static XScuTimer TimerInstance;
+static TimerSvc_Timer *Wheel[TIMER_SVC_WHEEL_SLOTS];
+static XTime WheelTime;		/* Timers are expired up to this time */
+static u32 TimerReady;
+
+/*****************************************************************************/
+/**
+* Set up the private timer as a one-shot and connect its interrupt.
+*
+* @return
+*		- XST_SUCCESS if the service is running
+*		- XST_FAILURE otherwise, and TimerSvc_WaitUntil() busy-waits
+*
+* @note		None.
+*
+******************************************************************************/
+int TimerSvc_Init(void)
+{
+	XScuTimer_Config *ConfigPtr;
+	int Status;
+
+	ConfigPtr = XScuTimer_LookupConfig(TIMER_SVC_DEVICE_ID);
+	if (ConfigPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XScuTimer_CfgInitialize(&TimerInstance, ConfigPtr,
+					 ConfigPtr->BaseAddr);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	XScuTimer_Stop(&TimerInstance);
+	XScuTimer_DisableAutoReload(&TimerInstance);
+	XScuTimer_SetPrescaler(&TimerInstance, 0U);
+	XScuTimer_ClearInterruptStatus(&TimerInstance);
+	XScuTimer_EnableInterrupt(&TimerInstance);
+
+	XTime_GetTime(&WheelTime);
+
+	Status = Intc_Connect(TIMER_SVC_INTR_ID,
+			      (Xil_InterruptHandler)TimerSvc_IrqHandler, NULL,
+			      TIMER_SVC_PRIORITY, INTC_TRIGGER_RISING);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	TimerReady = 1U;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Initialize a software timer, stopped.
+*
+* @param	Timer is the timer, owned by the caller.
+* @param	Handler is called when the timer expires, or NULL.
+* @param	CallBackRef is passed to the handler.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void TimerSvc_InitTimer(TimerSvc_Timer *Timer, TimerSvc_Handler Handler,
+			void *CallBackRef)
+{
+	Timer->Next = NULL;
+	Timer->Deadline = 0U;
+	Timer->Period = 0U;
+	Timer->Handler = Handler;
+	Timer->CallBackRef = CallBackRef;
+	Timer->Slot = 0U;
+	Timer->Armed = 0U;
+}
+
+/*****************************************************************************/
+/**
+* Start a software timer, or move it if it is running.
+*
+* @param	Timer is the timer.
+* @param	Deadline is the global timer value to expire at. A deadline
+*		already past expires at once.
+* @param	Period reloads the timer after each expiry, from its deadline
+*		so it does not drift; 0 for a one-shot.
+*
+* @return	None.
+*
+* @note		May be called from a handler or any interrupt.
+*
+******************************************************************************/
+void TimerSvc_Start(TimerSvc_Timer *Timer, XTime Deadline, XTime Period)
+{
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_IRQ);
+
+	if (Timer->Armed != 0U) {
+		TimerSvc_Unlink(Timer);
+	}
+	Timer->Deadline = Deadline;
+	Timer->Period = Period;
+	TimerSvc_Link(Timer);
+	TimerSvc_Program();
+
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+* Stop a software timer. Does nothing if it is not running.
+*
+* @param	Timer is the timer.
+*
+* @return	None.
+*
+* @note		May be called from a handler or any interrupt.
+*
+******************************************************************************/
+void TimerSvc_Stop(TimerSvc_Timer *Timer)
+{
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XIL_EXCEPTION_IRQ);
+
+	if (Timer->Armed != 0U) {
+		TimerSvc_Unlink(Timer);
+		TimerSvc_Program();
+	}
+
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+* Sleep in WFI until a deadline, or until a condition holds. The condition
+* is checked with IRQs masked before each WFI, so an interrupt that makes it
+* true cannot be missed.
+*
+* @param	Deadline is the global timer value to give up at.
+* @param	Cond is the condition, or NULL to sleep until Deadline.
+* @param	CallBackRef is passed to Cond.
+*
+* @return
+*		- XST_SUCCESS if Cond held
+*		- XST_TIMEOUT if the deadline passed first
+*
+* @note		Not for interrupt context. Before TimerSvc_Init() has
+*		succeeded, busy-waits instead.
+*
+******************************************************************************/
+int TimerSvc_WaitUntil(XTime Deadline, TimerSvc_Cond Cond,
+		       void *CallBackRef)
+{
+	TimerSvc_Timer Wake;
+	XTime Now;
+	u32 Cpsr;
+	int Status = XST_TIMEOUT;
+
+	if (TimerReady == 0U) {
+		do {
+			if ((Cond != NULL) && (Cond(CallBackRef) != 0)) {
+				return XST_SUCCESS;
+			}
+			XTime_GetTime(&Now);
+		} while (Now < Deadline);
+
+		return XST_TIMEOUT;
+	}
+
+	TimerSvc_InitTimer(&Wake, NULL, NULL);
+	TimerSvc_Start(&Wake, Deadline, 0U);
+
+	Cpsr = mfcpsr();
+	while (1) {
+		mtcpsr(Cpsr | XIL_EXCEPTION_IRQ);
+		if ((Cond != NULL) && (Cond(CallBackRef) != 0)) {
+			Status = XST_SUCCESS;
+			break;
+		}
+		if (Wake.Armed == 0U) {
+			break;
+		}
+		/* A pending IRQ ends the WFI even while it is masked */
+		wfi();
+		mtcpsr(Cpsr);
+	}
+	mtcpsr(Cpsr);
+
+	TimerSvc_Stop(&Wake);
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* Sleep in WFI for a number of microseconds. Interrupts are taken while
+* sleeping.
+*
+* @param	Us is the time to sleep.
+*
+* @return	None.
+*
+* @note		Not for interrupt context.
+*
+******************************************************************************/
+void TimerSvc_Usleep(u32 Us)
+{
+	XTime Now;
+
+	XTime_GetTime(&Now);
+	(void)TimerSvc_WaitUntil(Now + TIMER_SVC_US(Us), NULL, NULL);
+}
+
+/*****************************************************************************/
+/**
+* Private timer interrupt: run the timers that are due and load the timer
+* for the next one.
+*
+* @param	CallBackRef is unused.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void TimerSvc_IrqHandler(void *CallBackRef)
+{
+	XTime Now;
+
+	(void)CallBackRef;
+
+	XScuTimer_ClearInterruptStatus(&TimerInstance);
+
+	XTime_GetTime(&Now);
+	TimerSvc_Expire(Now);
+	TimerSvc_Program();
+}
+
+/*****************************************************************************/
+/**
+* Insert a timer into the slot of its deadline, in deadline order. A timer
+* already due goes into the current slot.
+*
+* @param	Timer is the timer, not armed.
+*
+* @return	None.
+*
+* @note		Called with IRQs masked.
+*
+******************************************************************************/
+static void TimerSvc_Link(TimerSvc_Timer *Timer)
+{
+	TimerSvc_Timer **Link;
+	XTime Time = Timer->Deadline;
+
+	if (Time < WheelTime) {
+		Time = WheelTime;
+	}
+	Timer->Slot = (u32)(Time >> TIMER_SVC_SLOT_SHIFT) & TIMER_SVC_SLOT_MASK;
+
+	Link = &Wheel[Timer->Slot];
+	while ((*Link != NULL) && ((*Link)->Deadline <= Timer->Deadline)) {
+		Link = &(*Link)->Next;
+	}
+	Timer->Next = *Link;
+	*Link = Timer;
+	Timer->Armed = 1U;
+}
+
+/*****************************************************************************/
+/**
+* Remove a timer from its slot.
+*
+* @param	Timer is the timer, armed.
+*
+* @return	None.
+*
+* @note		Called with IRQs masked.
+*
+******************************************************************************/
+static void TimerSvc_Unlink(TimerSvc_Timer *Timer)
+{
+	TimerSvc_Timer **Link = &Wheel[Timer->Slot];
+
+	while (*Link != NULL) {
+		if (*Link == Timer) {
+			*Link = Timer->Next;
+			break;
+		}
+		Link = &(*Link)->Next;
+	}
+	Timer->Next = NULL;
+	Timer->Armed = 0U;
+}
+
+/*****************************************************************************/
+/**
+* Run the timers due by Now. The slots from the last expiry up to Now are
+* visited once each, at most the whole wheel; in each, the timers at the
+* head that are due are removed, reloaded if periodic, and run.
+*
+* @param	Now is the global timer value.
+*
+* @return	None.
+*
+* @note		Called with IRQs masked.
+*
+******************************************************************************/
+static void TimerSvc_Expire(XTime Now)
+{
+	TimerSvc_Timer *Timer;
+	XTime Slot = WheelTime >> TIMER_SVC_SLOT_SHIFT;
+	XTime Last = Now >> TIMER_SVC_SLOT_SHIFT;
+	XTime Deadline;
+
+	if ((Last - Slot) >= TIMER_SVC_WHEEL_SLOTS) {
+		Slot = Last - TIMER_SVC_WHEEL_SLOTS + 1U;
+	}
+
+	/* Timers started by the handlers are linked from Now on */
+	WheelTime = Now;
+
+	for (; Slot <= Last; Slot++) {
+		while (1) {
+			Timer = Wheel[(u32)Slot & TIMER_SVC_SLOT_MASK];
+			if ((Timer == NULL) || (Timer->Deadline > Now)) {
+				break;
+			}
+
+			Deadline = Timer->Deadline;
+			TimerSvc_Unlink(Timer);
+			if (Timer->Period != 0U) {
+				/* Periods missed while IRQs were masked are
+				 * skipped, the phase is kept */
+				do {
+					Timer->Deadline += Timer->Period;
+				} while (Timer->Deadline <= Now);
+				TimerSvc_Link(Timer);
+			}
+
+			if (Timer->Handler != NULL) {
+				Timer->Handler(Timer->CallBackRef, Deadline);
+			}
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+* Load the private timer for the earliest deadline, or stop it if no timer
+* is running. The wheel is scanned from the current slot for one turn; the
+* first slot whose head falls due within that turn holds the earliest
+* deadline. Otherwise the earliest head of all, more than a turn away, is
+* taken, and the private timer is reloaded when it expires.
+*
+* @return	None.
+*
+* @note		Called with IRQs masked.
+*
+******************************************************************************/
+static void TimerSvc_Program(void)
+{
+	TimerSvc_Timer *Timer;
+	TimerSvc_Timer *Next = NULL;
+	XTime Slot = WheelTime >> TIMER_SVC_SLOT_SHIFT;
+	XTime Now;
+	XTime Ticks;
+	u32 Index;
+
+	for (Index = 0U; Index < TIMER_SVC_WHEEL_SLOTS; Index++) {
+		Timer = Wheel[(u32)(Slot + Index) & TIMER_SVC_SLOT_MASK];
+		if (Timer == NULL) {
+			continue;
+		}
+		if ((Timer->Deadline >> TIMER_SVC_SLOT_SHIFT) <=
+		    (Slot + Index)) {
+			Next = Timer;
+			break;
+		}
+		if ((Next == NULL) || (Timer->Deadline < Next->Deadline)) {
+			Next = Timer;
+		}
+	}
+
+	if (Next == NULL) {
+		XScuTimer_Stop(&TimerInstance);
+		return;
+	}
+
+	XTime_GetTime(&Now);
+	Ticks = (Next->Deadline > Now) ? (Next->Deadline - Now) : 1U;
+	if (Ticks > TIMER_SVC_MAX_LOAD) {
+		Ticks = TIMER_SVC_MAX_LOAD;
+	}
+
+	XScuTimer_Stop(&TimerInstance);
+	XScuTimer_ClearInterruptStatus(&TimerInstance);
+	XScuTimer_LoadTimer(&TimerInstance, (u32)Ticks);
+	XScuTimer_Start(&TimerInstance);
+}
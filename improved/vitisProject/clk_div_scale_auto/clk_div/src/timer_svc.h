@@ -0,0 +1,78 @@
+/*****************************************************************************/
+/**
+* @file timer_svc.h
+*
+* Tickless timer service on the private timer of CPU0. Deadlines are global
+* timer (XTime) values, so they line up with the pps timestamps. Software
+* timers are kept in a timer wheel of TIMER_SVC_WHEEL_SLOTS slots, each
+* sorted by deadline, and the private timer is loaded as a one-shot for the
+* earliest of them only; there is no periodic tick.
+*
+* TimerSvc_WaitUntil() sleeps in WFI until a deadline or until a condition
+* set by an interrupt handler holds, e.g. the next pps. TimerSvc_Usleep()
+* replaces the busy-waiting usleep() of the BSP in the application.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who  Date	  Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a xl   10/19/26 Initial release.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef TIMER_SVC_H		/* prevent circular inclusions */
+#define TIMER_SVC_H		/* by using protection macros */
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xtime_l.h"
+
+/************************** Constant Definitions ****************************/
+
+#define TIMER_SVC_PRIORITY	0x10U	/* Just below the pps interrupt */
+
+/* 64 slots of 2^18 ticks, about 0.8 ms: one turn of the wheel is 50 ms */
+#define TIMER_SVC_WHEEL_SLOTS	64U
+#define TIMER_SVC_SLOT_SHIFT	18U
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/* Microseconds to global timer ticks, without rounding COUNTS_PER_SECOND */
+#define TIMER_SVC_US(Us)	(((XTime)(Us) * COUNTS_PER_SECOND) / 1000000U)
+
+/**************************** Type Definitions ******************************/
+
+/*
+ * Called in IRQ context at or after Deadline. A handler may start or stop
+ * any timer, itself included.
+ */
+typedef void (*TimerSvc_Handler)(void *CallBackRef, XTime Deadline);
+
+/* Condition of TimerSvc_WaitUntil(), nonzero to stop waiting */
+typedef int (*TimerSvc_Cond)(void *CallBackRef);
+
+typedef struct TimerSvc_Timer {
+	struct TimerSvc_Timer *Next;	/* In its wheel slot */
+	XTime Deadline;
+	XTime Period;			/* Reload, 0 for a one-shot */
+	TimerSvc_Handler Handler;	/* May be NULL, to only wake the CPU */
+	void *CallBackRef;
+	u32 Slot;
+	volatile u32 Armed;
+} TimerSvc_Timer;
+
+/************************** Function Prototypes *****************************/
+
+int TimerSvc_Init(void);
+void TimerSvc_InitTimer(TimerSvc_Timer *Timer, TimerSvc_Handler Handler,
+			void *CallBackRef);
+void TimerSvc_Start(TimerSvc_Timer *Timer, XTime Deadline, XTime Period);
+void TimerSvc_Stop(TimerSvc_Timer *Timer);
+int TimerSvc_WaitUntil(XTime Deadline, TimerSvc_Cond Cond,
+		       void *CallBackRef);
+void TimerSvc_Usleep(u32 Us);
+
+#endif /* end of protection macro */
@@ -309,6 +309,8 @@
  * 3.9   hk   01/23/19 Add RX watermark support
  * 3.11  sd   02/14/20 Add clock support
  * 3.13  nsk  12/14/20 Updated the tcl to not to use the instance names.
+ * 3.18  xl   10/19/26 Added 1588 timer and PTP event timestamp APIs in
+ *                     xemacps_ptp.c.
  *
  * </pre>
  *
@@ -440,6 +442,21 @@ extern "C" {
 #define XEMACPS_HANDLER_ERROR   3U
 /*@}*/
 
+/** @name PTP event timestamp identifiers
+ *
+ * These constants are used as parameters to XEmacPs_PtpGetEventTime() to
+ * select which of the captured event timestamps is read.
+ * @{
+ */
+#define XEMACPS_PTP_EVENT_TX		0U /**< Sync/Delay_req transmitted */
+#define XEMACPS_PTP_EVENT_RX		1U /**< Sync/Delay_req received */
+#define XEMACPS_PTP_EVENT_PEER_TX	2U /**< Pdelay_req/resp transmitted */
+#define XEMACPS_PTP_EVENT_PEER_RX	3U /**< Pdelay_req/resp received */
+/*@}*/
+
+#define XEMACPS_PTP_NS_PER_SEC		1000000000U /**< Nanoseconds in the
+							 1588 second */
+
 /* Constants to determine the configuration of the hardware device. They are
  * used to allow the driver to verify it can operate with the hardware.
  */
@@ -553,6 +570,15 @@ typedef struct XEmacPs_Instance {
 
 } XEmacPs;
 
+/**
+ * 1588 time of the timestamp unit (TSU), either the free running timer or
+ * an event timestamp captured by the MAC.
+ */
+typedef struct {
+	u32 Seconds;		/**< Seconds field */
+	u32 NanoSeconds;	/**< Nanoseconds field, below 10^9 */
+} XEmacPs_PtpTime;
+
 
 /***************** Macros (Inline Functions) Definitions ********************/
 
@@ -835,6 +861,17 @@ LONG XEmacPs_SetTypeIdCheck(XEmacPs *InstancePtr, u32 Id_Check, u8 Index);
 LONG XEmacPs_SendPausePacket(XEmacPs *InstancePtr);
 void XEmacPs_DMABLengthUpdate(XEmacPs *InstancePtr, s32 BLength);
 
+/*
+ * 1588 timer and PTP event timestamp functions in xemacps_ptp.c
+ */
+void XEmacPs_PtpSetIncrement(XEmacPs *InstancePtr, u32 TsuClkFreqHz);
+void XEmacPs_PtpGetTime(XEmacPs *InstancePtr, XEmacPs_PtpTime *TimePtr);
+void XEmacPs_PtpSetTime(XEmacPs *InstancePtr, const XEmacPs_PtpTime *TimePtr);
+LONG XEmacPs_PtpAdjustTime(XEmacPs *InstancePtr, s32 DeltaNs);
+void XEmacPs_PtpGetEventTime(XEmacPs *InstancePtr, u32 Event,
+			     XEmacPs_PtpTime *TimePtr);
+u32 XEmacPs_PtpEventPending(XEmacPs *InstancePtr, u32 Mask);
+
 #ifdef __cplusplus
 }
 #endif
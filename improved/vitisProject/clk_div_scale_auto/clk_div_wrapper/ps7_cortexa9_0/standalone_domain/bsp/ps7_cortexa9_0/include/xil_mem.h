@@ -23,6 +23,7 @@
 * ----- -------- -------- -----------------------------------------------
 * 6.1   nsk      11/07/16 First release.
 * 7.0   mus      01/07/19 Add cpp extern macro
+* 8.1   xl       10/19/26 Added Xil_MemSet
 *
 * </pre>
 *
@@ -37,6 +38,7 @@ extern "C" {
 /************************** Function Prototypes *****************************/
 
 void Xil_MemCpy(void* dst, const void* src, u32 cnt);
+void Xil_MemSet(void* dst, s32 val, u32 cnt);
 
 #ifdef __cplusplus
 }
@@ -24,6 +24,7 @@
 *					  u32 which resolves issue of CR#805869
 * 5.4	pkp	 23/11/15 Added attribute definitions for Xil_SetTlbAttributes API
 * 6.8   aru  09/06/18 Removed compilation warnings for ARMCC toolchain.
+* 8.1   xl   10/19/26 Added Xil_SetPageAttributes for 4 KB and 64 KB pages
 * </pre>
 *
 *
@@ -81,6 +82,7 @@ void Xil_SetTlbAttributes(INTPTR Addr, u32 attrib);
 void Xil_EnableMMU(void);
 void Xil_DisableMMU(void);
 void* Xil_MemMap(UINTPTR PhysAddr, size_t size, u32 flags);
+s32 Xil_SetPageAttributes(INTPTR Addr, u32 Size, u32 attrib);
 
 #ifdef __cplusplus
 }
@@ -46,6 +46,7 @@
 *                         status reporting for ARMv7.
 *						  Updated Sync and SError fault status reporting
 *						  for ARMv8.
+* 8.1  xl        10/19/26 Added Xil_ExceptionSetFiqVector() for Cortex-A9.
 *
 *
 * </pre>
@@ -246,6 +247,41 @@ void Xil_ExceptionRemoveHandler(u32 Exception_id)
 				       NULL);
 }
 
+#if defined (__GNUC__) && !defined (__aarch64__) && !defined (ARMR5) && \
+	!defined (ARMR52) && !defined (ARMA53_32)
+/*****************************************************************************/
+/**
+*
+* @brief	Install a handler straight in the FIQ vector, in place of the
+*			FIQHandler of asm_vectors.S. The FIQ then skips the state save
+*			of FIQHandler and the XExc_VectorTable lookup, for interrupts
+*			that need the shortest latency.
+*
+* @param	Vector: FIQ vector, entered in FIQ mode with FIQs and IRQs
+*			masked. It must save any register it uses other than the
+*			banked r8-r12 and return with "subs pc, lr, #4". NULL
+*			restores FIQHandler.
+*
+* @return	None.
+*
+* @note		The vector table loads the vector as data, so no I-cache
+*			maintenance is needed. Call with FIQs masked.
+*
+****************************************************************************/
+void Xil_ExceptionSetFiqVector(Xil_FiqVector Vector)
+{
+	extern u32 FIQVector;
+	extern void FIQHandler(void);
+
+	if (Vector == NULL) {
+		FIQVector = (u32)(UINTPTR)FIQHandler;
+	} else {
+		FIQVector = (u32)(UINTPTR)Vector;
+	}
+	dsb();
+}
+#endif
+
 #if defined (__aarch64__)
 /*****************************************************************************/
 /**
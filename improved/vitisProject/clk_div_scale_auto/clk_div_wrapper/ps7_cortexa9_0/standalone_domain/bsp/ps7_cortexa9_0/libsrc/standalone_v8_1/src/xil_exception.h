@@ -59,6 +59,7 @@
 *                         status reporting for ARMv7.
 *						  Updated Sync and SError fault status reporting
 *						  for ARMv8.
+* 8.1  xl        10/19/26 Added Xil_ExceptionSetFiqVector() for Cortex-A9.
 * </pre>
 *
 ******************************************************************************/
@@ -242,6 +243,13 @@ extern "C" {
 typedef void (*Xil_ExceptionHandler)(void *data);
 typedef void (*Xil_InterruptHandler)(void *data);
 
+/**
+ * This typedef is an FIQ vector, entered straight from the vector table in
+ * FIQ mode. It saves what it uses besides r8-r12 and returns with
+ * "subs pc, lr, #4".
+ */
+typedef void (*Xil_FiqVector)(void);
+
 typedef struct {
         Xil_ExceptionHandler Handler;
         void *Data;
@@ -520,6 +528,11 @@ extern void Xil_GetExceptionRegisterHandler(u32 Exception_id,
 
 extern void Xil_ExceptionInit(void);
 
+#if defined (__GNUC__) && !defined (__aarch64__) && !defined (ARMR5) && \
+	!defined (ARMR52) && !defined (ARMA53_32)
+extern void Xil_ExceptionSetFiqVector(Xil_FiqVector Vector);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
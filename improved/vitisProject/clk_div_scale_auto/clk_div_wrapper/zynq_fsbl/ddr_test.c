@@ -0,0 +1,635 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file ddr_test.c
+*
+* DDR test of the FSBL, see ddr_test.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.0	xl	10/19/26	Initial release
+*
+* </pre>
+*
+* @note
+*
+* The line tests run with the D-cache off, as the FSBL runs after
+* ps7_init(), so every access goes to DDR. The sweep turns the D-cache on
+* for the compare and flushes it after each DMA fill, so no line read
+* before the fill is compared; it turns the cache off again when done.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "ddr_test.h"
+#include "xtime_l.h"
+#include "xil_cache.h"
+
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+#include "xdmaps.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#ifdef XPAR_PS7_DDR_0_S_AXI_BASEADDR
+/*
+ * DDR size as seen by the address lines; the first 1 MB is under OCM
+ */
+#define DDR_TEST_SIZE			(DDR_END_ADDR + 1U)
+
+#define DDR_TEST_WORD_PATTERN		0xAAAAAAAAU
+#define DDR_TEST_WORD_ANTIPATTERN	0x55555555U
+
+/*
+ * Bank test: one word per DDR_TEST_ROW_STRIDE over DDR_TEST_ROW_WINDOW
+ */
+#define DDR_TEST_ROW_STRIDE		0x1000U
+#define DDR_TEST_ROW_WINDOW		0x800000U
+#define DDR_TEST_ROW_SEED		0x3C96A55AU
+
+/*
+ * Sweep blocks, and the seed of their fill words
+ */
+#define DDR_TEST_BLOCK_SIZE		0x200000U
+#define DDR_TEST_SWEEP_SEED		0xA5C3F00FU
+
+#define DDR_TEST_DMA_DEVICE_ID		XPAR_XDMAPS_1_DEVICE_ID
+#define DDR_TEST_DMA_CHANNEL		0
+#define DDR_TEST_DMA_BURST_SIZE		4
+#define DDR_TEST_DMA_BURST_LEN		16
+#define DDR_TEST_DMA_MAX_COUNT		100000000U
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Address;
+	u32 Length;
+	u32 Pattern;
+	u32 First;		/**< First polarity of the block */
+} DdrTestJob;
+
+/************************** Function Prototypes ******************************/
+
+static u32 DdrTestDataLines(u32 Anchor);
+static u32 DdrTestAddressLines(u32 Anchor);
+static u32 DdrTestBanks(u32 Anchor);
+static u32 DdrTestSweep(u32 Mode, u32 *BytesTested);
+static u32 DdrTestGetJob(u32 JobNum, DdrTestJob *Job);
+static u32 DdrTestFillStart(const DdrTestJob *Job, u32 Slot);
+static u32 DdrTestFillWait(void);
+static void DdrTestReportFault(const DdrTestJob *Job);
+
+/************************** Variable Definitions *****************************/
+
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+static XDmaPs DdrTestDmaInstance;
+static u8 DdrTestDmaReady;
+static u8 DdrTestFillPending;
+
+/*
+ * Source word of the DMA fill of each job in flight, one cache line each
+ */
+static u32 DdrTestFillWord[2][8] __attribute__((aligned(32)));
+#endif
+
+static u32 DdrTestBlocks;
+static u32 DdrTestOrderBits;
+#endif
+
+/******************************************************************************/
+/**
+*
+* This function tests DDR in the given mode.
+*
+* @param	Mode is one of DDR_TEST_MODE_*
+* @param	Result is set to the result code, DDR_TEST_RESULT()
+* @param	BytesTested is set to the bytes the sweep compared
+*
+* @return
+*		- XST_SUCCESS if DDR passed
+*		- XST_FAILURE on the first fault found
+*
+* @note		The D-cache must be off.
+*
+****************************************************************************/
+u32 DdrTest(u32 Mode, u32 *Result, u32 *BytesTested)
+{
+#ifdef XPAR_PS7_DDR_0_S_AXI_BASEADDR
+	u32 Anchor;
+	u32 Fault = DDR_FAULT_NONE;
+
+	*BytesTested = 0U;
+
+	/*
+	 * The address lines are tested around an anchor with the two top
+	 * bits set, so that toggling any one line stays above the OCM
+	 */
+	Anchor = (DDR_TEST_SIZE >> 1) | (DDR_TEST_SIZE >> 2);
+
+	if (Mode != DDR_TEST_MODE_BASIC) {
+		if (DdrTestDataLines(Anchor) != XST_SUCCESS) {
+			Fault = DDR_FAULT_DATA_LINE;
+		} else if (DdrTestAddressLines(Anchor) != XST_SUCCESS) {
+			Fault = DDR_FAULT_ADDRESS_LINE;
+		} else if (DdrTestBanks(Anchor) != XST_SUCCESS) {
+			Fault = DDR_FAULT_BANK;
+		} else if (Mode != DDR_TEST_MODE_LINES) {
+			Fault = DdrTestSweep(Mode, BytesTested);
+		}
+	}
+
+	*Result = DDR_TEST_RESULT(Mode, Fault);
+
+	if (Fault != DDR_FAULT_NONE) {
+		fsbl_printf(DEBUG_GENERAL, "DDR test mode %lu failed, fault %lu\r\n",
+				Mode, Fault);
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_INFO, "DDR test mode %lu passed, %lu bytes swept\r\n",
+			Mode, *BytesTested);
+#else
+	*Result = DDR_TEST_RESULT(Mode, 0U);
+	*BytesTested = 0U;
+#endif
+
+	return XST_SUCCESS;
+}
+
+#ifdef XPAR_PS7_DDR_0_S_AXI_BASEADDR
+/******************************************************************************/
+/**
+*
+* This function walks a one and a zero over the 32 data lines. Another word
+* is written between the write and the read back, so the read does not see
+* the value still on the bus.
+*
+* @param	Anchor is the word to test
+*
+* @return
+*		- XST_SUCCESS if every line toggles on its own
+*		- XST_FAILURE otherwise
+*
+* @note		None
+*
+****************************************************************************/
+static u32 DdrTestDataLines(u32 Anchor)
+{
+	u32 Bit;
+	u32 Value;
+
+	for (Bit = 0U; Bit < 32U; Bit++) {
+		Value = 1U << Bit;
+		Xil_Out32(Anchor, Value);
+		Xil_Out32(Anchor + 0x40U, ~Value);
+		if (Xil_In32(Anchor) != Value) {
+			fsbl_printf(DEBUG_GENERAL, "DDR data line %lu: 0x%08lx\r\n",
+					Bit, Xil_In32(Anchor));
+			return XST_FAILURE;
+		}
+
+		Xil_Out32(Anchor, ~Value);
+		Xil_Out32(Anchor + 0x40U, Value);
+		if (Xil_In32(Anchor) != ~Value) {
+			fsbl_printf(DEBUG_GENERAL, "DDR data line %lu: 0x%08lx\r\n",
+					Bit, Xil_In32(Anchor));
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function tests the address lines: the words at the anchor with one
+* line toggled must all be distinct from each other and from the anchor.
+*
+* @param	Anchor is the base word
+*
+* @return
+*		- XST_SUCCESS if no line is stuck or shorted to another
+*		- XST_FAILURE otherwise
+*
+* @note		None
+*
+****************************************************************************/
+static u32 DdrTestAddressLines(u32 Anchor)
+{
+	u32 Bit;
+	u32 Other;
+
+	for (Bit = 2U; (1U << Bit) < DDR_TEST_SIZE; Bit++) {
+		Xil_Out32(Anchor ^ (1U << Bit), DDR_TEST_WORD_PATTERN);
+	}
+
+	/*
+	 * Stuck high: the anchor write shows up at a toggled address
+	 */
+	Xil_Out32(Anchor, DDR_TEST_WORD_ANTIPATTERN);
+	for (Bit = 2U; (1U << Bit) < DDR_TEST_SIZE; Bit++) {
+		if (Xil_In32(Anchor ^ (1U << Bit)) != DDR_TEST_WORD_PATTERN) {
+			fsbl_printf(DEBUG_GENERAL, "DDR address line %lu\r\n", Bit);
+			return XST_FAILURE;
+		}
+	}
+	Xil_Out32(Anchor, DDR_TEST_WORD_PATTERN);
+
+	/*
+	 * Stuck low or shorted: a toggled address write shows up elsewhere
+	 */
+	for (Bit = 2U; (1U << Bit) < DDR_TEST_SIZE; Bit++) {
+		Xil_Out32(Anchor ^ (1U << Bit), DDR_TEST_WORD_ANTIPATTERN);
+
+		if (Xil_In32(Anchor) != DDR_TEST_WORD_PATTERN) {
+			fsbl_printf(DEBUG_GENERAL, "DDR address line %lu\r\n", Bit);
+			return XST_FAILURE;
+		}
+		for (Other = 2U; (1U << Other) < DDR_TEST_SIZE; Other++) {
+			if ((Other != Bit) &&
+					(Xil_In32(Anchor ^ (1U << Other)) !=
+						DDR_TEST_WORD_PATTERN)) {
+				fsbl_printf(DEBUG_GENERAL,
+					"DDR address lines %lu and %lu\r\n",
+					Bit, Other);
+				return XST_FAILURE;
+			}
+		}
+
+		Xil_Out32(Anchor ^ (1U << Bit), DDR_TEST_WORD_PATTERN);
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function writes a word of its own address to every 4 KB of a window
+* that covers all banks and many rows of each, then reads them all back, so
+* a row or bank that decodes to another shows up.
+*
+* @param	Anchor is the start of the window
+*
+* @return
+*		- XST_SUCCESS if every word read back
+*		- XST_FAILURE otherwise
+*
+* @note		None
+*
+****************************************************************************/
+static u32 DdrTestBanks(u32 Anchor)
+{
+	u32 Address;
+	u32 Value;
+
+	for (Address = Anchor; Address < (Anchor + DDR_TEST_ROW_WINDOW);
+			Address += DDR_TEST_ROW_STRIDE) {
+		Xil_Out32(Address, Address ^ DDR_TEST_ROW_SEED);
+	}
+
+	for (Address = Anchor; Address < (Anchor + DDR_TEST_ROW_WINDOW);
+			Address += DDR_TEST_ROW_STRIDE) {
+		Value = Xil_In32(Address);
+		if (Value != (Address ^ DDR_TEST_ROW_SEED)) {
+			fsbl_printf(DEBUG_GENERAL, "DDR row at 0x%08lx: 0x%08lx\r\n",
+					Address, Value);
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function sweeps DDR in blocks, within the time of the mode. Each
+* block is filled with its word and compared, and then with the complement.
+* The blocks are visited in bit-reversed order, so a short sweep still
+* spreads over the whole device, and in pairs, so the DMA fills one block
+* while the other is compared.
+*
+* @param	Mode is DDR_TEST_MODE_50MS, DDR_TEST_MODE_500MS or
+*		DDR_TEST_MODE_FULL
+* @param	BytesTested is set to the bytes compared with both words
+*
+* @return	DDR_FAULT_NONE, DDR_FAULT_PATTERN or DDR_FAULT_DMA
+*
+* @note		None
+*
+****************************************************************************/
+static u32 DdrTestSweep(u32 Mode, u32 *BytesTested)
+{
+	DdrTestJob Job[2];
+	XTime Start;
+	XTime Now;
+	XTime Budget;
+	u32 JobNum = 0U;
+	u32 Slot = 0U;
+	u32 Fault = DDR_FAULT_NONE;
+	u32 Next;
+	u32 Have;
+	u32 HaveNext;
+	u32 Overlap;
+
+	if (Mode == DDR_TEST_MODE_50MS) {
+		Budget = COUNTS_PER_SECOND / 20U;
+	} else if (Mode == DDR_TEST_MODE_500MS) {
+		Budget = COUNTS_PER_SECOND / 2U;
+	} else {
+		Budget = 0U;
+	}
+
+	DdrTestBlocks = DDR_TEST_SIZE / DDR_TEST_BLOCK_SIZE;
+	for (DdrTestOrderBits = 0U; (1U << DdrTestOrderBits) < DdrTestBlocks;
+			DdrTestOrderBits++) {
+		;
+	}
+
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+	DdrTestDmaReady = 0;
+	DdrTestFillPending = 0;
+	{
+		XDmaPs_Config *DmaConfig;
+
+		DmaConfig = XDmaPs_LookupConfig(DDR_TEST_DMA_DEVICE_ID);
+		if ((DmaConfig != NULL) &&
+				(XDmaPs_CfgInitialize(&DdrTestDmaInstance, DmaConfig,
+					DmaConfig->BaseAddress) == XST_SUCCESS)) {
+			DdrTestDmaReady = 1;
+		}
+	}
+#endif
+
+	XTime_GetTime(&Start);
+	Xil_DCacheEnable();
+
+	Have = DdrTestGetJob(0U, &Job[Slot]);
+	if ((Have == TRUE) && (DdrTestFillStart(&Job[Slot], Slot) != XST_SUCCESS)) {
+		Fault = DDR_FAULT_DMA;
+		Have = FALSE;
+	}
+
+	while (Have == TRUE) {
+		if (DdrTestFillWait() != XST_SUCCESS) {
+			Fault = DDR_FAULT_DMA;
+			break;
+		}
+
+		/*
+		 * Drop lines of the block read before the fill ended
+		 */
+		Xil_DCacheFlush();
+
+		/*
+		 * The next job is filled while this one is compared, unless
+		 * it is the same block. None is started once the time is up.
+		 */
+		XTime_GetTime(&Now);
+		Next = Slot ^ 1U;
+		HaveNext = FALSE;
+		if ((Budget == 0U) || ((Now - Start) < Budget)) {
+			HaveNext = DdrTestGetJob(JobNum + 1U, &Job[Next]);
+		}
+		Overlap = (HaveNext == TRUE) &&
+				(Job[Next].Address != Job[Slot].Address);
+		if ((Overlap == TRUE) &&
+				(DdrTestFillStart(&Job[Next], Next) != XST_SUCCESS)) {
+			Fault = DDR_FAULT_DMA;
+			break;
+		}
+
+		if (DdrTestCompare(Job[Slot].Address, Job[Slot].Length,
+				Job[Slot].Pattern) != 0U) {
+			DdrTestReportFault(&Job[Slot]);
+			Fault = DDR_FAULT_PATTERN;
+			(void)DdrTestFillWait();
+			break;
+		}
+		if (Job[Slot].First == FALSE) {
+			*BytesTested += Job[Slot].Length;
+		}
+
+		if ((HaveNext == TRUE) && (Overlap == FALSE) &&
+				(DdrTestFillStart(&Job[Next], Next) != XST_SUCCESS)) {
+			Fault = DDR_FAULT_DMA;
+			break;
+		}
+
+		JobNum++;
+		Slot = Next;
+		Have = HaveNext;
+	}
+
+	Xil_DCacheDisable();
+
+	return Fault;
+}
+
+/******************************************************************************/
+/**
+*
+* This function returns a sweep job: blocks are taken two at a time, each
+* filled with its word, then each with the complement.
+*
+* @param	JobNum is the job number
+* @param	Job is set to the block and word of the job
+*
+* @return	TRUE if there is such a job, FALSE past the last one
+*
+* @note		None
+*
+****************************************************************************/
+static u32 DdrTestGetJob(u32 JobNum, DdrTestJob *Job)
+{
+	u32 Order;
+	u32 Block = 0U;
+	u32 Bit;
+	u32 End;
+
+	Order = ((JobNum >> 2) << 1) | (JobNum & 1U);
+	if (Order >= DdrTestBlocks) {
+		return FALSE;
+	}
+
+	/*
+	 * Bit-reversed block order, when the blocks are a power of two
+	 */
+	if ((1U << DdrTestOrderBits) == DdrTestBlocks) {
+		for (Bit = 0U; Bit < DdrTestOrderBits; Bit++) {
+			if ((Order & (1U << Bit)) != 0U) {
+				Block |= 1U << (DdrTestOrderBits - 1U - Bit);
+			}
+		}
+	} else {
+		Block = Order;
+	}
+
+	Job->Address = Block * DDR_TEST_BLOCK_SIZE;
+	End = Job->Address + DDR_TEST_BLOCK_SIZE;
+	if (Job->Address < DDR_START_ADDR) {
+		Job->Address = DDR_START_ADDR;
+	}
+	Job->Length = End - Job->Address;
+	Job->Pattern = Job->Address ^ DDR_TEST_SWEEP_SEED;
+	Job->First = TRUE;
+	if ((JobNum & 2U) != 0U) {
+		Job->Pattern = ~Job->Pattern;
+		Job->First = FALSE;
+	}
+
+	return TRUE;
+}
+
+/******************************************************************************/
+/**
+*
+* This function starts the fill of a block: with the PS DMA from a fixed
+* source word, or with the CPU when there is no DMA.
+*
+* @param	Job is the block and word
+* @param	Slot is the source word to use, not in use by the other fill
+*
+* @return
+*		- XST_SUCCESS if the fill was started or done
+*		- XST_FAILURE if the DMA did not start
+*
+* @note		None
+*
+****************************************************************************/
+static u32 DdrTestFillStart(const DdrTestJob *Job, u32 Slot)
+{
+	u32 Address;
+
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+	XDmaPs_Cmd DmaCmd;
+
+	if (DdrTestDmaReady == 1) {
+		DdrTestFillWord[Slot][0] = Job->Pattern;
+		Xil_DCacheFlushRange((INTPTR)DdrTestFillWord[Slot],
+				sizeof(DdrTestFillWord[Slot]));
+
+		memset(&DmaCmd, 0, sizeof(XDmaPs_Cmd));
+		DmaCmd.ChanCtrl.SrcBurstSize = DDR_TEST_DMA_BURST_SIZE;
+		DmaCmd.ChanCtrl.SrcBurstLen = DDR_TEST_DMA_BURST_LEN;
+		DmaCmd.ChanCtrl.SrcInc = 0;
+		DmaCmd.ChanCtrl.DstBurstSize = DDR_TEST_DMA_BURST_SIZE;
+		DmaCmd.ChanCtrl.DstBurstLen = DDR_TEST_DMA_BURST_LEN;
+		DmaCmd.ChanCtrl.DstInc = 1;
+		DmaCmd.BD.SrcAddr = (u32)DdrTestFillWord[Slot];
+		DmaCmd.BD.DstAddr = Job->Address;
+		DmaCmd.BD.Length = Job->Length;
+
+		if (XDmaPs_Start(&DdrTestDmaInstance, DDR_TEST_DMA_CHANNEL,
+				&DmaCmd, 0) != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "DDR test DMA Failed\r\n");
+			return XST_FAILURE;
+		}
+		DdrTestFillPending = 1;
+
+		return XST_SUCCESS;
+	}
+#else
+	(void)Slot;
+#endif
+
+	/*
+	 * The fill goes through the cache; the flush after it writes it out
+	 */
+	for (Address = Job->Address; Address < (Job->Address + Job->Length);
+			Address += 4U) {
+		Xil_Out32(Address, Job->Pattern);
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for the DMA fill in flight, if any.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the fill is done
+*		- XST_FAILURE on a DMA fault or time out
+*
+* @note		None
+*
+****************************************************************************/
+static u32 DdrTestFillWait(void)
+{
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+	u32 BaseAddress = DdrTestDmaInstance.Config.BaseAddress;
+	u32 Count = DDR_TEST_DMA_MAX_COUNT;
+
+	if (DdrTestFillPending == 0) {
+		return XST_SUCCESS;
+	}
+	DdrTestFillPending = 0;
+
+	/*
+	 * Wait for the channel event the generated program ends with
+	 */
+	while ((XDmaPs_ReadReg(BaseAddress, XDMAPS_INTSTATUS_OFFSET) &
+			(1U << DDR_TEST_DMA_CHANNEL)) == 0U) {
+		Count--;
+		if ((Count == 0U) ||
+				((XDmaPs_ReadReg(BaseAddress, XDMAPS_FSC_OFFSET) &
+				(1U << DDR_TEST_DMA_CHANNEL)) != 0U)) {
+			fsbl_printf(DEBUG_GENERAL, "DDR test DMA Failed\r\n");
+			(void)XDmaPs_ResetChannel(&DdrTestDmaInstance,
+					DDR_TEST_DMA_CHANNEL);
+			return XST_FAILURE;
+		}
+	}
+
+	/*
+	 * Clear the event and release the program buffer
+	 */
+	XDmaPs_DoneISR_0(&DdrTestDmaInstance);
+#endif
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function prints the first word of a block that did not compare.
+*
+* @param	Job is the block and word
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void DdrTestReportFault(const DdrTestJob *Job)
+{
+	u32 Address;
+	u32 Value;
+
+	for (Address = Job->Address; Address < (Job->Address + Job->Length);
+			Address += 4U) {
+		Value = Xil_In32(Address);
+		if (Value != Job->Pattern) {
+			fsbl_printf(DEBUG_GENERAL,
+				"DDR at 0x%08lx: 0x%08lx, expected 0x%08lx\r\n",
+				Address, Value, Job->Pattern);
+			return;
+		}
+	}
+}
+#endif
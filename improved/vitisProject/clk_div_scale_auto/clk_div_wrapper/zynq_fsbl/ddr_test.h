@@ -0,0 +1,95 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file ddr_test.h
+*
+* DDR test of the FSBL, run by DDRInitCheck() right after ps7_init(). The
+* mode is set with FSBL_DDR_TEST_MODE:
+*
+* - DDR_TEST_MODE_BASIC writes and reads back two words, the check of the
+*   FSBL before this test.
+* - DDR_TEST_MODE_LINES, the default, walks a one and a zero over the data
+*   lines, checks every address line for stuck and shorted bits, and writes
+*   a unique word to each 4 KB of a window that spans all banks. It takes
+*   about a millisecond.
+* - DDR_TEST_MODE_50MS and DDR_TEST_MODE_500MS add a sweep of as much of
+*   DDR as fits in that time, in 2 MB blocks spread over the whole device.
+* - DDR_TEST_MODE_FULL sweeps all of DDR.
+*
+* The sweep fills each block with the PS DMA, a word of the block address
+* and then its complement, and compares it with NEON loads through the
+* D-cache while the DMA fills the next block.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.0	xl	10/19/26	Initial release
+*
+* </pre>
+*
+* @note
+*
+* The result code of DdrTest() is stored in the boot profile entry of the
+* ddr check stage, and the bytes swept in its byte count.
+*
+******************************************************************************/
+#ifndef ___DDR_TEST_H___
+#define ___DDR_TEST_H___
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Modes, for FSBL_DDR_TEST_MODE
+ */
+#define DDR_TEST_MODE_BASIC		0U
+#define DDR_TEST_MODE_LINES		1U
+#define DDR_TEST_MODE_50MS		2U
+#define DDR_TEST_MODE_500MS		3U
+#define DDR_TEST_MODE_FULL		4U
+
+#ifndef FSBL_DDR_TEST_MODE
+#define FSBL_DDR_TEST_MODE		DDR_TEST_MODE_LINES
+#endif
+
+/*
+ * Result code: DDR_TEST_RESULT_VALID, the mode in bits 15:8 and one of
+ * DDR_FAULT_* in bits 7:0
+ */
+#define DDR_TEST_RESULT_VALID		0x80000000U
+#define DDR_TEST_RESULT(Mode, Fault)	(DDR_TEST_RESULT_VALID | \
+					((u32)(Mode) << 8) | (u32)(Fault))
+
+#define DDR_FAULT_NONE			0U
+#define DDR_FAULT_DATA_LINE		1U	/**< Data line stuck or shorted */
+#define DDR_FAULT_ADDRESS_LINE		2U	/**< Address line stuck or shorted */
+#define DDR_FAULT_BANK			3U	/**< Row or bank aliased */
+#define DDR_FAULT_PATTERN		4U	/**< Sweep compare failed */
+#define DDR_FAULT_DMA			5U	/**< Sweep DMA failed */
+
+/************************** Function Prototypes ******************************/
+
+u32 DdrTest(u32 Mode, u32 *Result, u32 *BytesTested);
+
+/*
+ * NEON compare of ddr_test_cmp.S
+ */
+u32 DdrTestCompare(u32 Address, u32 Length, u32 Pattern);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ___DDR_TEST_H___ */
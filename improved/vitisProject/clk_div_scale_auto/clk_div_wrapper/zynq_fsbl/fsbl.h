@@ -218,6 +218,10 @@
 * 18.00a ka  10/29/18   Fix for CR# 1006294 Added macro for FORCE_USE_AES_EXCLUDE
 * 19.0   vns 03/18/22   Fixed CR#1125470, added FsblPrintArray() prototype
 * 20.0   ng  12/08/22   Updated SDK release version
+* 21.0   xl  10/19/26   Added FSBL_CPU1_VALIDATE flag
+*                       Added FSBL_DDR_TEST_MODE flag
+*                       Added FSBL_IMAGE_DIR_OFFSET flag
+*                       Added FSBL_PCAP_POLL flag
 *
 * </pre>
 *
@@ -289,6 +293,31 @@
 * Note : Changing the default behaviour is not recommended from
 * Security perspective.
 *
+* FSBL_CPU1_VALIDATE
+* Defining this flag validates plain (not encrypted) PS partitions on CPU1:
+* the MD5 checksum and, with RSA_SUPPORT, the SHA-256 hash of a partition
+* are computed by CPU1 while CPU0 moves the next partition. All results are
+* checked before the handoff. On a single core device the partitions are
+* validated on CPU0 as without the flag.
+*
+* FSBL_DDR_TEST_MODE
+* Selects the DDR test run after ps7_init, one of DDR_TEST_MODE_* in
+* ddr_test.h. By default the data, address and bank lines are checked;
+* the 50 ms, 500 ms and full modes also sweep DDR with the PS DMA. The
+* result code is stored in the boot profile.
+*
+* FSBL_IMAGE_DIR_OFFSET
+* Flash offset of the multiboot image directory, see image_dir.h. On a
+* fallback from QSPI, NAND or NOR the next image is taken from the
+* directory when there is a valid one; without it flash is searched for
+* the next image header as before. Default 0xFE0000.
+*
+* FSBL_PCAP_POLL
+* Defining this flag polls the devcfg status register for DMA and FPGA done
+* as before. By default the CPU sleeps in WFI until the devcfg interrupt,
+* with the private timer as timeout, and PcapSetEvents() callbacks run on
+* DMA done, PL done and PCAP errors. The GIC is stopped before the handoff.
+*
 *******************************************************************************/
 #ifndef XIL_FSBL_H
 #define XIL_FSBL_H
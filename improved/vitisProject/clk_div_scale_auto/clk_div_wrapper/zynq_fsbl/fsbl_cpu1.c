@@ -0,0 +1,453 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_cpu1.c
+*
+* Partition validation on CPU1, see fsbl_cpu1.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.0	xl	10/19/26	Initial release
+* 21.0	xl	10/19/26	The mailbox has cache lines of its own
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_cpu1.h"
+
+#ifdef FSBL_CPU1_VALIDATE
+#include "xil_io.h"
+#include "xtime_l.h"
+#include "fsbl_profile.h"
+#include "md5.h"
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+#include "xwdtps.h"
+#endif
+
+#ifdef RSA_SUPPORT
+#include "rsa.h"
+#include "xil_cache.h"
+#include "xilrsa.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Time CPU1 gets to answer the wake-up, and to finish one job. A single
+ * core device never answers, and the partitions are then validated on CPU0.
+ */
+#define FSBL_CPU1_START_TIMEOUT		(COUNTS_PER_SECOND / 100U)
+#define FSBL_CPU1_JOB_TIMEOUT		(COUNTS_PER_SECOND * 10U)
+
+#define FSBL_CPU1_DIGEST_SIZE		32U
+#define FSBL_CPU1_MD5_SIZE		16U
+
+/*
+ * L1 and L2 line size; the mailbox is aligned and padded to it
+ */
+#define FSBL_CPU1_CACHE_LINE		32U
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Type;		/**< FSBL_CPU1_JOB_* */
+	u32 PartitionNum;
+	u32 Address;		/**< Data to hash */
+	u32 Length;		/**< Bytes to hash */
+	u32 AcAddress;		/**< Authentication certificate, SHA-256 jobs */
+	u32 Status;		/**< XST_SUCCESS once a MD5 job matched */
+	u64 StartTicks;		/**< Global timer, set by CPU1 */
+	u64 EndTicks;
+	u8 Expected[FSBL_CPU1_MD5_SIZE];	/**< Checksum from the image */
+	u8 Digest[FSBL_CPU1_DIGEST_SIZE];	/**< Hash computed by CPU1 */
+} FsblCpu1Job;
+
+/*
+ * CPU0 writes Posted after filling a job and Quit to stop CPU1; CPU1 writes
+ * Done after each job and Running while it serves the mailbox. The type is
+ * aligned, so its size is a whole number of cache lines too.
+ */
+typedef struct {
+	u32 Running;
+	u32 Posted;
+	u32 Done;
+	u32 Quit;
+	FsblCpu1Job Job[FSBL_CPU1_MAX_JOBS];
+} __attribute__((aligned(FSBL_CPU1_CACHE_LINE))) FsblCpu1Mailbox;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/*
+ * Event hints for the CPU1 wait loops, not in xpseudo_asm.h
+ */
+#define sev()	__asm__ __volatile__ ("sev" : : : "memory")
+#define wfe()	__asm__ __volatile__ ("wfe" : : : "memory")
+
+/************************** Function Prototypes ******************************/
+
+static u32 FsblCpu1Start(void);
+static u32 FsblCpu1Wait(volatile u32 *Value, u32 Target, XTime Timeout);
+
+/************************** Variable Definitions *****************************/
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
+#endif
+
+/*
+ * Alone in its cache lines, see the note in fsbl_cpu1.h
+ */
+static volatile FsblCpu1Mailbox Mailbox;
+
+/*
+ * CPU1 is woken on the first job; it is given up on for the rest of the
+ * boot if it does not answer
+ */
+static u8 Cpu1StartedFlag;
+static u8 Cpu1FailedFlag;
+
+/******************************************************************************/
+/**
+*
+* This function tells whether partitions can be handed to CPU1.
+*
+* @param	None
+*
+* @return	TRUE unless CPU1 failed to start earlier in this boot
+*
+* @note		None
+*
+****************************************************************************/
+u32 FsblCpu1Available(void)
+{
+	return (Cpu1FailedFlag == 0U) ? TRUE : FALSE;
+}
+
+/******************************************************************************/
+/**
+*
+* This function hands the hash of a partition to CPU1, waking CPU1 first if
+* needed. The partition must stay in place until FsblCpu1Finish().
+*
+* @param	Type is FSBL_CPU1_JOB_MD5 or FSBL_CPU1_JOB_SHA256
+* @param	PartitionNum is the partition, for messages and the profile
+* @param	Address is the partition in DDR
+* @param	Length is the number of bytes to hash
+* @param	Expected is the MD5 checksum from the image, MD5 jobs only
+* @param	AcAddress is the authentication certificate, SHA-256 jobs only
+*
+* @return
+*		- XST_SUCCESS if CPU1 took the job
+*		- XST_FAILURE if CPU1 is not available or the list is full;
+*		  the caller then validates the partition itself
+*
+* @note		None
+*
+****************************************************************************/
+u32 FsblCpu1Submit(u32 Type, u32 PartitionNum, u32 Address, u32 Length,
+		const u8 *Expected, u32 AcAddress)
+{
+	volatile FsblCpu1Job *JobPtr;
+	u32 Index;
+
+	if ((Cpu1FailedFlag != 0U) || (Mailbox.Posted >= FSBL_CPU1_MAX_JOBS)) {
+		return XST_FAILURE;
+	}
+
+	if (Cpu1StartedFlag == 0U) {
+		if (FsblCpu1Start() != XST_SUCCESS) {
+			fsbl_printf(DEBUG_INFO, "CPU1 did not start, "
+					"validating on CPU0\r\n");
+			Cpu1FailedFlag = 1U;
+			return XST_FAILURE;
+		}
+		Cpu1StartedFlag = 1U;
+	}
+
+	JobPtr = &Mailbox.Job[Mailbox.Posted];
+	JobPtr->Type = Type;
+	JobPtr->PartitionNum = PartitionNum;
+	JobPtr->Address = Address;
+	JobPtr->Length = Length;
+	JobPtr->AcAddress = AcAddress;
+	JobPtr->Status = XST_FAILURE;
+	JobPtr->StartTicks = 0U;
+	JobPtr->EndTicks = 0U;
+	for (Index = 0U; Index < FSBL_CPU1_MD5_SIZE; Index++) {
+		JobPtr->Expected[Index] = (Expected != NULL) ? Expected[Index] : 0U;
+	}
+
+	/*
+	 * Publish the job only once it is complete
+	 */
+	dsb();
+	Mailbox.Posted = Mailbox.Posted + 1U;
+	dsb();
+	sev();
+
+	fsbl_printf(DEBUG_INFO, "Partition %lu validation on CPU1\r\n",
+			PartitionNum);
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for CPU1 to finish every job, parks it in the Boot ROM
+* loop and checks the results. SHA-256 jobs are authenticated here, on CPU0,
+* with the hash CPU1 computed.
+*
+* @param	FailStatus returns the FSBL status code to report on failure
+*
+* @return
+*		- XST_SUCCESS if every partition handed to CPU1 is valid, or
+*		  none was
+*		- XST_FAILURE otherwise
+*
+* @note		The time CPU1 spent on each job is added to the boot profile.
+*
+****************************************************************************/
+u32 FsblCpu1Finish(u32 *FailStatus)
+{
+	volatile FsblCpu1Job *JobPtr;
+	u8 Digest[FSBL_CPU1_DIGEST_SIZE];
+	u32 Index;
+	u32 Byte;
+	u32 Status = XST_SUCCESS;
+
+	*FailStatus = 0U;
+
+	if (Cpu1StartedFlag == 0U) {
+		return XST_SUCCESS;
+	}
+
+	/*
+	 * Wait job by job, so a long list does not time out as a whole
+	 */
+	for (Index = Mailbox.Done; Index < Mailbox.Posted; Index++) {
+		if (FsblCpu1Wait(&Mailbox.Done, Index + 1U,
+				FSBL_CPU1_JOB_TIMEOUT) != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "CPU1 validation timed out\r\n");
+			*FailStatus = PARTITION_CHECKSUM_FAIL;
+			return XST_FAILURE;
+		}
+	}
+
+	Mailbox.Quit = 1U;
+	dsb();
+	sev();
+	(void)FsblCpu1Wait(&Mailbox.Running, 0U, FSBL_CPU1_START_TIMEOUT);
+	Cpu1StartedFlag = 0U;
+
+	for (Index = 0U; Index < Mailbox.Posted; Index++) {
+		JobPtr = &Mailbox.Job[Index];
+
+		FsblProfileRecord((JobPtr->Type == FSBL_CPU1_JOB_MD5) ?
+				FSBL_PROF_CPU1_MD5 : FSBL_PROF_CPU1_SHA,
+				JobPtr->PartitionNum, JobPtr->Length,
+				JobPtr->StartTicks, JobPtr->EndTicks);
+
+		if (JobPtr->Type == FSBL_CPU1_JOB_MD5) {
+			if (JobPtr->Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL, "Partition %lu checksum "
+						"mismatch on CPU1\r\n", JobPtr->PartitionNum);
+				*FailStatus = PARTITION_CHECKSUM_FAIL;
+				Status = XST_FAILURE;
+				break;
+			}
+			continue;
+		}
+
+#ifdef RSA_SUPPORT
+		for (Byte = 0U; Byte < FSBL_CPU1_DIGEST_SIZE; Byte++) {
+			Digest[Byte] = JobPtr->Digest[Byte];
+		}
+		FsblPrintArray(Digest, 32, "Partition Hash Calculated");
+
+		Xil_DCacheEnable();
+		Status = AuthenticatePartition((u8 *)JobPtr->AcAddress, Digest);
+		Xil_DCacheFlush();
+		Xil_DCacheDisable();
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "Partition %lu authentication "
+					"failed\r\n", JobPtr->PartitionNum);
+			*FailStatus = AUTHENTICATION_FAIL;
+			break;
+		}
+#else
+		(void)Byte;
+		(void)Digest;
+		*FailStatus = RSA_SUPPORT_NOT_ENABLED_FAIL;
+		Status = XST_FAILURE;
+		break;
+#endif
+	}
+
+	return Status;
+}
+
+/******************************************************************************/
+/**
+*
+* This function is the C entry of CPU1, called by FsblCpu1Entry with the MMU
+* and I-cache on. It serves the mailbox until CPU0 sets Quit and then parks
+* CPU1 in the Boot ROM loop.
+*
+* @param	None
+*
+* @return	Does not return
+*
+* @note		None
+*
+****************************************************************************/
+void FsblCpu1Main(void)
+{
+	volatile FsblCpu1Job *JobPtr;
+	u8 Digest[FSBL_CPU1_DIGEST_SIZE];
+	XTime Now;
+	u32 Index;
+	u32 Status;
+
+	/*
+	 * The Boot ROM loop must wait again once CPU1 is parked
+	 */
+	Xil_Out32(FSBL_CPU1_WAKE_ADDR, 0U);
+
+	Mailbox.Running = 1U;
+	dsb();
+	sev();
+
+	for (;;) {
+		if (Mailbox.Done < Mailbox.Posted) {
+			JobPtr = &Mailbox.Job[Mailbox.Done];
+
+			XTime_GetTime(&Now);
+			JobPtr->StartTicks = Now;
+
+			if (JobPtr->Type == FSBL_CPU1_JOB_MD5) {
+				md5((u8 *)JobPtr->Address, JobPtr->Length, Digest, 0);
+				Status = XST_SUCCESS;
+				for (Index = 0U; Index < FSBL_CPU1_MD5_SIZE; Index++) {
+					JobPtr->Digest[Index] = Digest[Index];
+					if (Digest[Index] != JobPtr->Expected[Index]) {
+						Status = XST_FAILURE;
+					}
+				}
+				JobPtr->Status = Status;
+			}
+#ifdef RSA_SUPPORT
+			else if (JobPtr->Type == FSBL_CPU1_JOB_SHA256) {
+				sha_256((u8 *)JobPtr->Address, JobPtr->Length, Digest);
+				for (Index = 0U; Index < FSBL_CPU1_DIGEST_SIZE; Index++) {
+					JobPtr->Digest[Index] = Digest[Index];
+				}
+				JobPtr->Status = XST_SUCCESS;
+			}
+#endif
+
+			XTime_GetTime(&Now);
+			JobPtr->EndTicks = Now;
+
+			dsb();
+			Mailbox.Done = Mailbox.Done + 1U;
+			dsb();
+			sev();
+			continue;
+		}
+
+		if (Mailbox.Quit != 0U) {
+			break;
+		}
+
+		wfe();
+	}
+
+	Mailbox.Running = 0U;
+	dsb();
+	sev();
+
+	FsblCpu1Park();
+}
+
+/******************************************************************************/
+/**
+*
+* This function wakes CPU1 and waits for it to reach FsblCpu1Main().
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if CPU1 is running
+*		- XST_FAILURE if it did not answer
+*
+* @note		None
+*
+****************************************************************************/
+static u32 FsblCpu1Start(void)
+{
+	Mailbox.Running = 0U;
+	Mailbox.Posted = 0U;
+	Mailbox.Done = 0U;
+	Mailbox.Quit = 0U;
+	dsb();
+
+	Xil_Out32(FSBL_CPU1_WAKE_ADDR, (u32)FsblCpu1Entry);
+	dsb();
+	sev();
+
+	return FsblCpu1Wait(&Mailbox.Running, 1U, FSBL_CPU1_START_TIMEOUT);
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for a mailbox word written by CPU1.
+*
+* @param	Value is the word to watch
+* @param	Target is the value to wait for
+* @param	Timeout is the longest wait, in global timer ticks
+*
+* @return
+*		- XST_SUCCESS if the word reached Target
+*		- XST_FAILURE on time out
+*
+* @note		The watchdog is restarted while waiting.
+*
+****************************************************************************/
+static u32 FsblCpu1Wait(volatile u32 *Value, u32 Target, XTime Timeout)
+{
+	XTime Start;
+	XTime Now;
+
+	XTime_GetTime(&Start);
+
+	while (*Value != Target) {
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+		/*
+		 * Prevent WDT reset
+		 */
+		XWdtPs_RestartWdt(&Watchdog);
+#endif
+		XTime_GetTime(&Now);
+		if ((Now - Start) > Timeout) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+#endif
@@ -0,0 +1,86 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_cpu1.h
+*
+* Partition validation on CPU1. With FSBL_CPU1_VALIDATE defined, the FSBL
+* wakes CPU1 out of the Boot ROM wait loop and hands it the checksum (MD5)
+* and, with RSA_SUPPORT, the SHA-256 of each plain PS partition, while CPU0
+* goes on to move the next partition. CPU0 collects the results before the
+* handoff and parks CPU1 back in the Boot ROM loop, so the application can
+* start it the usual way through 0xFFFFFFF0.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.0	xl	10/19/26	Initial release
+* 21.0	xl	10/19/26	The mailbox has cache lines of its own
+*
+* </pre>
+*
+* @note
+*
+* The two CPUs share a mailbox in the FSBL data, a list of jobs that CPU0
+* fills and CPU1 works through in order. CPU1 runs with the D-cache off.
+* CPU0 turns its D-cache and the L2 on while it moves, inflates or
+* authenticates a partition, and CPU1 may be running then. The mailbox is
+* therefore aligned and padded to whole cache lines, so that no other
+* variable shares a line with it. CPU0 only touches the mailbox with its
+* D-cache off, so it never holds a dirty copy, and no clean or flush of a
+* neighbouring variable can write a stale copy over what CPU1 stored.
+*
+******************************************************************************/
+#ifndef FSBL_CPU1_H_
+#define FSBL_CPU1_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Boot ROM wait loop of CPU1: CPU1 waits in WFE at FSBL_CPU1_ROM_LOOP until
+ * FSBL_CPU1_WAKE_ADDR holds an address, then jumps to it
+ */
+#define FSBL_CPU1_ROM_LOOP		0xFFFFFE00U
+#define FSBL_CPU1_WAKE_ADDR		0xFFFFFFF0U
+
+#define FSBL_CPU1_MAX_JOBS		14U	/**< MAX_PARTITION_NUMBER */
+
+/*
+ * Job types
+ */
+#define FSBL_CPU1_JOB_MD5		1U	/**< md5(), compared with Expected */
+#define FSBL_CPU1_JOB_SHA256		2U	/**< sha_256(), checked by CPU0 */
+
+/**************************** Type Definitions *******************************/
+
+/************************** Function Prototypes ******************************/
+
+u32 FsblCpu1Available(void);
+u32 FsblCpu1Submit(u32 Type, u32 PartitionNum, u32 Address, u32 Length,
+		const u8 *Expected, u32 AcAddress);
+u32 FsblCpu1Finish(u32 *FailStatus);
+
+/*
+ * CPU1 side, entered from fsbl_cpu1_entry.S
+ */
+void FsblCpu1Main(void);
+void FsblCpu1Entry(void);
+void FsblCpu1Park(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* end of protection macro */
@@ -0,0 +1,243 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_profile.c
+*
+* Boot profile of the FSBL. See fsbl_profile.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.0	xl	10/19/26	Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "xtime_l.h"
+#include "fsbl_profile.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Returned by FsblProfileStart() when the table is full; FsblProfileEnd()
+ * ignores it
+ */
+#define FSBL_PROFILE_NO_ENTRY		0xFFFFFFFFU
+
+/************************** Variable Definitions *****************************/
+
+/*
+ * The table, placed at FSBL_PROFILE_BASEADDR by lscript.ld
+ */
+static FsblProfile BootProfile __attribute__((section(".boot_profile")));
+
+static u32 CurrentPartition = FSBL_PROFILE_NO_PARTITION;
+
+/******************************************************************************/
+/**
+*
+* This function clears the profile table. It must be called first in main(),
+* before ps7_init().
+*
+* @param	None
+*
+* @return	None
+*
+* @note		OCM keeps its contents over a soft reset, so the magic number
+*		of the previous boot is cleared first and only written back by
+*		FsblProfileFinish().
+*
+****************************************************************************/
+void FsblProfileInit(void)
+{
+	BootProfile.Magic = 0U;
+	BootProfile.Version = FSBL_PROFILE_VERSION;
+	BootProfile.Count = 0U;
+	BootProfile.TicksPerSecond = COUNTS_PER_SECOND;
+	BootProfile.BootMode = 0U;
+	BootProfile.HandoffAddr = 0U;
+	BootProfile.HandoffTicks = 0U;
+
+	CurrentPartition = FSBL_PROFILE_NO_PARTITION;
+}
+
+/******************************************************************************/
+/**
+*
+* This function sets the partition recorded with the following stages.
+*
+* @param	PartitionNum is the partition being loaded, or
+*		FSBL_PROFILE_NO_PARTITION
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void FsblProfileSetPartition(u32 PartitionNum)
+{
+	CurrentPartition = PartitionNum;
+}
+
+/******************************************************************************/
+/**
+*
+* This function opens a profile entry.
+*
+* @param	Stage is one of FSBL_PROF_*
+*
+* @return	Entry number to pass to FsblProfileEnd()
+*
+* @note		Stages past FSBL_PROFILE_MAX_ENTRIES are not recorded.
+*
+****************************************************************************/
+u32 FsblProfileStart(u32 Stage)
+{
+	FsblProfileEntry *EntryPtr;
+	XTime Now;
+	u32 EntryNum;
+
+	EntryNum = BootProfile.Count;
+	if (EntryNum >= FSBL_PROFILE_MAX_ENTRIES) {
+		return FSBL_PROFILE_NO_ENTRY;
+	}
+
+	EntryPtr = &BootProfile.Entry[EntryNum];
+	EntryPtr->Stage = Stage;
+	EntryPtr->Partition = CurrentPartition;
+	EntryPtr->Bytes = 0U;
+	EntryPtr->Result = 0U;
+	EntryPtr->EndTicks = 0U;
+
+	XTime_GetTime(&Now);
+	EntryPtr->StartTicks = Now;
+
+	BootProfile.Count = EntryNum + 1U;
+
+	return EntryNum;
+}
+
+/******************************************************************************/
+/**
+*
+* This function closes a profile entry.
+*
+* @param	EntryNum is the value returned by FsblProfileStart()
+* @param	Bytes is the amount of data handled by the stage, or 0
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void FsblProfileEnd(u32 EntryNum, u32 Bytes)
+{
+	XTime Now;
+
+	if (EntryNum >= FSBL_PROFILE_MAX_ENTRIES) {
+		return;
+	}
+
+	XTime_GetTime(&Now);
+	BootProfile.Entry[EntryNum].EndTicks = Now;
+	BootProfile.Entry[EntryNum].Bytes = Bytes;
+}
+
+/******************************************************************************/
+/**
+*
+* This function stores the result code of a stage, such as that of the DDR
+* test.
+*
+* @param	EntryNum is the value returned by FsblProfileStart()
+* @param	Result is the result code
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void FsblProfileSetResult(u32 EntryNum, u32 Result)
+{
+	if (EntryNum >= FSBL_PROFILE_MAX_ENTRIES) {
+		return;
+	}
+
+	BootProfile.Entry[EntryNum].Result = Result;
+}
+
+/******************************************************************************/
+/**
+*
+* This function adds a complete entry timed elsewhere, such as a stage that
+* ran on CPU1.
+*
+* @param	Stage is one of FSBL_PROF_*
+* @param	PartitionNum is the partition, or FSBL_PROFILE_NO_PARTITION
+* @param	Bytes is the amount of data handled by the stage, or 0
+* @param	StartTicks is the global timer at stage start
+* @param	EndTicks is the global timer at stage end
+*
+* @return	None
+*
+* @note		Entries past FSBL_PROFILE_MAX_ENTRIES are not recorded.
+*
+****************************************************************************/
+void FsblProfileRecord(u32 Stage, u32 PartitionNum, u32 Bytes,
+		u64 StartTicks, u64 EndTicks)
+{
+	FsblProfileEntry *EntryPtr;
+
+	if (BootProfile.Count >= FSBL_PROFILE_MAX_ENTRIES) {
+		return;
+	}
+
+	EntryPtr = &BootProfile.Entry[BootProfile.Count];
+	EntryPtr->Stage = Stage;
+	EntryPtr->Partition = PartitionNum;
+	EntryPtr->Bytes = Bytes;
+	EntryPtr->Result = 0U;
+	EntryPtr->StartTicks = StartTicks;
+	EntryPtr->EndTicks = EndTicks;
+
+	BootProfile.Count++;
+}
+
+/******************************************************************************/
+/**
+*
+* This function completes the table just before the handoff.
+*
+* @param	HandoffAddr is the application entry, 0 for the JTAG exit
+*
+* @return	None
+*
+* @note		The application only trusts the table once the magic number
+*		is set, so it is written last, after a barrier.
+*
+****************************************************************************/
+void FsblProfileFinish(u32 HandoffAddr)
+{
+	XTime Now;
+
+	BootProfile.BootMode = Xil_In32(BOOT_MODE_REG) & BOOT_MODES_MASK;
+	BootProfile.HandoffAddr = HandoffAddr;
+
+	XTime_GetTime(&Now);
+	BootProfile.HandoffTicks = Now;
+
+	dsb();
+	BootProfile.Magic = FSBL_PROFILE_MAGIC;
+	dsb();
+}
@@ -0,0 +1,116 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_profile.h
+*
+* Boot profile of the FSBL. Every boot stage is timed with the global timer
+* and recorded in a table in the top of OCM, which is left in place at
+* handoff so the application can read and print it.
+*
+* The table layout is shared with the application (boot_profile.h in the
+* application sources); keep the two in step and bump
+* FSBL_PROFILE_VERSION when it changes.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.0	xl	10/19/26	Initial release
+*
+* </pre>
+*
+* @note
+*
+* The global timer is started by the BSP start-up code before main(), so the
+* ticks count from FSBL entry. ps7_init() reprograms the CPU PLL, and with it
+* the global timer clock, so the PS7_INIT stage is only approximate.
+*
+******************************************************************************/
+#ifndef FSBL_PROFILE_H_
+#define FSBL_PROFILE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Table location, the .boot_profile region of lscript.ld. It is above the
+ * FSBL stacks and below the Boot ROM area at 0xFFFFFE00.
+ */
+#define FSBL_PROFILE_BASEADDR		0xFFFFFA00U
+#define FSBL_PROFILE_MAGIC		0x464F5250U	/* "PROF" */
+#define FSBL_PROFILE_VERSION		1U
+#define FSBL_PROFILE_MAX_ENTRIES	24U
+
+#define FSBL_PROFILE_NO_PARTITION	0xFFFFFFFFU
+
+/*
+ * Boot stages
+ */
+#define FSBL_PROF_PS7_INIT		1U	/**< ps7_init(): MIO, PLL, DDR */
+#define FSBL_PROF_DDR_CHECK		2U	/**< DDRInitCheck() */
+#define FSBL_PROF_PCAP_INIT		3U	/**< InitPcap() */
+#define FSBL_PROF_FLASH_INIT		4U	/**< InitQspi/InitNand/InitSD... */
+#define FSBL_PROF_HEADER		5U	/**< Partition header read */
+#define FSBL_PROF_MOVE			6U	/**< MoveImage() of a partition */
+#define FSBL_PROF_PCAP_XFER		7U	/**< PCAP copy/decrypt to DDR */
+#define FSBL_PROF_PCAP_LOAD		8U	/**< Bitstream download */
+#define FSBL_PROF_MD5			9U	/**< Partition checksum */
+#define FSBL_PROF_AUTH			10U	/**< RSA authentication */
+#define FSBL_PROF_DECRYPT		11U	/**< PS partition decryption */
+#define FSBL_PROF_LOAD_IMAGE		12U	/**< LoadBootImage(), all partitions */
+#define FSBL_PROF_HANDOFF		13U	/**< FsblHandoff() up to the jump */
+#define FSBL_PROF_STREAM		14U	/**< Bitstream read and download, overlapped */
+#define FSBL_PROF_CPU1_MD5		15U	/**< Partition checksum on CPU1 */
+#define FSBL_PROF_CPU1_SHA		16U	/**< Partition SHA-256 on CPU1 */
+#define FSBL_PROF_CPU1_WAIT		17U	/**< CPU0 waiting for CPU1 */
+#define FSBL_PROF_INFLATE		18U	/**< Compressed partition read and load */
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Stage;		/**< FSBL_PROF_* */
+	u32 Partition;		/**< Partition number or FSBL_PROFILE_NO_PARTITION */
+	u32 Bytes;		/**< Bytes handled by the stage, 0 if none */
+	u32 Result;		/**< Result code of the stage, 0 if none */
+	u64 StartTicks;		/**< Global timer at stage start */
+	u64 EndTicks;		/**< Global timer at stage end, 0 if open */
+} FsblProfileEntry;
+
+typedef struct {
+	u32 Magic;		/**< FSBL_PROFILE_MAGIC once the table is complete */
+	u32 Version;		/**< FSBL_PROFILE_VERSION */
+	u32 Count;		/**< Valid entries */
+	u32 TicksPerSecond;	/**< Global timer frequency */
+	u32 BootMode;		/**< BOOT_MODE_REG & BOOT_MODES_MASK */
+	u32 HandoffAddr;	/**< Application entry, 0 for JTAG exit */
+	u64 HandoffTicks;	/**< Global timer just before the jump */
+	FsblProfileEntry Entry[FSBL_PROFILE_MAX_ENTRIES];
+} FsblProfile;
+
+/************************** Function Prototypes ******************************/
+
+void FsblProfileInit(void);
+void FsblProfileSetPartition(u32 PartitionNum);
+u32 FsblProfileStart(u32 Stage);
+void FsblProfileEnd(u32 EntryNum, u32 Bytes);
+void FsblProfileSetResult(u32 EntryNum, u32 Result);
+void FsblProfileRecord(u32 Stage, u32 PartitionNum, u32 Bytes,
+		u64 StartTicks, u64 EndTicks);
+void FsblProfileFinish(u32 HandoffAddr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* end of protection macro */
@@ -0,0 +1,232 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file image_dir.c
+*
+* Multiboot image directory checks and image selection, see image_dir.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.0	xl	10/19/26	Initial release
+*
+* </pre>
+*
+* @note
+*
+* None of these functions read flash; the caller reads the two copies and
+* checks the header of the image selected.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include <stddef.h>
+#include "xstatus.h"
+#include "image_dir.h"
+
+/************************** Constant Definitions *****************************/
+
+#define IMAGE_DIR_CRC_POLY		0xEDB88320U
+
+/************************** Variable Definitions *****************************/
+
+/*
+ * CRC-32 of each nibble, small enough to keep in the OCM
+ */
+static const u32 ImageDirCrcTable[16] = {
+	0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+	0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+	0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+	0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+};
+
+/******************************************************************************/
+/**
+*
+* This function updates a CRC-32 (IEEE 802.3, reflected polynomial
+* IMAGE_DIR_CRC_POLY) with a buffer.
+*
+* @param	Crc is the CRC so far, 0 to start
+* @param	Data is the buffer
+* @param	Length is the buffer length in bytes
+*
+* @return	The updated CRC
+*
+* @note		None
+*
+*******************************************************************************/
+u32 ImageDirCrc32(u32 Crc, const u8 *Data, u32 Length)
+{
+	u32 Index;
+
+	Crc = ~Crc;
+	for (Index = 0U; Index < Length; Index++) {
+		Crc ^= Data[Index];
+		Crc = (Crc >> 4) ^ ImageDirCrcTable[Crc & 0xFU];
+		Crc = (Crc >> 4) ^ ImageDirCrcTable[Crc & 0xFU];
+	}
+
+	return ~Crc;
+}
+
+/******************************************************************************/
+/**
+*
+* This function computes the CRC of a directory copy, over all of it but
+* the Crc word.
+*
+* @param	Dir is the directory copy
+*
+* @return	The CRC
+*
+* @note		None
+*
+*******************************************************************************/
+u32 ImageDirCrc(const ImageDir *Dir)
+{
+	u32 Crc;
+
+	Crc = ImageDirCrc32(0U, (const u8 *)Dir, offsetof(ImageDir, Crc));
+	Crc = ImageDirCrc32(Crc, (const u8 *)Dir->Entry, sizeof(Dir->Entry));
+
+	return Crc;
+}
+
+/******************************************************************************/
+/**
+*
+* This function checks a directory copy read from flash.
+*
+* @param	Dir is the directory copy
+*
+* @return
+*		- XST_SUCCESS if the copy is valid
+*		- XST_FAILURE if it is erased, corrupt or has a bad entry
+*
+* @note		None
+*
+*******************************************************************************/
+u32 ImageDirCheck(const ImageDir *Dir)
+{
+	u32 Index;
+
+	if ((Dir->Magic != IMAGE_DIR_MAGIC) ||
+			(Dir->Count > IMAGE_DIR_ENTRIES_MAX) ||
+			(Dir->Crc != ImageDirCrc(Dir))) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0U; Index < Dir->Count; Index++) {
+		if ((Dir->Entry[Index].Offset % IMAGE_DIR_ALIGN) != 0U) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function picks the copy of the directory to use.
+*
+* @param	First is the first copy
+* @param	Second is the second copy
+*
+* @return	The valid copy with the higher sequence, or NULL if neither
+*		is valid
+*
+* @note		The sequence may wrap; a copy is newer when it is less than
+*		half the sequence range ahead of the other.
+*
+*******************************************************************************/
+const ImageDir *ImageDirPick(const ImageDir *First, const ImageDir *Second)
+{
+	u32 FirstValid;
+	u32 SecondValid;
+
+	FirstValid = (ImageDirCheck(First) == XST_SUCCESS);
+	SecondValid = (ImageDirCheck(Second) == XST_SUCCESS);
+
+	if (FirstValid && SecondValid) {
+		if ((s32)(Second->Sequence - First->Sequence) > 0) {
+			return Second;
+		}
+		return First;
+	}
+	if (FirstValid) {
+		return First;
+	}
+	if (SecondValid) {
+		return Second;
+	}
+
+	return NULL;
+}
+
+/******************************************************************************/
+/**
+*
+* This function returns where to start looking for the image to fall back
+* to: the entry after the failed image, or the first entry if the failed
+* image is not in the directory.
+*
+* @param	Dir is the directory
+* @param	FailedOffset is the flash offset of the image that failed
+*
+* @return	The entry index to pass to ImageDirNext()
+*
+* @note		Images before the failed one are not tried again, so a
+*		fallback never loops back to an image that has failed.
+*
+*******************************************************************************/
+u32 ImageDirStart(const ImageDir *Dir, u32 FailedOffset)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < Dir->Count; Index++) {
+		if (((Dir->Entry[Index].Flags & IMAGE_DIR_FLAG_VALID) != 0U) &&
+				(Dir->Entry[Index].Offset == FailedOffset)) {
+			return Index + 1U;
+		}
+	}
+
+	return 0U;
+}
+
+/******************************************************************************/
+/**
+*
+* This function returns the next image to try, from an entry on.
+*
+* @param	Dir is the directory
+* @param	FailedOffset is the flash offset of the image that failed
+* @param	Index is the first entry to consider
+*
+* @return	The index of the first entry from Index on that is valid, not
+*		marked bad and not the failed image, or IMAGE_DIR_NONE
+*
+* @note		None
+*
+*******************************************************************************/
+u32 ImageDirNext(const ImageDir *Dir, u32 FailedOffset, u32 Index)
+{
+	const ImageDirEntry *Entry;
+
+	for (; Index < Dir->Count; Index++) {
+		Entry = &Dir->Entry[Index];
+		if (((Entry->Flags & IMAGE_DIR_FLAG_VALID) != 0U) &&
+				((Entry->Flags & IMAGE_DIR_FLAG_BAD) == 0U) &&
+				(Entry->Offset != FailedOffset)) {
+			return Index;
+		}
+	}
+
+	return IMAGE_DIR_NONE;
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file image_dir.h
+*
+* Multiboot image directory. A table of the boot images in flash, in the
+* order they are to be tried, kept in two copies at a fixed flash offset.
+* On a fallback the FSBL takes the image after the failed one from the
+* directory instead of searching flash for the next image header 32 KB at
+* a time.
+*
+* Each copy is an ImageDir, the second IMAGE_DIR_COPY_OFFSET after the
+* first, in another erase sector. A copy is valid when its magic and CRC-32
+* match; of two valid copies the one with the higher Sequence is used, so
+* the directory can be rewritten one copy at a time.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.0	xl	10/19/26	Initial release
+*
+* </pre>
+*
+* @note
+*
+* The directory is written by the host tool improved/tools/mkimgdir.c. The
+* FSBL only reads it; an image found bad is marked with IMAGE_DIR_FLAG_BAD
+* by the tool, or skipped by the FSBL when its header does not check.
+*
+******************************************************************************/
+#ifndef ___IMAGE_DIR_H___
+#define ___IMAGE_DIR_H___
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Flash offset of the first copy, the last two 64 KB sectors of a 16 MB
+ * QSPI flash by default
+ */
+#ifndef FSBL_IMAGE_DIR_OFFSET
+#define FSBL_IMAGE_DIR_OFFSET		0x00FE0000U
+#endif
+#define IMAGE_DIR_COPY_OFFSET		0x00010000U
+
+#define IMAGE_DIR_MAGIC			0x52494449U	/* "IDIR" */
+#define IMAGE_DIR_ENTRIES_MAX		16U
+#define IMAGE_DIR_ALIGN			0x8000U	/* Multiboot offset unit */
+#define IMAGE_DIR_NONE			0xFFFFFFFFU
+
+/*
+ * Entry flags
+ */
+#define IMAGE_DIR_FLAG_VALID		0x1U	/**< Entry in use */
+#define IMAGE_DIR_FLAG_BAD		0x2U	/**< Image not to be booted */
+#define IMAGE_DIR_FLAG_GOLDEN		0x4U	/**< Golden image */
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Offset;		/**< Flash offset of the boot image */
+	u32 Version;		/**< Image version, informational */
+	u32 Flags;		/**< IMAGE_DIR_FLAG_* */
+	u32 Reserved;
+} ImageDirEntry;
+
+typedef struct {
+	u32 Magic;		/**< IMAGE_DIR_MAGIC */
+	u32 Sequence;		/**< Higher is newer */
+	u32 Count;		/**< Entries in use */
+	u32 Crc;		/**< CRC-32 of the copy with this word left out */
+	ImageDirEntry Entry[IMAGE_DIR_ENTRIES_MAX];
+} ImageDir;
+
+/************************** Function Prototypes ******************************/
+
+u32 ImageDirCrc32(u32 Crc, const u8 *Data, u32 Length);
+u32 ImageDirCrc(const ImageDir *Dir);
+u32 ImageDirCheck(const ImageDir *Dir);
+const ImageDir *ImageDirPick(const ImageDir *First, const ImageDir *Second);
+u32 ImageDirStart(const ImageDir *Dir, u32 FailedOffset);
+u32 ImageDirNext(const ImageDir *Dir, u32 FailedOffset, u32 Index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ___IMAGE_DIR_H___ */
@@ -53,6 +53,16 @@
 *                       which is being used instead of one from DDR.
 *                       Deleted GetImageHeaderAndSignature() and added
 *                       GetNAuthImageHeader()
+* 13.0  xl  10/19/26    Record partition stages in the boot profile table
+*                       Overlap the flash read of a bitstream with its
+*                       PCAP download for non-linear boot devices
+*                       Checksum partitions from non-linear boot devices
+*                       chunk by chunk as they are read, with D-cache on
+*                       Run the MD5 self test before the first checksum
+*                       Validate plain PS partitions on CPU1 while CPU0
+*                       moves the next one (FSBL_CPU1_VALIDATE)
+*                       Decompress LZ4 compressed plain partitions while
+*                       they are read, into the PCAP or to the load address
 *
 * </pre>
 *
@@ -68,7 +78,11 @@
 #include "xreg_cortexa9.h"
 #include "pcap.h"
 #include "fsbl_hooks.h"
+#include "fsbl_profile.h"
 #include "md5.h"
+#include "xil_cache.h"
+#include "fsbl_cpu1.h"
+#include "lz4.h"
 
 #ifdef XPAR_XWDTPS_0_BASEADDR
 #include "xwdtps.h"
@@ -76,7 +90,6 @@
 
 #ifdef RSA_SUPPORT
 #include "rsa.h"
-#include "xil_cache.h"
 #include "xilrsa.h"
 #endif
 /************************** Constant Definitions *****************************/
@@ -85,6 +98,24 @@
 #define MAXIMUM_IMAGE_WORD_LEN 0x40000000
 #define MD5_CHECKSUM_SIZE   16
 
+/*
+ * Bitstreams from non-linear boot devices are read and downloaded in chunks
+ * of this size, alternating between two buffers at DDR_TEMP_START_ADDR
+ */
+#define BITSTREAM_CHUNK_SIZE	0x20000
+
+/*
+ * Checksummed partitions from non-linear boot devices are read and hashed in
+ * chunks of this size, so each chunk is hashed while it is still in L2
+ */
+#define CHECKSUM_CHUNK_SIZE	0x20000
+
+/*
+ * Compressed blocks of a partition are read to a staging buffer of this
+ * size, a block payload and the header of the next block
+ */
+#define INFLATE_STAGING_SIZE	(LZ4_BLOCK_SIZE_MAX + 4U)
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
@@ -93,6 +124,14 @@
 u32 ValidateParition(u32 StartAddr, u32 Length, u32 ChecksumOffset);
 u32 GetPartitionChecksum(u32 ChecksumOffset, u8 *Checksum);
 u32 CalcPartitionChecksum(u32 SourceAddr, u32 DataLength, u8 *Checksum);
+static u32 PartitionStreamBitstream(u32 SourceAddr, u32 Length);
+static u32 PartitionMoveChecksum(u32 SourceAddr, u32 LoadAddr, u32 Length);
+static u32 PartitionInflate(u32 SourceAddr, u32 LoadAddr, u32 Length,
+		const u32 *FrameData);
+#ifdef FSBL_CPU1_VALIDATE
+static void PartitionSubmitCpu1(u32 PartitionNum, u32 StartAddr,
+		u32 Length, u32 ChecksumOffset);
+#endif
 
 /************************** Variable Definitions *****************************/
 /*
@@ -103,6 +142,27 @@ u8 PLPartitionFlag;
 u8 PSPartitionFlag;
 u8 SignedPartitionFlag;
 u8 PartitionChecksumFlag;
+
+/*
+ * MD5 of the partition computed by PartitionMoveChecksum(), used by
+ * ValidateParition() instead of hashing the partition again
+ */
+static u8 PartitionDigest[MD5_CHECKSUM_SIZE];
+static u8 PartitionDigestFlag;
+
+/*
+ * Set once MD5SelfTest() has passed
+ */
+static u8 Md5SelfTestFlag;
+
+/*
+ * PartitionDeferFlag is set before the move of a partition that CPU1 is to
+ * validate; Cpu1ChecksumFlag and Cpu1AuthFlag once CPU1 took the checksum
+ * and the authentication of the partition
+ */
+static u8 PartitionDeferFlag;
+static u8 Cpu1ChecksumFlag;
+static u8 Cpu1AuthFlag;
 u8 BitstreamFlag;
 u8 ApplicationFlag;
 
@@ -157,12 +217,16 @@ u32 LoadBootImage(void)
 	u32 Status;
 	PartHeader *HeaderPtr;
 	u32 EfuseStatusRegValue;
+	u32 ProfEntry;
 #ifdef RSA_SUPPORT
 	u8 Hash[SHA_VALBYTES];
 	u8 *Ac;
 #endif
 #ifndef FORCE_USE_AES_EXCLUDE
 	u32 EncOnly;
+#endif
+#ifdef FSBL_CPU1_VALIDATE
+	u32 FailStatus;
 #endif
 	/*
 	 * Resetting the Flags
@@ -212,7 +276,9 @@ u32 LoadBootImage(void)
 	/*
 	 * Get partitions header information
 	 */
+	ProfEntry = FsblProfileStart(FSBL_PROF_HEADER);
 	Status = GetPartitionHeaderInfo(ImageStartAddress);
+	FsblProfileEnd(ProfEntry, 0);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL, "Partition Header Load Failed\r\n");
 		OutputStatus(GET_HEADER_INFO_FAIL);
@@ -278,6 +344,7 @@ u32 LoadBootImage(void)
 	while (PartitionNum < PartitionCount) {
 
 		fsbl_printf(DEBUG_INFO, "Partition Number: %lu\r\n", PartitionNum);
+		FsblProfileSetPartition(PartitionNum);
 
 		HeaderPtr = &PartitionHeader[PartitionNum];
 
@@ -390,6 +457,23 @@ u32 LoadBootImage(void)
 			SignedPartitionFlag = 0;
 		}
 
+		/*
+		 * Plain PS partitions are validated on CPU1 while CPU0 moves
+		 * the next partition; encrypted and PL partitions must be
+		 * valid before they are used and stay on CPU0
+		 */
+		PartitionDeferFlag = 0;
+		Cpu1ChecksumFlag = 0;
+		Cpu1AuthFlag = 0;
+#ifdef FSBL_CPU1_VALIDATE
+		if ((PSPartitionFlag == 1) && (EncryptedPartitionFlag == 0) &&
+				((PartitionChecksumFlag == 1) ||
+						(SignedPartitionFlag == 1)) &&
+				(FsblCpu1Available() == TRUE)) {
+			PartitionDeferFlag = 1;
+		}
+#endif
+
 		/*
 		 * Load address check
 		 * Loop will break when PS load address zero and partition is
@@ -456,14 +540,26 @@ u32 LoadBootImage(void)
 				PartitionStartAddr = PartitionLoadAddr;
 			}
 
-			if (PartitionChecksumFlag) {
+#ifdef FSBL_CPU1_VALIDATE
+			if (PartitionDeferFlag) {
+				PartitionSubmitCpu1(PartitionNum, PartitionStartAddr,
+						(PartitionTotalSize << WORD_LENGTH_SHIFT),
+						ImageStartAddress  +
+						(PartitionChecksumOffset << WORD_LENGTH_SHIFT));
+			}
+#endif
+
+			if (PartitionChecksumFlag && (!Cpu1ChecksumFlag)) {
 				/*
 				 * Validate the partition data with checksum
 				 */
+				ProfEntry = FsblProfileStart(FSBL_PROF_MD5);
 				Status = ValidateParition(PartitionStartAddr,
 						(PartitionTotalSize << WORD_LENGTH_SHIFT),
 						ImageStartAddress  +
 						(PartitionChecksumOffset << WORD_LENGTH_SHIFT));
+				FsblProfileEnd(ProfEntry,
+						PartitionTotalSize << WORD_LENGTH_SHIFT);
 				if (Status != XST_SUCCESS) {
 					fsbl_printf(DEBUG_GENERAL,"PARTITION_CHECKSUM_FAIL\r\n");
 					OutputStatus(PARTITION_CHECKSUM_FAIL);
@@ -476,8 +572,9 @@ u32 LoadBootImage(void)
 			/*
 			 * Authentication Partition
 			 */
-			if (SignedPartitionFlag == 1 ) {
+			if ((SignedPartitionFlag == 1) && (!Cpu1AuthFlag)) {
 #ifdef RSA_SUPPORT
+				ProfEntry = FsblProfileStart(FSBL_PROF_AUTH);
 				Xil_DCacheEnable();
 				sha_256((u8 *)PartitionStartAddr,
 						((PartitionTotalSize << WORD_LENGTH_SHIFT) -
@@ -499,6 +596,8 @@ u32 LoadBootImage(void)
 				fsbl_printf(DEBUG_INFO,"Authentication Done\r\n");
 				Xil_DCacheFlush();
                 Xil_DCacheDisable();
+				FsblProfileEnd(ProfEntry,
+						PartitionTotalSize << WORD_LENGTH_SHIFT);
 #else
 				/*
 				 * In case user not enabled RSA authentication feature
@@ -513,9 +612,12 @@ u32 LoadBootImage(void)
 			 * Decrypt PS partition
 			 */
 			if (EncryptedPartitionFlag && PSPartitionFlag) {
+				ProfEntry = FsblProfileStart(FSBL_PROF_DECRYPT);
 				Status = DecryptPartition(PartitionStartAddr,
 						PartitionDataLength,
 						PartitionImageLength);
+				FsblProfileEnd(ProfEntry,
+						PartitionImageLength << WORD_LENGTH_SHIFT);
 				if (Status != XST_SUCCESS) {
 					fsbl_printf(DEBUG_GENERAL,"DECRYPTION_FAIL\r\n");
 					OutputStatus(DECRYPTION_FAIL);
@@ -527,11 +629,14 @@ u32 LoadBootImage(void)
 			 * Load Signed PL partition in Fabric
 			 */
 			if (PLPartitionFlag) {
+				ProfEntry = FsblProfileStart(FSBL_PROF_PCAP_LOAD);
 				Status = PcapLoadPartition((u32*)PartitionStartAddr,
 						(u32*)PartitionLoadAddr,
 						PartitionImageLength,
 						PartitionDataLength,
 						EncryptedPartitionFlag);
+				FsblProfileEnd(ProfEntry,
+						PartitionImageLength << WORD_LENGTH_SHIFT);
 				if (Status != XST_SUCCESS) {
 					fsbl_printf(DEBUG_GENERAL,"BITSTREAM_DOWNLOAD_FAIL\r\n");
 					OutputStatus(BITSTREAM_DOWNLOAD_FAIL);
@@ -558,6 +663,22 @@ u32 LoadBootImage(void)
 		PartitionNum++;
 	}
 
+#ifdef FSBL_CPU1_VALIDATE
+	/*
+	 * Collect the partitions validated on CPU1 before the handoff
+	 */
+	ProfEntry = FsblProfileStart(FSBL_PROF_CPU1_WAIT);
+	Status = FsblCpu1Finish(&FailStatus);
+	FsblProfileEnd(ProfEntry, 0);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"CPU1_VALIDATION_FAIL\r\n");
+		OutputStatus(FailStatus);
+		FsblFallback();
+	}
+#endif
+
+	FsblProfileSetPartition(FSBL_PROFILE_NO_PARTITION);
+
 	return ExecAddress;
 }
 
@@ -1086,6 +1207,22 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
     u32 LoadAddr;
     u32 ImageWordLen;
     u32 DataWordLen;
+    u32 ProfEntry;
+    u32 FrameData[(LZ4_FRAME_HEADER_SIZE >> WORD_LENGTH_SHIFT) + 1];
+
+	PartitionDigestFlag = 0;
+
+	/*
+	 * Check the MD5 code against known answers before the first
+	 * checksummed partition
+	 */
+	if (PartitionChecksumFlag && (Md5SelfTestFlag == 0)) {
+		if (MD5SelfTest() != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "MD5 Self Test Failed\r\n");
+			return XST_FAILURE;
+		}
+		Md5SelfTestFlag = 1;
+	}
 
 	SourceAddr = ImageBaseAddress;
 	SourceAddr += Header->PartitionStart<<WORD_LENGTH_SHIFT;
@@ -1093,6 +1230,39 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 	ImageWordLen = Header->ImageWordLen;
 	DataWordLen = Header->DataWordLen;
 
+	/*
+	 * A plain partition may be LZ4 compressed; it is then decompressed
+	 * while it is read. The frame header and the first block header are
+	 * read through MoveImage(), which adds the flash base address itself
+	 */
+	if ((!(SignedPartitionFlag || PartitionChecksumFlag ||
+			EncryptedPartitionFlag)) &&
+			((ImageWordLen << WORD_LENGTH_SHIFT) >
+				LZ4_FRAME_HEADER_SIZE)) {
+		Status = MoveImage(SourceAddr, (u32)FrameData,
+					sizeof(FrameData));
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+			return XST_FAILURE;
+		}
+
+		if (Lz4FrameCheck((Lz4Frame *)FrameData) == XST_SUCCESS) {
+			ProfEntry = FsblProfileStart(FSBL_PROF_INFLATE);
+			Status = PartitionInflate(SourceAddr, LoadAddr,
+						(ImageWordLen << WORD_LENGTH_SHIFT),
+						FrameData);
+			FsblProfileEnd(ProfEntry,
+					((Lz4Frame *)FrameData)->Length);
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,
+					"Compressed Partition Load Failed\r\n");
+				return XST_FAILURE;
+			}
+
+			return XST_SUCCESS;
+		}
+	}
+
 	/*
 	 * Add flash base address for linear boot devices
 	 */
@@ -1126,6 +1296,25 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 		SecureTransferFlag = 0;
 	}
 
+	/*
+	 * A plain bitstream from a non-linear boot device is downloaded while
+	 * it is read, instead of being copied to DDR first
+	 */
+	if ((!LinearBootDeviceFlag) && PLPartitionFlag &&
+			(!(SignedPartitionFlag || PartitionChecksumFlag ||
+			   EncryptedPartitionFlag))) {
+		ProfEntry = FsblProfileStart(FSBL_PROF_STREAM);
+		Status = PartitionStreamBitstream(SourceAddr,
+					(ImageWordLen << WORD_LENGTH_SHIFT));
+		FsblProfileEnd(ProfEntry, ImageWordLen << WORD_LENGTH_SHIFT);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "PCAP Bitstream Download Failed\r\n");
+			return XST_FAILURE;
+		}
+
+		return XST_SUCCESS;
+	}
+
 	/*
 	 * CPU is used for data transfer in case of non-linear
 	 * boot device
@@ -1138,9 +1327,17 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 			LoadAddr = DDR_TEMP_START_ADDR;
 		}
 
-		Status = MoveImage(SourceAddr,
+		ProfEntry = FsblProfileStart(FSBL_PROF_MOVE);
+		if (PartitionChecksumFlag && (!PartitionDeferFlag)) {
+			Status = PartitionMoveChecksum(SourceAddr,
 						LoadAddr,
 						(ImageWordLen << WORD_LENGTH_SHIFT));
+		} else {
+			Status = MoveImage(SourceAddr,
+						LoadAddr,
+						(ImageWordLen << WORD_LENGTH_SHIFT));
+		}
+		FsblProfileEnd(ProfEntry, ImageWordLen << WORD_LENGTH_SHIFT);
 		if(Status != XST_SUCCESS) {
 			fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
 			return XST_FAILURE;
@@ -1168,11 +1365,13 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 		/*
 		 * Data transfer using PCAP
 		 */
+		ProfEntry = FsblProfileStart(FSBL_PROF_PCAP_XFER);
 		Status = PcapDataTransfer((u32*)SourceAddr,
 						(u32*)LoadAddr,
 						ImageWordLen,
 						DataWordLen,
 						SecureTransferFlag);
+		FsblProfileEnd(ProfEntry, ImageWordLen << WORD_LENGTH_SHIFT);
 		if(Status != XST_SUCCESS) {
 			fsbl_printf(DEBUG_GENERAL, "PCAP Data Transfer Failed\r\n");
 			return XST_FAILURE;
@@ -1189,11 +1388,14 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 	 * if checksum and authentication bits are not set
 	 */
 	if (PLPartitionFlag && (!(SignedPartitionFlag || PartitionChecksumFlag))) {
+		ProfEntry = FsblProfileStart(FSBL_PROF_PCAP_LOAD);
 		Status = PcapLoadPartition((u32*)SourceAddr,
 					(u32*)Header->LoadAddr,
 					Header->ImageWordLen,
 					Header->DataWordLen,
 					EncryptedPartitionFlag);
+		FsblProfileEnd(ProfEntry,
+				Header->ImageWordLen << WORD_LENGTH_SHIFT);
 		if(Status != XST_SUCCESS) {
 			fsbl_printf(DEBUG_GENERAL, "PCAP Bitstream Download Failed\r\n");
 			return XST_FAILURE;
@@ -1204,6 +1406,349 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 }
 
 
+/******************************************************************************/
+/**
+*
+* This function reads a bitstream from the boot device and downloads it to
+* the fabric in chunks, with two buffers: the PCAP DMA takes chunk N from
+* one while MoveImage() reads chunk N+1 into the other, so the download
+* takes about the longer of the read and the configuration instead of their
+* sum.
+*
+* @param	SourceAddr is the bitstream address in the boot device
+* @param	Length is the bitstream length in bytes, a multiple of 4
+*
+* @return
+*		- XST_SUCCESS if the fabric is configured
+*		- XST_FAILURE if a read or the download failed
+*
+* @note		None
+*
+*******************************************************************************/
+static u32 PartitionStreamBitstream(u32 SourceAddr, u32 Length)
+{
+	u32 Buffer[2];
+	u32 BufferIndex = 0;
+	u32 Offset = 0;
+	u32 ChunkLength;
+	u32 Status;
+
+	Buffer[0] = DDR_TEMP_START_ADDR;
+	Buffer[1] = DDR_TEMP_START_ADDR + BITSTREAM_CHUNK_SIZE;
+
+	Status = PcapStreamStart();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	while (Offset < Length) {
+		ChunkLength = Length - Offset;
+		if (ChunkLength > BITSTREAM_CHUNK_SIZE) {
+			ChunkLength = BITSTREAM_CHUNK_SIZE;
+		}
+
+		/*
+		 * The buffer was last used two chunks ago; PcapStreamChunk()
+		 * has waited for that chunk before queuing the previous one
+		 */
+		Status = MoveImage(SourceAddr + Offset, Buffer[BufferIndex],
+					ChunkLength);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+			(void)PcapStreamFinish();
+			return XST_FAILURE;
+		}
+
+		Status = PcapStreamChunk((u32 *)Buffer[BufferIndex],
+					ChunkLength >> WORD_LENGTH_SHIFT);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		Offset += ChunkLength;
+		BufferIndex ^= 1;
+	}
+
+	return PcapStreamFinish();
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads a checksummed partition from the boot device in chunks
+* and feeds each chunk to MD5 right after it is read, with D-cache on, so
+* the partition is hashed from cache instead of being read back from DDR
+* once it has been copied. The digest is kept for ValidateParition().
+*
+* @param	SourceAddr is the partition address in the boot device
+* @param	LoadAddr is the DDR address to copy the partition to
+* @param	Length is the partition length in bytes
+*
+* @return
+*		- XST_SUCCESS if the partition was copied and hashed
+*		- XST_FAILURE if a read failed
+*
+* @note		The cache is flushed and disabled again before returning, so
+*		the partition is in DDR for the PCAP and for the handoff.
+*
+*******************************************************************************/
+static u32 PartitionMoveChecksum(u32 SourceAddr, u32 LoadAddr, u32 Length)
+{
+	MD5Context Context;
+	u32 Offset = 0;
+	u32 ChunkLength;
+	u32 Status = XST_SUCCESS;
+
+	MD5Init(&Context);
+
+	Xil_DCacheEnable();
+
+	while (Offset < Length) {
+		ChunkLength = Length - Offset;
+		if (ChunkLength > CHECKSUM_CHUNK_SIZE) {
+			ChunkLength = CHECKSUM_CHUNK_SIZE;
+		}
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+		/*
+		 * Prevent WDT reset
+		 */
+		XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+		Status = MoveImage(SourceAddr + Offset, LoadAddr + Offset,
+					ChunkLength);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+
+		MD5Update(&Context, (u8 *)(LoadAddr + Offset), ChunkLength, 0);
+
+		Offset += ChunkLength;
+	}
+
+	Xil_DCacheFlush();
+	Xil_DCacheDisable();
+
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	MD5Final(&Context, PartitionDigest, 0);
+	PartitionDigestFlag = 1;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function loads a LZ4 compressed partition, see lz4.h. Each block is
+* read to a staging buffer together with the header of the next block, and
+* decompressed with the D-cache on.
+*
+* A bitstream is decompressed into the two PCAP buffers of
+* PartitionStreamBitstream() in turn, and each block goes to the PCAP while
+* the next one is read and decompressed. A PS partition is decompressed to
+* its load address.
+*
+* @param	SourceAddr is the partition offset in the boot image
+* @param	LoadAddr is the load address of a PS partition
+* @param	Length is the compressed partition length in bytes
+* @param	FrameData is the frame header and the first block header
+*
+* @return
+*		- XST_SUCCESS if the partition was loaded
+*		- XST_FAILURE if a read, the data or the download failed
+*
+* @note		The staging buffer of a PS partition is at
+*		DDR_TEMP_START_ADDR, or right after the partition when the
+*		partition covers DDR_TEMP_START_ADDR.
+*
+*******************************************************************************/
+static u32 PartitionInflate(u32 SourceAddr, u32 LoadAddr, u32 Length,
+		const u32 *FrameData)
+{
+	const Lz4Frame *Frame = (const Lz4Frame *)FrameData;
+	u32 Buffer[2];
+	u32 BufferIndex = 0;
+	u32 Staging;
+	u32 Offset = LZ4_FRAME_HEADER_SIZE + 4U;
+	u32 Output = 0;
+	u32 BlockHeader;
+	u32 PayloadLength;
+	u32 ReadLength;
+	u32 BlockLength;
+	u32 Produced;
+	u32 Destination;
+	u32 Status = XST_SUCCESS;
+
+	if (PLPartitionFlag) {
+		if ((Frame->Length & 0x3U) != 0U) {
+			return XST_FAILURE;
+		}
+		Buffer[0] = DDR_TEMP_START_ADDR;
+		Buffer[1] = DDR_TEMP_START_ADDR + BITSTREAM_CHUNK_SIZE;
+		Staging = DDR_TEMP_START_ADDR + (2U * BITSTREAM_CHUNK_SIZE);
+
+		Status = PcapStreamStart();
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	} else {
+		Staging = DDR_TEMP_START_ADDR;
+		if ((LoadAddr < (DDR_TEMP_START_ADDR + INFLATE_STAGING_SIZE)) &&
+				((LoadAddr + Frame->Length) > DDR_TEMP_START_ADDR)) {
+			Staging = (LoadAddr + Frame->Length + 0x1FU) & ~0x1FU;
+		}
+	}
+
+	Xil_DCacheEnable();
+
+	BlockHeader = FrameData[LZ4_FRAME_HEADER_SIZE >> WORD_LENGTH_SHIFT];
+	while (BlockHeader != 0U) {
+		PayloadLength = BlockHeader & LZ4_BLOCK_LENGTH_MASK;
+		ReadLength = ((PayloadLength + 3U) & ~3U) + 4U;
+		BlockLength = Frame->Length - Output;
+		if (BlockLength > Frame->BlockSize) {
+			BlockLength = Frame->BlockSize;
+		}
+		if ((PayloadLength == 0U) || (BlockLength == 0U) ||
+				(PayloadLength > Frame->BlockSize) ||
+				(ReadLength > (Length - Offset))) {
+			fsbl_printf(DEBUG_GENERAL, "Invalid Compressed Block\r\n");
+			Status = XST_FAILURE;
+			break;
+		}
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+		/*
+		 * Prevent WDT reset
+		 */
+		XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+		Status = MoveImage(SourceAddr + Offset, Staging, ReadLength);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+			break;
+		}
+
+		/*
+		 * The buffer of a bitstream was last used two blocks ago;
+		 * PcapStreamChunk() has waited for that block before queuing
+		 * the previous one
+		 */
+		if (PLPartitionFlag) {
+			Destination = Buffer[BufferIndex];
+		} else {
+			Destination = LoadAddr + Output;
+		}
+
+		if ((BlockHeader & LZ4_BLOCK_RAW) != 0U) {
+			Produced = PayloadLength;
+			if (Produced == BlockLength) {
+				(void)memcpy((void *)Destination,
+						(const void *)Staging, Produced);
+			}
+		} else {
+			Status = Lz4DecompressBlock((const u8 *)Staging,
+						PayloadLength, (u8 *)Destination,
+						BlockLength, &Produced);
+		}
+		if ((Status != XST_SUCCESS) || (Produced != BlockLength)) {
+			fsbl_printf(DEBUG_GENERAL, "Invalid Compressed Block\r\n");
+			Status = XST_FAILURE;
+			break;
+		}
+
+		if (PLPartitionFlag) {
+			Xil_DCacheFlushRange(Destination, BlockLength);
+			Status = PcapStreamChunk((u32 *)Destination,
+					BlockLength >> WORD_LENGTH_SHIFT);
+			if (Status != XST_SUCCESS) {
+				break;
+			}
+			BufferIndex ^= 1;
+		}
+
+		Output += BlockLength;
+		Offset += ReadLength;
+		BlockHeader = Xil_In32(Staging + ReadLength - 4U);
+	}
+
+	if ((Status == XST_SUCCESS) && (Output != Frame->Length)) {
+		fsbl_printf(DEBUG_GENERAL, "Invalid Compressed Length\r\n");
+		Status = XST_FAILURE;
+	}
+
+	Xil_DCacheFlush();
+	Xil_DCacheDisable();
+
+	if (PLPartitionFlag) {
+		if (PcapStreamFinish() != XST_SUCCESS) {
+			Status = XST_FAILURE;
+		}
+	}
+
+	return Status;
+}
+
+#ifdef FSBL_CPU1_VALIDATE
+/******************************************************************************/
+/**
+*
+* This function hands the checksum and the authentication of a partition
+* already in DDR to CPU1, and sets Cpu1ChecksumFlag and Cpu1AuthFlag for what
+* CPU1 took. What CPU1 did not take is validated by the caller as before.
+*
+* @param	PartitionNum is the partition number
+* @param	StartAddr is the partition in DDR
+* @param	Length is the partition length in bytes, signature included
+* @param	ChecksumOffset is the checksum offset in the boot image
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void PartitionSubmitCpu1(u32 PartitionNum, u32 StartAddr,
+		u32 Length, u32 ChecksumOffset)
+{
+	u8 Checksum[MD5_CHECKSUM_SIZE];
+	u32 Status;
+
+	if (PartitionChecksumFlag) {
+		/*
+		 * The expected checksum is read here, CPU1 does not touch
+		 * the boot device
+		 */
+		Status = GetPartitionChecksum(ChecksumOffset, Checksum);
+		if (Status != XST_SUCCESS) {
+			return;
+		}
+
+		Status = FsblCpu1Submit(FSBL_CPU1_JOB_MD5, PartitionNum,
+				StartAddr, Length, Checksum, 0U);
+		if (Status != XST_SUCCESS) {
+			return;
+		}
+		Cpu1ChecksumFlag = 1;
+	}
+
+#ifdef RSA_SUPPORT
+	if (SignedPartitionFlag) {
+		Status = FsblCpu1Submit(FSBL_CPU1_JOB_SHA256, PartitionNum,
+				StartAddr, Length - RSA_PARTITION_SIGNATURE_SIZE,
+				NULL, StartAddr + Length - RSA_SIGNATURE_SIZE);
+		if (Status == XST_SUCCESS) {
+			Cpu1AuthFlag = 1;
+		}
+	}
+#endif
+}
+#endif
+
 /******************************************************************************/
 /**
 *
@@ -1286,11 +1831,17 @@ u32 ValidateParition(u32 StartAddr, u32 Length, u32 ChecksumOffset)
     fsbl_printf(DEBUG_INFO, "\r\n");
 
     /*
-     * Calculate checksum for the partition
+     * Calculate checksum for the partition, unless it was calculated
+     * while the partition was read
      */
-    Status = CalcPartitionChecksum(StartAddr, Length, &CalcChecksum[0]);
-	if(Status != XST_SUCCESS) {
-        return XST_FAILURE;
+    if (PartitionDigestFlag) {
+        memcpy(CalcChecksum, PartitionDigest, MD5_CHECKSUM_SIZE);
+        PartitionDigestFlag = 0;
+    } else {
+        Status = CalcPartitionChecksum(StartAddr, Length, &CalcChecksum[0]);
+        if(Status != XST_SUCCESS) {
+            return XST_FAILURE;
+        }
     }
 
     fsbl_printf(DEBUG_INFO, "Calculated checksum\r\n");
@@ -1363,9 +1914,13 @@ u32 GetPartitionChecksum(u32 ChecksumOffset, u8 *Checksum)
 u32 CalcPartitionChecksum(u32 SourceAddr, u32 DataLength, u8 *Checksum)
 {
 	/*
-	 * Calculate checksum using MD5 algorithm
+	 * Calculate checksum using MD5 algorithm, with D-cache on so the
+	 * partition is not read word by word from DDR
 	 */
+	Xil_DCacheEnable();
 	md5((u8*)SourceAddr, DataLength, Checksum, 0 );
+	Xil_DCacheFlush();
+	Xil_DCacheDisable();
 
     return XST_SUCCESS;
 }
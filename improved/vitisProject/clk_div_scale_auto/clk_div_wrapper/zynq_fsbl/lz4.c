@@ -0,0 +1,206 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file lz4.c
+*
+* LZ4 block decompression for compressed partitions, see lz4.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.0	xl	10/19/26	Initial release
+*
+* </pre>
+*
+* @note
+*
+* The decompressor checks every length and offset against the source and
+* destination buffers, so a corrupt partition fails instead of writing
+* outside the buffer it was given.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include <string.h>
+#include "xstatus.h"
+#include "lz4.h"
+
+/************************** Constant Definitions *****************************/
+
+#define LZ4_MIN_MATCH		4U
+#define LZ4_RUN_MASK		0xFU
+
+/************************** Function Prototypes ******************************/
+
+static u32 Lz4ReadLength(const u8 **Input, const u8 *InputEnd, u32 *Length);
+
+/******************************************************************************/
+/**
+*
+* This function checks the frame header of a partition.
+*
+* @param	Frame is the first LZ4_FRAME_HEADER_SIZE bytes of the partition
+*
+* @return
+*		- XST_SUCCESS if the partition is a compressed partition
+*		- XST_FAILURE otherwise
+*
+* @note		None
+*
+*******************************************************************************/
+u32 Lz4FrameCheck(const Lz4Frame *Frame)
+{
+	if ((Frame->Magic != LZ4_FRAME_MAGIC) ||
+			(Frame->Length == 0U) ||
+			(Frame->BlockSize == 0U) ||
+			(Frame->BlockSize > LZ4_BLOCK_SIZE_MAX) ||
+			((Frame->BlockSize & 0x3U) != 0U)) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function decompresses one LZ4 block.
+*
+* @param	Source is the compressed block
+* @param	SourceLength is the compressed block length in bytes
+* @param	Destination is the buffer to decompress to
+* @param	DestinationLength is the buffer length in bytes
+* @param	OutputLength is set to the number of bytes decompressed
+*
+* @return
+*		- XST_SUCCESS if the block was decompressed
+*		- XST_FAILURE if the block is corrupt or does not fit
+*
+* @note		Long runs of one byte, the padding of a bitstream, are
+*		matches at offset 1 and are filled with memset().
+*
+*******************************************************************************/
+u32 Lz4DecompressBlock(const u8 *Source, u32 SourceLength,
+		u8 *Destination, u32 DestinationLength, u32 *OutputLength)
+{
+	const u8 *Input = Source;
+	const u8 *InputEnd = Source + SourceLength;
+	u8 *Output = Destination;
+	u8 *OutputEnd = Destination + DestinationLength;
+	const u8 *Match;
+	u32 Token;
+	u32 Length;
+	u32 Offset;
+	u32 Copy;
+
+	while (Input < InputEnd) {
+		Token = *Input++;
+
+		/*
+		 * Literals
+		 */
+		Length = Token >> 4;
+		if (Length == LZ4_RUN_MASK) {
+			if (Lz4ReadLength(&Input, InputEnd, &Length) != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+		}
+		if ((Length > (u32)(InputEnd - Input)) ||
+				(Length > (u32)(OutputEnd - Output))) {
+			return XST_FAILURE;
+		}
+		(void)memcpy(Output, Input, Length);
+		Input += Length;
+		Output += Length;
+
+		/*
+		 * The last sequence has literals only
+		 */
+		if (Input == InputEnd) {
+			break;
+		}
+
+		/*
+		 * Match
+		 */
+		if ((u32)(InputEnd - Input) < 2U) {
+			return XST_FAILURE;
+		}
+		Offset = (u32)Input[0] | ((u32)Input[1] << 8);
+		Input += 2;
+		if ((Offset == 0U) || (Offset > (u32)(Output - Destination))) {
+			return XST_FAILURE;
+		}
+
+		Length = Token & LZ4_RUN_MASK;
+		if (Length == LZ4_RUN_MASK) {
+			if (Lz4ReadLength(&Input, InputEnd, &Length) != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+		}
+		Length += LZ4_MIN_MATCH;
+		if (Length > (u32)(OutputEnd - Output)) {
+			return XST_FAILURE;
+		}
+
+		Match = Output - Offset;
+		if (Offset == 1U) {
+			(void)memset(Output, *Match, Length);
+			Output += Length;
+		} else {
+			/*
+			 * The match may overlap the output; copy it in pieces
+			 * of at most Offset bytes, which never overlap
+			 */
+			while (Length > 0U) {
+				Copy = (Length < Offset) ? Length : Offset;
+				(void)memcpy(Output, Match, Copy);
+				Output += Copy;
+				Match += Copy;
+				Length -= Copy;
+			}
+		}
+	}
+
+	*OutputLength = (u32)(Output - Destination);
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads the extension bytes of a literal or match length.
+*
+* @param	Input is the read position, advanced past the bytes read
+* @param	InputEnd is the end of the block
+* @param	Length is the length to add the extension bytes to
+*
+* @return
+*		- XST_SUCCESS if the length was read
+*		- XST_FAILURE if the block ends within it
+*
+* @note		None
+*
+*******************************************************************************/
+static u32 Lz4ReadLength(const u8 **Input, const u8 *InputEnd, u32 *Length)
+{
+	u32 Byte;
+
+	do {
+		if ((*Input >= InputEnd) || (*Length > LZ4_BLOCK_SIZE_MAX)) {
+			return XST_FAILURE;
+		}
+		Byte = **Input;
+		(*Input)++;
+		*Length += Byte;
+	} while (Byte == 0xFFU);
+
+	return XST_SUCCESS;
+}
@@ -0,0 +1,82 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file lz4.h
+*
+* LZ4 compressed partitions. bootgen has no compression attribute, so a
+* compressed partition is recognised by its contents: the partition data
+* starts with a Lz4Frame header, followed by blocks of at most BlockSize
+* uncompressed bytes each.
+*
+* Every block starts with a 32-bit word, the payload length in bytes with
+* LZ4_BLOCK_RAW set when the payload is stored uncompressed, followed by the
+* payload padded to a word. A zero word ends the partition. The compressed
+* blocks are LZ4 blocks as described in the LZ4 block format.
+*
+* The partition header lengths are those of the compressed data; the
+* uncompressed length is in the frame header.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.0	xl	10/19/26	Initial release
+*
+* </pre>
+*
+* @note
+*
+* Only plain partitions (not encrypted, signed or checksummed) may be
+* compressed; the checksum and the signature are those of the data in the
+* boot image, and the FSBL would have nothing to check them on.
+*
+******************************************************************************/
+#ifndef ___LZ4_H___
+#define ___LZ4_H___
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#define LZ4_FRAME_MAGIC		0x345A4C46U	/* "FLZ4" */
+#define LZ4_FRAME_HEADER_SIZE	16U
+
+/*
+ * Blocks are decompressed into the 128 KB PCAP buffers of a bitstream, so
+ * they can be no larger
+ */
+#define LZ4_BLOCK_SIZE_MAX	0x20000U
+
+#define LZ4_BLOCK_RAW		0x80000000U	/* Payload stored uncompressed */
+#define LZ4_BLOCK_LENGTH_MASK	0x7FFFFFFFU
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Magic;		/**< LZ4_FRAME_MAGIC */
+	u32 Length;		/**< Uncompressed length in bytes */
+	u32 BlockSize;		/**< Uncompressed bytes per block */
+	u32 Reserved;
+} Lz4Frame;
+
+/************************** Function Prototypes ******************************/
+
+u32 Lz4FrameCheck(const Lz4Frame *Frame);
+u32 Lz4DecompressBlock(const u8 *Source, u32 SourceLength,
+		u8 *Destination, u32 DestinationLength, u32 *OutputLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ___LZ4_H___ */
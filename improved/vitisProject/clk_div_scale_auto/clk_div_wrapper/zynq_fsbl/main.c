@@ -82,6 +82,12 @@
 * 											of failure.
 * 16.00a bsv 03/26/18	Fix for CR# 996973  Add code under JTAG_ENABLE_LEVEL_SHIFTERS macro
 * 											to enable level shifters in jtag boot mode.
+* 17.00a xl  10/19/26	Record the boot stages in the boot profile table
+*						Close the SD boot file after the load
+*						Test DDR lines, banks and, in the
+*						timed modes, a DMA swept area
+*						Take the fallback image from the
+*						image directory when there is one
 * </pre>
 *
 * @note
@@ -113,6 +119,9 @@
 #include "xstatus.h"
 #include "fsbl_hooks.h"
 #include "xtime_l.h"
+#include "fsbl_profile.h"
+#include "ddr_test.h"
+#include "image_dir.h"
 
 #ifdef XPAR_XWDTPS_0_BASEADDR
 #include "xwdtps.h"
@@ -168,8 +177,10 @@ void  CheckWDTReset(void);
 #endif
 
 u32 NextValidImageCheck(void);
+static u32 BootDeviceSize(void);
+static u32 ImageDirFallback(u32 FailedOffset, u32 *NextOffset);
 
-u32 DDRInitCheck(void);
+u32 DDRInitCheck(u32 *Result, u32 *BytesTested);
 
 /************************** Variable Definitions *****************************/
 /*
@@ -217,10 +228,23 @@ int main(void)
 	u32 HandoffAddress = 0;
 	u32 Status = XST_SUCCESS;
 	u32 RegVal;
+	u32 ProfEntry;
+#ifdef XPAR_PS7_DDR_0_S_AXI_BASEADDR
+	u32 DdrResult;
+	u32 DdrBytes;
+#endif
+
+	/*
+	 * Boot profile, every stage from here on is timed
+	 */
+	FsblProfileInit();
+
 	/*
 	 * PCW initialization for MIO,PLL,CLK and DDR
 	 */
+	ProfEntry = FsblProfileStart(FSBL_PROF_PS7_INIT);
 	Status = ps7_init();
+	FsblProfileEnd(ProfEntry, 0);
 	if (Status != FSBL_PS7_INIT_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"PS7_INIT_FAIL : %s\r\n",
 						getPS7MessageInfo(Status));
@@ -276,7 +300,10 @@ int main(void)
     /*
      * DDR Read/write test 
      */
-	Status = DDRInitCheck();
+	ProfEntry = FsblProfileStart(FSBL_PROF_DDR_CHECK);
+	Status = DDRInitCheck(&DdrResult, &DdrBytes);
+	FsblProfileEnd(ProfEntry, DdrBytes);
+	FsblProfileSetResult(ProfEntry, DdrResult);
 	if (Status == XST_FAILURE) {
 		fsbl_printf(DEBUG_GENERAL,"DDR_INIT_FAIL \r\n");
 		/* Error Handling here */
@@ -292,7 +319,9 @@ int main(void)
 	/*
 	 * PCAP initialization
 	 */
+	ProfEntry = FsblProfileStart(FSBL_PROF_PCAP_INIT);
 	Status = InitPcap();
+	FsblProfileEnd(ProfEntry, 0);
 	if (Status == XST_FAILURE) {
 		fsbl_printf(DEBUG_GENERAL,"PCAP_INIT_FAIL \n\r");
 		OutputStatus(PCAP_INIT_FAIL);
@@ -360,6 +389,8 @@ int main(void)
 	BootModeRegister = Xil_In32(BOOT_MODE_REG);
 	BootModeRegister &= BOOT_MODES_MASK;
 
+	ProfEntry = FsblProfileStart(FSBL_PROF_FLASH_INIT);
+
 	/*
 	 * QSPI BOOT MODE
 	 */
@@ -507,6 +538,8 @@ int main(void)
 		FsblFallback();
 	}
 
+	FsblProfileEnd(ProfEntry, 0);
+
 	fsbl_printf(DEBUG_INFO,"Flash Base Address: 0x%08lx\r\n", FlashReadBaseAddress);
 
 	/*
@@ -545,7 +578,18 @@ int main(void)
 	/*
 	 * Load boot image
 	 */
+	ProfEntry = FsblProfileStart(FSBL_PROF_LOAD_IMAGE);
 	HandoffAddress = LoadBootImage();
+	FsblProfileEnd(ProfEntry, 0);
+
+#if defined(XPAR_PS7_SD_0_S_AXI_BASEADDR) || defined(XPAR_XSDPS_0_BASEADDR)
+	/*
+	 * Close the boot file, this also reports the SD read counters
+	 */
+	if ((BootModeRegister == SD_MODE) || (BootModeRegister == MMC_MODE)) {
+		ReleaseSD();
+	}
+#endif
 
 	fsbl_printf(DEBUG_INFO,"Handoff Address: 0x%08lx\r\n",HandoffAddress);
 
@@ -707,6 +751,9 @@ void FsblFallback(void)
 void FsblHandoff(u32 FsblStartAddr)
 {
 	u32 Status;
+	u32 ProfEntry;
+
+	ProfEntry = FsblProfileStart(FSBL_PROF_HANDOFF);
 
 	/*
 	 * Enable level shifter
@@ -761,6 +808,11 @@ void FsblHandoff(u32 FsblStartAddr)
 	XWdtPs_Stop(&Watchdog);
 #endif
 
+	/*
+	 * Leave the GIC as the BootROM did for the application
+	 */
+	PcapIntrStop();
+
 	/*
 	 * Clear our mark in reboot status register
 	 */
@@ -773,10 +825,14 @@ void FsblHandoff(u32 FsblStartAddr)
 		SlcrLock();
 
 		fsbl_printf(DEBUG_INFO,"No Execution Address JTAG handoff \r\n");
+		FsblProfileEnd(ProfEntry, 0);
+		FsblProfileFinish(FsblStartAddr);
 		FsblHandoffJtagExit();
 	} else {
 		fsbl_printf(DEBUG_GENERAL,"SUCCESSFUL_HANDOFF\r\n");
 		OutputStatus(SUCCESSFUL_HANDOFF);
+		FsblProfileEnd(ProfEntry, 0);
+		FsblProfileFinish(FsblStartAddr);
 		FsblHandoffExit(FsblStartAddr);
 	}
 
@@ -1019,10 +1075,16 @@ static void FIQ_Handler (void)
 * @return
 * return  none
 *
+* @note		With an image directory in flash the register is set to the
+*		next image of the directory, so neither the boot rom nor
+*		NextValidImageCheck() has to search for it.
+*
 ****************************************************************************/
 static void Update_MultiBootRegister(void)
 {
 	u32 MultiBootReg = 0;
+	u32 FailedOffset;
+	u32 NextOffset;
 
 	if (Silicon_Version != SILICON_VERSION_1) {
 		/*
@@ -1031,10 +1093,24 @@ static void Update_MultiBootRegister(void)
 		MultiBootReg =	XDcfg_ReadReg(DcfgInstPtr->Config.BaseAddr,
 					XDCFG_MULTIBOOT_ADDR_OFFSET);
 
-		/*
-		 * Incrementing multiboot register by one
-		 */
-		MultiBootReg++;
+		FailedOffset = (MultiBootReg & PCAP_MBOOT_REG_REBOOT_OFFSET_MASK)
+								* GOLDEN_IMAGE_OFFSET;
+
+		if ((SystemInitFlag == 1) &&
+				(ImageDirFallback(FailedOffset, &NextOffset) ==
+					XST_SUCCESS)) {
+			/*
+			 * Point at the next image of the directory
+			 */
+			MultiBootReg = (MultiBootReg &
+					~PCAP_MBOOT_REG_REBOOT_OFFSET_MASK) |
+					(NextOffset / GOLDEN_IMAGE_OFFSET);
+		} else {
+			/*
+			 * Incrementing multiboot register by one
+			 */
+			MultiBootReg++;
+		}
 
 		XDcfg_WriteReg(DcfgInstPtr->Config.BaseAddr,
 				XDCFG_MULTIBOOT_ADDR_OFFSET,
@@ -1406,26 +1482,14 @@ u32 NextValidImageCheck(void)
 {
 	u32 ImageBaseAddr;
 	u32 MultiBootReg;
-	u32 BootDevMaxSize=0;
+	u32 BootDevMaxSize;
 
 	fsbl_printf(DEBUG_GENERAL, "Searching For Next Valid Image");
 	
 	/*
 	 * Setting variable with maximum flash size based on boot mode
 	 */
-#ifdef XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR
-	if (FlashReadBaseAddress == XPS_QSPI_LINEAR_BASEADDR) {
-		BootDevMaxSize = QspiFlashSize;
-	}
-#endif
-
-	if (FlashReadBaseAddress == XPS_NAND_BASEADDR) {
-		BootDevMaxSize  = NAND_FLASH_SIZE;
-	}
-
-	if (FlashReadBaseAddress == XPS_NOR_BASEADDR) {
-		BootDevMaxSize  = NOR_FLASH_SIZE;
-	}
+	BootDevMaxSize = BootDeviceSize();
 
 	/*
 	 * Read the multiboot register
@@ -1441,7 +1505,8 @@ u32 NextValidImageCheck(void)
 	
 	/*
 	 * Valid image search continue till end of the flash
-	 * With increment 32KB in each iteration
+	 * With increment 32KB in each iteration. With an image directory
+	 * the register already points at the image, found on the first read
 	 */
 	while (ImageBaseAddr < BootDevMaxSize) {
 
@@ -1481,12 +1546,117 @@ u32 NextValidImageCheck(void)
 	return XST_FAILURE;
 }
 
+/******************************************************************************
+*
+* This function returns the size of the flash booted from
+*
+* @param	None
+*
+* @return	Flash size in bytes, 0 if not booted from QSPI, NAND or NOR
+*
+* @note		None
+*
+*******************************************************************************/
+static u32 BootDeviceSize(void)
+{
+	u32 BootDevMaxSize = 0;
+
+#ifdef XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR
+	if (FlashReadBaseAddress == XPS_QSPI_LINEAR_BASEADDR) {
+		BootDevMaxSize = QspiFlashSize;
+	}
+#endif
+
+	if (FlashReadBaseAddress == XPS_NAND_BASEADDR) {
+		BootDevMaxSize  = NAND_FLASH_SIZE;
+	}
+
+	if (FlashReadBaseAddress == XPS_NOR_BASEADDR) {
+		BootDevMaxSize  = NOR_FLASH_SIZE;
+	}
+
+	return BootDevMaxSize;
+}
+
+/******************************************************************************
+*
+* This function takes the image to fall back to from the image directory,
+* see image_dir.h. Both copies of the directory are read, and the images
+* after the failed one are tried in directory order until one has a valid
+* boot header.
+*
+* @param	FailedOffset is the flash offset of the image that failed
+* @param	NextOffset is set to the flash offset of the image found
+*
+* @return
+*		- XST_SUCCESS if an image was found
+*		- XST_FAILURE if there is no valid directory or no image left
+*
+* @note		This takes two directory reads and a header check per image
+*		tried, where NextValidImageCheck() reads every 32 KB of flash
+*		up to the next image.
+*
+*******************************************************************************/
+static u32 ImageDirFallback(u32 FailedOffset, u32 *NextOffset)
+{
+	static ImageDir DirCopy[2];
+	const ImageDir *Dir;
+	u32 DeviceSize;
+	u32 Copy;
+	u32 Index;
+	u32 Offset;
+
+	DeviceSize = BootDeviceSize();
+	if ((FSBL_IMAGE_DIR_OFFSET + (2U * IMAGE_DIR_COPY_OFFSET)) > DeviceSize) {
+		return XST_FAILURE;
+	}
+
+	for (Copy = 0U; Copy < 2U; Copy++) {
+		if (MoveImage(FSBL_IMAGE_DIR_OFFSET + (Copy * IMAGE_DIR_COPY_OFFSET),
+				(u32)&DirCopy[Copy], sizeof(ImageDir)) != XST_SUCCESS) {
+			DirCopy[Copy].Magic = 0U;
+		}
+	}
+
+	Dir = ImageDirPick(&DirCopy[0], &DirCopy[1]);
+	if (Dir == NULL) {
+		fsbl_printf(DEBUG_INFO, "No Image Directory\r\n");
+		return XST_FAILURE;
+	}
+
+	for (Index = ImageDirStart(Dir, FailedOffset);
+			(Index = ImageDirNext(Dir, FailedOffset, Index)) !=
+				IMAGE_DIR_NONE;
+			Index++) {
+		Offset = Dir->Entry[Index].Offset;
+		if ((Offset < DeviceSize) &&
+				(ImageCheckID(Offset) == XST_SUCCESS) &&
+				(HeaderChecksum(Offset) == XST_SUCCESS)) {
+			fsbl_printf(DEBUG_GENERAL, "Image directory %lu: image %lu, "
+					"version 0x%08lx, offset 0x%08lx\r\n",
+					Dir->Sequence, Index, Dir->Entry[Index].Version,
+					Offset);
+			*NextOffset = Offset;
+			return XST_SUCCESS;
+		}
+
+		fsbl_printf(DEBUG_INFO, "Image directory: image %lu at 0x%08lx "
+				"not valid\r\n", Index, Offset);
+	}
+
+	fsbl_printf(DEBUG_INFO, "No Image Left In Directory\r\n");
+
+	return XST_FAILURE;
+}
+
 /******************************************************************************/
 /**
 *
-* This function Checks for the ddr initialization completion
+* This function Checks for the ddr initialization completion, then tests
+* DDR in the FSBL_DDR_TEST_MODE mode, see ddr_test.h
 *
-* @param	None.
+* @param	Result is set to the DDR test result code
+* @param	BytesTested is set to the bytes swept by the DDR test
 *
 * @return
 *		- XST_SUCCESS if the initialization is successful
@@ -1495,10 +1665,13 @@ u32 NextValidImageCheck(void)
 * @note		None.
 *
 ****************************************************************************/
-u32 DDRInitCheck(void)
+u32 DDRInitCheck(u32 *Result, u32 *BytesTested)
 {
 	u32 ReadVal;
 
+	*Result = DDR_TEST_RESULT(FSBL_DDR_TEST_MODE, DDR_FAULT_DATA_LINE);
+	*BytesTested = 0U;
+
 	/*
 	 * Write and Read from the DDR location for sanity checks
 	 */
@@ -1517,5 +1690,5 @@ u32 DDRInitCheck(void)
 		return XST_FAILURE;
 	}
 
-	return XST_SUCCESS;
+	return DdrTest(FSBL_DDR_TEST_MODE, Result, BytesTested);
 }
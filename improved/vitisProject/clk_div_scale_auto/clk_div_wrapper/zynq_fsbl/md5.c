@@ -67,6 +67,10 @@
 * Ver	Who	Date		Changes
 * ----- ---- -------- -------------------------------------------------------
 * 5.00a sgd	05/17/13 Initial release
+* 21.0	xl	10/19/26 Word aligned input is transformed in place instead of
+*					 being copied to the context block by block, copies
+*					 and byte swaps are done a word at a time, and
+*					 MD5SelfTest checks the known answers of RFC 1321
 *
 *
 * </pre>
@@ -77,6 +81,45 @@
 /****************************** Include Files *********************************/
 
 #include "md5.h"
+#include "xstatus.h"
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define MD5_IS_WORD_ALIGNED( x )	( ( ( (UINTPTR)( x ) ) & 0x3U ) == 0U )
+
+/*
+ * Byte reverse of a word, a single REV instruction on the Cortex-A9
+ */
+#define MD5_BYTE_SWAP( x )	__builtin_bswap32( x )
+
+/************************** Variable Definitions *****************************/
+
+/*
+ * Known answers from RFC 1321, appendix A.5
+ */
+static const struct {
+	const char *Message;
+	u8 Digest[ 16 ];
+} MD5TestVector[] = {
+	{ "",
+	  { 0xd4, 0x1d, 0x8c, 0xd9, 0x8f, 0x00, 0xb2, 0x04,
+	    0xe9, 0x80, 0x09, 0x98, 0xec, 0xf8, 0x42, 0x7e } },
+	{ "abc",
+	  { 0x90, 0x01, 0x50, 0x98, 0x3c, 0xd2, 0x4f, 0xb0,
+	    0xd6, 0x96, 0x3f, 0x7d, 0x28, 0xe1, 0x7f, 0x72 } },
+	{ "message digest",
+	  { 0xf9, 0x6b, 0x69, 0x7d, 0x7c, 0xb7, 0x93, 0x8d,
+	    0x52, 0x5a, 0x2f, 0x31, 0xaa, 0xf1, 0x61, 0xd0 } },
+	{ "abcdefghijklmnopqrstuvwxyz",
+	  { 0xc3, 0xfc, 0xd3, 0xd7, 0x61, 0x92, 0xe4, 0x00,
+	    0x7d, 0xfb, 0x49, 0x6c, 0xca, 0x67, 0xe1, 0x3b } },
+	{ "12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+	  { 0x57, 0xed, 0xf4, 0xa2, 0x2b, 0xe3, 0xc9, 0x55,
+	    0xac, 0x49, 0xda, 0x2e, 0x21, 0x07, 0xb6, 0x7a } }
+};
+
+#define MD5_TEST_VECTORS	( sizeof( MD5TestVector ) / sizeof( MD5TestVector[ 0 ] ) )
+#define MD5_TEST_MAX_LEN	80
 
 /******************************************************************************/
 /**
@@ -125,7 +168,33 @@ inline void * MD5Memcpy( void *dest, const void *src,
 {
 	register char * dst8 = (char*)dest;
 	register char * src8 = (char*)src;
+	register u32 * dst32;
+	register const u32 * src32;
 	
+	if( MD5_IS_WORD_ALIGNED( dst8 ) && MD5_IS_WORD_ALIGNED( src8 ) ) {
+		dst32 = (u32 *)dest;
+		src32 = (const u32 *)src;
+
+		if( doByteSwap == FALSE ) {
+			while( count >= sizeof( u32 ) ) {
+				*dst32++ = *src32++;
+				count -= sizeof( u32 );
+			}
+
+			dst8 = (char *)dst32;
+			src8 = (char *)src32;
+		} else {
+			count /= sizeof( u32 );
+
+			while( count-- ) {
+				*dst32++ = MD5_BYTE_SWAP( *src32 );
+				src32++;
+			}
+
+			return dest;
+		}
+	}
+
 	if( doByteSwap == FALSE ) {
 		while( count-- )
 			*dst8++ = *src8++;
@@ -354,9 +423,19 @@ inline void MD5Update( MD5Context *context, u8 *buffer,
 	}
 		
 	/*
-	 * Process data in 64-byte, 512 bit, chunks
+	 * Process data in 64-byte, 512 bit, chunks. Word aligned data that
+	 * needs no swap is transformed where it is, without the copy.
 	 */
 
+	if( ( doByteSwap == FALSE ) && MD5_IS_WORD_ALIGNED( buffer ) ) {
+		while( len >= MD5_SIGNATURE_BYTE_SIZE ) {
+			MD5Transform( context->buffer, (u32 *)buffer );
+
+			buffer += MD5_SIGNATURE_BYTE_SIZE;
+			len    -= MD5_SIGNATURE_BYTE_SIZE;
+		}
+	}
+
 	while( len >= MD5_SIGNATURE_BYTE_SIZE ) {
 		MD5Memcpy( context->intermediate, buffer, MD5_SIGNATURE_BYTE_SIZE,
 				 doByteSwap );
@@ -482,3 +561,63 @@ void md5( u8 *input, u32 len, u8 *digest, boolean doByteSwap )
 	
 	MD5Final( &context, digest, doByteSwap );
 }
+
+/******************************************************************************/
+/**
+*
+* This function checks md5() against the known answers of RFC 1321, with the
+* messages both word aligned and not, and fed whole and a byte at a time, so
+* every path of MD5Update and MD5Memcpy is exercised
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if every digest matches
+*		- XST_FAILURE otherwise
+*
+* @note		None
+*
+****************************************************************************/
+u32 MD5SelfTest( void )
+{
+	MD5Context context;
+	u32 message[ ( MD5_TEST_MAX_LEN + 8 ) / sizeof( u32 ) ];
+	u8 digest[ 16 ];
+	u8 *input;
+	u32 vector;
+	u32 offset;
+	u32 len;
+	u32 index;
+
+	for( vector = 0; vector < MD5_TEST_VECTORS; vector++ ) {
+		len = 0;
+		while( MD5TestVector[ vector ].Message[ len ] != '\0' ) {
+			len++;
+		}
+
+		for( offset = 0; offset < 2; offset++ ) {
+			input = (u8 *)message + offset;
+			MD5Memcpy( input, MD5TestVector[ vector ].Message, len, FALSE );
+
+			md5( input, len, digest, FALSE );
+			for( index = 0; index < 16; index++ ) {
+				if( digest[ index ] != MD5TestVector[ vector ].Digest[ index ] ) {
+					return XST_FAILURE;
+				}
+			}
+
+			MD5Init( &context );
+			for( index = 0; index < len; index++ ) {
+				MD5Update( &context, input + index, 1, FALSE );
+			}
+			MD5Final( &context, digest, FALSE );
+			for( index = 0; index < 16; index++ ) {
+				if( digest[ index ] != MD5TestVector[ vector ].Digest[ index ] ) {
+					return XST_FAILURE;
+				}
+			}
+		}
+	}
+
+	return XST_SUCCESS;
+}
@@ -15,6 +15,7 @@
 * Ver	Who	Date		Changes
 * ----- ---- -------- -------------------------------------------------------
 * 5.00a sgd	05/17/13 Initial release
+* 21.0	xl	10/19/26 Added MD5SelfTest
 *
 * </pre>
 *
@@ -84,6 +85,8 @@ void MD5Final( MD5Context *context, u8 *digest, boolean doByteSwap );
 
 void md5( u8 *input, u32	len, u8 *digest, boolean doByteSwap );
 
+u32 MD5SelfTest( void );
+
 /************************** Variable Definitions *****************************/
 
 #ifdef __cplusplus
@@ -59,6 +59,12 @@
 * 											In pcap.c, check pl power
 * 											through MCTRL register for
 * 											3.0 and later versions of silicon.
+* 17.00a xl  10/19/26   Added PcapStreamStart/Chunk/Finish to download a
+*                       bitstream in chunks while the next chunk is read
+*                       PCAP waits sleep until the devcfg interrupt instead
+*                       of polling, with PcapSetEvents() callbacks
+*                       The error checks after a wait also test the status
+*                       bits taken by the interrupt handler
 * </pre>
 *
 * @note
@@ -80,6 +86,10 @@
 #ifdef XPAR_XWDTPS_0_BASEADDR
 #include "xwdtps.h"
 #endif
+#ifndef FSBL_PCAP_POLL
+#include "xscugic.h"
+#include "xscutimer.h"
+#endif
 /************************** Constant Definitions *****************************/
 /*
  * The following constants map to the XPAR parameters created in the
@@ -88,18 +98,59 @@
  */
 
 #define DCFG_DEVICE_ID		XPAR_XDCFG_0_DEVICE_ID
+#define DCFG_INTR_ID		XPAR_XDCFG_0_INTR
+#define GIC_DEVICE_ID		XPAR_SCUGIC_SINGLE_DEVICE_ID
+#define TIMER_DEVICE_ID		XPAR_XSCUTIMER_0_DEVICE_ID
+#define TIMER_INTR_ID		XPAR_SCUTIMER_INTR
+
+/*
+ * Devcfg status bits kept for PcapWaitDone(); the interrupt handler of the
+ * driver clears them in the register
+ */
+#define PCAP_EVENT_MASK		(XDCFG_IXR_DMA_DONE_MASK | \
+				XDCFG_IXR_D_P_DONE_MASK | \
+				XDCFG_IXR_PCFG_DONE_MASK | \
+				FSBL_XDCFG_IXR_ERROR_FLAGS_MASK)
+
+/* The private timer counts at half the CPU clock */
+#define PCAP_WAIT_TIMEOUT_COUNT	((XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / 2000U) * \
+				PCAP_WAIT_TIMEOUT_MS)
 
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
+#define wfi()	__asm__ __volatile__ ("wfi" : : : "memory")
+
 /************************** Function Prototypes ******************************/
 extern int XDcfgPollDone(u32 MaskValue, u32 MaxCount);
+#ifndef FSBL_PCAP_POLL
+static void PcapIntrHandler(void *CallBackRef, u32 IntrStatus);
+static void PcapTimerHandler(void *CallBackRef);
+#endif
 
 /************************** Variable Definitions *****************************/
+/*
+ * Set while a chunk of a streamed bitstream is in the PCAP DMA
+ */
+static u32 PcapStreamPending;
+
 /* Devcfg driver instance */
 static XDcfg DcfgInstance;
 XDcfg *DcfgInstPtr;
+
+/*
+ * Devcfg interrupt state: set when the PCAP waits on the interrupt, the
+ * status bits seen since they were last waited for, and the callbacks
+ */
+static volatile u32 PcapEventStatus;
+static PcapEvents PcapCallbacks;
+#ifndef FSBL_PCAP_POLL
+static u32 PcapIntrReady;
+static volatile u32 PcapTimedOut;
+static XScuGic GicInstance;
+static XScuTimer TimerInstance;
+#endif
 extern u32 Silicon_Version;
 #ifdef XPAR_XWDTPS_0_BASEADDR
 extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
@@ -185,7 +236,7 @@ u32 PcapDataTransfer(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	/*
 	 * Poll for the DMA done
 	 */
-	Status = XDcfgPollDone(XDCFG_IXR_DMA_DONE_MASK, MAX_COUNT);
+	Status = PcapWaitDone(XDCFG_IXR_DMA_DONE_MASK);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_INFO,"PCAP_DMA_DONE_FAIL \r\n");
 		return XST_FAILURE;
@@ -194,9 +245,9 @@ u32 PcapDataTransfer(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	fsbl_printf(DEBUG_INFO,"DMA Done ! \n\r");
 		
 	/*
-	 * Check for errors
+	 * Check for errors; the interrupt handler may have taken them
 	 */
-	IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr);
+	IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr) | PcapEventStatus;
 	if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
 		fsbl_printf(DEBUG_INFO,"Errors in PCAP \r\n");
 		return XST_FAILURE;
@@ -311,7 +362,7 @@ u32 PcapLoadPartition(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	/*
 	 * Poll for the DMA done
 	 */
-	Status = XDcfgPollDone(XDCFG_IXR_DMA_DONE_MASK, MAX_COUNT);
+	Status = PcapWaitDone(XDCFG_IXR_DMA_DONE_MASK);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_INFO,"PCAP_DMA_DONE_FAIL \r\n");
 		return XST_FAILURE;
@@ -322,7 +373,7 @@ u32 PcapLoadPartition(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	/*
 	 * Poll for FPGA Done
 	 */
-	Status = XDcfgPollDone(XDCFG_IXR_PCFG_DONE_MASK, MAX_COUNT);
+	Status = PcapWaitDone(XDCFG_IXR_PCFG_DONE_MASK);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_INFO,"PCAP_FPGA_DONE_FAIL\r\n");
 		return XST_FAILURE;
@@ -331,9 +382,9 @@ u32 PcapLoadPartition(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	fsbl_printf(DEBUG_INFO,"FPGA Done ! \n\r");
 	
 	/*
-	 * Check for errors
+	 * Check for errors; the interrupt handler may have taken them
 	 */
-	IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr);
+	IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr) | PcapEventStatus;
 	if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
 		fsbl_printf(DEBUG_INFO,"Errors in PCAP \r\n");
 		return XST_FAILURE;
@@ -351,6 +402,154 @@ u32 PcapLoadPartition(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	return XST_SUCCESS;
 }
 
+/******************************************************************************/
+/**
+*
+* This function starts a bitstream download that is fed in chunks with
+* PcapStreamChunk(). It clears the PCAP and resets the fabric like
+* PcapLoadPartition() does.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the fabric is ready for the first chunk
+*		- XST_FAILURE if the PCAP could not be cleared or the fabric
+*		  did not initialize
+*
+* @note		Only for unencrypted bitstreams; every chunk is a separate
+*		DMA command, which the AES engine does not accept.
+*
+****************************************************************************/
+u32 PcapStreamStart(void)
+{
+	u32 Status;
+
+	PcapStreamPending = 0;
+
+	Status = ClearPcapStatus();
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_CLEAR_STATUS_FAIL \r\n");
+		return XST_FAILURE;
+	}
+
+	Status = FabricInit();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function queues one chunk of a streamed bitstream. It waits for the
+* previous chunk to leave the DMA, then starts this one and returns without
+* waiting, so the caller can read the next chunk meanwhile.
+*
+* @param	SourceData is the chunk in DDR, which must not be touched until
+*		the next call of PcapStreamChunk() or PcapStreamFinish()
+* @param	WordLength is the chunk length in words
+*
+* @return
+*		- XST_SUCCESS if the chunk was queued
+*		- XST_FAILURE if the previous chunk failed or the DMA could not
+*		  be started
+*
+* @note		None
+*
+****************************************************************************/
+u32 PcapStreamChunk(u32 *SourceData, u32 WordLength)
+{
+	u32 Status;
+
+	if (PcapStreamPending) {
+		Status = PcapWaitDone(XDCFG_IXR_DMA_DONE_MASK);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_INFO,"PCAP_DMA_DONE_FAIL \r\n");
+			return XST_FAILURE;
+		}
+		PcapStreamPending = 0;
+	}
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+	/*
+	 * Prevent WDT reset
+	 */
+	XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+	/*
+	 * Every chunk is a complete DMA command to the invalid (PL) address
+	 */
+	Status = XDcfg_Transfer(DcfgInstPtr,
+			(u8 *)((u32)SourceData | PCAP_LAST_TRANSFER), WordLength,
+			(u8 *)(XDCFG_DMA_INVALID_ADDRESS | PCAP_LAST_TRANSFER),
+			WordLength, XDCFG_NON_SECURE_PCAP_WRITE);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"Status of XDcfg_Transfer = %lu \r \n",Status);
+		return XST_FAILURE;
+	}
+
+	PcapStreamPending = 1;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function completes a streamed bitstream download: it waits for the
+* last chunk and for the fabric to report done.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the fabric is configured
+*		- XST_FAILURE otherwise
+*
+* @note		None
+*
+****************************************************************************/
+u32 PcapStreamFinish(void)
+{
+	u32 Status;
+	u32 IntrStsReg;
+
+	if (PcapStreamPending) {
+		Status = PcapWaitDone(XDCFG_IXR_DMA_DONE_MASK);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_INFO,"PCAP_DMA_DONE_FAIL \r\n");
+			return XST_FAILURE;
+		}
+		PcapStreamPending = 0;
+	}
+
+	fsbl_printf(DEBUG_INFO,"DMA Done ! \n\r");
+
+	/*
+	 * Poll for FPGA Done
+	 */
+	Status = PcapWaitDone(XDCFG_IXR_PCFG_DONE_MASK);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_FPGA_DONE_FAIL\r\n");
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_INFO,"FPGA Done ! \n\r");
+
+	/*
+	 * Check for errors; the interrupt handler may have taken them
+	 */
+	IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr) | PcapEventStatus;
+	if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
+		fsbl_printf(DEBUG_INFO,"Errors in PCAP \r\n");
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
 /******************************************************************************/
 /**
 *
@@ -383,6 +582,15 @@ int InitPcap(void)
 		return XST_FAILURE;
 	}
 
+#ifndef FSBL_PCAP_POLL
+	/*
+	 * Without the interrupt the PCAP is polled as before
+	 */
+	if (PcapIntrInit() != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO, "PCAP interrupt not available, polling\n\r");
+	}
+#endif
+
 	return XST_SUCCESS;
 }
 /******************************************************************************/
@@ -611,6 +819,7 @@ u32 ClearPcapStatus(void)
 	 * Clear it all, so if Boot ROM comes back, it can proceed
 	 */
 	XDcfg_IntrClear(DcfgInstPtr, 0xFFFFFFFF);
+	PcapEventStatus = 0;
 
 	/*
 	 * Get PCAP Interrupt Status Register
@@ -647,7 +856,10 @@ u32 ClearPcapStatus(void)
 	if ((StatusReg & XDCFG_STATUS_DMA_CMD_Q_E_MASK) !=
 			XDCFG_STATUS_DMA_CMD_Q_E_MASK) {
 
-		IntStatusReg = XDcfg_IntrGetStatus(DcfgInstPtr);
+		/*
+		 * The interrupt handler may have taken the DMA done already
+		 */
+		IntStatusReg = XDcfg_IntrGetStatus(DcfgInstPtr) | PcapEventStatus;
 
 		if ((IntStatusReg & XDCFG_IXR_DMA_DONE_MASK) !=
 				XDCFG_IXR_DMA_DONE_MASK){
@@ -788,3 +1000,285 @@ int XDcfgPollDone(u32 MaskValue, u32 MaxCount)
 
 	return XST_SUCCESS;
 }
+
+/******************************************************************************/
+/**
+*
+* This function waits for DMA done or FPGA done. With the devcfg interrupt
+* the CPU sleeps until the interrupt or the timeout; otherwise the status
+* register is polled with XDcfgPollDone().
+*
+* @param	MaskValue is the status bits to wait for
+*
+* @return
+*		- XST_SUCCESS if all bits of MaskValue were set
+*		- XST_FAILURE on a PCAP error or after PCAP_WAIT_TIMEOUT_MS
+*
+* @note		The bits waited for are cleared, like XDcfgPollDone() does.
+*
+****************************************************************************/
+u32 PcapWaitDone(u32 MaskValue)
+{
+#ifndef FSBL_PCAP_POLL
+	u32 Events;
+
+	if (!PcapIntrReady) {
+		return (u32)XDcfgPollDone(MaskValue, MAX_COUNT);
+	}
+
+	PcapTimedOut = 0;
+	XScuTimer_LoadTimer(&TimerInstance, PCAP_WAIT_TIMEOUT_COUNT);
+	XScuTimer_Start(&TimerInstance);
+
+	/*
+	 * IRQs are masked from the check to the WFI so that an interrupt in
+	 * between still wakes the CPU; it is taken once they are unmasked
+	 */
+	for (;;) {
+		Xil_ExceptionDisable();
+		Events = PcapEventStatus;
+		if (((Events & MaskValue) == MaskValue) ||
+				((Events & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) != 0) ||
+				PcapTimedOut) {
+			break;
+		}
+		wfi();
+		Xil_ExceptionEnable();
+	}
+
+	PcapEventStatus = Events & ~MaskValue;
+	Xil_ExceptionEnable();
+	XScuTimer_Stop(&TimerInstance);
+
+	if (Events & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
+		fsbl_printf(DEBUG_INFO,"FATAL errors in PCAP %lx\r\n", Events);
+		PcapDumpRegisters();
+		return XST_FAILURE;
+	}
+
+	if ((Events & MaskValue) != MaskValue) {
+		fsbl_printf(DEBUG_GENERAL,"PCAP transfer timed out \r\n");
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+#else
+	return (u32)XDcfgPollDone(MaskValue, MAX_COUNT);
+#endif
+}
+
+/******************************************************************************/
+/**
+*
+* This function sets the callbacks of the devcfg interrupt. They run in
+* interrupt context, after the status bits are recorded for PcapWaitDone(),
+* so a caller can start the next piece of work as soon as the PCAP is done
+* instead of when it next waits.
+*
+* @param	EventsPtr is the callbacks, NULL to remove them
+*
+* @return	None
+*
+* @note		Without the devcfg interrupt the callbacks are never called.
+*
+****************************************************************************/
+void PcapSetEvents(const PcapEvents *EventsPtr)
+{
+	Xil_ExceptionDisable();
+	if (EventsPtr != NULL) {
+		PcapCallbacks = *EventsPtr;
+	} else {
+		PcapCallbacks.DmaDone = NULL;
+		PcapCallbacks.PlDone = NULL;
+		PcapCallbacks.Error = NULL;
+		PcapCallbacks.CallBackRef = NULL;
+	}
+	Xil_ExceptionEnable();
+}
+
+#ifndef FSBL_PCAP_POLL
+/******************************************************************************/
+/**
+*
+* This function sets up the GIC for the devcfg interrupt and the private
+* timer that bounds the PCAP waits, and enables IRQs.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the PCAP waits on the interrupt
+*		- XST_FAILURE if the GIC or the timer could not be set up
+*
+* @note		Called from InitPcap(). PcapIntrStop() undoes it before the
+*		handoff.
+*
+****************************************************************************/
+int PcapIntrInit(void)
+{
+	XScuGic_Config *GicConfigPtr;
+	XScuTimer_Config *TimerConfigPtr;
+	int Status;
+
+	GicConfigPtr = XScuGic_LookupConfig(GIC_DEVICE_ID);
+	TimerConfigPtr = XScuTimer_LookupConfig(TIMER_DEVICE_ID);
+	if ((GicConfigPtr == NULL) || (TimerConfigPtr == NULL)) {
+		return XST_FAILURE;
+	}
+
+	Status = XScuGic_CfgInitialize(&GicInstance, GicConfigPtr,
+					GicConfigPtr->CpuBaseAddress);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = XScuTimer_CfgInitialize(&TimerInstance, TimerConfigPtr,
+					TimerConfigPtr->BaseAddr);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * One-shot timeout of each wait
+	 */
+	XScuTimer_Stop(&TimerInstance);
+	XScuTimer_DisableAutoReload(&TimerInstance);
+	XScuTimer_ClearInterruptStatus(&TimerInstance);
+	XScuTimer_EnableInterrupt(&TimerInstance);
+
+	XDcfg_SetHandler(DcfgInstPtr, (void *)PcapIntrHandler, NULL);
+	XDcfg_IntrDisable(DcfgInstPtr, XDCFG_IXR_ALL_MASK);
+	XDcfg_IntrClear(DcfgInstPtr, XDCFG_IXR_ALL_MASK);
+	PcapEventStatus = 0;
+
+	Status = XScuGic_Connect(&GicInstance, DCFG_INTR_ID,
+			(Xil_InterruptHandler)XDcfg_InterruptHandler, DcfgInstPtr);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = XScuGic_Connect(&GicInstance, TIMER_INTR_ID,
+			(Xil_InterruptHandler)PcapTimerHandler, NULL);
+	if (Status != XST_SUCCESS) {
+		XScuGic_Disconnect(&GicInstance, DCFG_INTR_ID);
+		return XST_FAILURE;
+	}
+
+	/*
+	 * The FSBL IRQ vector locks down on any interrupt until now
+	 */
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_IRQ_INT,
+			(Xil_ExceptionHandler)XScuGic_InterruptHandler,
+			&GicInstance);
+
+	XDcfg_IntrEnable(DcfgInstPtr, PCAP_EVENT_MASK);
+	XScuGic_Enable(&GicInstance, DCFG_INTR_ID);
+	XScuGic_Enable(&GicInstance, TIMER_INTR_ID);
+	Xil_ExceptionEnable();
+
+	PcapIntrReady = 1;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function returns the GIC, the private timer and the devcfg interrupt
+* to their reset state, so the application finds them as the BootROM left
+* them.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void PcapIntrStop(void)
+{
+	if (!PcapIntrReady) {
+		return;
+	}
+
+	Xil_ExceptionDisable();
+	PcapIntrReady = 0;
+
+	XScuTimer_Stop(&TimerInstance);
+	XScuTimer_DisableInterrupt(&TimerInstance);
+	XScuTimer_ClearInterruptStatus(&TimerInstance);
+
+	XDcfg_IntrDisable(DcfgInstPtr, XDCFG_IXR_ALL_MASK);
+	XDcfg_IntrClear(DcfgInstPtr, XDCFG_IXR_ALL_MASK);
+
+	XScuGic_Disable(&GicInstance, DCFG_INTR_ID);
+	XScuGic_Disable(&GicInstance, TIMER_INTR_ID);
+	XScuGic_Disconnect(&GicInstance, DCFG_INTR_ID);
+	XScuGic_Disconnect(&GicInstance, TIMER_INTR_ID);
+	XScuGic_Stop(&GicInstance);
+}
+
+/******************************************************************************/
+/**
+*
+* This function is the devcfg callback of the driver interrupt handler. It
+* records the status bits for PcapWaitDone() and calls PcapSetEvents()
+* callbacks.
+*
+* @param	CallBackRef is unused
+* @param	IntrStatus is the devcfg interrupt status, already cleared
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void PcapIntrHandler(void *CallBackRef, u32 IntrStatus)
+{
+	(void)CallBackRef;
+
+	IntrStatus &= PCAP_EVENT_MASK;
+	PcapEventStatus |= IntrStatus;
+
+	if ((IntrStatus & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) &&
+			(PcapCallbacks.Error != NULL)) {
+		PcapCallbacks.Error(PcapCallbacks.CallBackRef, IntrStatus);
+	}
+	if ((IntrStatus & XDCFG_IXR_DMA_DONE_MASK) &&
+			(PcapCallbacks.DmaDone != NULL)) {
+		PcapCallbacks.DmaDone(PcapCallbacks.CallBackRef, IntrStatus);
+	}
+	if ((IntrStatus & XDCFG_IXR_PCFG_DONE_MASK) &&
+			(PcapCallbacks.PlDone != NULL)) {
+		PcapCallbacks.PlDone(PcapCallbacks.CallBackRef, IntrStatus);
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function is the private timer interrupt: a PCAP wait timed out.
+*
+* @param	CallBackRef is unused
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void PcapTimerHandler(void *CallBackRef)
+{
+	(void)CallBackRef;
+
+	XScuTimer_ClearInterruptStatus(&TimerInstance);
+	PcapTimedOut = 1;
+}
+#else
+int PcapIntrInit(void)
+{
+	return XST_FAILURE;
+}
+
+void PcapIntrStop(void)
+{
+}
+#endif
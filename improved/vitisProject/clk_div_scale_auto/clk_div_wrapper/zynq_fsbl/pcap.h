@@ -22,6 +22,8 @@
 * 						Fabric Initialization sequence is modified to check
 * 						the PL power before sequence starts and checking INIT_B
 * 						reset status twice in case of failure.
+* 17.00a xl  10/19/26	Added the chunked bitstream download functions
+*						Added the devcfg interrupt events
 * </pre>
 *
 * @note
@@ -53,6 +55,12 @@ extern "C" {
 #define LVL_PL_PS 0x0000000F
 #define LVL_PS_PL 0x0000000A
 
+/*
+ * Longest PCAP wait with the devcfg interrupt, in ms. The private timer
+ * wakes the CPU when it runs out.
+ */
+#define PCAP_WAIT_TIMEOUT_MS	4000U
+
 /* Fix for #672779 */
 #define FSBL_XDCFG_IXR_ERROR_FLAGS_MASK		(XDCFG_IXR_AXI_WERR_MASK | \
 						XDCFG_IXR_AXI_RTO_MASK |  \
@@ -63,6 +71,20 @@ extern "C" {
 						XDCFG_IXR_P2D_LEN_ERR_MASK |\
 						XDCFG_IXR_PCFG_HMAC_ERR_MASK)
 
+/**************************** Type Definitions *******************************/
+/*
+ * Callbacks of the devcfg interrupt, called in interrupt context with the
+ * status bits that raised it. Any of them may be NULL.
+ */
+typedef void (*PcapEventHandler)(void *CallBackRef, u32 IntrStatus);
+
+typedef struct {
+	PcapEventHandler DmaDone;	/* A DMA command completed */
+	PcapEventHandler PlDone;	/* The PL is configured */
+	PcapEventHandler Error;		/* An FSBL_XDCFG_IXR_ERROR_FLAGS_MASK bit */
+	void *CallBackRef;
+} PcapEvents;
+
 int InitPcap(void);
 void PcapDumpRegisters(void);
 u32 ClearPcapStatus(void);
@@ -72,6 +94,13 @@ u32 PcapLoadPartition(u32 *SourceData, u32 *DestinationData, u32 SourceLength,
 		 	u32 DestinationLength, u32 Flags);
 u32 PcapDataTransfer(u32 *SourceData, u32 *DestinationData, u32 SourceLength,
  			u32 DestinationLength, u32 Flags);
+u32 PcapStreamStart(void);
+u32 PcapStreamChunk(u32 *SourceData, u32 WordLength);
+u32 PcapStreamFinish(void);
+int PcapIntrInit(void);
+void PcapIntrStop(void);
+void PcapSetEvents(const PcapEvents *EventsPtr);
+u32 PcapWaitDone(u32 MaskValue);
 /************************** Variable Definitions *****************************/
 #ifdef __cplusplus
 }
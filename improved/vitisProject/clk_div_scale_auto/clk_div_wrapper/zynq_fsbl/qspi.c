@@ -37,6 +37,11 @@
 *					 					 instead of hard coded read
 *					 					 command (0x6B).
 * 15.0 bsv 09/04/20  Add support for 2Gb flash parts
+* 16.0 xl  10/19/26  Non-linear reads switch the controller to linear mode
+*                    for each bank and copy through the linear window with
+*                    the PS DMA, instead of 4KB polled transfers
+* 17.0 xl  10/19/26  Linear reads of QSPI_DMA_MIN_LENGTH or more go through
+*                    the PS DMA too; CPU copies use Xil_MemCpy
 * </pre>
 *
 * @note
@@ -51,6 +56,11 @@
 #ifdef XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR
 #include "xqspips_hw.h"
 #include "xqspips.h"
+#include "xil_cache.h"
+#include "xil_mem.h"
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+#include "xdmaps.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
@@ -95,11 +105,22 @@
 #define OVERHEAD_SIZE		4
 
 /*
- * The following constants specify the max amount of data and the size of the
- * the buffer required to hold the data and overhead to transfer the data to
- * and from the FLASH.
+ * Non-linear reads are copied from the linear window by the secure PS DMA.
+ * A generated DMA program of 64 byte bursts can move at most 4MB, so each
+ * bank is copied in pieces of QSPI_DMA_CHUNK_SIZE.
  */
-#define DATA_SIZE		4096
+#define QSPI_DMA_DEVICE_ID	XPAR_XDMAPS_1_DEVICE_ID
+#define QSPI_DMA_CHANNEL	0
+#define QSPI_DMA_CHUNK_SIZE	0x100000
+#define QSPI_DMA_BURST_SIZE	4
+#define QSPI_DMA_BURST_LEN	16
+#define QSPI_DMA_MAX_COUNT	100000000
+
+/*
+ * Linear boot reads shorter than this are copied by the CPU; setting up the
+ * DMA program costs more than it saves
+ */
+#define QSPI_DMA_MIN_LENGTH	0x10000
 
 /*
  * The following defines are for dual flash interface.
@@ -164,6 +185,14 @@
 
 /************************** Function Prototypes ******************************/
 
+static void QspiLinearRead(u32 LinearOffset, u32 DestinationAddress,
+		u32 LengthBytes);
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+static u32 QspiDmaInit(void);
+static u32 QspiDmaCopy(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes);
+#endif
+
 /************************** Variable Definitions *****************************/
 
 XQspiPs QspiInstance;
@@ -177,9 +206,14 @@ extern u8 LinearBootDeviceFlag;
  * The following variables are used to read and write to the eeprom and they
  * are global to avoid having large buffers on the stack
  */
-u8 ReadBuffer[DATA_SIZE + DATA_OFFSET + DUMMY_SIZE];
+u8 ReadBuffer[DATA_OFFSET + DUMMY_SIZE];
 u8 WriteBuffer[DATA_OFFSET + DUMMY_SIZE];
 
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+static XDmaPs QspiDmaInstance;
+static u8 QspiDmaReady;
+#endif
+
 /******************************************************************************/
 /**
 *
@@ -415,6 +449,16 @@ u32 InitQspi(void)
 		XQspiPs_SetLqspiConfigReg(QspiInstancePtr, ConfigCmd);
 	}
 
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+	/*
+	 * Non-linear reads and large linear reads go through the DMA if it
+	 * comes up, otherwise the CPU copies from the linear window
+	 */
+	if (QspiDmaInit() != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"QSPI DMA init failed, using CPU copy\r\n");
+	}
+#endif
+
 	return XST_SUCCESS;
 }
 
@@ -517,46 +561,6 @@ u32 FlashReadID(void)
 }
 
 
-/******************************************************************************
-*
-* This function reads from the  serial FLASH connected to the
-* QSPI interface.
-*
-* @param	Address contains the address to read data from in the FLASH.
-* @param	ByteCount contains the number of bytes to read.
-*
-* @return	None.
-*
-* @note		None.
-*
-******************************************************************************/
-void FlashRead(u32 Address, u32 ByteCount)
-{
-	/*
-	 * Setup the write command with the specified address and data for the
-	 * FLASH
-	 */
-	u32 LqspiCrReg;
-	u8  ReadCommand;
-
-	LqspiCrReg = XQspiPs_GetLqspiConfigReg(QspiInstancePtr);
-	ReadCommand = (u8) (LqspiCrReg & XQSPIPS_LQSPI_CR_INST_MASK);
-	WriteBuffer[COMMAND_OFFSET]   = ReadCommand;
-	WriteBuffer[ADDRESS_1_OFFSET] = (u8)((Address & 0xFF0000) >> 16);
-	WriteBuffer[ADDRESS_2_OFFSET] = (u8)((Address & 0xFF00) >> 8);
-	WriteBuffer[ADDRESS_3_OFFSET] = (u8)(Address & 0xFF);
-
-	ByteCount += DUMMY_SIZE;
-
-	/*
-	 * Send the read command to the FLASH to read the specified number
-	 * of bytes from the FLASH, send the read command and address and
-	 * receive the specified number of bytes of data in the data buffer
-	 */
-	XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer, ReadBuffer,
-				ByteCount + OVERHEAD_SIZE);
-}
-
 /******************************************************************************/
 /**
 *
@@ -576,12 +580,14 @@ void FlashRead(u32 Address, u32 ByteCount)
 ****************************************************************************/
 u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 {
-	u8	*BufferPtr;
+	u32 BufferAddress;
 	u32 Length = 0;
 	u32 BankSel = 0;
 	u32 LqspiCrReg;
+	u32 LinearOffset;
 	u32 Status;
 	u8 BankSwitchFlag = 1;
+	u8 UpperPageFlag = 0;
 
 	/*
 	 * Linear access check
@@ -594,14 +600,24 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 			LengthBytes += (4 - (LengthBytes & 0x00000003));
 		}
 
-		memcpy((void*)DestinationAddress,
-		      (const void*)(SourceAddress + FlashReadBaseAddress),
-		      (size_t)LengthBytes);
+		SourceAddress += FlashReadBaseAddress;
+
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+		if ((QspiDmaReady == 1) && (LengthBytes >= QSPI_DMA_MIN_LENGTH) &&
+				(((SourceAddress | DestinationAddress) & 0x3) == 0)) {
+			if (QspiDmaCopy(SourceAddress, DestinationAddress,
+					LengthBytes) == XST_SUCCESS) {
+				return XST_SUCCESS;
+			}
+		}
+#endif
+		Xil_MemCpy((void*)DestinationAddress,
+		      (const void*)SourceAddress, LengthBytes);
 	} else {
 		/*
 		 * Non Linear access
 		 */
-		BufferPtr = (u8*)DestinationAddress;
+		BufferAddress = DestinationAddress;
 
 		/*
 		 * Dual parallel connection actual flash is half
@@ -612,13 +628,9 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 
 		while(LengthBytes > 0) {
 			/*
-			 * Local of DATA_SIZE size used for read/write buffer
+			 * Read as much as the current bank holds in one go
 			 */
-			if(LengthBytes > DATA_SIZE) {
-				Length = DATA_SIZE;
-			} else {
-				Length = LengthBytes;
-			}
+			Length = LengthBytes;
 
 			/*
 			 * Dual stack connection
@@ -643,6 +655,7 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 					 * Subtract first flash size when accessing second flash
 					 */
 					SourceAddress = SourceAddress - (QspiFlashSize/2);
+					UpperPageFlag = 1;
 
 					fsbl_printf(DEBUG_INFO, "stacked - upper CS \n\r");
 
@@ -650,6 +663,12 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 					 * Assert the FLASH chip select.
 					 */
 					XQspiPs_SetSlaveSelect(QspiInstancePtr);
+				} else if ((UpperPageFlag == 0) &&
+						((SourceAddress + Length) > (QspiFlashSize/2))) {
+					/*
+					 * Stop at the end of the lower flash
+					 */
+					Length = (QspiFlashSize/2) - SourceAddress;
 				}
 			}
 
@@ -698,14 +717,21 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 			}
 
 			/*
-			 * Copying the image to local buffer
+			 * The controller sends 24 bit addresses in linear mode and
+			 * the flash takes the upper bits from its bank register.
+			 * The upper stacked flash is at 16MB in the linear window,
+			 * and dual parallel flashes interleave, so the window
+			 * address is twice the address in each flash.
 			 */
-			FlashRead(SourceAddress, Length);
+			LinearOffset = SourceAddress & (FLASH_SIZE_16MB - 1);
+			if (XPAR_XQSPIPS_0_QSPI_MODE == DUAL_PARALLEL_CONNECTION) {
+				LinearOffset = LinearOffset * 2;
+			}
+			if (UpperPageFlag == 1) {
+				LinearOffset += FLASH_SIZE_16MB;
+			}
 
-			/*
-			 * Moving the data from local buffer to DDR destination address
-			 */
-			memcpy(BufferPtr, &ReadBuffer[DATA_OFFSET + DUMMY_SIZE], Length);
+			QspiLinearRead(LinearOffset, BufferAddress, Length);
 
 			/*
 			 * Updated the variables
@@ -721,7 +747,7 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 				SourceAddress += Length;
 			}
 
-			BufferPtr = (u8*)((u32)BufferPtr + Length);
+			BufferAddress += Length;
 		}
 
 		/*
@@ -755,6 +781,196 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 
 
 
+/******************************************************************************/
+/**
+*
+* This function reads from the flash through the linear window while the
+* controller is in I/O mode. The controller is switched to linear mode with
+* the same read command and bus setup for the copy and switched back after,
+* so the bank register and chip select set up in I/O mode stay in effect.
+*
+* @param	LinearOffset is the offset of the data in the linear window
+* @param	DestinationAddress is address in DDR data space
+* @param	LengthBytes is the length of the data in Bytes, not crossing a
+*		bank
+*
+* @return	None
+*
+* @note		The CPU copies when the DMA is not available, the addresses
+*		are not word aligned or the DMA fails. The DMA driver keeps
+*		the destination coherent when the D-cache is on.
+*
+****************************************************************************/
+static void QspiLinearRead(u32 LinearOffset, u32 DestinationAddress,
+		u32 LengthBytes)
+{
+	u32 LqspiCrReg;
+	u32 SourceAddress;
+	u8 CopiedFlag = 0;
+
+	LqspiCrReg = XQspiPs_GetLqspiConfigReg(QspiInstancePtr);
+	SourceAddress = FlashReadBaseAddress + LinearOffset;
+
+	/*
+	 * Enter linear mode with the I/O mode read configuration
+	 */
+	XQspiPs_Disable(QspiInstancePtr);
+	XQspiPs_SetOptions(QspiInstancePtr, XQSPIPS_LQSPI_MODE_OPTION |
+			XQSPIPS_HOLD_B_DRIVE_OPTION);
+	XQspiPs_SetLqspiConfigReg(QspiInstancePtr,
+			(LqspiCrReg & (~XQSPIPS_LQSPI_CR_U_PAGE_MASK)) |
+			XQSPIPS_LQSPI_CR_LINEAR_MASK);
+	XQspiPs_Enable(QspiInstancePtr);
+
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+	if ((QspiDmaReady == 1) &&
+			(((SourceAddress | DestinationAddress | LengthBytes) & 0x3) == 0)) {
+		if (QspiDmaCopy(SourceAddress, DestinationAddress,
+				LengthBytes) == XST_SUCCESS) {
+			CopiedFlag = 1;
+		}
+	}
+#endif
+	if (CopiedFlag == 0) {
+		/*
+		 * The window shows another bank after each bank switch, so
+		 * drop anything cached from it while the D-cache is on
+		 */
+		Xil_DCacheInvalidateRange(SourceAddress, LengthBytes);
+		Xil_MemCpy((void*)DestinationAddress, (const void*)SourceAddress,
+				LengthBytes);
+	}
+
+	/*
+	 * Back to I/O mode with manual chip select
+	 */
+	XQspiPs_Disable(QspiInstancePtr);
+	XQspiPs_SetOptions(QspiInstancePtr, XQSPIPS_FORCE_SSELECT_OPTION |
+			XQSPIPS_HOLD_B_DRIVE_OPTION);
+	XQspiPs_SetLqspiConfigReg(QspiInstancePtr, LqspiCrReg);
+	XQspiPs_SetSlaveSelect(QspiInstancePtr);
+}
+
+#ifdef XPAR_XDMAPS_1_DEVICE_ID
+/******************************************************************************/
+/**
+*
+* This function initializes the secure PS DMA used for non-linear reads.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the DMA is ready
+*		- XST_FAILURE if the DMA could not be initialized
+*
+* @note		The DMA interrupts are not connected; QspiDmaCopy() polls.
+*
+****************************************************************************/
+static u32 QspiDmaInit(void)
+{
+	XDmaPs_Config *DmaConfig;
+	int Status;
+
+	QspiDmaReady = 0;
+
+	DmaConfig = XDmaPs_LookupConfig(QSPI_DMA_DEVICE_ID);
+	if (NULL == DmaConfig) {
+		return XST_FAILURE;
+	}
+
+	Status = XDmaPs_CfgInitialize(&QspiDmaInstance, DmaConfig,
+			DmaConfig->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	QspiDmaReady = 1;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function copies from the linear window to DDR with the PS DMA, in
+* pieces of QSPI_DMA_CHUNK_SIZE, polling for the end of each piece.
+*
+* @param	SourceAddress is the address in the linear window
+* @param	DestinationAddress is address in DDR data space
+* @param	LengthBytes is the length of the data in Bytes
+*
+* @return
+*		- XST_SUCCESS if the data was copied
+*		- XST_FAILURE on a DMA fault or time out. The DMA is not used
+*		  again after a failure.
+*
+* @note		None
+*
+****************************************************************************/
+static u32 QspiDmaCopy(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes)
+{
+	XDmaPs_Cmd DmaCmd;
+	u32 BaseAddress = QspiDmaInstance.Config.BaseAddress;
+	u32 Length;
+	u32 Count;
+	int Status;
+
+	while (LengthBytes > 0) {
+		Length = LengthBytes;
+		if (Length > QSPI_DMA_CHUNK_SIZE) {
+			Length = QSPI_DMA_CHUNK_SIZE;
+		}
+
+		memset(&DmaCmd, 0, sizeof(XDmaPs_Cmd));
+		DmaCmd.ChanCtrl.SrcBurstSize = QSPI_DMA_BURST_SIZE;
+		DmaCmd.ChanCtrl.SrcBurstLen = QSPI_DMA_BURST_LEN;
+		DmaCmd.ChanCtrl.SrcInc = 1;
+		DmaCmd.ChanCtrl.DstBurstSize = QSPI_DMA_BURST_SIZE;
+		DmaCmd.ChanCtrl.DstBurstLen = QSPI_DMA_BURST_LEN;
+		DmaCmd.ChanCtrl.DstInc = 1;
+		DmaCmd.BD.SrcAddr = SourceAddress;
+		DmaCmd.BD.DstAddr = DestinationAddress;
+		DmaCmd.BD.Length = Length;
+
+		Status = XDmaPs_Start(&QspiDmaInstance, QSPI_DMA_CHANNEL, &DmaCmd, 0);
+		if (Status != XST_SUCCESS) {
+			QspiDmaReady = 0;
+			return XST_FAILURE;
+		}
+
+		/*
+		 * Wait for the channel event the generated program ends with
+		 */
+		Count = QSPI_DMA_MAX_COUNT;
+		while ((XDmaPs_ReadReg(BaseAddress, XDMAPS_INTSTATUS_OFFSET) &
+				(1U << QSPI_DMA_CHANNEL)) == 0) {
+			Count--;
+			if ((Count == 0) ||
+					((XDmaPs_ReadReg(BaseAddress, XDMAPS_FSC_OFFSET) &
+					(1U << QSPI_DMA_CHANNEL)) != 0)) {
+				fsbl_printf(DEBUG_GENERAL, "QSPI DMA Failed\n\r");
+				(void)XDmaPs_ResetChannel(&QspiDmaInstance,
+						QSPI_DMA_CHANNEL);
+				QspiDmaReady = 0;
+				return XST_FAILURE;
+			}
+		}
+
+		/*
+		 * Clear the event and release the program buffer
+		 */
+		XDmaPs_DoneISR_0(&QspiDmaInstance);
+
+		SourceAddress += Length;
+		DestinationAddress += Length;
+		LengthBytes -= Length;
+	}
+
+	return XST_SUCCESS;
+}
+#endif
+
 /******************************************************************************
 *
 * This functions selects the current bank
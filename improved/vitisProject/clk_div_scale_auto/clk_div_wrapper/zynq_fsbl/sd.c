@@ -18,6 +18,10 @@
 * 1.00a jz	04/28/11 Initial release
 * 7.00a kc  10/18/13 Integrated SD/MMC driver
 * 12.00a ssc 12/11/14 Fix for CR# 839182
+* 21.0  xl  10/19/26 Map the clusters of the boot file once with the FatFs
+*                    fast seek, and read whole sectors straight from the
+*                    card in transfers of up to 2 MB
+*                    Report the diskio sector cache counters on release
 *
 * </pre>
 *
@@ -38,16 +42,34 @@
 #include "xstatus.h"
 
 #include "ff.h"
+#include "diskio.h"
 #include "sd.h"
 
 /************************** Constant Definitions *****************************/
 
+/*
+ * Cluster link map of the boot file, in DWORDs: the size, two entries per
+ * fragment and a terminator, so a file in up to 127 fragments fits
+ */
+#define SD_LINKMAP_SIZE		256U
+
+/*
+ * Longest single card read, in sectors. The SD driver builds one ADMA2
+ * descriptor per 64 KB and has 32 of them.
+ */
+#define SD_MAX_READ_SECTORS	((32U * 0x10000U) / FF_MAX_SS)
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
 
+static u32 SDReadFile(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes);
+static u32 SDReadSectors(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes);
+
 /************************** Variable Definitions *****************************/
 
 extern u32 FlashReadBaseAddress;
@@ -57,6 +79,7 @@ static FIL fil;		/* File object */
 static FATFS fatfs;
 static char buffer[32];
 static char *boot_file = buffer;
+static DWORD LinkMap[SD_LINKMAP_SIZE];
 
 /******************************************************************************/
 /******************************************************************************/
@@ -97,6 +120,20 @@ u32 InitSD(const char *filename)
 		return XST_FAILURE;
 	}
 
+	/*
+	 * Map the clusters of the boot file once, so a seek does not walk
+	 * the FAT chain and a fragment can be read in one go. Without the
+	 * map, a file in too many fragments is read through f_read only.
+	 */
+	LinkMap[0] = SD_LINKMAP_SIZE;
+	fil.cltbl = LinkMap;
+	rc = f_lseek(&fil, CREATE_LINKMAP);
+	if (rc != FR_OK) {
+		fsbl_printf(DEBUG_INFO,"SD: No cluster map, %lu entries needed: %d\r\n",
+				(u32)LinkMap[0], rc);
+		fil.cltbl = NULL;
+	}
+
 	return XST_SUCCESS;
 
 }
@@ -120,7 +157,63 @@ u32 InitSD(const char *filename)
 ****************************************************************************/
 u32 SDAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 {
+	u32 Offset = 0U;
+	u32 Status;
+
+	/*
+	 * With the cluster map, the whole sectors of the request go straight
+	 * from the card to a word aligned destination; a partial sector at
+	 * either end, and anything the direct read did not cover, go
+	 * through f_read
+	 */
+	if (fil.cltbl != NULL) {
+		Offset = (FF_MAX_SS - (SourceAddress % FF_MAX_SS)) % FF_MAX_SS;
+		if ((Offset < LengthBytes) &&
+				(((DestinationAddress + Offset) & 0x3U) == 0U)) {
+			if (Offset != 0U) {
+				Status = SDReadFile(SourceAddress, DestinationAddress,
+						Offset);
+				if (Status != XST_SUCCESS) {
+					return Status;
+				}
+			}
+			Offset += SDReadSectors(SourceAddress + Offset,
+					DestinationAddress + Offset,
+					LengthBytes - Offset);
+		} else {
+			Offset = 0U;
+		}
+	}
+
+	if (Offset == LengthBytes) {
+		return XST_SUCCESS;
+	}
 
+	return SDReadFile(SourceAddress + Offset, DestinationAddress + Offset,
+			LengthBytes - Offset);
+
+} /* End of SDAccess */
+
+/******************************************************************************/
+/**
+*
+* This function reads the boot file through f_lseek and f_read.
+*
+* @param	SourceAddress is the offset in the boot file
+* @param	DestinationAddress is the destination address
+* @param	LengthBytes is the number of bytes to read
+*
+* @return
+*		- XST_SUCCESS unless the seek failed
+*		- XST_FAILURE if the seek failed
+*
+* @note		A read error is reported but not returned, a short image
+*		fails the checks of its header or checksum instead.
+*
+****************************************************************************/
+static u32 SDReadFile(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes)
+{
 	FRESULT rc;	 /* Result code */
 	UINT br;
 
@@ -137,8 +230,90 @@ u32 SDAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 	}
 
 	return XST_SUCCESS;
+}
 
-} /* End of SDAccess */
+/******************************************************************************/
+/**
+*
+* This function reads whole sectors of the boot file straight from the card,
+* one disk_read per fragment of the cluster map and at most
+* SD_MAX_READ_SECTORS at a time, so the SD driver moves them with ADMA2 in
+* few, long transfers.
+*
+* @param	SourceAddress is the offset in the boot file, sector aligned
+* @param	DestinationAddress is the destination address, word aligned
+* @param	LengthBytes is the number of bytes wanted
+*
+* @return	Number of bytes read, a multiple of the sector size. It is
+*		short at the end of the file, at a partial last sector and on
+*		a read error.
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SDReadSectors(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes)
+{
+	FATFS *fs = fil.obj.fs;
+	DWORD ClusterBytes = (DWORD)fs->csize * FF_MAX_SS;
+	DWORD *Fragment;
+	DWORD Cluster;
+	DWORD InCluster;
+	LBA_t Sector;
+	UINT Count;
+	u32 Offset;
+	u32 Done = 0U;
+
+	if (SourceAddress >= fil.obj.objsize) {
+		return 0U;
+	}
+	if (LengthBytes > (fil.obj.objsize - SourceAddress)) {
+		LengthBytes = (u32)(fil.obj.objsize - SourceAddress);
+	}
+	LengthBytes -= LengthBytes % FF_MAX_SS;
+
+	while (Done < LengthBytes) {
+		/*
+		 * Find the fragment holding the offset
+		 */
+		Offset = SourceAddress + Done;
+		Cluster = Offset / ClusterBytes;
+		Fragment = &LinkMap[1];
+		while ((Fragment[0] != 0U) && (Cluster >= Fragment[0])) {
+			Cluster -= Fragment[0];
+			Fragment += 2;
+		}
+		if (Fragment[0] == 0U) {
+			break;
+		}
+
+		/*
+		 * Read up to the end of the fragment
+		 */
+		InCluster = (Offset % ClusterBytes) / FF_MAX_SS;
+		Sector = fs->database +
+				((LBA_t)(Fragment[1] + Cluster - 2U) * fs->csize) +
+				InCluster;
+		Count = (UINT)(((Fragment[0] - Cluster) * fs->csize) - InCluster);
+		if (Count > ((LengthBytes - Done) / FF_MAX_SS)) {
+			Count = (LengthBytes - Done) / FF_MAX_SS;
+		}
+		if (Count > SD_MAX_READ_SECTORS) {
+			Count = SD_MAX_READ_SECTORS;
+		}
+
+		if (disk_read(fs->pdrv, (BYTE *)(DestinationAddress + Done),
+				Sector, Count) != RES_OK) {
+			fsbl_printf(DEBUG_GENERAL,"SD: Read of %u sectors at %lu failed\r\n",
+					Count, (u32)Sector);
+			break;
+		}
+
+		Done += Count * FF_MAX_SS;
+	}
+
+	return Done;
+}
 
 
 /******************************************************************************/
@@ -155,7 +330,14 @@ u32 SDAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 ****************************************************************************/
 void ReleaseSD(void) {
 
+	DISK_CACHE_STATS Stats;
+
 	f_close(&fil);
+
+	disk_cache_stats(&Stats, 1U);
+	fsbl_printf(DEBUG_INFO,"SD: %lu card reads, %lu sectors, cache %lu hits"
+			" %lu misses\r\n", (u32)Stats.Reads, (u32)Stats.Sectors,
+			(u32)Stats.Hits, (u32)Stats.Misses);
 	return;
 
 
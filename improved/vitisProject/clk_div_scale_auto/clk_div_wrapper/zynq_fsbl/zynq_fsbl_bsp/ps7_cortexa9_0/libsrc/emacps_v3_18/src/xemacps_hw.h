@@ -40,6 +40,8 @@
 * 3.9  hk   01/23/19 Add RX watermark support
 * 3.10 hk   05/16/19 Clear status registers properly in reset
 * 3.18  sne 01/11/23 Add PCS control and status registers information.
+* 3.18  xl  10/19/26 Add 1588 timer adjust and increment register bit
+*                    definitions.
 * </pre>
 *
 ******************************************************************************/
@@ -405,6 +407,25 @@ typedef enum { MDC_DIV_8 = 0U, MDC_DIV_16, MDC_DIV_32, MDC_DIV_48,
 #define XEMACPS_DMACR_INCR16_AHB_BURST	0x00000010U /**< 16 bytes AHB bursts */
 /*@}*/
 
+/** @name 1588 timer register bit definitions
+ * @{
+ */
+#define XEMACPS_1588_NANOSEC_MASK	0x3FFFFFFFU /**< Nanoseconds counter */
+#define XEMACPS_1588_ADJ_SUB_MASK	0x80000000U /**< Subtract the adjust
+							value from the timer */
+#define XEMACPS_1588_ADJ_NS_MASK	0x3FFFFFFFU /**< Nanoseconds to add or
+							subtract */
+#define XEMACPS_1588_INC_NS_MASK	0x000000FFU /**< Nanoseconds added per
+							TSU clock */
+#define XEMACPS_1588_INC_ALTNS_MASK	0x0000FF00U /**< Alternate increment */
+#define XEMACPS_1588_INC_ALTNS_SHIFT	8U	    /**< Shift for alternate
+							increment */
+#define XEMACPS_1588_INC_ALTCNT_MASK	0x00FF0000U /**< Increments before the
+							alternate one is used */
+#define XEMACPS_1588_INC_ALTCNT_SHIFT	16U	    /**< Shift for alternate
+							increment count */
+/*@}*/
+
 /** @name transmit status register bit definitions
  * @{
  */
@@ -0,0 +1,289 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+ *
+ * @file xemacps_ptp.c
+* @addtogroup emacps_v3_16
+* @{
+ *
+ * Functions in this file give access to the IEEE 1588 timestamp unit (TSU)
+ * of the GEM: programming the timer increment, reading, setting and
+ * adjusting the 1588 timer, and reading the event timestamps the MAC
+ * captures when PTP event frames (Sync, Delay_req, Pdelay_req and
+ * Pdelay_resp) pass the MII. See xemacps.h for a detailed description of the
+ * driver.
+ *
+ * The functions do not parse PTP messages. The caller pairs the captured
+ * event timestamps with the origin timestamps carried in the PTP messages.
+ *
+ * <pre>
+ * MODIFICATION HISTORY:
+ *
+ * Ver   Who  Date     Changes
+ * ----- ---- -------- -------------------------------------------------------
+ * 3.18  xl   10/19/26 First release
+ * </pre>
+ *****************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xemacps.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * The timer period is computed in 1/65536 ns so the alternate increment can
+ * be derived with integer arithmetic only.
+ */
+#define XEMACPS_PTP_FRAC_BITS	16U
+#define XEMACPS_PTP_FRAC_ONE	((u32)1U << XEMACPS_PTP_FRAC_BITS)
+
+/**************************** Type Definitions *******************************/
+
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+
+/************************** Function Prototypes ******************************/
+
+
+/************************** Variable Definitions *****************************/
+
+
+/*****************************************************************************/
+/**
+ * Program the 1588 timer increment for the frequency of the TSU clock. The
+ * nanosecond count added per TSU clock is the rounded clock period; the
+ * remaining fraction is approximated with the alternate increment, which the
+ * MAC applies once after a programmed number of regular increments.
+ *
+ * @param InstancePtr is a pointer to the instance to be worked on.
+ * @param TsuClkFreqHz is the frequency of the TSU clock in Hz. On Zynq this
+ *        is CPU_1x unless the TSU clock is taken from EMIO.
+ *
+ * @return None
+ *
+ *****************************************************************************/
+void XEmacPs_PtpSetIncrement(XEmacPs *InstancePtr, u32 TsuClkFreqHz)
+{
+	u64 PeriodFrac;
+	u32 BaseNs;
+	u32 AltNs;
+	u32 AltCount;
+	u32 Delta;
+	u32 RegIncr;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == (u32)XIL_COMPONENT_IS_READY);
+	Xil_AssertVoid(TsuClkFreqHz != 0x00000000U);
+
+	PeriodFrac = ((u64)XEMACPS_PTP_NS_PER_SEC << XEMACPS_PTP_FRAC_BITS) /
+			TsuClkFreqHz;
+	BaseNs = (u32)((PeriodFrac + (XEMACPS_PTP_FRAC_ONE >> 1U)) >>
+			XEMACPS_PTP_FRAC_BITS);
+
+	if (PeriodFrac >= ((u64)BaseNs << XEMACPS_PTP_FRAC_BITS)) {
+		Delta = (u32)(PeriodFrac - ((u64)BaseNs << XEMACPS_PTP_FRAC_BITS));
+		AltNs = BaseNs + 1U;
+	} else {
+		Delta = (u32)(((u64)BaseNs << XEMACPS_PTP_FRAC_BITS) - PeriodFrac);
+		AltNs = BaseNs - 1U;
+	}
+
+	/*
+	 * One alternate increment every AltCount + 1 clocks corrects a period
+	 * error of Delta; below 1/256 ns the count field cannot express it.
+	 */
+	if ((Delta << 8U) < XEMACPS_PTP_FRAC_ONE) {
+		AltNs = 0U;
+		AltCount = 0U;
+	} else {
+		AltCount = ((XEMACPS_PTP_FRAC_ONE + (Delta >> 1U)) / Delta) - 1U;
+		if (AltCount == 0U) {
+			AltCount = 1U;
+		}
+	}
+
+	RegIncr = (BaseNs & XEMACPS_1588_INC_NS_MASK) |
+		  ((AltNs << XEMACPS_1588_INC_ALTNS_SHIFT) &
+		   XEMACPS_1588_INC_ALTNS_MASK) |
+		  ((AltCount << XEMACPS_1588_INC_ALTCNT_SHIFT) &
+		   XEMACPS_1588_INC_ALTCNT_MASK);
+
+	XEmacPs_WriteReg(InstancePtr->Config.BaseAddress,
+			 XEMACPS_1588_INC_OFFSET, RegIncr);
+}
+
+/*****************************************************************************/
+/**
+ * Read the current value of the 1588 timer. The seconds register is read on
+ * both sides of the nanoseconds register so a nanosecond wrap between the two
+ * reads is not returned as a time one second in the past.
+ *
+ * @param InstancePtr is a pointer to the instance to be worked on.
+ * @param TimePtr is the location the time is returned in.
+ *
+ * @return None
+ *
+ *****************************************************************************/
+void XEmacPs_PtpGetTime(XEmacPs *InstancePtr, XEmacPs_PtpTime *TimePtr)
+{
+	u32 Seconds;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(TimePtr != NULL);
+
+	Seconds = XEmacPs_ReadReg(InstancePtr->Config.BaseAddress,
+				  XEMACPS_1588_SEC_OFFSET);
+	TimePtr->NanoSeconds = XEmacPs_ReadReg(InstancePtr->Config.BaseAddress,
+				XEMACPS_1588_NANOSEC_OFFSET) &
+				XEMACPS_1588_NANOSEC_MASK;
+	TimePtr->Seconds = XEmacPs_ReadReg(InstancePtr->Config.BaseAddress,
+				XEMACPS_1588_SEC_OFFSET);
+
+	if (TimePtr->Seconds != Seconds) {
+		TimePtr->NanoSeconds = XEmacPs_ReadReg(
+				InstancePtr->Config.BaseAddress,
+				XEMACPS_1588_NANOSEC_OFFSET) &
+				XEMACPS_1588_NANOSEC_MASK;
+	}
+}
+
+/*****************************************************************************/
+/**
+ * Load the 1588 timer. Used to step the timer when the offset to the master
+ * is too large to be slewed out with XEmacPs_PtpAdjustTime().
+ *
+ * @param InstancePtr is a pointer to the instance to be worked on.
+ * @param TimePtr is the time to load. NanoSeconds must be below 10^9.
+ *
+ * @return None
+ *
+ *****************************************************************************/
+void XEmacPs_PtpSetTime(XEmacPs *InstancePtr, const XEmacPs_PtpTime *TimePtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(TimePtr != NULL);
+	Xil_AssertVoid(TimePtr->NanoSeconds < XEMACPS_PTP_NS_PER_SEC);
+
+	XEmacPs_WriteReg(InstancePtr->Config.BaseAddress,
+			 XEMACPS_1588_SEC_OFFSET, TimePtr->Seconds);
+	XEmacPs_WriteReg(InstancePtr->Config.BaseAddress,
+			 XEMACPS_1588_NANOSEC_OFFSET, TimePtr->NanoSeconds);
+}
+
+/*****************************************************************************/
+/**
+ * Add a signed number of nanoseconds to the 1588 timer in a single update,
+ * without the read-modify-write race of XEmacPs_PtpSetTime().
+ *
+ * @param InstancePtr is a pointer to the instance to be worked on.
+ * @param DeltaNs is the adjustment, positive to move the timer forward.
+ *
+ * @return
+ * - XST_SUCCESS if the adjustment was applied
+ * - XST_INVALID_PARAM if DeltaNs does not fit the 30-bit adjust field
+ *
+ *****************************************************************************/
+LONG XEmacPs_PtpAdjustTime(XEmacPs *InstancePtr, s32 DeltaNs)
+{
+	u32 RegAdj;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == (u32)XIL_COMPONENT_IS_READY);
+
+	if (DeltaNs < 0) {
+		RegAdj = (u32)0U - (u32)DeltaNs;
+		if (RegAdj > XEMACPS_1588_ADJ_NS_MASK) {
+			return (LONG)(XST_INVALID_PARAM);
+		}
+		RegAdj |= XEMACPS_1588_ADJ_SUB_MASK;
+	} else {
+		RegAdj = (u32)DeltaNs;
+		if (RegAdj > XEMACPS_1588_ADJ_NS_MASK) {
+			return (LONG)(XST_INVALID_PARAM);
+		}
+	}
+
+	XEmacPs_WriteReg(InstancePtr->Config.BaseAddress,
+			 XEMACPS_1588_ADJ_OFFSET, RegAdj);
+
+	return (LONG)(XST_SUCCESS);
+}
+
+/*****************************************************************************/
+/**
+ * Read one of the event timestamps captured by the MAC. The registers hold
+ * the time of the most recent event of that kind; use
+ * XEmacPs_PtpEventPending() to find out whether a new one was captured.
+ *
+ * @param InstancePtr is a pointer to the instance to be worked on.
+ * @param Event is one of the XEMACPS_PTP_EVENT_* identifiers.
+ * @param TimePtr is the location the timestamp is returned in.
+ *
+ * @return None
+ *
+ *****************************************************************************/
+void XEmacPs_PtpGetEventTime(XEmacPs *InstancePtr, u32 Event,
+			     XEmacPs_PtpTime *TimePtr)
+{
+	u32 SecOffset;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(TimePtr != NULL);
+	Xil_AssertVoid(Event <= XEMACPS_PTP_EVENT_PEER_RX);
+
+	switch (Event) {
+	case XEMACPS_PTP_EVENT_TX:
+		SecOffset = XEMACPS_PTP_TXSEC_OFFSET;
+		break;
+	case XEMACPS_PTP_EVENT_RX:
+		SecOffset = XEMACPS_PTP_RXSEC_OFFSET;
+		break;
+	case XEMACPS_PTP_EVENT_PEER_TX:
+		SecOffset = XEMACPS_PTPP_TXSEC_OFFSET;
+		break;
+	default:
+		SecOffset = XEMACPS_PTPP_RXSEC_OFFSET;
+		break;
+	}
+
+	/* The nanoseconds register always follows the seconds register */
+	TimePtr->Seconds = XEmacPs_ReadReg(InstancePtr->Config.BaseAddress,
+					   SecOffset);
+	TimePtr->NanoSeconds = XEmacPs_ReadReg(InstancePtr->Config.BaseAddress,
+					SecOffset + 4U) &
+					XEMACPS_1588_NANOSEC_MASK;
+}
+
+/*****************************************************************************/
+/**
+ * Check and acknowledge PTP event interrupt status bits. Intended for polled
+ * operation; when the MAC interrupt handler is in use the same bits are
+ * cleared there.
+ *
+ * @param InstancePtr is a pointer to the instance to be worked on.
+ * @param Mask is a bit mask of XEMACPS_IXR_PTP* bits to check.
+ *
+ * @return The subset of Mask that was set. Those bits are cleared.
+ *
+ *****************************************************************************/
+u32 XEmacPs_PtpEventPending(XEmacPs *InstancePtr, u32 Mask)
+{
+	u32 RegISR;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	RegISR = XEmacPs_ReadReg(InstancePtr->Config.BaseAddress,
+				 XEMACPS_ISR_OFFSET) & Mask;
+	if (RegISR != 0x00000000U) {
+		XEmacPs_WriteReg(InstancePtr->Config.BaseAddress,
+				 XEMACPS_ISR_OFFSET, RegISR);
+	}
+
+	return RegISR;
+}
+/** @} */
@@ -89,6 +89,18 @@
 * 8.1    asa 02/13/23 The existing Xil_DCacheInvalidateRange has a bug where
 *                     the last cache line will not get invalidated under certain
 *                     scenarios. Changes are made to fix the same.
+* 8.1    xl  10/19/26 Xil_DCacheFlushRange cleans all of L1 by set/way, and
+*                     all of L2 by way, for ranges larger than those caches.
+*                     L2 maintenance by line in Xil_DCacheFlushRange and
+*                     Xil_DCacheInvalidateRange is synced once per chunk, not
+*                     after every line, and interrupts are masked for one
+*                     chunk of XIL_CACHE_RANGE_CHUNK bytes at a time instead
+*                     of for the whole range.
+* 8.1    xl  10/19/26 Added L2 cache lockdown by way and by line,
+*                     Xil_L2CacheLockRange and friends. Xil_L2CacheFlush
+*                     only cleans the locked ways, Xil_L2CacheInvalidate
+*                     leaves them alone, and Xil_L2CacheDisable unlocks them
+*                     before it flushes the whole cache.
 * </pre>
 *
 ******************************************************************************/
@@ -111,6 +123,24 @@
 
 #define IRQ_FIQ_MASK 0xC0U	/* Mask IRQ and FIQ interrupts in cpsr */
 
+#define XIL_L2_CACHE_WAYS	0xFFU	/* The 8 ways of the PL310, 64 KB each */
+
+/*
+ * Range maintenance: from these lengths Xil_DCacheFlushRange flushes the
+ * whole L1 (32 KB, 1024 set/way operations) or the whole L2 (512 KB, by
+ * way), which takes fewer operations than going line by line. Interrupts
+ * are masked for at most XIL_CACHE_RANGE_CHUNK bytes of a range.
+ */
+#ifndef XIL_CACHE_L1_FLUSH_ALL_LEN
+#define XIL_CACHE_L1_FLUSH_ALL_LEN	0x8000U
+#endif
+#ifndef XIL_CACHE_L2_FLUSH_ALL_LEN
+#define XIL_CACHE_L2_FLUSH_ALL_LEN	0x80000U
+#endif
+#ifndef XIL_CACHE_RANGE_CHUNK
+#define XIL_CACHE_RANGE_CHUNK		0x4000U
+#endif
+
 #ifdef __GNUC__
 	extern s32  _stack_end;
 	extern s32  __undef_stack;
@@ -154,6 +184,27 @@ static void Xil_L2CacheSync(void)
 {
 	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_SYNC_OFFSET, 0x0U);
 }
+
+/****************************************************************************
+*
+* Write the data and instruction lockdown registers of all masters.
+*
+* @param	Ways, ways no master may allocate lines in, bit n for way n.
+*
+* @return	None.
+*
+****************************************************************************/
+static void Xil_L2WriteLockdown(u32 Ways)
+{
+	u32 Master;
+
+	for (Master = 0U; Master < 8U; Master++) {
+		Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_DLCKDWN_0_WAY_OFFSET +
+			  (Master * 8U), Ways);
+		Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_ILCKDWN_0_WAY_OFFSET +
+			  (Master * 8U), Ways);
+	}
+}
 #endif
 /****************************************************************************/
 /**
@@ -306,6 +357,7 @@ void Xil_DCacheInvalidateRange(INTPTR opstartaddr, u32 len)
 	INTPTR tempadr;
 	INTPTR opendaddr;
 	INTPTR endaddr;
+	INTPTR chunkaddr;
 	u32 currmask;
 	volatile u32 *L2CCOffset = (volatile u32 *)(XPS_L2CC_BASEADDR +
 				    XPS_L2CC_CACHE_INVLD_PA_OFFSET);
@@ -347,30 +399,51 @@ void Xil_DCacheInvalidateRange(INTPTR opstartaddr, u32 len)
 			}
 		}
 
-		tempadr = opstartaddr;
+		mtcpsr(currmask);
+
+		/*
+		 * Unlike a flush, an invalidation of the whole cache would
+		 * lose dirty lines outside the range, so it is done line by
+		 * line, one chunk at a time
+		 */
+		while (opstartaddr < endaddr) {
+			chunkaddr = endaddr;
+			if ((endaddr - opstartaddr) > XIL_CACHE_RANGE_CHUNK) {
+				chunkaddr = opstartaddr + XIL_CACHE_RANGE_CHUNK;
+			}
 
-		while (tempadr < endaddr) {
+			mtcpsr(currmask | IRQ_FIQ_MASK);
 #ifndef USE_AMP
-			/* Invalidate L2 cache line */
-			*L2CCOffset = tempadr;
+			/*
+			 * Line operations of the L2 cache are atomic; one sync
+			 * drains them all
+			 */
+			for (tempadr = opstartaddr; tempadr < chunkaddr;
+					tempadr += cacheline) {
+				/* Invalidate L2 cache line */
+				*L2CCOffset = tempadr;
+			}
 			Xil_L2CacheSync();
-			tempadr += cacheline;
 #endif
-		}
 
-		while (opstartaddr < endaddr) {
-	/* Invalidate L1 Data cache line */
+			for (tempadr = opstartaddr; tempadr < chunkaddr;
+					tempadr += cacheline) {
+				/* Invalidate L1 Data cache line */
 #if defined (__GNUC__) || defined (__ICCARM__)
-			asm_cp15_inval_dc_line_mva_poc(opstartaddr);
+				asm_cp15_inval_dc_line_mva_poc(tempadr);
 #else
-			{ volatile register u32 Reg
-				__asm(XREG_CP15_INVAL_DC_LINE_MVA_POC);
-			  Reg = opstartaddr; }
+				{ volatile register u32 Reg
+					__asm(XREG_CP15_INVAL_DC_LINE_MVA_POC);
+				  Reg = tempadr; }
 #endif
-			opstartaddr += cacheline;
+			}
+			/* Wait for L1 cache invalidation to complete */
+			dsb();
+			mtcpsr(currmask);
+
+			opstartaddr = chunkaddr;
 		}
-		/* Wait for L1 cache invalidation to complete */
-		dsb();
+		return;
 	}
 	mtcpsr(currmask);
 }
@@ -448,48 +521,83 @@ void Xil_DCacheFlushRange(INTPTR opstartadr, u32 len)
 {
 	const u32 cacheline = 32U;
 	u32 opendadr;
+	u32 chunkadr;
 	u32 currmask;
 	u32 tempadr;
+	u32 l1all;
 
 	volatile u32 *L2CCOffset = (volatile u32 *)(XPS_L2CC_BASEADDR +
 				    XPS_L2CC_CACHE_INV_CLN_PA_OFFSET);
 
-	currmask = mfcpsr();
-	mtcpsr(currmask | IRQ_FIQ_MASK);
+	if (len == 0U) {
+		return;
+	}
 
-	if (len != 0U) {
-		opendadr = opstartadr + len;
-		opstartadr &= ~(cacheline - 1U);
+	opendadr = opstartadr + len;
+	opstartadr &= ~(cacheline - 1U);
 
-		tempadr = opstartadr;
+	/* L1 first, so that its dirty lines are in L2 when L2 is flushed */
+	l1all = (len >= XIL_CACHE_L1_FLUSH_ALL_LEN) ? 1U : 0U;
+	if (l1all != 0U) {
+		Xil_L1DCacheFlush();
+	}
 
-		while (tempadr < opendadr) {
-			/* Flush L1 Data cache line */
+	currmask = mfcpsr();
+#ifndef USE_AMP
+	if (len >= XIL_CACHE_L2_FLUSH_ALL_LEN) {
+		if (l1all == 0U) {
+			Xil_L1DCacheFlush();
+		}
+		/* Cleans the locked ways too, see Xil_L2CacheFlush */
+		mtcpsr(currmask | IRQ_FIQ_MASK);
+		Xil_L2CacheFlush();
+		mtcpsr(currmask);
+		return;
+	}
+#endif
+
+	while ((u32)opstartadr < opendadr) {
+		chunkadr = opendadr;
+		if ((opendadr - (u32)opstartadr) > XIL_CACHE_RANGE_CHUNK) {
+			chunkadr = (u32)opstartadr + XIL_CACHE_RANGE_CHUNK;
+		}
+
+		mtcpsr(currmask | IRQ_FIQ_MASK);
+		if (l1all == 0U) {
+			for (tempadr = opstartadr; tempadr < chunkadr;
+					tempadr += cacheline) {
+				/* Flush L1 Data cache line */
 #if defined (__GNUC__) || defined (__ICCARM__)
-			asm_cp15_clean_inval_dc_line_mva_poc(tempadr);
+				asm_cp15_clean_inval_dc_line_mva_poc(tempadr);
 #else
-			{ volatile register u32 Reg
-				__asm(XREG_CP15_CLEAN_INVAL_DC_LINE_MVA_POC);
-			  Reg = tempadr; }
+				{ volatile register u32 Reg
+					__asm(XREG_CP15_CLEAN_INVAL_DC_LINE_MVA_POC);
+				  Reg = tempadr; }
 #endif
-			tempadr += cacheline;
+			}
+			/* Wait for L1 cache clean and invalidation to complete */
+			dsb();
 		}
-		/* Wait for L1 cache clean and invalidation to complete */
-		dsb();
 
 #ifndef USE_AMP
+		/*
+		 * Line operations of the L2 cache are atomic; one sync drains
+		 * them all
+		 */
 		/* Disable Write-back and line fills */
 		Xil_L2WriteDebugCtrl(0x3U);
-		while ((u32)opstartadr < opendadr) {
+		for (tempadr = opstartadr; tempadr < chunkadr;
+				tempadr += cacheline) {
 			/* Flush L2 cache line */
-			*L2CCOffset = opstartadr;
-			Xil_L2CacheSync();
-			opstartadr += cacheline;
+			*L2CCOffset = tempadr;
 		}
+		Xil_L2CacheSync();
 		Xil_L2WriteDebugCtrl(0x0U);
 #endif
+		mtcpsr(currmask);
+
+		opstartadr = chunkadr;
 	}
-	mtcpsr(currmask);
 }
 /****************************************************************************/
 /**
@@ -1257,6 +1365,9 @@ void Xil_L2CacheEnable(void)
 *
 * @return	None.
 *
+* @note		Locks taken with Xil_L2CacheLockRange and Xil_L2CacheLockLines
+*			are dropped, so that every way is cleaned and invalidated.
+*
 ****************************************************************************/
 void Xil_L2CacheDisable(void)
 {
@@ -1266,7 +1377,9 @@ void Xil_L2CacheDisable(void)
 
     if((L2CCReg & 0x1U) != 0U) {
 
-        /* Clean and Invalidate L2 Cache */
+        /* Unlock, then Clean and Invalidate L2 Cache */
+        Xil_L2WriteLockdown(0x0U);
+        Xil_L2CacheUnlockLines(XIL_L2_CACHE_WAYS);
         Xil_L2CacheFlush();
 
 	    /* Disable the L2CC */
@@ -1285,6 +1398,8 @@ void Xil_L2CacheDisable(void)
 *
 * @return	None.
 *
+* @note		Ways locked with Xil_L2CacheLockRange are not invalidated.
+*
 ****************************************************************************/
 void Xil_L2CacheInvalidate(void)
 {
@@ -1308,14 +1423,16 @@ void Xil_L2CacheInvalidate(void)
 
 	#endif
 	u32 ResultDCache;
-	/* Invalidate the caches */
-	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_INVLD_WAY_OFFSET,
-		  0x0000FFFFU);
+	u32 Ways;
+
+	/* Invalidate the caches, but not the locked ways */
+	Ways = 0x0000FFFFU & ~Xil_L2CacheGetLockedWays();
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_INVLD_WAY_OFFSET, Ways);
 	ResultDCache = Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_INVLD_WAY_OFFSET)
-							& 0x0000FFFFU;
+							& Ways;
 	while(ResultDCache != (u32)0U) {
 		ResultDCache = Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_INVLD_WAY_OFFSET)
-							& 0x0000FFFFU;
+							& Ways;
 	}
 
 	/* Wait for the invalidate to complete */
@@ -1405,24 +1522,39 @@ void Xil_L2CacheInvalidateRange(u32 adr, u32 len)
 *
 * @return	None.
 *
+* @note		Ways locked with Xil_L2CacheLockRange are cleaned but not
+*			invalidated, so their lines stay locked.
+*
 ****************************************************************************/
 void Xil_L2CacheFlush(void)
 {
 	u32 ResultL2Cache;
+	u32 Locked;
+	u32 Ways;
 
-	/* Flush the caches */
+	/* Flush the caches, only clean the locked ways */
+	Locked = Xil_L2CacheGetLockedWays();
+	Ways = 0x0000FFFFU & ~Locked;
 
 	/* Disable Write-back and line fills */
 	Xil_L2WriteDebugCtrl(0x3U);
 
-	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_INV_CLN_WAY_OFFSET,
-		  0x0000FFFFU);
+	if (Locked != 0U) {
+		Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_CLEAN_WAY_OFFSET,
+			  Locked);
+		while ((Xil_In32(XPS_L2CC_BASEADDR +
+				 XPS_L2CC_CACHE_CLEAN_WAY_OFFSET) & Locked) != 0U) {
+			/* Background operation */
+		}
+	}
+
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_INV_CLN_WAY_OFFSET, Ways);
 	ResultL2Cache = Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_INV_CLN_WAY_OFFSET)
-							& 0x0000FFFFU;
+							& Ways;
 
 	while(ResultL2Cache != (u32)0U) {
 		ResultL2Cache = Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_INV_CLN_WAY_OFFSET)
-									& 0x0000FFFFU;
+									& Ways;
 	}
 
 	Xil_L2CacheSync();
@@ -1527,4 +1659,159 @@ void Xil_L2CacheStoreLine(u32 adr)
 	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_CLEAN_PA_OFFSET, adr);
 	Xil_L2CacheSync();
 }
+
+/****************************************************************************/
+/**
+* @brief	Load an address range into the given level 2 cache ways and lock
+*			them, so that the range stays cached whatever else runs. The
+*			range is flushed, then read line by line while no master may
+*			allocate in the other ways, then the given ways are locked for
+*			all masters. Locked lines are still written and read as usual,
+*			they are only never evicted.
+*
+* @param	WayMask: Ways to load and lock, bit n for way n. Each way holds
+*			64 KB, which must be enough for the range.
+* @param	adr: 32bit start address of the range to be locked.
+* @param	len: Length of the range to be locked in bytes.
+*
+* @return	None.
+*
+* @note		The ways should be empty: use ways not locked before. Other
+*			lines, such as the stack and the code of this function, may
+*			also land in the ways while the range is loaded. Invalidating a
+*			locked line by address frees it for good, as nothing can
+*			allocate in a locked way again.
+*
+****************************************************************************/
+void Xil_L2CacheLockRange(u32 WayMask, u32 adr, u32 len)
+{
+	u32 LocalAddr = adr;
+	const u32 cacheline = 32U;
+	u32 end;
+	u32 Locked;
+	u32 currmask;
+
+	currmask = mfcpsr();
+	mtcpsr(currmask | IRQ_FIQ_MASK);
+
+	if (len != 0U) {
+		/* Nothing of the range may hit in L1 or another way */
+		Xil_DCacheFlushRange(adr, len);
+
+		end = LocalAddr + len;
+		LocalAddr = LocalAddr & ~(cacheline - 1U);
+
+		Locked = Xil_L2CacheGetLockedWays();
+		Xil_L2WriteLockdown(XIL_L2_CACHE_WAYS & ~WayMask);
+
+		while (LocalAddr < end) {
+			(void)Xil_In32(LocalAddr);
+			LocalAddr += cacheline;
+		}
+		dsb();
+
+		Xil_L2WriteLockdown((Locked | WayMask) & XIL_L2_CACHE_WAYS);
+	}
+
+	mtcpsr(currmask);
+}
+
+/****************************************************************************/
+/**
+* @brief	Unlock level 2 cache ways locked with Xil_L2CacheLockRange. Their
+*			lines stay cached until they are evicted as usual.
+*
+* @param	WayMask: Ways to unlock, bit n for way n.
+*
+* @return	None.
+*
+****************************************************************************/
+void Xil_L2CacheUnlockWays(u32 WayMask)
+{
+	Xil_L2WriteLockdown(Xil_L2CacheGetLockedWays() & ~WayMask);
+	dsb();
+}
+
+/****************************************************************************/
+/**
+* @brief	Return the locked level 2 cache ways.
+*
+* @return	Locked ways, bit n for way n.
+*
+****************************************************************************/
+u32 Xil_L2CacheGetLockedWays(void)
+{
+	return Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_DLCKDWN_0_WAY_OFFSET) &
+	       XIL_L2_CACHE_WAYS;
+}
+
+/****************************************************************************/
+/**
+* @brief	Load an address range into the level 2 cache and lock it line by
+*			line. The lines may go to any way that is not locked, and stay
+*			there until Xil_L2CacheUnlockLines.
+*
+* @param	adr: 32bit start address of the range to be locked.
+* @param	len: Length of the range to be locked in bytes.
+*
+* @return	None.
+*
+* @note		Every line allocated while the range is loaded is locked, so
+*			the stack and the code of this function may be too.
+*			Xil_L2CacheFlush and Xil_L2CacheInvalidate still clean and
+*			invalidate lines locked this way; lock by way to keep them.
+*
+****************************************************************************/
+void Xil_L2CacheLockLines(u32 adr, u32 len)
+{
+	u32 LocalAddr = adr;
+	const u32 cacheline = 32U;
+	u32 end;
+	u32 currmask;
+
+	currmask = mfcpsr();
+	mtcpsr(currmask | IRQ_FIQ_MASK);
+
+	if (len != 0U) {
+		Xil_DCacheFlushRange(adr, len);
+
+		end = LocalAddr + len;
+		LocalAddr = LocalAddr & ~(cacheline - 1U);
+
+		Xil_Out32(XPS_L2CC_BASEADDR +
+			  XPS_L2CC_CACHE_LCKDWN_LINE_ENABLE_OFFSET, 0x1U);
+		while (LocalAddr < end) {
+			(void)Xil_In32(LocalAddr);
+			LocalAddr += cacheline;
+		}
+		dsb();
+		Xil_Out32(XPS_L2CC_BASEADDR +
+			  XPS_L2CC_CACHE_LCKDWN_LINE_ENABLE_OFFSET, 0x0U);
+	}
+
+	mtcpsr(currmask);
+}
+
+/****************************************************************************/
+/**
+* @brief	Unlock the lines locked with Xil_L2CacheLockLines in the given
+*			level 2 cache ways.
+*
+* @param	WayMask: Ways to unlock the lines of, bit n for way n.
+*
+* @return	None.
+*
+****************************************************************************/
+void Xil_L2CacheUnlockLines(u32 WayMask)
+{
+	u32 Ways = WayMask & XIL_L2_CACHE_WAYS;
+
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_UUNLOCK_ALL_WAY_OFFSET,
+		  Ways);
+	while ((Xil_In32(XPS_L2CC_BASEADDR +
+			 XPS_L2CC_CACHE_UUNLOCK_ALL_WAY_OFFSET) & Ways) != 0U) {
+		/* Background operation */
+	}
+	dsb();
+}
 #endif
@@ -21,6 +21,7 @@
 * ----- ---- -------- -----------------------------------------------
 * 1.00a ecm  01/24/10 First release
 * 6.8   aru  09/06/18 Removed compilation warnings for ARMCC toolchain.
+* 8.1   xl   10/19/26 Added the L2 cache lockdown functions.
 * </pre>
 *
 ******************************************************************************/
@@ -64,6 +65,11 @@ void Xil_L2CacheFlush(void);
 void Xil_L2CacheFlushLine(u32 adr);
 void Xil_L2CacheFlushRange(u32 adr, u32 len);
 void Xil_L2CacheStoreLine(u32 adr);
+void Xil_L2CacheLockRange(u32 WayMask, u32 adr, u32 len);
+void Xil_L2CacheUnlockWays(u32 WayMask);
+u32 Xil_L2CacheGetLockedWays(void);
+void Xil_L2CacheLockLines(u32 adr, u32 len);
+void Xil_L2CacheUnlockLines(u32 WayMask);
 
 #ifdef __cplusplus
 }
@@ -22,6 +22,10 @@
 * 			  violations.
 * 7.7	sk	 01/10/22 Include xil_mem.h header file to fix Xil_MemCpy
 * 			  prototype misra_c_2012_rule_8_4 violation.
+* 8.1   xl       10/19/26 Xil_MemCpy aligns source and destination when they
+* 			  are at the same offset in a word and copies in
+* 			  bursts of 32 bytes, with LDM/STM of 8 registers and
+* 			  PLD on ARM. Added Xil_MemSet.
 *
 * </pre>
 *
@@ -32,7 +36,101 @@
 #include "xil_types.h"
 #include "xil_mem.h"
 
+/************************** Constant Definitions ****************************/
+
+#define XIL_MEM_BLOCK		32U	/* Bytes per burst, 8 words */
+#define XIL_MEM_BLOCK_MIN	64U	/* Shorter lengths go word by word */
+#define XIL_MEM_WORD_MASK	3U
+
 /***************** Inline Functions Definitions ********************/
+/*****************************************************************************/
+/**
+* @brief       Copy whole bursts between word aligned buffers.
+*
+* @param       dst: word aligned destination
+*
+* @param       src: word aligned source
+*
+* @param       blocks: number of XIL_MEM_BLOCK bursts, not 0
+*
+*****************************************************************************/
+static inline void Xil_MemCpyBlocks(u32 *dst, const u32 *src, u32 blocks)
+{
+#if defined (__GNUC__) && defined (__arm__)
+	/* r7 and r11 are left alone, either may be the frame pointer */
+	__asm__ __volatile__(
+		"1:	pld	[%1, #64]\n"
+		"	ldmia	%1!, {r3-r6, r8-r10, r12}\n"
+		"	subs	%2, %2, #1\n"
+		"	stmia	%0!, {r3-r6, r8-r10, r12}\n"
+		"	bne	1b\n"
+		: "+r" (dst), "+r" (src), "+r" (blocks)
+		:
+		: "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12", "cc",
+		  "memory");
+#else
+	while (blocks > 0U) {
+		dst[0] = src[0];
+		dst[1] = src[1];
+		dst[2] = src[2];
+		dst[3] = src[3];
+		dst[4] = src[4];
+		dst[5] = src[5];
+		dst[6] = src[6];
+		dst[7] = src[7];
+		dst += 8U;
+		src += 8U;
+		blocks -= 1U;
+	}
+#endif
+}
+
+/*****************************************************************************/
+/**
+* @brief       Fill whole bursts of a word aligned buffer.
+*
+* @param       dst: word aligned destination
+*
+* @param       val: word to fill with
+*
+* @param       blocks: number of XIL_MEM_BLOCK bursts, not 0
+*
+*****************************************************************************/
+static inline void Xil_MemSetBlocks(u32 *dst, u32 val, u32 blocks)
+{
+#if defined (__GNUC__) && defined (__arm__)
+	__asm__ __volatile__(
+		"	mov	r3, %2\n"
+		"	mov	r4, %2\n"
+		"	mov	r5, %2\n"
+		"	mov	r6, %2\n"
+		"	mov	r8, %2\n"
+		"	mov	r9, %2\n"
+		"	mov	r10, %2\n"
+		"	mov	r12, %2\n"
+		"1:	subs	%1, %1, #1\n"
+		"	stmia	%0!, {r3-r6, r8-r10, r12}\n"
+		"	bne	1b\n"
+		: "+r" (dst), "+r" (blocks)
+		: "r" (val)
+		: "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12", "cc",
+		  "memory");
+#else
+	while (blocks > 0U) {
+		dst[0] = val;
+		dst[1] = val;
+		dst[2] = val;
+		dst[3] = val;
+		dst[4] = val;
+		dst[5] = val;
+		dst[6] = val;
+		dst[7] = val;
+		dst += 8U;
+		blocks -= 1U;
+	}
+#endif
+}
+
 /*****************************************************************************/
 /**
 * @brief       This  function copies memory from once location to other.
@@ -43,11 +141,32 @@
 *
 * @param       cnt: 32 bit length of bytes to be copied
 *
+* @note        When source and destination are at the same offset in a word,
+*              the first bytes are copied one by one up to a word boundary
+*              and the rest in bursts of XIL_MEM_BLOCK bytes.
+*
 *****************************************************************************/
 void Xil_MemCpy(void* dst, const void* src, u32 cnt)
 {
 	char *d = (char*)(void *)dst;
 	const char *s = src;
+	u32 blocks;
+
+	if ((cnt >= XIL_MEM_BLOCK_MIN) &&
+	    ((((UINTPTR)d ^ (UINTPTR)s) & XIL_MEM_WORD_MASK) == 0U)) {
+		while (((UINTPTR)d & XIL_MEM_WORD_MASK) != 0U) {
+			*d = *s;
+			d += 1U;
+			s += 1U;
+			cnt -= 1U;
+		}
+		blocks = cnt / XIL_MEM_BLOCK;
+		Xil_MemCpyBlocks((u32 *)(void *)d, (const u32 *)(const void *)s,
+				 blocks);
+		d += blocks * XIL_MEM_BLOCK;
+		s += blocks * XIL_MEM_BLOCK;
+		cnt -= blocks * XIL_MEM_BLOCK;
+	}
 
 	while (cnt >= sizeof (s32)) {
 		*(s32*)d = *(s32*)s;
@@ -68,3 +187,52 @@ void Xil_MemCpy(void* dst, const void* src, u32 cnt)
 		cnt -= 1U;
 	}
 }
+
+/*****************************************************************************/
+/**
+* @brief       This  function fills memory with a byte value.
+*
+* @param       dst: pointer pointing to destination memory
+*
+* @param       val: value to fill with, the low 8 bits are used
+*
+* @param       cnt: 32 bit length of bytes to be filled
+*
+* @note        The first bytes are written one by one up to a word boundary
+*              and the rest in bursts of XIL_MEM_BLOCK bytes, so no store
+*              is unaligned.
+*
+*****************************************************************************/
+void Xil_MemSet(void* dst, s32 val, u32 cnt)
+{
+	char *d = (char*)(void *)dst;
+	u32 word = (u32)val & 0xFFU;
+	u32 blocks;
+
+	word |= word << 8U;
+	word |= word << 16U;
+
+	while ((cnt > 0U) && (((UINTPTR)d & XIL_MEM_WORD_MASK) != 0U)) {
+		*d = (char)word;
+		d += 1U;
+		cnt -= 1U;
+	}
+
+	if (cnt >= XIL_MEM_BLOCK_MIN) {
+		blocks = cnt / XIL_MEM_BLOCK;
+		Xil_MemSetBlocks((u32 *)(void *)d, word, blocks);
+		d += blocks * XIL_MEM_BLOCK;
+		cnt -= blocks * XIL_MEM_BLOCK;
+	}
+
+	while (cnt >= sizeof (u32)) {
+		*(u32*)(void *)d = word;
+		d += sizeof (u32);
+		cnt -= sizeof (u32);
+	}
+	while ((cnt) > 0U){
+		*d = (char)word;
+		d += 1U;
+		cnt -= 1U;
+	}
+}
@@ -8,7 +8,8 @@
 * @file xil_mmu.c
 *
 * This file provides APIs for enabling/disabling MMU and setting the memory
-* attributes for sections, in the MMU translation table.
+* attributes for sections, in the MMU translation table, and for 4 KB and
+* 64 KB pages in second level tables.
 *
 * <pre>
 * MODIFICATION HISTORY:
@@ -31,6 +32,8 @@
 *			 redundant TLB invalidation in the same API at the beginning.
 * 6.8   aru  09/06/18 Removed compilation warnings for ARMCC toolchain.
 *                     It fixes CR#1008309.
+* 8.1   xl   10/19/26 Added Xil_SetPageAttributes, which maps 4 KB and 64 KB
+*                     pages through second level tables.
 * </pre>
 *
 * @note
@@ -46,6 +49,7 @@
 #include "xil_types.h"
 #include "xil_mmu.h"
 #include "xil_errata.h"
+#include "xstatus.h"
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
@@ -54,12 +58,58 @@
 /************************** Constant Definitions *****************************/
 #define     ARM_AR_MEM_TTB_SECT_SIZE               1024*1024
 #define     ARM_AR_MEM_TTB_SECT_SIZE_MASK          (~(ARM_AR_MEM_TTB_SECT_SIZE-1UL))
+
+/* Second level (coarse) tables: 256 entries of 4 KB, 1 KB aligned */
+#define     ARM_AR_MEM_TTB_L2_ENTRIES              256U
+#define     ARM_AR_MEM_TTB_L2_ALIGN                1024U
+#define     ARM_AR_MEM_SMALL_PAGE_SIZE             0x1000U
+#define     ARM_AR_MEM_LARGE_PAGE_SIZE             0x10000U
+#define     ARM_AR_MEM_LARGE_PAGE_ENTRIES          16U
+
+/* Descriptor types, bits [1:0] */
+#define     ARM_AR_MEM_DESC_TYPE_MASK              0x3U
+#define     ARM_AR_MEM_DESC_FAULT                  0x0U
+#define     ARM_AR_MEM_DESC_COARSE                 0x1U
+#define     ARM_AR_MEM_DESC_SECTION                0x2U
+#define     ARM_AR_MEM_DESC_LARGE_PAGE             0x1U
+#define     ARM_AR_MEM_DESC_SMALL_PAGE             0x2U
+#define     ARM_AR_MEM_SECT_SUPERSECTION           (0x1U << 18)
+
+/* Section fields kept by a coarse table descriptor: domain and NS */
+#define     ARM_AR_MEM_SECT_DOMAIN_MASK            0x1E0U
+#define     ARM_AR_MEM_SECT_NS_SHIFT               19U
+#define     ARM_AR_MEM_COARSE_NS_SHIFT             3U
+
+/*
+ * Second level tables available to Xil_SetPageAttributes, one for each
+ * 1 MB section mapped with pages. At most 32.
+ */
+#ifndef XIL_MMU_L2_TABLES
+#define     XIL_MMU_L2_TABLES                      8U
+#endif
+
 /************************** Variable Definitions *****************************/
 
 extern u32 MMUTable;
 
+#if defined (__ICCARM__)
+#pragma data_alignment = 1024
+static u32 MmuL2Table[XIL_MMU_L2_TABLES][ARM_AR_MEM_TTB_L2_ENTRIES];
+#else
+static u32 MmuL2Table[XIL_MMU_L2_TABLES][ARM_AR_MEM_TTB_L2_ENTRIES]
+			__attribute__ ((aligned (ARM_AR_MEM_TTB_L2_ALIGN)));
+#endif
+/* Section served by each second level table, plus one; 0 if free */
+static u32 MmuL2Section[XIL_MMU_L2_TABLES];
+
 /************************** Function Prototypes ******************************/
 
+static s32 Xil_MmuMapPages(u32 *L1Table, UINTPTR Addr, u32 Size, u32 attrib,
+			u32 *FreedMask);
+static u32 *Xil_MmuGetL2Table(u32 *L1Table, u32 Section, u32 FreedMask);
+static u32 *Xil_MmuFindL2Table(u32 Section);
+static u32 Xil_MmuPageDesc(u32 attrib, u32 PageSize);
+
 /*****************************************************************************/
 /**
 * @brief	This function sets the memory attributes for a section covering 1MB
@@ -200,3 +250,270 @@ void* Xil_MemMap(UINTPTR PhysAddr, size_t size, u32 flags)
    }
    return (void*)PhysAddr;
 }
+
+/*****************************************************************************/
+/**
+* @brief	This function sets the memory attributes of a range of 4 KB
+*			pages. The 1 MB sections that the range covers in part are split
+*			into second level tables, which keep the attributes of the
+*			section for the rest of it. 64 KB aligned parts of the range are
+*			mapped with large pages, whole sections with section entries.
+*
+* @param	Addr: 32-bit address of the range, 4 KB aligned.
+* @param	Size: Size of the range in bytes, a multiple of 4 KB.
+* @param	attrib: Attribute for the given memory region, in the section
+*			format of Xil_SetTlbAttributes. The domain and NS bits of a
+*			split section are kept.
+*
+* @return	XST_SUCCESS if the range is mapped, XST_INVALID_PARAM if the
+*			range is not page aligned or wraps, XST_FAILURE if all the
+*			XIL_MMU_L2_TABLES second level tables are in use. The part of
+*			the range before a failure stays mapped.
+*
+* @note		The MMU or D-cache does not need to be disabled before changing a
+*			translation table entry. The range is mapped flat, the virtual
+*			address is the physical address. A section set again with
+*			Xil_SetTlbAttributes or mapped whole here gives its second level
+*			table back.
+*
+******************************************************************************/
+s32 Xil_SetPageAttributes(INTPTR Addr, u32 Size, u32 attrib)
+{
+	u32 FreedMask = 0U;
+	u32 Index;
+	s32 Status;
+
+	Status = Xil_MmuMapPages(&MMUTable, (UINTPTR)Addr, Size, attrib,
+				 &FreedMask);
+
+	Xil_DCacheFlush();
+
+	mtcp(XREG_CP15_INVAL_UTLB_UNLOCKED, 0U);
+	/* Invalidate all branch predictors */
+	mtcp(XREG_CP15_INVAL_BRANCH_ARRAY, 0U);
+
+	dsb(); /* ensure completion of the BP and TLB invalidation */
+	isb(); /* synchronize context on this processor */
+
+	/* No walk uses a table given back any more, it can be reused */
+	for (Index = 0U; Index < XIL_MMU_L2_TABLES; Index++) {
+		if ((FreedMask & (1U << Index)) != 0U) {
+			MmuL2Section[Index] = 0U;
+		}
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Write the entries of a page range to a translation table.
+*
+* @param	L1Table: First level translation table, 4096 entries.
+* @param	Addr: Address of the range, 4 KB aligned.
+* @param	Size: Size of the range in bytes, a multiple of 4 KB.
+* @param	attrib: Attribute in section format.
+* @param	FreedMask: Returns a bit for each second level table no longer
+*			in use, to be freed once the TLBs are invalidated.
+*
+* @return	XST_SUCCESS, XST_INVALID_PARAM or XST_FAILURE.
+*
+******************************************************************************/
+static s32 Xil_MmuMapPages(u32 *L1Table, UINTPTR Addr, u32 Size, u32 attrib,
+			u32 *FreedMask)
+{
+	u32 Section;
+	u32 Entry;
+	u32 Count;
+	u32 Desc;
+	u32 *L2Table;
+	u32 Index;
+
+	if ((Size == 0U) || (((Addr | Size) &
+	    (ARM_AR_MEM_SMALL_PAGE_SIZE - 1U)) != 0U) ||
+	    ((u32)Addr > (0xFFFFFFFFU - (Size - 1U))) ||
+	    ((attrib & ARM_AR_MEM_SECT_SUPERSECTION) != 0U)) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	while (Size > 0U) {
+		Section = (u32)Addr / 0x100000U;
+
+		if ((((u32)Addr & (ARM_AR_MEM_TTB_SECT_SIZE - 1U)) == 0U) &&
+		    (Size >= ARM_AR_MEM_TTB_SECT_SIZE)) {
+			/* A whole section needs no second level table */
+			L2Table = Xil_MmuFindL2Table(Section);
+			if (L2Table != NULL) {
+				*FreedMask |= 1U << ((u32)(L2Table - MmuL2Table[0]) /
+						ARM_AR_MEM_TTB_L2_ENTRIES);
+			}
+			L1Table[Section] = ((u32)Addr & 0xFFF00000U) | attrib;
+			Addr += ARM_AR_MEM_TTB_SECT_SIZE;
+			Size -= ARM_AR_MEM_TTB_SECT_SIZE;
+			continue;
+		}
+
+		L2Table = Xil_MmuGetL2Table(L1Table, Section, *FreedMask);
+		if (L2Table == NULL) {
+			return (s32)XST_FAILURE;
+		}
+
+		Entry = ((u32)Addr / ARM_AR_MEM_SMALL_PAGE_SIZE) %
+			ARM_AR_MEM_TTB_L2_ENTRIES;
+		if ((((u32)Addr & (ARM_AR_MEM_LARGE_PAGE_SIZE - 1U)) == 0U) &&
+		    (Size >= ARM_AR_MEM_LARGE_PAGE_SIZE)) {
+			/* A large page is repeated in 16 consecutive entries */
+			Desc = Xil_MmuPageDesc(attrib, ARM_AR_MEM_LARGE_PAGE_SIZE);
+			Count = ARM_AR_MEM_LARGE_PAGE_ENTRIES;
+		} else {
+			Desc = Xil_MmuPageDesc(attrib, ARM_AR_MEM_SMALL_PAGE_SIZE);
+			Count = 1U;
+		}
+		if (Desc != ARM_AR_MEM_DESC_FAULT) {
+			Desc |= (u32)Addr & ~(Count * ARM_AR_MEM_SMALL_PAGE_SIZE - 1U);
+		}
+		for (Index = 0U; Index < Count; Index++) {
+			L2Table[Entry + Index] = Desc;
+		}
+
+		Addr += Count * ARM_AR_MEM_SMALL_PAGE_SIZE;
+		Size -= Count * ARM_AR_MEM_SMALL_PAGE_SIZE;
+	}
+
+	return (s32)XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Return the second level table of a section, splitting the
+*			section into 4 KB pages of the same attributes if it has none.
+*
+* @param	L1Table: First level translation table.
+* @param	Section: Index of the 1 MB section.
+* @param	FreedMask: Tables given back since the TLBs were invalidated,
+*			which may still be walked.
+*
+* @return	The second level table, NULL if none is free.
+*
+* @note		A table whose section was set by Xil_SetTlbAttributes since is
+*			free again.
+*
+******************************************************************************/
+static u32 *Xil_MmuGetL2Table(u32 *L1Table, u32 Section, u32 FreedMask)
+{
+	u32 SectDesc = L1Table[Section];
+	u32 *L2Table;
+	u32 Desc;
+	u32 Index;
+
+	L2Table = Xil_MmuFindL2Table(Section);
+	if ((L2Table != NULL) &&
+	    ((SectDesc & ARM_AR_MEM_DESC_TYPE_MASK) == ARM_AR_MEM_DESC_COARSE)) {
+		return L2Table;
+	}
+
+	if (L2Table == NULL) {
+		for (Index = 0U; Index < XIL_MMU_L2_TABLES; Index++) {
+			if ((MmuL2Section[Index] == 0U) ||
+			    (((FreedMask & (1U << Index)) == 0U) &&
+			     ((L1Table[MmuL2Section[Index] - 1U] &
+			       ARM_AR_MEM_DESC_TYPE_MASK) !=
+			      ARM_AR_MEM_DESC_COARSE))) {
+				MmuL2Section[Index] = Section + 1U;
+				L2Table = MmuL2Table[Index];
+				break;
+			}
+		}
+		if (L2Table == NULL) {
+			return NULL;
+		}
+	}
+
+	/*
+	 * The table starts as the section it replaces. A section set by
+	 * Xil_SetTlbAttributes since it was split gets its old table back.
+	 */
+	Desc = Xil_MmuPageDesc(SectDesc, ARM_AR_MEM_SMALL_PAGE_SIZE);
+	for (Index = 0U; Index < ARM_AR_MEM_TTB_L2_ENTRIES; Index++) {
+		if (Desc == ARM_AR_MEM_DESC_FAULT) {
+			L2Table[Index] = ARM_AR_MEM_DESC_FAULT;
+		} else {
+			L2Table[Index] = (SectDesc & 0xFFF00000U) |
+					 (Index * ARM_AR_MEM_SMALL_PAGE_SIZE) | Desc;
+		}
+	}
+
+	L1Table[Section] = ((u32)(UINTPTR)L2Table &
+			    ~(ARM_AR_MEM_TTB_L2_ALIGN - 1U)) |
+			   (((SectDesc >> ARM_AR_MEM_SECT_NS_SHIFT) & 0x1U) <<
+			    ARM_AR_MEM_COARSE_NS_SHIFT) |
+			   (SectDesc & ARM_AR_MEM_SECT_DOMAIN_MASK) |
+			   ARM_AR_MEM_DESC_COARSE;
+
+	return L2Table;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Find the second level table assigned to a section.
+*
+* @param	Section: Index of the 1 MB section.
+*
+* @return	The second level table, NULL if the section has none.
+*
+******************************************************************************/
+static u32 *Xil_MmuFindL2Table(u32 Section)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < XIL_MMU_L2_TABLES; Index++) {
+		if (MmuL2Section[Index] == (Section + 1U)) {
+			return MmuL2Table[Index];
+		}
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Encode the attributes of a section as those of a small or a large
+*			page, without the page address.
+*
+* @param	attrib: Section attribute, as in xil_mmu.h.
+* @param	PageSize: ARM_AR_MEM_SMALL_PAGE_SIZE or
+*			ARM_AR_MEM_LARGE_PAGE_SIZE.
+*
+* @return	The page descriptor bits, ARM_AR_MEM_DESC_FAULT for a section
+*			that is not mapped (RESERVED) or a coarse table descriptor.
+*
+* @note		Section: XN [4], AP [11:10], TEX [14:12], APX [15], S [16],
+*			nG [17]. Small page: XN [0], AP [5:4], TEX [8:6], APX [9], S
+*			[10], nG [11]. Large page: as the small page, with TEX [14:12]
+*			and XN [15]. B [2] and C [3] are the same in all three.
+*
+******************************************************************************/
+static u32 Xil_MmuPageDesc(u32 attrib, u32 PageSize)
+{
+	u32 Desc;
+
+	if ((attrib & ARM_AR_MEM_DESC_SECTION) == 0U) {
+		return ARM_AR_MEM_DESC_FAULT;
+	}
+
+	Desc = attrib & 0xCU;				/* C, B */
+	Desc |= ((attrib >> 10) & 0x3U) << 4;		/* AP */
+	Desc |= ((attrib >> 15) & 0x7U) << 9;		/* APX, S, nG */
+
+	if (PageSize == ARM_AR_MEM_LARGE_PAGE_SIZE) {
+		Desc |= ARM_AR_MEM_DESC_LARGE_PAGE;
+		Desc |= ((attrib >> 12) & 0x7U) << 12;	/* TEX */
+		Desc |= ((attrib >> 4) & 0x1U) << 15;	/* XN */
+	} else {
+		Desc |= ARM_AR_MEM_DESC_SMALL_PAGE;
+		Desc |= ((attrib >> 12) & 0x7U) << 6;	/* TEX */
+		Desc |= (attrib >> 4) & 0x1U;		/* XN */
+	}
+
+	return Desc;
+}
@@ -67,6 +67,8 @@
 * 4.5   sk   03/31/21 Maintain discrete global variables for each controller.
 * 4.6   sk   07/20/21 Fixed compilation warning in RAM interface.
 * 4.8   sk   05/05/22 Replace standard lib functions with Xilinx functions.
+* 5.0   xl   10/19/26 Added an LRU cache with sequential read-ahead for
+*                     single sector reads, and its counters.
 *
 * </pre>
 *
@@ -87,6 +89,28 @@
 #define SD_CD_DELAY		10000U
 #define XSDPS_NUM_INSTANCES	2
 
+/*
+ * Sector cache. FatFs reads the FAT, directories and partial sectors of
+ * files one sector at a time, and reads many of them again while it walks
+ * a path or a cluster chain; those reads are cached. Multi sector reads of
+ * file data go to the media directly.
+ * The cache holds FILE_SYSTEM_CACHE_SECTORS sectors in lines of
+ * FILE_SYSTEM_READ_AHEAD sectors. A miss right after the previous miss
+ * fills a whole line, any other miss one sector. A cache size of 0
+ * removes the cache.
+ */
+#ifndef FILE_SYSTEM_CACHE_SECTORS
+#define FILE_SYSTEM_CACHE_SECTORS	16U
+#endif
+#ifndef FILE_SYSTEM_READ_AHEAD
+#define FILE_SYSTEM_READ_AHEAD		4U
+#endif
+
+#if FILE_SYSTEM_CACHE_SECTORS > 0
+#define CACHE_LINES	(FILE_SYSTEM_CACHE_SECTORS / FILE_SYSTEM_READ_AHEAD)
+#define CACHE_SS	512U
+#endif
+
 #ifdef FILE_SYSTEM_INTERFACE_RAM
 #include "xparameters.h"
 
@@ -117,6 +141,34 @@ static u32 SlotType[XSDPS_NUM_INSTANCES];
 static u8 HostCntrlrVer[XSDPS_NUM_INSTANCES];
 #endif
 
+#if FILE_SYSTEM_CACHE_SECTORS > 0
+typedef struct {
+	LBA_t Start;		/* First sector of the line */
+	u32 Age;		/* Cache clock at the last use */
+	BYTE Drive;
+	BYTE Count;		/* Valid sectors, 0 for a free line */
+} CacheLine;
+
+static CacheLine Cache[CACHE_LINES];
+#ifdef __ICCARM__
+#pragma data_alignment = 32
+static BYTE CacheData[CACHE_LINES][FILE_SYSTEM_READ_AHEAD * CACHE_SS];
+#else
+static BYTE CacheData[CACHE_LINES][FILE_SYSTEM_READ_AHEAD * CACHE_SS]
+	__attribute__ ((aligned(32)));
+#endif
+static u32 CacheClock;
+static LBA_t CacheNextMiss[XSDPS_NUM_INSTANCES];
+#endif
+static DISK_CACHE_STATS CacheStats;
+
+static DRESULT disk_read_media(BYTE pdrv, BYTE *buff, LBA_t sector,
+		UINT count);
+#if FILE_SYSTEM_CACHE_SECTORS > 0
+static DRESULT disk_read_cached(BYTE pdrv, BYTE *buff, LBA_t sector);
+static void disk_cache_drop(BYTE pdrv, LBA_t sector, UINT count);
+#endif
+
 /*-----------------------------------------------------------------------*/
 /* Get Disk Status							*/
 /*-----------------------------------------------------------------------*/
@@ -294,6 +346,11 @@ DSTATUS disk_initialize (
 	}
 
 
+	/*
+	 * The card may have been changed
+	 */
+	disk_cache_invalidate(pdrv);
+
 	/*
 	 * Disk is initialized.
 	 * Store the same in Stat.
@@ -346,10 +403,6 @@ DRESULT disk_read (
 )
 {
 	DSTATUS s;
-#ifdef FILE_SYSTEM_INTERFACE_SD
-	s32 Status = XST_FAILURE;
-	DWORD LocSector = sector;
-#endif
 
 	s = disk_status(pdrv);
 
@@ -360,6 +413,44 @@ DRESULT disk_read (
 		return RES_PARERR;
 	}
 
+#if FILE_SYSTEM_CACHE_SECTORS > 0
+	if (count == 1U) {
+		return disk_read_cached(pdrv, buff, sector);
+	}
+#endif
+	CacheStats.Bypassed += count;
+
+	return disk_read_media(pdrv, buff, sector, count);
+}
+
+/*****************************************************************************/
+/**
+*
+* Reads sectors from the media, without the cache.
+*
+* @param	pdrv - Drive number
+* @param	*buff - Pointer to the data buffer to store read data
+* @param	sector - Start sector number
+* @param	count - Sector count
+*
+* @return
+*		RES_OK		Read successful
+*		RES_ERROR	Read not successful
+*
+* @note		Counted in the Reads and Sectors of the cache counters.
+*
+******************************************************************************/
+static DRESULT disk_read_media(BYTE pdrv, BYTE *buff, LBA_t sector,
+		UINT count)
+{
+#ifdef FILE_SYSTEM_INTERFACE_SD
+	s32 Status = XST_FAILURE;
+	DWORD LocSector = sector;
+#endif
+
+	CacheStats.Reads++;
+	CacheStats.Sectors += count;
+
 #ifdef FILE_SYSTEM_INTERFACE_SD
 	/* Convert LBA to byte address if needed */
 	if ((SdInstance[pdrv].HCS) == 0U) {
@@ -373,11 +464,13 @@ DRESULT disk_read (
 #endif
 
 #ifdef FILE_SYSTEM_INTERFACE_RAM
+	(void)pdrv;
 	Xil_SMemCpy(buff, count * SECTORSIZE, dataramfs + (sector * SECTORSIZE),
 			count * SECTORSIZE, count * SECTORSIZE);
 #endif
 
 #if !defined(FILE_SYSTEM_INTERFACE_SD) && !defined(FILE_SYSTEM_INTERFACE_RAM)
+	(void)pdrv;
 	(void)buff;
 	(void)sector;
 #endif
@@ -385,6 +478,172 @@ DRESULT disk_read (
     return RES_OK;
 }
 
+#if FILE_SYSTEM_CACHE_SECTORS > 0
+/*****************************************************************************/
+/**
+*
+* Reads one sector through the cache. On a miss, the least recently used
+* line is refilled, with FILE_SYSTEM_READ_AHEAD sectors from the missed
+* one when the miss follows the previous one, else with that sector only.
+*
+* @param	pdrv - Drive number
+* @param	*buff - Pointer to the data buffer to store read data
+* @param	sector - Sector number
+*
+* @return
+*		RES_OK		Read successful
+*		RES_ERROR	Read not successful
+*
+* @note		A failed read-ahead, at the end of the media, is retried
+*		for the one sector.
+*
+******************************************************************************/
+static DRESULT disk_read_cached(BYTE pdrv, BYTE *buff, LBA_t sector)
+{
+	CacheLine *Line;
+	u32 Index;
+	u32 Victim = 0U;
+	UINT Count = 1U;
+	DRESULT res;
+
+	CacheClock++;
+
+	for (Index = 0U; Index < CACHE_LINES; Index++) {
+		Line = &Cache[Index];
+		if ((Line->Count != 0U) && (Line->Drive == pdrv) &&
+				(sector >= Line->Start) &&
+				(sector < (Line->Start + Line->Count))) {
+			Line->Age = CacheClock;
+			CacheStats.Hits++;
+			(void)Xil_SMemCpy(buff, CACHE_SS,
+					&CacheData[Index][(sector - Line->Start) * CACHE_SS],
+					CACHE_SS, CACHE_SS);
+			return RES_OK;
+		}
+		if ((Cache[Victim].Count != 0U) &&
+				((Line->Count == 0U) || (Line->Age < Cache[Victim].Age))) {
+			Victim = Index;
+		}
+	}
+
+	CacheStats.Misses++;
+	if ((pdrv < XSDPS_NUM_INSTANCES) && (sector == CacheNextMiss[pdrv])) {
+		Count = FILE_SYSTEM_READ_AHEAD;
+	}
+
+	Line = &Cache[Victim];
+	Line->Count = 0U;
+	res = disk_read_media(pdrv, CacheData[Victim], sector, Count);
+	if ((res != RES_OK) && (Count > 1U)) {
+		Count = 1U;
+		res = disk_read_media(pdrv, CacheData[Victim], sector, Count);
+	}
+	if (res != RES_OK) {
+		return res;
+	}
+
+	CacheStats.ReadAhead += Count - 1U;
+	if (pdrv < XSDPS_NUM_INSTANCES) {
+		CacheNextMiss[pdrv] = sector + 1U;
+	}
+	Line->Start = sector;
+	Line->Drive = pdrv;
+	Line->Count = (BYTE)Count;
+	Line->Age = CacheClock;
+	(void)Xil_SMemCpy(buff, CACHE_SS, CacheData[Victim], CACHE_SS, CACHE_SS);
+
+	return RES_OK;
+}
+
+/*****************************************************************************/
+/**
+*
+* Drops the cached copies of sectors about to change.
+*
+* @param	pdrv - Drive number
+* @param	sector - First sector
+* @param	count - Sector count
+*
+* @return	None
+*
+* @note		None
+*
+******************************************************************************/
+static void disk_cache_drop(BYTE pdrv, LBA_t sector, UINT count)
+{
+	CacheLine *Line;
+	u32 Index;
+
+	for (Index = 0U; Index < CACHE_LINES; Index++) {
+		Line = &Cache[Index];
+		if ((Line->Count != 0U) && (Line->Drive == pdrv) &&
+				(sector < (Line->Start + Line->Count)) &&
+				(Line->Start < (sector + count))) {
+			Line->Count = 0U;
+		}
+	}
+}
+#endif
+
+/*****************************************************************************/
+/**
+*
+* Empties the sector cache of a drive, for when the media may have been
+* changed behind FatFs.
+*
+* @param	pdrv - Drive number
+*
+* @return	None
+*
+* @note		None
+*
+******************************************************************************/
+void disk_cache_invalidate (
+	BYTE pdrv		/* Physical drive number (0..) */
+)
+{
+#if FILE_SYSTEM_CACHE_SECTORS > 0
+	u32 Index;
+
+	for (Index = 0U; Index < CACHE_LINES; Index++) {
+		if (Cache[Index].Drive == pdrv) {
+			Cache[Index].Count = 0U;
+		}
+	}
+	if (pdrv < XSDPS_NUM_INSTANCES) {
+		CacheNextMiss[pdrv] = 0U;
+	}
+#else
+	(void)pdrv;
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* Returns the sector cache counters, counted since the start or the last
+* call with reset set.
+*
+* @param	*stats - Filled with the counters
+* @param	reset - Non-zero to clear the counters after reading them
+*
+* @return	None
+*
+* @note		None
+*
+******************************************************************************/
+void disk_cache_stats (
+	DISK_CACHE_STATS *stats,	/* Counters */
+	BYTE reset					/* Clear them after the copy */
+)
+{
+	*stats = CacheStats;
+	if (reset != 0U) {
+		(void)Xil_SMemSet(&CacheStats, sizeof(CacheStats), 0U,
+				sizeof(CacheStats));
+	}
+}
+
 /*-----------------------------------------------------------------------*/
 /* Miscellaneous Functions						*/
 /*-----------------------------------------------------------------------*/
@@ -424,6 +683,7 @@ DRESULT disk_ioctl (
 				SendBuff[0] *= (DWORD)XSDPS_BLK_SIZE_512_MASK;
 				SendBuff[1] *= (DWORD)XSDPS_BLK_SIZE_512_MASK;
 			}
+			disk_cache_invalidate(pdrv);
 			(void)XSdPs_Erase(&SdInstance[pdrv], SendBuff[0], SendBuff[1]);
 			res = RES_OK;
 			break;
@@ -530,6 +790,10 @@ DRESULT disk_write (
 		return RES_PARERR;
 	}
 
+#if FILE_SYSTEM_CACHE_SECTORS > 0
+	disk_cache_drop(pdrv, sector, count);
+#endif
+
 #ifdef FILE_SYSTEM_INTERFACE_SD
 	/* Convert LBA to byte address if needed */
 	if ((SdInstance[pdrv].HCS) == 0U) {
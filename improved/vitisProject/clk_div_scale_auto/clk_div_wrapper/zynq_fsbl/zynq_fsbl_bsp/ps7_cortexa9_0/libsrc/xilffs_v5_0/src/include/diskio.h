@@ -27,6 +27,16 @@ typedef enum {
 	RES_PARERR		/* 4: Invalid Parameter */
 } DRESULT;
 
+/* Sector cache counters */
+typedef struct {
+	DWORD Hits;			/* Single sector reads served from the cache */
+	DWORD Misses;		/* Single sector reads that went to the media */
+	DWORD ReadAhead;	/* Sectors read ahead on sequential misses */
+	DWORD Bypassed;		/* Sectors read around the cache */
+	DWORD Reads;		/* Media read commands */
+	DWORD Sectors;		/* Sectors read from the media */
+} DISK_CACHE_STATS;
+
 
 /*---------------------------------------*/
 /* Prototypes for disk control functions */
@@ -37,6 +47,8 @@ DSTATUS disk_status (BYTE pdrv);
 DRESULT disk_read (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count);
 DRESULT disk_write (BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count);
 DRESULT disk_ioctl (BYTE pdrv, BYTE cmd, void* buff);
+void disk_cache_invalidate (BYTE pdrv);
+void disk_cache_stats (DISK_CACHE_STATS* stats, BYTE reset);
 
 
 /* Disk Status Bits (DSTATUS) */